@@ -3,33 +3,134 @@
 
 #include "gpaddon.h"
 
-#include <vector>
+#include <new>
 #include <pico/mutex.h>
 
+// Add-ons one manager can hold, every registered one fits
+#define ADDONMGR_MAX_ADDONS ADDON_ID_COUNT
+
+// Time a pass may spend on add-on polls, the first due poll of a pass always runs
+#ifndef ADDON_POLL_BUDGET_US
+#define ADDON_POLL_BUDGET_US 400
+#endif
+
 enum ADDON_PROCESS {
     CORE0_INPUT,
     CORE0_USBREPORT,
     CORE1_ALWAYS,
-    CORE1_LOOP
+    CORE1_LOOP,
+    ADDON_PROCESS_COUNT
+};
+
+struct AddonPollStats {
+    uint32_t polls;         // polls that ran
+    uint32_t deferred;      // times a due poll was left for a later pass, the budget was spent
+    uint32_t overruns;      // polls that ran a whole period or more behind their deadline
+    uint32_t lastUs;        // duration of the last poll
+    uint32_t maxUs;
+    uint32_t maxLateUs;     // furthest a poll ran behind its deadline
+};
+
+// Time spent in one hook, only collected with LOOP_PROFILER_ENABLED
+struct AddonTimingStats {
+    uint32_t count;
+    uint32_t max;
+    uint32_t sum;           // us, wraps after ~71 minutes spent in the hook
 };
 
 struct AddonBlock {
     GPAddon * ptr;
+    AddonId id;
     ADDON_PROCESS process;
+    uint8_t hooks;          // AddonHook flags the add-on implements
+    uint32_t setupUs;       // time spent in available() and setup()
+    int32_t setupHeap;      // heap setup() left allocated
+    AddonSchedule schedule;
+    uint32_t nextPollUs;    // deadline of the next poll
+    AddonPollStats pollStats;
+    AddonTimingStats preprocessTiming;
+    AddonTimingStats processTiming;
+};
+
+// Entry of a per-phase dispatch list, the add-on pointer is kept next to its block to save a load per call
+struct AddonDispatch {
+    GPAddon * ptr;
+    AddonBlock * block;
+};
+
+// Dispatch entries of all phases in one array, grouped by phase in load order
+struct AddonDispatchList {
+    AddonDispatch entries[ADDONMGR_MAX_ADDONS];
+    uint8_t ends[ADDON_PROCESS_COUNT];      // one past the last entry of each phase
+
+    void add(ADDON_PROCESS process, const AddonDispatch& entry);
+    AddonDispatch * begin(ADDON_PROCESS process) { return entries + (process == 0 ? 0 : ends[process - 1]); }
+    AddonDispatch * end(ADDON_PROCESS process) { return entries + ends[process]; }
+};
+
+// Where add-on T lives once constructed, in place of a heap allocation. One instance per add-on type.
+template <typename T>
+struct AddonStorage {
+    alignas(T) static uint8_t buffer[sizeof(T)];
 };
 
+template <typename T>
+alignas(T) uint8_t AddonStorage<T>::buffer[sizeof(T)];
+
 class AddonManager {
 public:
     AddonManager() {}
     ~AddonManager() {}
+
+    // Load add-on T if its config enables it, constructing it in its static storage only then
+    template <typename T>
+    bool LoadAddon(ADDON_PROCESS processAt) {
+        if (!T::isEnabled() || addonCount == ADDONMGR_MAX_ADDONS)
+            return false;
+        return LoadBlock(new (AddonStorage<T>::buffer) T(), T::ID, processAt, false, false);
+    }
+
+    // Same, then pushes the add-on's USB host listener
+    template <typename T>
+    bool LoadUSBAddon(ADDON_PROCESS processAt) {
+        if (!T::isEnabled() || addonCount == ADDONMGR_MAX_ADDONS)
+            return false;
+        return LoadBlock(new (AddonStorage<T>::buffer) T(), T::ID, processAt, true, false);
+    }
+
+    // Add-on created on the heap elsewhere, e.g. by a host tool, deleted again when not available
     bool LoadAddon(GPAddon*, ADDON_PROCESS);
-    bool LoadUSBAddon(GPAddon*, ADDON_PROCESS);
     void ReinitializeAddons(ADDON_PROCESS);
     void PreprocessAddons(ADDON_PROCESS);
     void ProcessAddons(ADDON_PROCESS);
-    GPAddon * GetAddon(std::string); // hack for NeoPicoLED
+    // Run the due polls, long overdue ones, then highest priority, then earliest deadline first, until budgetUs is spent
+    void PollAddons(ADDON_PROCESS, uint32_t budgetUs = ADDON_POLL_BUDGET_US);
+    // Clear the poll and timing stats of every add-on
+    void ResetStats();
+    uint8_t GetAddonCount() const { return addonCount; }
+    const AddonBlock& GetAddonBlock(uint8_t index) const { return blocks[index]; }
+    GPAddon * GetAddon(AddonId id);
+    // Time and heap all loads took so far, kept add-ons or not
+    uint32_t GetLoadUs() const { return loadUs; }
+    int32_t GetLoadHeap() const { return loadHeap; }
+
+    static const char * GetAddonName(AddonId id);
+    // Manager that last loaded an add-on on the core, for reporting from the other one
+    static const AddonManager * GetCoreManager(uint8_t core);
 private:
-    std::vector<AddonBlock*> addons;    // addons currently loaded
+    bool LoadBlock(GPAddon * addon, AddonId id, ADDON_PROCESS processAt, bool usbListener, bool onHeap);
+
+    AddonBlock blocks[ADDONMGR_MAX_ADDONS];     // addons currently loaded
+    uint8_t addonCount = 0;
+    uint32_t loadUs = 0;
+    int32_t loadHeap = 0;
+    // Built as add-ons load, only the add-ons that implement the hook
+    AddonDispatchList preprocessList = { };
+    AddonDispatchList processList = { };
+    AddonDispatchList reinitList = { };
+    AddonDispatchList pollList = { };
+
+    static const AddonManager * coreManagers[2];
 };
 
 #endif
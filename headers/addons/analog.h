@@ -71,9 +71,6 @@
 #define ANALOG_ERROR 1000
 #endif
 
-// Analog Module Name
-#define AnalogName "Analog"
-
 #define ADC_COUNT 2
 
 typedef struct
@@ -97,11 +94,12 @@ typedef struct
 
 class AnalogInput : public GPAddon {
 public:
-    virtual bool available();
+    static bool isEnabled();
     virtual void setup();       // Analog Setup
     virtual void process();     // Analog Process
     virtual void preprocess() {}
-    virtual std::string name() { return AnalogName; }
+    virtual uint8_t getHooks() { return ADDON_HOOK_PROCESS; }
+    static constexpr AddonId ID = ADDON_ID_ANALOG;
 private:
     float readPin(Pin_t pin, uint16_t center);
     float emaCalculation(float ema_value, float ema_previous);
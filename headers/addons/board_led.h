@@ -17,20 +17,18 @@
 #define BOARD_LED_TYPE ON_BOARD_LED_MODE_OFF
 #endif  
 
-// BoardLed Module Name
-#define OnBoardLedName "OnBoardLed"
-
 #define BOARD_LED_PIN 25
 #define BLINK_INTERVAL_USB_UNMOUNTED 200
 #define BLINK_INTERVAL_CONFIG_MODE 1000
 
 class BoardLedAddon : public GPAddon {
 public:
-	virtual bool available();
+	static bool isEnabled();
 	virtual void setup();       // BoardLed Setup
 	virtual void process();     // BoardLed Process
 	virtual void preprocess() {}
-	virtual std::string name() { return OnBoardLedName; }
+	virtual uint8_t getHooks() { return ADDON_HOOK_PROCESS; }
+	static constexpr AddonId ID = ADDON_ID_BOARD_LED;
 private:
 	OnBoardLedMode onBoardLedMode;
 	bool isConfigMode;
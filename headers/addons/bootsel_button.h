@@ -12,16 +12,14 @@
 #define BOOTSEL_BUTTON_MASK 0 // 0 means none, get other mask from GamepadState.h
 #endif
 
-// BootselButton Module Name
-#define BootselButtonName "BootselButton"
-
 class BootselButtonAddon : public GPAddon {
 public:
-	virtual bool available();
+	static bool isEnabled();
 	virtual void setup();       // BootselButton Setup
 	virtual void process() {}     // BootselButton Process
 	virtual void preprocess();
-	virtual std::string name() { return BootselButtonName; }
+	virtual uint8_t getHooks() { return ADDON_HOOK_PREPROCESS; }
+	static constexpr AddonId ID = ADDON_ID_BOOTSEL_BUTTON;
 private:	
 	bool isBootselPressed();
 	uint32_t bootselButtonMap;
@@ -21,9 +21,6 @@
 #define BUZZER_VOLUME 100
 #endif
 
-// Buzzer Speaker Module
-#define BuzzerSpeakerName "BuzzerSpeaker"
-
 enum Tone {
 	B0 = 31,
 	C1 = 33,
@@ -129,11 +126,12 @@ struct Song {
 class BuzzerSpeakerAddon : public GPAddon
 {
 public:
-	virtual bool available();
+	static bool isEnabled();
 	virtual void setup();
 	virtual void preprocess() {}
 	virtual void process();
-	virtual std::string name() { return BuzzerSpeakerName; }
+	virtual uint8_t getHooks() { return ADDON_HOOK_PROCESS; }
+	static constexpr AddonId ID = ADDON_ID_BUZZER_SPEAKER;
 private:
 	void processBuzzer();
 	void play(Song *song);
@@ -18,6 +18,7 @@
 #include "gpaddon.h"
 #include "gamepad.h"
 #include "storagemanager.h"
+#include "eventmanager.h"
 #include "peripheralmanager.h"
 #include "peripheral_i2c.h"
 #include "peripheral_spi.h"
@@ -182,18 +183,17 @@
 	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00
 #endif
 
-// i2c Display Module
-#define DisplayName "Display"
-
 // i2C OLED Display
 class DisplayAddon : public GPAddon
 {
 public:
+	static bool isEnabled();
 	virtual bool available();
 	virtual void setup();
 	virtual void preprocess() {}
 	virtual void process();
-	virtual std::string name() { return DisplayName; }
+	virtual uint8_t getHooks() { return ADDON_HOOK_PROCESS; }
+	static constexpr AddonId ID = ADDON_ID_DISPLAY;
 
     void handleSystemRestart(GPEvent* e);
     void handleMenuNavigation(GPEvent* e);
@@ -208,6 +208,8 @@ private:
 	const DisplayOptions& getDisplayOptions();
 	bool isDisplayPowerOff();
 	void setDisplayPower(uint8_t status);
+	EventHandlerToken restartHandler;
+	EventHandlerToken menuNavigationHandler;
 	uint32_t displaySaverTimeout = 0;
 	int32_t displaySaverTimer;
 	uint8_t displayIsPowerOn = 1;
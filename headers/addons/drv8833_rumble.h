@@ -35,9 +35,6 @@
 #define DRV8833_RUMBLE_DUTY_MAX 100.0f
 #endif
 
-// DRV8833 Rumble Module
-#define DRV8833RumbleName "DRV8833Rumble"
-
 // Scale uint8 to 0 -> 100 range
 #define motorToDuty(m) (100.0f * (m/255.0f))
 // Rescale from 0 -> 100 range to min -> max range
@@ -47,17 +44,18 @@
 class DRV8833RumbleAddon : public GPAddon
 {
 public:
-	virtual bool available();
+	static bool isEnabled();
 	virtual void setup();
 	virtual void preprocess() {}
 	virtual void process();
-	virtual std::string name() { return DRV8833RumbleName; }
+	virtual uint8_t getHooks() { return ADDON_HOOK_PROCESS; }
+	static constexpr AddonId ID = ADDON_ID_DRV8833_RUMBLE;
 private:
 	uint32_t pwmSetFreqDuty(uint slice, uint channel, uint32_t frequency, float duty);
-	bool compareRumbleState(Gamepad * gamepad);
-	void setRumbleState(Gamepad * gamepad);
+	bool compareRumbleState(const GamepadAuxHaptics& haptics);
+	void setRumbleState(const GamepadAuxHaptics& haptics);
 	void disableMotors();
-	void enableMotors(Gamepad * gamepad);
+	void enableMotors(const GamepadAuxHaptics& haptics);
 	uint8_t leftMotorPin;
 	uint8_t rightMotorPin;
 	uint8_t motorSleepPin;
@@ -70,6 +68,8 @@ private:
 	float dutyMax;
 	uint32_t sysClock;
 	GamepadAuxHaptics currentRumbleState;
+	GamepadAuxState auxState; // last aux state core0 published
+	uint32_t auxStateVersion = 0;
 };
 
 #endif
@@ -13,31 +13,21 @@
 #define DUAL_DIRECTIONAL_STICK_MODE DPAD_MODE_DIGITAL
 #endif
 
-// Dual Directional Module Name
-#define DualDirectionalName "DualDirectional"
-
 class DualDirectionalInput : public GPAddon {
 public:
-    virtual bool available();
+    static bool isEnabled();
     virtual void setup();       // Dual Directional Setup
     virtual void process();     // Dual Directional Process
     virtual void reinit();
     virtual void preprocess();  // Dual Directional Pre-Process (Cheat)
-    virtual std::string name() { return DualDirectionalName; }
+    static constexpr AddonId ID = ADDON_ID_DUAL_DIRECTIONAL;
 private:
     uint8_t gpadToBinary(DpadMode, GamepadState);
-    uint8_t updateDpadDDI(uint8_t dpad, DpadDirection direction);
-    uint8_t filterToFourWayModeDDI(uint8_t dpad);
-    void SOCDDualClean(SOCDMode);
     uint8_t SOCDCombine(SOCDMode, uint8_t);
-    uint8_t SOCDGamepadClean(uint8_t, bool isLastWin);
     void OverrideGamepad(Gamepad *, DpadMode, uint8_t);
-    const SOCDMode getSOCDMode(const GamepadOptions&);
     uint8_t dualState;          // Dual Directional State
-    DpadDirection lastGPUD; // Gamepad Last Up-Down
-    DpadDirection lastGPLR; // Gamepad Last Left-Right
-    DpadDirection lastDualUD; // Dual Last Up-Down
-    DpadDirection lastDualLR; // Gamepad Last Left-Right
+    DpadResolver dualResolver; // Dual 4-way and SOCD history
+    DpadResolver gamepadResolver; // Gamepad + Dual re-clean history in mixed mode
     GamepadButtonMapping *mapDpadUp;
     GamepadButtonMapping *mapDpadDown;
     GamepadButtonMapping *mapDpadLeft;
@@ -32,16 +32,14 @@
 #define FOCUS_MODE_MACRO_LOCK_ENABLED 1
 #endif
 
-// FocusMode Module Name
-#define FocusModeName "FocusMode"
-
 class FocusModeAddon : public GPAddon {
 public:
-	virtual bool available();
+	static bool isEnabled();
 	virtual void setup();       // FocusMode Setup
 	virtual void process();     // FocusMode Process
 	virtual void preprocess() {}
-	virtual std::string name() { return FocusModeName; }
+	virtual uint8_t getHooks() { return ADDON_HOOK_PROCESS; }
+	static constexpr AddonId ID = ADDON_ID_FOCUS_MODE;
 private:
 	uint32_t buttonLockMask;
 	GamepadButtonMapping *mapFocusMode;
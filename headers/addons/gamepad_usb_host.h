@@ -11,16 +11,14 @@
 #define GAMEPAD_USB_HOST_ENABLED 0
 #endif
 
-// GamepadUSBHost Module Name
-#define GamepadUSBHostName "GamepadUSBHost"
-
 class GamepadUSBHostAddon : public GPAddon {
 public:
-	virtual bool available();
+	static bool isEnabled();
 	virtual void setup();       // GamepadUSBHost Setup
 	virtual void process() {}   // GamepadUSBHost Process
 	virtual void preprocess();
-	virtual std::string name() { return GamepadUSBHostName; }
+	virtual uint8_t getHooks() { return ADDON_HOOK_PREPROCESS; }
+	static constexpr AddonId ID = ADDON_ID_GAMEPAD_USB_HOST;
 private:
 };
 
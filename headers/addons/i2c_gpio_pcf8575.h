@@ -133,20 +133,27 @@
 #define PCF8575_PIN15_ACTION GpioAction::NONE
 #endif
 
-// IO Module Name
-#define PCF8575AddonName "PCF8575"
+// Period of the output pin writes, the input pins are read every pass
+#ifndef PCF8575_POLL_US
+#define PCF8575_POLL_US 1000
+#endif
 
 class PCF8575Addon : public GPAddon {
 public:
+	static bool isEnabled();
 	virtual bool available();
 	virtual void setup();
-	virtual void preprocess() {}
+	virtual void preprocess();  // Pin Read
 	virtual void process();
-    virtual std::string name() { return PCF8575AddonName; }
+	virtual uint8_t getHooks() { return ADDON_HOOK_PREPROCESS | ADDON_HOOK_PROCESS; }
+	virtual void poll();        // Pin Write
+	virtual AddonSchedule getSchedule() { return { hasOutputs ? PCF8575_POLL_US : 0, ADDON_PRIORITY_HIGH }; }
+    static constexpr AddonId ID = ADDON_ID_PCF8575;
 
     std::map<uint8_t, GpioMappingInfo> pinRef;
 private:
     PCF8575* pcf;
+    bool hasOutputs = false;
 
     bool inputButtonUp = false;
     bool inputButtonDown = false;
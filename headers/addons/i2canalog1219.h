@@ -32,8 +32,10 @@
 #define I2C_ANALOG1219_ADDRESS 0x40
 #endif
 
-// Analog Module Name
-#define I2CAnalog1219Name "I2CAnalog"
+// One channel per conversion at 1000 SPS
+#ifndef I2C_ANALOG1219_POLL_US
+#define I2C_ANALOG1219_POLL_US 1000
+#endif
 
 typedef struct {
 	float A[4];
@@ -41,17 +43,19 @@ typedef struct {
 
 class I2CAnalog1219Input : public GPAddon {
 public:
+	static bool isEnabled();
 	virtual bool available();
 	virtual void setup();       // Analog Setup
 	virtual void preprocess() {}
 	virtual void process();     // Analog Process
-    virtual std::string name() { return I2CAnalog1219Name; }
+	virtual uint8_t getHooks() { return ADDON_HOOK_PROCESS; }
+	virtual void poll();        // ADS1219 Read
+	virtual AddonSchedule getSchedule() { return { I2C_ANALOG1219_POLL_US, ADDON_PRIORITY_NORMAL }; }
+    static constexpr AddonId ID = ADDON_ID_I2C_ANALOG_1219;
 private:
     ADS1219Device * ads;
 	ADS_PINS pins;
 	int channelHop;
-	uint32_t uIntervalMS;       // ADS1219 Interval
-	uint32_t nextTimer;         // Turbo Timer
 };
 
 #endif  // _I2CAnalog_H_
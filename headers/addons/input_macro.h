@@ -29,17 +29,15 @@
 #define MAX_MACRO_LIMIT 6
 #define INPUT_HOLD_US 16666
 
-// Input Macro Module Name
-#define InputMacroName "Input Macro"
-
 class InputMacro : public GPAddon {
 public:
-	virtual bool available();   // GPAddon available
+	static bool isEnabled();
 	virtual void setup();       // Analog Setup
 	virtual void process() {};     // Analog Process
 	virtual void preprocess();
     virtual void reinit();
-    virtual std::string name() { return InputMacroName; }
+	virtual uint8_t getHooks() { return ADDON_HOOK_PREPROCESS | ADDON_HOOK_REINIT; }
+    static constexpr AddonId ID = ADDON_ID_INPUT_MACRO;
 private:
 	void checkMacroPress();
 	void checkMacroAction();
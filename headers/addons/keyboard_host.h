@@ -15,16 +15,14 @@
 #define KEYBOARD_HOST_PIN_5V -1
 #endif
 
-// KeyboardHost Module Name
-#define KeyboardHostName "KeyboardHost"
-
 class KeyboardHostAddon : public GPAddon {
 public:
-	virtual bool available();
+	static bool isEnabled();
 	virtual void setup();       // KeyboardHost Setup
 	virtual void process() {}   // KeyboardHost Process
 	virtual void preprocess();
-	virtual std::string name() { return KeyboardHostName; }
+	virtual uint8_t getHooks() { return ADDON_HOOK_PREPROCESS; }
+	static constexpr AddonId ID = ADDON_ID_KEYBOARD_HOST;
 private:
 };
 
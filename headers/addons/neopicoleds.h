@@ -155,7 +155,7 @@
 #endif
 
 void configureAnimations(AnimationStation *as);
-AnimationHotkey animationHotkeys(Gamepad *gamepad);
+AnimationHotkey animationHotkeys(GamepadState& state);
 PixelMatrix createLedButtonLayout(ButtonLayout layout, int ledsPerPixel);
 PixelMatrix createLedButtonLayout(ButtonLayout layout, std::vector<uint8_t> *positions);
 
@@ -168,16 +168,15 @@ public:
 	uint16_t * getLedLevels() { return ledLevels; }
 };
 
-#define NeoPicoLEDName "NeoPicoLED"
-
 // NeoPico LED Addon
 class NeoPicoLEDAddon : public GPAddon {
 public:
-	virtual bool available();
+	static bool isEnabled();
 	virtual void setup();
 	virtual void preprocess() {}
 	virtual void process();
-	virtual std::string name() { return NeoPicoLEDName; }
+	virtual uint8_t getHooks() { return ADDON_HOOK_PROCESS; }
+	static constexpr AddonId ID = ADDON_ID_NEOPICO_LED;
 	void configureLEDs();
 	uint32_t frame[100];
 private:
@@ -190,6 +189,10 @@ private:
 	uint8_t setupButtonPositions();
 	const uint32_t intervalMS = 10;
 	absolute_time_t nextRunTime;
+	GamepadState processedState;
+	uint32_t processedStateVersion = 0;
+	GamepadAuxState processedAuxState;
+	uint32_t processedAuxStateVersion = 0;
 	uint8_t ledCount;
 	PixelMatrix matrix;
 	NeoPico *neopico;
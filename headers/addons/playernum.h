@@ -15,16 +15,14 @@
 #define PLAYER_NUMBER 1
 #endif
 
-// Analog Module Name
-#define PlayerNumName "PlayerNum"
-
 class PlayerNumAddon : public GPAddon {
 public:
-	virtual bool available();
+	static bool isEnabled();
 	virtual void setup();       // Analog Setup
 	virtual void process();     // Analog Process
 	virtual void preprocess() {}
-    virtual std::string name() { return PlayerNumName; }
+	virtual uint8_t getHooks() { return ADDON_HOOK_PROCESS; }
+    static constexpr AddonId ID = ADDON_ID_PLAYER_NUM;
 private:
 	void handleLED(int);
 	uint8_t assigned;
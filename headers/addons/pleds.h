@@ -27,18 +27,16 @@ public:
 	void display();
 };
 
-// Player LED Module
-#define PLEDName "PLED"
-
 // Player LED Module
 class PlayerLEDAddon : public GPAddon
 {
 public:
-	virtual bool available();
+	static bool isEnabled();
 	virtual void setup();
 	virtual void preprocess() {}
 	virtual void process();
-	virtual std::string name() { return PLEDName; }
+	virtual uint8_t getHooks() { return ADDON_HOOK_PROCESS; }
+	static constexpr AddonId ID = ADDON_ID_PLAYER_LED;
 	PlayerLEDAddon() {
 		type = static_cast<PLEDType>(Storage::getInstance().getLedOptions().pledType);
 	}
@@ -51,6 +49,8 @@ protected:
 
 private:
 	bool turnOffWhenSuspended;
+	GamepadAuxState auxState; // last aux state core0 published
+	uint32_t auxStateVersion = 0;
 };
 
 #endif
@@ -23,18 +23,16 @@
 #define REACTIVE_LED_FADE_INC 1
 #endif
 
-// Reactive LED Module
-#define ReactiveLEDName "ReactiveLED"
-
 // Reactive LED
 class ReactiveLEDAddon : public GPAddon
 {
     public:
-        virtual bool available();
+        static bool isEnabled();
         virtual void setup();
         virtual void preprocess() {}
         virtual void process();
-        virtual std::string name() { return ReactiveLEDName; }
+        virtual uint8_t getHooks() { return ADDON_HOOK_PROCESS; }
+        static constexpr AddonId ID = ADDON_ID_REACTIVE_LED;
     private:
         struct ReactiveLEDPinState {
             uint16_t pinNumber = -1;
@@ -50,6 +48,10 @@ class ReactiveLEDAddon : public GPAddon
 
         ReactiveLEDPinState ledPins[REACTIVE_LED_COUNT];
 
+        GamepadState state;
+        uint32_t stateVersion = 0;  // version of the processed state the LEDs show
+        bool fading = false;        // an LED still has steps to go without a new state
+
         void setLEDByMode(ReactiveLEDPinState &ledState, bool pressed);
 };
 
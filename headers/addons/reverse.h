@@ -33,16 +33,14 @@
 #define REVERSE_RIGHT_DEFAULT 0
 #endif
 
-// Reverse Module Name
-#define ReverseName "Input Reverse"
-
 class ReverseInput : public GPAddon {
 public:
-	virtual bool available();
+	static bool isEnabled();
 	virtual void setup();       // Reverse Button Setup
 	virtual void preprocess() {}
 	virtual void process();     // Reverse process
-    virtual std::string name() { return ReverseName; }
+	virtual uint8_t getHooks() { return ADDON_HOOK_PROCESS; }
+    static constexpr AddonId ID = ADDON_ID_REVERSE;
 private:
     void update();
     uint8_t input(uint32_t valueMask, uint16_t buttonMask, uint16_t buttonMaskReverse, uint8_t action, bool invertAxis);
@@ -78,16 +78,14 @@
 #define ENCODER_RADIUS 1440 // 4 phases * 360
 #define ENCODER_PRECISION 16
 
-// RotaryEncoderName Module Name
-#define RotaryEncoderName "Rotary"
-
 class RotaryEncoderInput : public GPAddon {
 public:
-    virtual bool available();
+    static bool isEnabled();
 	virtual void setup();       // Rotary Setup
     virtual void preprocess() {}
 	virtual void process();     // Rotary process
-    virtual std::string name() { return RotaryEncoderName; }
+    virtual uint8_t getHooks() { return ADDON_HOOK_PROCESS; }
+    static constexpr AddonId ID = ADDON_ID_ROTARY_ENCODER;
 
     typedef struct {
         bool enabled = false;
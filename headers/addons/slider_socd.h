@@ -22,17 +22,15 @@
 #define SLIDER_SOCD_SLOT_DEFAULT SOCD_MODE_NEUTRAL
 #endif
 
-// Slider Module Name
-#define SliderSOCDName "SliderSOCD"
-
 class SliderSOCDInput : public GPAddon {
 public:
-    virtual bool available();
+    static bool isEnabled();
 	virtual void setup();       // SliderSOCD Button Setup
     virtual void reinit();
     virtual void preprocess() {}
 	virtual void process();     // SliderSOCD process
-    virtual std::string name() { return SliderSOCDName; }
+    virtual uint8_t getHooks() { return ADDON_HOOK_PROCESS | ADDON_HOOK_REINIT; }
+    static constexpr AddonId ID = ADDON_ID_SLIDER_SOCD;
 private:
     SOCDMode read();
 
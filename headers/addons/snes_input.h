@@ -9,13 +9,14 @@
 #include "storagemanager.h"
 #include "SNESpad.h"
 
-// SNESpad Module Name
-#define SNESpadName "SNESpad"
-
 #ifndef SNES_PAD_ENABLED
 #define SNES_PAD_ENABLED 0
 #endif
 
+#ifndef SNES_PAD_POLL_US
+#define SNES_PAD_POLL_US 1000
+#endif
+
 #ifndef SNES_PAD_LATCH_PIN
 #define SNES_PAD_LATCH_PIN -1
 #endif
@@ -30,15 +31,16 @@
 
 class SNESpadInput : public GPAddon {
 public:
-	virtual bool available();
+	static bool isEnabled();
 	virtual void setup();       // SNESpad Setup
 	virtual void process();     // SNESpad Process
 	virtual void preprocess() {}
-	virtual std::string name() { return SNESpadName; }
+	virtual uint8_t getHooks() { return ADDON_HOOK_PROCESS; }
+	virtual void poll();        // SNESpad Read
+	virtual AddonSchedule getSchedule() { return { SNES_PAD_POLL_US, ADDON_PRIORITY_HIGH }; }
+	static constexpr AddonId ID = ADDON_ID_SNES_PAD;
 private:
     SNESpad * snes;
-    uint32_t uIntervalMS;
-    uint32_t nextTimer;
 
     bool buttonA = false;
     bool buttonB = false;
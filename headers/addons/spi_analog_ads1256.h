@@ -29,16 +29,27 @@
 #define SPI_ANALOG1256_SPEED 5000000
 #endif
 
-// Analog Module Name
-#define SPIAnalog1256Name "SPIAnalogADS1256"
+// Default period of the channel reads. A read of all channels takes ~35 us per channel at 30000 SPS, too long
+// to sit between the GPIO sample and the report every pass, so it runs as a poll after the report instead:
+// a stick value reaches the host up to one period plus one pass after its conversion.
+#ifndef SPI_ANALOG1256_POLL_US
+#define SPI_ANALOG1256_POLL_US 1000
+#endif
+
+// Bounds for the configured period, a read of all six channels has to fit with room for the rest of the loop
+#define SPI_ANALOG1256_MIN_POLL_US 250
+#define SPI_ANALOG1256_MAX_POLL_US 100000
 
 class SPIAnalog1256Input : public GPAddon {
 public:
-	virtual bool available();
+	static bool isEnabled();
 	virtual void setup();       // Analog Setup
 	virtual void preprocess() {}
 	virtual void process();     // Analog Process
-    virtual std::string name() { return SPIAnalog1256Name; }
+	virtual uint8_t getHooks() { return ADDON_HOOK_PROCESS; }
+	virtual void poll();        // ADS1256 Read
+	virtual AddonSchedule getSchedule() { return { pollPeriodUs, ADDON_PRIORITY_NORMAL }; }
+    static constexpr AddonId ID = ADDON_ID_SPI_ANALOG_1256;
 private:
     uint8_t convert24to8bit(float voltage);
     uint16_t convert24to16bit(float voltage);
@@ -47,6 +58,7 @@ private:
     float values[ADS1256_CHANNEL_COUNT]; // Cache for latest read values
     bool enableTriggers;
     uint8_t readChannelCount; // Number of channels to read from the ADC
+    uint32_t pollPeriodUs = SPI_ANALOG1256_POLL_US;
     float analogMax = ADS1256_MAX_3V;
 };
 
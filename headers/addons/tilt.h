@@ -85,16 +85,14 @@
 #define TILT_SOCD_MODE SOCD_MODE_NEUTRAL
 #endif
 
-// Tilt Module Name
-#define TiltName "Tilt"
-
 class TiltInput : public GPAddon {
 public:
-	virtual bool available();
+	static bool isEnabled();
 	virtual void setup();       // Tilt Setup
 	virtual void process();     // Tilt Process
 	virtual void preprocess();  // Tilt Pre-Process (Cheat)
-	virtual std::string name() { return TiltName; }
+	virtual uint8_t getHooks() { return ADDON_HOOK_PREPROCESS | ADDON_HOOK_PROCESS; }
+	static constexpr AddonId ID = ADDON_ID_TILT;
 private:
 	void SOCDTiltClean(SOCDMode);
 	uint8_t SOCDCombine(SOCDMode, uint8_t);
@@ -105,10 +103,8 @@ private:
 	uint8_t tiltRightState;          // Tilt Right Analog State
 	DpadDirection lastGPUD; // Gamepad Last Up-Down
 	DpadDirection lastGPLR; // Gamepad Last Left-Right
-	DpadDirection leftLastTiltUD; // Tilt Last Up-Down
-	DpadDirection leftLastTiltLR; // Gamepad Last Left-Right
-	DpadDirection rightLastTiltUD; // Tilt Last Up-Down
-	DpadDirection rightLastTiltLR; // Gamepad Last Left-Right
+	DpadResolver leftTiltResolver; // Tilt Left SOCD history
+	DpadResolver rightTiltResolver; // Tilt Right SOCD history
 	uint32_t dpadTime[4];
 	uint8_t tilt1FactorLeftX;
     uint8_t tilt1FactorLeftY;
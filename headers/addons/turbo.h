@@ -96,17 +96,15 @@
 #define PIN_SHMUP_DIAL -1
 #endif
 
-// Turbo Module Name
-#define TurboName "Turbo"
-
 class TurboInput : public GPAddon {
 public:
-    virtual bool available();
+    static bool isEnabled();
     virtual void setup();       // TURBO Button Setup
     virtual void reinit();
     virtual void preprocess() {}
     virtual void process();     // TURBO Setting of buttons (Enable/Disable)
-    virtual std::string name() { return TurboName; }
+    virtual uint8_t getHooks() { return ADDON_HOOK_PROCESS | ADDON_HOOK_REINIT; }
+    static constexpr AddonId ID = ADDON_ID_TURBO;
 
     void handleEncoder(GPEvent* e);
 private:
@@ -131,7 +129,7 @@ private:
     uint16_t dialValue;         // Turbo Dial Value (Raw)
     uint16_t incrementValue;    // Turbo Dial Increment Value
     uint8_t shmupBtnPin[4];     // Turbo SHMUP Non-Turbo Pins
-    uint16_t shmupBtnPinMask[4];// Cache for shmup button pin masks
+    Mask_t shmupBtnPinMask[4];  // Cache for shmup button pin masks
     uint16_t shmupBtnMask[4];   // Turbo SHMUP Non-Turbo Button Masks
     uint16_t lastButtons;       // Last buttons (for Turbo Reset on Release)
     bool hasLedPin;             // Flag for LED pin presence
@@ -15,13 +15,14 @@
 #include "peripheralmanager.h"
 #include "wiiextension_dev.h"
 
-// WiiExtension Module Name
-#define WiiExtensionName "WiiExtension"
-
 #ifndef WII_EXTENSION_ENABLED
 #define WII_EXTENSION_ENABLED 0
 #endif
 
+#ifndef WII_EXTENSION_POLL_US
+#define WII_EXTENSION_POLL_US 1000
+#endif
+
 #ifndef WII_EXTENSION_I2C_SDA_PIN
 #define WII_EXTENSION_I2C_SDA_PIN -1
 #endif
@@ -80,15 +81,17 @@ typedef struct {
 
 class WiiExtensionInput : public GPAddon {
 public:
+    static bool isEnabled();
     virtual bool available();
     virtual void setup();       // WiiExtension Setup
     virtual void process();     // WiiExtension Process
     virtual void preprocess() {}
-    virtual std::string name() { return WiiExtensionName; }
+    virtual uint8_t getHooks() { return ADDON_HOOK_PROCESS; }
+    virtual void poll();        // WiiExtension Read
+    virtual AddonSchedule getSchedule() { return { WII_EXTENSION_POLL_US, ADDON_PRIORITY_HIGH }; }
+    static constexpr AddonId ID = ADDON_ID_WII_EXTENSION;
 private:
     WiiExtensionDevice * wii;
-    uint32_t uIntervalMS;
-    uint32_t nextTimer;
 
     // controller ID = config
     // defaults if no defined config
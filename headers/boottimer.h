@@ -0,0 +1,67 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#ifndef BOOTTIMER_H_
+#define BOOTTIMER_H_
+
+#include <cstdint>
+
+#include "BoardConfig.h"
+
+// With fast boot, core1 sets its add-ons up this long after reset when no host took a report by then
+#ifndef BOOT_DEFERRED_SETUP_TIMEOUT_MS
+#define BOOT_DEFERRED_SETUP_TIMEOUT_MS 1000
+#endif
+
+enum BootPhase : uint8_t {
+    BOOT_PHASE_RESET = 0,           // reset to main(): boot ROM, runtime init and static constructors
+    BOOT_PHASE_STORAGE,             // Storage::init, loading the config and migrating it
+    BOOT_PHASE_PERIPHERALS,         // I2C, SPI and USB host peripherals
+    BOOT_PHASE_GAMEPAD,             // Gamepad::setup, pin mappings and button GPIOs
+    BOOT_PHASE_ADDONS,              // core0 add-on setup()
+    BOOT_PHASE_BOOT_ACTION,         // reading the boot buttons
+    BOOT_PHASE_DRIVER,              // input driver setup, saving a changed input mode
+    BOOT_PHASE_CORE1,               // core0 waiting for core1 setup
+    BOOT_PHASE_FIRST_REPORT,        // TinyUSB init and enumeration, until the first report to a ready host
+    BOOT_PHASE_DEFERRED_ADDONS,     // core1 add-on setup() after the first report, fast boot only
+    BOOT_PHASE_COUNT
+};
+
+struct BootTimes {
+    uint32_t phaseUs[BOOT_PHASE_COUNT];     // time each phase took
+    uint32_t doneUs[BOOT_PHASE_COUNT];      // time since reset each phase ended at, 0 if it didn't run
+};
+
+/**
+ * @brief Times the steps from reset to the first USB report, the window the boot buttons are read in.
+ *
+ * Core0 marks the end of each phase of GP2040::setup, main() and GP2040::run in order, each mark records
+ * the time since the previous one. Fast boot moves core1's add-on setup behind the first report; core1
+ * records that phase on its own as it doesn't hold core0 up.
+ *
+ * The times of the last boot that got to its first report are kept in uninitialized RAM, so a reboot into
+ * web config can still show them.
+ */
+namespace BootTimer {
+    // Start timing this boot, first thing in main()
+    void start();
+    // Record the time since the previous mark (or start) against the phase, core0 only
+    void mark(BootPhase phase);
+    // Record a phase run off core0's path, from startUs until now
+    void record(BootPhase phase, uint32_t startUs);
+    // Core0 sent its first report to a ready host, marks BOOT_PHASE_FIRST_REPORT and keeps the times of this boot
+    void firstReport();
+    bool firstReportSent();
+    // Fast boot: the first report went out, or no host took one before BOOT_DEFERRED_SETUP_TIMEOUT_MS
+    bool deferredSetupDue();
+
+    // This boot so far
+    const BootTimes& getBootTimes();
+    // The last boot that got to its first report, nullptr if there is none
+    const BootTimes* getLastBootTimes();
+    const char* getPhaseName(BootPhase phase);
+}
+
+#endif
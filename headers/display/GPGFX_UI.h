@@ -20,6 +20,8 @@ class GPGFX_UI {
         GPGFX* getRenderer() { return _renderer; }
         Gamepad* getGamepad();
         Gamepad* getProcessedGamepad();
+        // Takes the processed state core0 published last for getProcessedGamepad, false when it is the one it already had
+        static bool refreshProcessedGamepad();
         DisplayOptions getDisplayOptions();
         uint16_t map(uint16_t x, uint16_t in_min, uint16_t in_max, uint16_t out_min, uint16_t out_max);
     private:
@@ -12,6 +12,8 @@ class GPScreen : public GPWidget {
         void clear();
         virtual void init() = 0;
         virtual void shutdown() = 0;
+        // false while nothing the screen shows moved, the display then skips update and draw for this pass
+        virtual bool needsRedraw(bool stateChanged) { return true; }
     protected:
         virtual void drawScreen() = 0;
         GPWidget * addElement(GPWidget* element) {
@@ -10,6 +10,7 @@
 #include <algorithm> 
 #include <cctype>
 #include <locale>
+#include "eventmanager.h"
 #include "layoutmanager.h"
 #include "GPGFX_UI_widgets.h"
 #include "GPGFX_UI_layouts.h"
@@ -17,6 +18,9 @@
 #define INPUT_HISTORY_MAX_INPUTS 22
 #define INPUT_HISTORY_MAX_MODES 11
 
+// How often the status bar is redrawn while the processed state stands still
+#define BUTTON_LAYOUT_STATUS_REFRESH_MS 250
+
 // Static to ensure memory is never doubled
 static const char * displayNames[INPUT_HISTORY_MAX_MODES][INPUT_HISTORY_MAX_INPUTS] = {
     {		// HID / DINPUT
@@ -105,6 +109,7 @@ class ButtonLayoutScreen : public GPScreen {
         virtual int8_t update();
         virtual void init();
         virtual void shutdown();
+        virtual bool needsRedraw(bool stateChanged);
 
         void handleProfileChange(GPEvent* e);
         void handleUSB(GPEvent* e);
@@ -139,6 +144,10 @@ class ButtonLayoutScreen : public GPScreen {
 
         Gamepad* gamepad;
         InputMode inputMode;
+
+        EventHandlerToken profileChangeHandler;
+        EventHandlerToken usbMountHandler;
+        EventHandlerToken usbUnmountHandler;
         std::string statusBar;
         std::string footer;
 
@@ -154,6 +163,7 @@ class ButtonLayoutScreen : public GPScreen {
         uint8_t bannerDelay = 2;
         int bannerDelayStart = 0;
         std::string bannerMessage;
+        uint32_t lastRedraw = 0;
         uint16_t prevButtonState = 0;
         uint8_t prevLayoutLeft = 0;
         uint8_t prevLayoutRight = 0;
@@ -12,7 +12,10 @@ class StatsScreen : public GPScreen {
         virtual void shutdown();
     protected:
         virtual void drawScreen();
+        void drawBootTimes(uint8_t firstPhase);
+        void drawLoopProfile(uint8_t firstStage);
         uint16_t prevButtonState = 0;
+        uint8_t page = 0;
 };
 
 #endif
\ No newline at end of file
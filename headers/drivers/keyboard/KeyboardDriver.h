@@ -36,6 +36,7 @@ private:
     uint16_t last_report_size;
     KeyboardReport keyboardReport;
     int8_t volumeChange;
+    EventHandlerToken encoderHandler;
 };
 
 #endif // _KEYBOARD_DRIVER_H_
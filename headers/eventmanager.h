@@ -8,11 +8,12 @@
 #include <array>
 #include <functional>
 #include <cctype>
+#include <cstddef>
 #include "config.pb.h"
 #include "enums.pb.h"
 
 #include "GPEvent.h"
-#include "GPGamepadEvent.h"
+#include "GPInputFrameEvent.h"
 #include "GPEncoderEvent.h"
 #include "GPMenuNavigateEvent.h"
 #include "GPProfileEvent.h"
@@ -21,12 +22,54 @@
 #include "GPSystemRebootEvent.h"
 #include "GPUSBHostEvent.h"
 
+#include "spscqueue.h"
+
 #define EVENTMGR EventManager::getInstance()
 
+// Handlers one event type can have registered on each core at a time, slots of unregistered handlers are reused
+#define EVENTMGR_MAX_HANDLERS 8
+
+// Events one core can have waiting for the other, more are dropped
+#ifndef EVENTMGR_QUEUE_SIZE
+#define EVENTMGR_QUEUE_SIZE 16
+#endif
+
+// Room for a copy of the largest event
+#define EVENTMGR_QUEUED_EVENT_SIZE sizeof(GPInputFrameEvent)
+
+#define EVENTMGR_CORES 2
+
+/**
+ * @brief Registration of an event handler, the handler is unregistered when the token is destroyed or released.
+ *
+ * Whoever registers a handler keeps the token for as long as the handler may be called, usually as a member
+ * next to the state the handler uses, so an object can't be called into after it is gone.
+ */
+class EventHandlerToken {
+    public:
+        EventHandlerToken() {}
+        EventHandlerToken(uint8_t core, GPEventType eventType, uint8_t slot, uint16_t generation) :
+            core(core), eventType(eventType), slot(slot), generation(generation) {}
+        EventHandlerToken(EventHandlerToken&& other) { *this = std::move(other); }
+        EventHandlerToken& operator=(EventHandlerToken&& other);
+        ~EventHandlerToken() { release(); }
+
+        EventHandlerToken(EventHandlerToken const&) = delete;
+        void operator=(EventHandlerToken const&) = delete;
+
+        // Unregister the handler now, does nothing if it already is
+        void release();
+        bool isRegistered() const { return slot != EVENTMGR_MAX_HANDLERS; }
+    private:
+        uint8_t core = 0;
+        GPEventType eventType = GP_EVENT_BASE;
+        uint8_t slot = EVENTMGR_MAX_HANDLERS;
+        uint16_t generation = 0;
+};
+
 class EventManager {
     public:
         typedef std::function<void(GPEvent* event)> EventFunction;
-        typedef std::pair<GPEventType, std::vector<EventFunction>> EventEntry;
 
         EventManager(EventManager const&) = delete;
         void operator=(EventManager const&)  = delete;
@@ -39,12 +82,60 @@ class EventManager {
         void init();
         void clearEventHandlers();
 
-        void registerEventHandler(GPEventType eventType, EventFunction handler);
-        void triggerEvent(GPEvent* event);
+        // The handler stays registered while the returned token lives. The token is not registered when all
+        // EVENTMGR_MAX_HANDLERS slots of the event type are taken. A handler with a mask is skipped for events
+        // whose eventMask shares no bit with it.
+        //
+        // Handlers are called on the core they were registered from and tokens are released there too. Each core
+        // has a table of its own, registering on one never touches what the other one dispatches from.
+        [[nodiscard]] EventHandlerToken registerEventHandler(GPEventType eventType, EventFunction handler, uint32_t mask = GPEVENT_MASK_ALL);
+        void unregisterEventHandler(uint8_t core, GPEventType eventType, uint8_t slot, uint16_t generation);
+
+        // Events are built by the caller, usually as a temporary, and only live for the call: handlers must not
+        // keep the pointer they get. Nothing is allocated on the way.
+        //
+        // Handlers on this core run right away. If the other core has handlers for the event a copy is queued
+        // for it without waiting, it runs them the next time it calls processQueuedEvents.
+        void triggerEvent(GPEvent& event);
+        void triggerEvent(GPEvent&& event) { triggerEvent(event); }
+
+        // Run the handlers of this core for the events the other core queued, each core calls this once a loop
+        void processQueuedEvents();
+
+        // Registered handlers of an event type, for the memory report
+        uint8_t getHandlerCount(GPEventType eventType) const;
+        // Events for a core that found its queue full
+        uint32_t getDroppedEvents(uint8_t core) const { return droppedEvents[core]; }
     private:
         EventManager(){}
 
-        std::vector<std::pair<GPEventType, std::vector<EventFunction>>> eventList;
+        void dispatch(GPEvent& event, uint8_t core);
+        void queueEvent(GPEvent& event, uint8_t core);
+        void releaseSlot(uint8_t core, GPEventType eventType, uint8_t slot);
+
+        // The handlers one core registered for an event type, only the other core's triggerEvent reads count
+        struct EventHandlers {
+            EventFunction handlers[EVENTMGR_MAX_HANDLERS];
+            uint32_t masks[EVENTMGR_MAX_HANDLERS] = { };
+            uint16_t generations[EVENTMGR_MAX_HANDLERS] = { };
+            volatile uint8_t count = 0;
+            uint8_t released = 0;                   // slots unregistered while their event type was being dispatched
+        };
+
+        // A copy of an event on its way to the other core
+        struct QueuedEvent {
+            alignas(alignof(std::max_align_t)) uint8_t storage[EVENTMGR_QUEUED_EVENT_SIZE];
+        };
+
+        // handlers of each core indexed by event type
+        std::array<EventHandlers, _GPEventType_ARRAYSIZE> eventHandlers[EVENTMGR_CORES];
+        // a handler can unregister handlers (its own included) while it runs, their slots are only freed once
+        // the outermost dispatch of their core returns
+        uint8_t dispatchDepth[EVENTMGR_CORES] = { };
+        bool hasReleased[EVENTMGR_CORES] = { };
+        // events for each core, from the other one
+        SPSCQueue<QueuedEvent, EVENTMGR_QUEUE_SIZE> queues[EVENTMGR_CORES];
+        uint32_t droppedEvents[EVENTMGR_CORES] = { };
 };
 
-#endif
\ No newline at end of file
+#endif
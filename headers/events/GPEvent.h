@@ -3,12 +3,17 @@
 
 #define GPEVENT_CALLBACK(x) ([this](GPEvent* event){x;})
 
+// Handlers registered without a mask get every event of their type
+#define GPEVENT_MASK_ALL 0xFFFFFFFF
+
 class GPEvent {
     public:
         GPEvent() {}
-        ~GPEvent() {}
+        virtual ~GPEvent() {}
 
         virtual GPEventType eventType() { return this->_eventType; }
+        // What this event is about, only handlers whose mask shares a bit with it are called
+        virtual uint32_t eventMask() { return GPEVENT_MASK_ALL; }
     private:
         GPEventType _eventType = GP_EVENT_BASE;
 };
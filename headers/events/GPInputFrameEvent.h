@@ -0,0 +1,98 @@
+#ifndef _GPINPUTFRAMEEVENT_H_
+#define _GPINPUTFRAMEEVENT_H_
+
+#include "gamepad.h"
+
+// What changed in a pass, the event mask of GPInputFrameEvent: handlers registered with a mask only run when
+// one of its bits changed
+#define INPUT_FRAME_RAW_PRESSED         (1 << 0)
+#define INPUT_FRAME_RAW_RELEASED        (1 << 1)
+#define INPUT_FRAME_PROCESSED_PRESSED   (1 << 2)
+#define INPUT_FRAME_PROCESSED_RELEASED  (1 << 3)
+#define INPUT_FRAME_ANALOG_MOVED        (1 << 4)
+
+#define INPUT_FRAME_RAW                 (INPUT_FRAME_RAW_PRESSED | INPUT_FRAME_RAW_RELEASED)
+#define INPUT_FRAME_PROCESSED           (INPUT_FRAME_PROCESSED_PRESSED | INPUT_FRAME_PROCESSED_RELEASED | INPUT_FRAME_ANALOG_MOVED)
+
+struct GPInputMasks {
+    uint8_t dpad = 0;
+    uint32_t buttons = 0;
+    uint16_t aux = 0;
+
+    bool any() const { return (dpad | buttons | aux) != 0; }
+};
+
+struct GPAnalogDeltas {
+    int32_t lx = 0;
+    int32_t ly = 0;
+    int32_t rx = 0;
+    int32_t ry = 0;
+    int16_t lt = 0;
+    int16_t rt = 0;
+
+    bool any() const { return (lx | ly | rx | ry | lt | rt) != 0; }
+};
+
+/**
+ * @brief Everything the inputs did in one pass of the core0 loop, in one event.
+ *
+ * Raw masks compare the state Gamepad::read returned with the one of the last pass, processed masks and analog
+ * deltas compare the state the driver sent with the last one sent. GP2040::run dispatches it once the report is
+ * queued, so handlers never run between sampling the inputs and sending them.
+ */
+class GPInputFrameEvent : public GPEvent {
+    public:
+        GPInputFrameEvent() {}
+        ~GPInputFrameEvent() {}
+
+        void setRaw(const GamepadState& prevState, const GamepadState& currState) {
+            rawPressed.dpad = currState.dpad & ~prevState.dpad;
+            rawPressed.buttons = currState.buttons & ~prevState.buttons;
+            rawPressed.aux = currState.aux & ~prevState.aux;
+            rawReleased.dpad = prevState.dpad & ~currState.dpad;
+            rawReleased.buttons = prevState.buttons & ~currState.buttons;
+            rawReleased.aux = prevState.aux & ~currState.aux;
+
+            changes &= ~INPUT_FRAME_RAW;
+            if (rawPressed.any()) changes |= INPUT_FRAME_RAW_PRESSED;
+            if (rawReleased.any()) changes |= INPUT_FRAME_RAW_RELEASED;
+        }
+
+        void setProcessed(const GamepadState& prevState, const GamepadState& currState) {
+            processedPressed.dpad = currState.dpad & ~prevState.dpad;
+            processedPressed.buttons = currState.buttons & ~prevState.buttons;
+            processedPressed.aux = currState.aux & ~prevState.aux;
+            processedReleased.dpad = prevState.dpad & ~currState.dpad;
+            processedReleased.buttons = prevState.buttons & ~currState.buttons;
+            processedReleased.aux = prevState.aux & ~currState.aux;
+
+            analogDeltas.lx = (int32_t)currState.lx - prevState.lx;
+            analogDeltas.ly = (int32_t)currState.ly - prevState.ly;
+            analogDeltas.rx = (int32_t)currState.rx - prevState.rx;
+            analogDeltas.ry = (int32_t)currState.ry - prevState.ry;
+            analogDeltas.lt = (int16_t)currState.lt - prevState.lt;
+            analogDeltas.rt = (int16_t)currState.rt - prevState.rt;
+
+            state = currState;
+
+            changes &= ~INPUT_FRAME_PROCESSED;
+            if (processedPressed.any()) changes |= INPUT_FRAME_PROCESSED_PRESSED;
+            if (processedReleased.any()) changes |= INPUT_FRAME_PROCESSED_RELEASED;
+            if (analogDeltas.any()) changes |= INPUT_FRAME_ANALOG_MOVED;
+        }
+
+        GPInputMasks rawPressed;
+        GPInputMasks rawReleased;
+        GPInputMasks processedPressed;
+        GPInputMasks processedReleased;
+        GPAnalogDeltas analogDeltas;
+        GamepadState state;     // processed state of this pass
+        uint32_t changes = 0;   // INPUT_FRAME_* bits
+
+        GPEventType eventType() { return this->_eventType; }
+        uint32_t eventMask() { return this->changes; }
+    private:
+        GPEventType _eventType = GP_EVENT_INPUT_FRAME;
+};
+
+#endif
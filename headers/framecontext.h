@@ -0,0 +1,61 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#ifndef FRAMECONTEXT_H_
+#define FRAMECONTEXT_H_
+
+#include <stdint.h>
+
+#include "enums.pb.h"
+#include "types.h"
+
+/**
+ * @brief Values that stay the same for a whole pass of the core0 loop.
+ *
+ * GP2040::run captures them once at the top of every pass, before debouncing, and every stage of the pipeline
+ * (read, add-ons, process, driver) reads them from here instead of asking the driver, the clock and storage
+ * again. Every stage of a pass sees the same time, so time-based add-ons (turbo, macros) step consistently.
+ *
+ * The GPIO snapshots are the only view of the pins a pass gets: add-ons read rawGpio instead of sampling pins
+ * themselves, so a pin changing in the middle of a pass can't be seen by one stage and missed by another.
+ *
+ * Only core0 captures the context. Core1 add-ons keep using the clock and the driver directly.
+ */
+class FrameContext {
+public:
+	FrameContext(FrameContext const&) = delete;
+	void operator=(FrameContext const&) = delete;
+
+	static inline const FrameContext& current() { return context; }
+
+	// Start a new pass: time, joystick midpoint of the active driver, options
+	static void capture();
+	// GPIO of this pass, set once it is debounced
+	static void captureGpio(Mask_t raw, Mask_t debounced);
+	// Options changed in the middle of the pass (hotkeys), resolve them again
+	static void refreshOptions();
+
+	// Add-on pins outside the profile's pin mappings to debounce along with the buttons, add-ons call this from setup
+	static void addDebounceGpios(Mask_t pins, DebounceMode mode);
+	static inline Mask_t getAddonGpios() { return addonGpios; }
+	static inline Mask_t getAddonEagerGpios() { return addonEagerGpios; }
+
+	uint32_t frame;       // passes captured since boot
+	uint64_t micros;      // time the pass started
+	uint32_t millis;
+	uint16_t joystickMid; // GetJoystickMidValue of the active driver
+	SOCDMode socdMode;    // Gamepad::resolveSOCDMode of the current options
+	uint32_t profileNumber;
+	Mask_t rawGpio;       // all GPIO, bitwise NOTed like the debounced mask
+	Mask_t debouncedGpio; // button and add-on GPIO after debouncing
+private:
+	FrameContext();
+
+	static FrameContext context;
+	static Mask_t addonGpios;
+	static Mask_t addonEagerGpios;
+};
+
+#endif
@@ -0,0 +1,61 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#ifndef FRAMESCHEDULER_H_
+#define FRAMESCHEDULER_H_
+
+#include <stdint.h>
+
+// Full speed USB frame length, the host sends a SOF every frame
+#define FRAME_SCHEDULER_FRAME_US 1000
+
+// Bounds for the configured lead, the lead must leave room to sleep in every frame
+#define FRAME_SCHEDULER_MIN_LEAD_US 50
+#define FRAME_SCHEDULER_MAX_LEAD_US 900
+
+/**
+ * @brief Late-latch scheduling of the core0 loop against the USB SOF.
+ *
+ * Instead of free running, the loop sleeps until lead us before the next expected SOF, then samples the
+ * inputs, runs the pipeline and arms the report, so the host's IN poll at the start of the next frame picks
+ * up a report that is at most lead us old.
+ *
+ * After arming, the loop waits for the SOF itself (the frame number changing) and uses its time as the
+ * phase for the next frame. A missed or late SOF (pipeline longer than the lead, bus suspended) unlocks
+ * the scheduler and the next sync looks for a SOF over a whole frame.
+ *
+ * The timing logic (latchTime, sofObserved, unlock) is separate from the hardware access (waitForLatch,
+ * syncToFrame) so it can be driven with simulated times.
+ */
+class FrameScheduler {
+public:
+	FrameScheduler();
+
+	void setLead(uint32_t leadUs);
+	uint32_t getLead() const { return lead; }
+	bool isLocked() const { return locked; }
+
+	// Time (in us) the next frame's inputs should be sampled at, only valid while locked
+	uint32_t latchTime() const { return lastSof + FRAME_SCHEDULER_FRAME_US - lead; }
+	// A SOF was seen at now
+	void sofObserved(uint32_t now);
+	// The SOF phase is no longer known
+	void unlock() { locked = false; }
+	// Number of frames whose pipeline ran past the SOF
+	uint32_t getOverruns() const { return overruns; }
+
+	// Sleep until latchTime(), returns right away when unlocked
+	void waitForLatch();
+	// Wait for the SOF following this latch and lock onto it
+	void syncToFrame();
+private:
+	uint32_t lead;
+	uint32_t lastSof;
+	uint32_t overruns;
+	uint16_t latchFrame;
+	bool locked;
+};
+
+#endif
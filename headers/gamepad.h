@@ -9,6 +9,7 @@
 #include "enums.pb.h"
 #include "gamepad/GamepadState.h"
 #include "gamepad/GamepadAuxState.h"
+#include "gamepad/GamepadMapping.h"
 
 #include "pico/stdlib.h"
 
@@ -29,6 +30,9 @@ struct GamepadButtonMapping
 	const uint32_t buttonMask;
 };
 
+// Number of GamepadButtonMapping members below, mapDpadUp through map48WayMode
+#define GAMEPAD_BUTTON_MAPPING_COUNT 49
+
 class Gamepad {
 public:
 	Gamepad();
@@ -191,7 +195,7 @@ public:
 	GamepadButtonMapping *map48WayMode;
 
 	// gamepad specific proxy of debounced buttons --- 1 = active (inverse of the raw GPIO)
-	// see GP2040::debounceGpioGetAll for details
+	// see GpioInput::debounceGpioGetAll for details
 	Mask_t debouncedGpio;
 
 	bool userRequestedReinit = false;
@@ -215,9 +219,14 @@ private:
 	GamepadOptions & options;
 	DpadMode activeDpadMode;
 	bool map48WayModeToggle;
+	DpadResolver dpadResolver;
 	const HotkeyOptions & hotkeyOptions;
 
 	GamepadHotkey lastAction = HOTKEY_NONE;
+
+	// storage behind the map* members, and what read() resolves them with
+	GamepadButtonMapping buttonMappings[GAMEPAD_BUTTON_MAPPING_COUNT];
+	GamepadMappingPlan * mappingPlan = nullptr;
 };
 
 #endif
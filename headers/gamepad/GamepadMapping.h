@@ -0,0 +1,82 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+class Gamepad;
+
+// Inputs a mapping can drive besides buttons and dpad, see GamepadMappingEntry::flags
+#define GAMEPAD_MAPPING_FUNCTION       (1U << 0)
+#define GAMEPAD_MAPPING_DP_MODE_DP     (1U << 1)
+#define GAMEPAD_MAPPING_DP_MODE_LS     (1U << 2)
+#define GAMEPAD_MAPPING_DP_MODE_RS     (1U << 3)
+#define GAMEPAD_MAPPING_4_8_WAY_MODE   (1U << 4)
+#define GAMEPAD_MAPPING_LS_X_NEG       (1U << 5)
+#define GAMEPAD_MAPPING_LS_X_POS       (1U << 6)
+#define GAMEPAD_MAPPING_LS_Y_NEG       (1U << 7)
+#define GAMEPAD_MAPPING_LS_Y_POS       (1U << 8)
+#define GAMEPAD_MAPPING_RS_X_NEG       (1U << 9)
+#define GAMEPAD_MAPPING_RS_X_POS       (1U << 10)
+#define GAMEPAD_MAPPING_RS_Y_NEG       (1U << 11)
+#define GAMEPAD_MAPPING_RS_Y_POS       (1U << 12)
+
+// The debounced GPIO mask is looked up one byte at a time
+#define GAMEPAD_MAPPING_LUT_COUNT 4
+#define GAMEPAD_MAPPING_LUT_SIZE  256
+
+/**
+ * @brief What a set of pressed pins maps to. Entries for disjoint pin sets combine with a bitwise OR.
+ */
+struct GamepadMappingEntry
+{
+	uint32_t buttons;
+	uint16_t flags;
+	uint8_t dpad;
+	uint8_t reserved;
+};
+
+/**
+ * @brief Pin to state mapping of a profile, compiled into one lookup table per byte of the GPIO mask.
+ *
+ * Every pin maps to a fixed set of outputs, so the outputs of a GPIO mask are the OR of the outputs of each
+ * of its bytes. Gamepad::setup compiles its mappings once per profile, after which Gamepad::read resolves the
+ * whole mask with four table reads instead of testing each mapping.
+ */
+class GamepadMappingPlan
+{
+public:
+	GamepadMappingPlan();
+
+	void clear();
+
+	// Rebuild the tables from the pin masks of the gamepad's button mappings
+	void compile(const Gamepad & gamepad);
+
+	// Pressing any pin in pinMask sets these outputs
+	void addButtons(uint32_t pinMask, uint32_t buttonMask);
+	void addDpad(uint32_t pinMask, uint8_t dpadMask);
+	void addFlags(uint32_t pinMask, uint16_t flags);
+
+	inline GamepadMappingEntry __attribute__((always_inline)) lookup(uint32_t values) const {
+		const GamepadMappingEntry& b0 = luts[0][values & 0xFF];
+		const GamepadMappingEntry& b1 = luts[1][(values >> 8) & 0xFF];
+		const GamepadMappingEntry& b2 = luts[2][(values >> 16) & 0xFF];
+		const GamepadMappingEntry& b3 = luts[3][values >> 24];
+
+		GamepadMappingEntry entry;
+		entry.buttons = b0.buttons | b1.buttons | b2.buttons | b3.buttons;
+		entry.flags = b0.flags | b1.flags | b2.flags | b3.flags;
+		entry.dpad = b0.dpad | b1.dpad | b2.dpad | b3.dpad;
+		entry.reserved = 0;
+		return entry;
+	}
+
+private:
+	void add(uint32_t pinMask, const GamepadMappingEntry& outputs);
+
+	GamepadMappingEntry luts[GAMEPAD_MAPPING_LUT_COUNT][GAMEPAD_MAPPING_LUT_SIZE];
+};
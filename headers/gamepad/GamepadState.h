@@ -159,23 +159,41 @@ uint16_t dpadToAnalogY(uint8_t dpad);
 
 uint8_t getMaskFromDirection(DpadDirection direction);
 
-uint8_t updateDpad(uint8_t dpad, DpadDirection direction);
-
-/**
- * @brief Filter diagonals out of the dpad, making the device work as a 4-way lever.
- *
- * The most recent cardinal direction wins.
- *
- * @param dpad The GameState.dpad value.
- * @return uint8_t The new dpad value.
- */
-uint8_t filterToFourWayMode(uint8_t dpad);
-
 /**
- * @brief Run SOCD cleaning against a D-pad value.
+ * @brief Direction history of one d-pad, for the cleaning steps that depend on what was pressed before.
  *
- * @param mode The SOCD cleaning mode.
- * @param dpad The GamepadState.dpad value.
- * @return uint8_t The clean D-pad value.
+ * A plain value with no allocation, so every d-pad (the gamepad's, Dual Directional, each Tilt stick) owns one
+ * and keeps its own history. Both steps are table driven, the tables are built at compile time.
  */
-uint8_t runSOCDCleaner(SOCDMode mode, uint8_t dpad);
+class DpadResolver
+{
+public:
+	DpadResolver() { reset(); }
+
+	// Forget the history, as if nothing had been pressed
+	void reset();
+
+	/**
+	 * @brief Filter diagonals out of the dpad, making the device work as a 4-way lever.
+	 *
+	 * The most recent cardinal direction wins.
+	 *
+	 * @param dpad The GameState.dpad value.
+	 * @return uint8_t The new dpad value.
+	 */
+	uint8_t filterToFourWayMode(uint8_t dpad);
+
+	/**
+	 * @brief Run SOCD cleaning against a D-pad value.
+	 *
+	 * @param mode The SOCD cleaning mode.
+	 * @param dpad The GamepadState.dpad value.
+	 * @return uint8_t The clean D-pad value.
+	 */
+	uint8_t runSOCDCleaner(SOCDMode mode, uint8_t dpad);
+
+private:
+	uint8_t fourWayHistory;	// which directions are held, in press order
+	uint8_t lastUD;		// direction each axis last resolved to
+	uint8_t lastLR;
+};
@@ -13,6 +13,8 @@
 #include "addonmanager.h"
 #include "eventmanager.h"
 #include "gpdriver.h"
+#include "gpioinput.h"
+#include "framescheduler.h"
 
 #include "pico/types.h"
 
@@ -25,10 +27,10 @@ public:
 private:
     Gamepad snapshot;
     AddonManager addons;
-    // GPIO debouncer
-    void debounceGpioGetAll();
-    Mask_t buttonGpios;
-    uint32_t gpioDebounceTime[NUM_BANK0_GPIOS];
+    // button GPIOs and their debouncer
+    GpioInput gpioInput;
+    // SOF late-latch scheduling
+    FrameScheduler frameScheduler;
 
     struct RebootHotkeys {
         RebootHotkeys();
@@ -66,20 +68,13 @@ private:
     BootAction getBootAction();
     void getReinitGamepad(Gamepad * gamepad);
 
-    // GPIO manipulation for setup and profile reinit
-    void initializeStandardGpio();
-    void deinitializeStandardGpio();
-
-    // event handling checking
-    void checkRawState(GamepadState prevState, GamepadState currState);
-    void checkProcessedState(GamepadState prevState, GamepadState currState);
-
     // input mask, action
     std::map<uint32_t, int32_t> bootActions;
 
     bool saveRequested = false;
     bool saveSuccessful = false;
     void handleStorageSave(GPEvent* e);
+    EventHandlerToken storageSaveHandler;
 
     bool rebootRequested = false;
     void handleSystemReboot(GPEvent* e);
@@ -17,9 +17,12 @@ public:
     void run();             // loop core1
     bool ready(){ return isReady; }
 private:
+    void setupAddons();
+
     GPDriver * inputDriver;
     AddonManager addons;
     bool isReady;
+    bool deferredSetup;     // fast boot, add-ons are set up after the first report
 };
 
 #endif
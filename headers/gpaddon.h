@@ -6,15 +6,71 @@
 
 #include <string>
 
+// Add-ons AddonManager knows, core0 ones in the order GP2040::setup loads them, then the core1 ones
+enum AddonId : uint8_t {
+    ADDON_ID_KEYBOARD_HOST = 0,
+    ADDON_ID_GAMEPAD_USB_HOST,
+    ADDON_ID_ANALOG,
+    ADDON_ID_BOOTSEL_BUTTON,
+    ADDON_ID_DUAL_DIRECTIONAL,
+    ADDON_ID_FOCUS_MODE,
+    ADDON_ID_I2C_ANALOG_1219,
+    ADDON_ID_SPI_ANALOG_1256,
+    ADDON_ID_WII_EXTENSION,
+    ADDON_ID_SNES_PAD,
+    ADDON_ID_PLAYER_NUM,
+    ADDON_ID_SLIDER_SOCD,
+    ADDON_ID_TILT,
+    ADDON_ID_ROTARY_ENCODER,
+    ADDON_ID_PCF8575,
+    ADDON_ID_REVERSE,
+    ADDON_ID_TURBO,
+    ADDON_ID_INPUT_MACRO,
+    ADDON_ID_DISPLAY,
+    ADDON_ID_NEOPICO_LED,
+    ADDON_ID_PLAYER_LED,
+    ADDON_ID_BOARD_LED,
+    ADDON_ID_BUZZER_SPEAKER,
+    ADDON_ID_DRV8833_RUMBLE,
+    ADDON_ID_REACTIVE_LED,
+    ADDON_ID_COUNT,
+    ADDON_ID_NONE = ADDON_ID_COUNT, // loaded from a pointer, not one of the above
+};
+
+// Which due poll runs first when several are due in the same pass, higher first
+enum AddonPriority : uint8_t {
+    ADDON_PRIORITY_LOW = 0,
+    ADDON_PRIORITY_NORMAL,
+    ADDON_PRIORITY_HIGH,
+};
+
+// Per-pass hooks an add-on implements, AddonManager leaves the others out of its dispatch lists
+enum AddonHook : uint8_t {
+    ADDON_HOOK_PREPROCESS = (1 << 0),
+    ADDON_HOOK_PROCESS = (1 << 1),
+    ADDON_HOOK_REINIT = (1 << 2),
+};
+
+#define ADDON_HOOKS_ALL (ADDON_HOOK_PREPROCESS | ADDON_HOOK_PROCESS | ADDON_HOOK_REINIT)
+
+struct AddonSchedule {
+    uint32_t periodUs = 0;                          // 0: the add-on has no poll
+    AddonPriority priority = ADDON_PRIORITY_NORMAL;
+};
+
 class GPAddon
 {
 public:
     virtual ~GPAddon() { }
-    virtual bool available() = 0;
+    /**
+     * Hardware check once the add-on is constructed, e.g. whether its I2C device answers. Whether the
+     * config enables it at all is the add-on's static isEnabled(), AddonManager asks that before it
+     * constructs anything.
+     */
+    virtual bool available() { return true; }
     virtual void setup() = 0;
     virtual void process() = 0;
     virtual void preprocess() = 0;
-    virtual std::string name() = 0;
 
     /**
      * Reinitialize the addon --- only implement this if it makes sense to, e.g. if this
@@ -23,6 +79,21 @@ public:
      */
     virtual void reinit() { }
 
+    /**
+     * Which of preprocess(), process() and reinit() do anything, AddonManager only calls those. Add-ons
+     * that leave a hook empty say so here and skip the call every pass.
+     */
+    virtual uint8_t getHooks() { return ADDON_HOOKS_ALL; }
+
+    /**
+     * Peripheral reads that don't have to happen every pass, e.g. an I2C or SPI device. Add-ons that return a
+     * period here get poll() called by their AddonManager once it is due, after the pass sent its report and
+     * only while the pass has poll budget left. process() still runs every pass and applies what the last
+     * poll read, so a slow bus never holds up the GPIO inputs.
+     */
+    virtual AddonSchedule getSchedule() { return AddonSchedule(); }
+    virtual void poll() { }
+
     // For add-ons that require a USB-host listener, get listener
     virtual USBListener * getListener() { return listener; }
 
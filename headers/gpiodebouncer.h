@@ -0,0 +1,68 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#ifndef GPIODEBOUNCER_H_
+#define GPIODEBOUNCER_H_
+
+#include <stdint.h>
+
+#include "types.h"
+
+// Number of counter bit-planes; enough to count any supported debounce delay (in ms) past its threshold
+#define GPIO_DEBOUNCE_PLANES 32
+
+// Upper bound for the debounce delay, keeps the counter inside GPIO_DEBOUNCE_PLANES
+#define GPIO_DEBOUNCE_MAX_DELAY 0x3FFFFFFF
+
+/**
+ * @brief Bit-parallel (vertical counter) GPIO debouncer.
+ *
+ * Every GPIO gets a counter of the milliseconds elapsed since its debounced state last changed.
+ * The counters are stored bit-sliced: plane N holds bit N of all 32 counters, so advancing time
+ * and checking the threshold are a handful of word-wide AND/XOR operations instead of a loop over
+ * the pins.
+ *
+ * Standard pins may change their debounced state once their counter exceeds the debounce delay, after
+ * which the counter starts over. This matches the previous per-pin timestamp implementation exactly.
+ *
+ * Eager pins pass a press on the first sampled edge and defer the release instead: the counter starts
+ * when the pin is first seen released and the release is only accepted once the pin stayed released
+ * for longer than the debounce delay. Chatter while pressed therefore never reaches the debounced state.
+ */
+class GpioDebouncer {
+public:
+	GpioDebouncer();
+
+	/**
+	 * @brief Debounce a raw GPIO sample.
+	 *
+	 * @param debounced The current debounced state (1 = active).
+	 * @param raw The raw GPIO sample (1 = active).
+	 * @param watched The pins to debounce, other bits of debounced are left untouched.
+	 * @param eager The watched pins that use eager press/deferred release debouncing.
+	 * @param now The current time in ms.
+	 * @param delay The debounce delay in ms.
+	 * @return Mask_t The new debounced state.
+	 */
+	Mask_t debounce(Mask_t debounced, Mask_t raw, Mask_t watched, Mask_t eager, uint32_t now, uint32_t delay);
+
+	/**
+	 * @brief Eager pins with a deferred release in progress, these need debouncing even if raw matches debounced.
+	 */
+	Mask_t pendingReleases() const { return releasing; }
+private:
+	void setDelay(uint32_t delay);
+	void advance(uint32_t now);
+
+	Mask_t counter[GPIO_DEBOUNCE_PLANES];
+	Mask_t settled;         // pins whose counter passed the threshold and may change state
+	Mask_t releasing;       // eager pins that are debounced pressed but sampled released
+	uint32_t delay;
+	uint32_t threshold;     // delay + 1, the counter value at which a pin is settled
+	uint8_t planes;         // bit-planes in use for the current threshold
+	uint32_t lastMillis;
+};
+
+#endif
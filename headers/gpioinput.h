@@ -0,0 +1,32 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#ifndef GPIOINPUT_H_
+#define GPIOINPUT_H_
+
+#include "gpiodebouncer.h"
+#include "types.h"
+
+/**
+ * @brief The button GPIOs of the loaded profile on core0: setting them up and debouncing them every pass.
+ *
+ * Shared by GP2040 and the host simulator, so the simulator debounces with the firmware's code.
+ */
+class GpioInput {
+public:
+	GpioInput();
+
+	// GPIO manipulation for setup and profile reinit
+	void initializeStandardGpio();
+	void deinitializeStandardGpio();
+
+	void debounceGpioGetAll();
+private:
+	Mask_t buttonGpios;
+	Mask_t eagerDebounceGpios;
+	GpioDebouncer gpioDebouncer;
+};
+
+#endif
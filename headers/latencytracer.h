@@ -0,0 +1,88 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#ifndef LATENCYTRACER_H_
+#define LATENCYTRACER_H_
+
+#include <cstdint>
+
+#include "BoardConfig.h"
+#include "enums.pb.h"
+
+// Input-to-report latency tracing, off by default as it adds timer reads and a state compare per loop
+#ifndef LATENCY_TRACER_ENABLED
+#define LATENCY_TRACER_ENABLED 0
+#endif
+
+// bucket 0 counts 0us, bucket N counts [2^(N-1), 2^N) us, the last bucket also counts everything above
+#define LATENCY_TRACER_HISTOGRAM_BUCKETS 16
+
+// Input modes with their own stats, INPUT_MODE_CONFIG and anything above is not traced
+#define LATENCY_TRACER_INPUT_MODES (INPUT_MODE_GENERIC + 1)
+
+enum LatencyTracePoint : uint8_t {
+    LATENCY_POINT_QUEUED = 0,       // sample to the driver handing the changed report to TinyUSB
+    LATENCY_POINT_COMPLETED,        // sample to TinyUSB reporting the IN transfer as done
+    LATENCY_POINT_COUNT
+};
+
+struct LatencyStats {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t histogram[LATENCY_TRACER_HISTOGRAM_BUCKETS];
+};
+
+/**
+ * @brief Measures the time from the GPIO sample that changed the gamepad state to the USB report carrying it.
+ *
+ * The sample time of the first state change not yet sent is kept until the driver queues a report, which
+ * records the queued latency and moves the stamp in flight until the transfer completes. A driver that
+ * finds its report unchanged drops the stamp, the change didn't affect anything the host would see.
+ *
+ * The stats are kept in uninitialized RAM so they survive the reboot into web config, where they can be read.
+ * All times are passed in (in us) so the tracer can be driven by any clock.
+ */
+namespace LatencyTracer {
+    // Start tracing for the input mode, keeping stats from previous boots
+    void init(InputMode mode);
+    // The GPIOs are about to be sampled
+    void sample(uint32_t now);
+    // The processed gamepad state of this loop did (not) change
+    void stateChanged(bool changed);
+    // The driver handed a changed report to TinyUSB
+    void reportQueued(uint32_t now);
+    // The driver found its report unchanged and didn't send it
+    void reportUnchanged();
+    // TinyUSB completed an IN transfer
+    void reportCompleted(uint32_t now);
+    // Clear the stats of all input modes
+    void reset();
+
+    const LatencyStats& getStats(InputMode mode, LatencyTracePoint point);
+    // Average latency in us
+    uint32_t getAverage(InputMode mode, LatencyTracePoint point);
+}
+
+#if LATENCY_TRACER_ENABLED
+#include "hardware/timer.h"
+
+#define LATENCY_TRACE_INIT(mode)         LatencyTracer::init(mode)
+#define LATENCY_TRACE_SAMPLE()           LatencyTracer::sample(time_us_32())
+#define LATENCY_TRACE_STATE(changed)     LatencyTracer::stateChanged(changed)
+#define LATENCY_TRACE_QUEUED()           LatencyTracer::reportQueued(time_us_32())
+#define LATENCY_TRACE_UNCHANGED()        LatencyTracer::reportUnchanged()
+#define LATENCY_TRACE_COMPLETED()        LatencyTracer::reportCompleted(time_us_32())
+#else
+#define LATENCY_TRACE_INIT(mode)
+#define LATENCY_TRACE_SAMPLE()
+#define LATENCY_TRACE_STATE(changed)
+#define LATENCY_TRACE_QUEUED()
+#define LATENCY_TRACE_UNCHANGED()
+#define LATENCY_TRACE_COMPLETED()
+#endif
+
+#endif
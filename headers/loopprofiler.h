@@ -0,0 +1,81 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#ifndef LOOPPROFILER_H_
+#define LOOPPROFILER_H_
+
+#include <cstdint>
+
+#include "BoardConfig.h"
+
+// Per-stage timing of the core0 loop, off by default as it adds a timer read per stage
+#ifndef LOOP_PROFILER_ENABLED
+#define LOOP_PROFILER_ENABLED 0
+#endif
+
+// bucket 0 counts 0us, bucket N counts [2^(N-1), 2^N) us, the last bucket also counts everything above
+#define LOOP_PROFILER_HISTOGRAM_BUCKETS 16
+
+enum LoopProfileStage : uint8_t {
+    LOOP_STAGE_STORAGE = 0,         // gamepad reinit, events from core1 and enqueued saves
+    LOOP_STAGE_DEBOUNCE,
+    LOOP_STAGE_READ,
+    LOOP_STAGE_USB_HOST,
+    LOOP_STAGE_ADDON_PREPROCESS,
+    LOOP_STAGE_HOTKEYS,
+    LOOP_STAGE_PROCESS,
+    LOOP_STAGE_ADDON_PROCESS,       // (post) process add-ons and the copy for core1
+    LOOP_STAGE_DRIVER,
+    LOOP_STAGE_EVENTS,              // input frame event, once the report is queued
+    LOOP_STAGE_ADDON_USBREPORT,
+    LOOP_STAGE_TUD_TASK,
+    LOOP_STAGE_ADDON_POLL,          // due add-on polls, within ADDON_POLL_BUDGET_US
+    LOOP_STAGE_FLASH,               // a step of a pending save, within the flash stall budget
+    LOOP_STAGE_TOTAL,               // whole iteration, including anything not covered by a stage
+    LOOP_STAGE_COUNT
+};
+
+struct LoopProfileStats {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t histogram[LOOP_PROFILER_HISTOGRAM_BUCKETS];
+};
+
+namespace LoopProfiler {
+    // Start collecting for this boot, keeping the stats of the last boot that wasn't web config
+    void init(bool configMode);
+    // Start a loop iteration
+    void begin();
+    // Record the time since the previous mark (or begin) against the stage
+    void mark(LoopProfileStage stage);
+    // Finish a loop iteration, recording the whole iteration against LOOP_STAGE_TOTAL
+    void end();
+    // Clear all collected stats
+    void reset();
+
+    const LoopProfileStats& getStats(LoopProfileStage stage);
+    // Stats of the last boot that ran the gamepad rather than web config, if RAM kept them over the reboot
+    const LoopProfileStats* getGameplayStats(LoopProfileStage stage);
+    // Average stage time in us
+    uint32_t getAverage(LoopProfileStage stage);
+    uint32_t getAverage(const LoopProfileStats& stats);
+    const char* getStageName(LoopProfileStage stage);
+    // Short name for the stats screen
+    const char* getStageLabel(LoopProfileStage stage);
+}
+
+#if LOOP_PROFILER_ENABLED
+#define LOOP_PROFILE_BEGIN()        LoopProfiler::begin()
+#define LOOP_PROFILE_MARK(stage)    LoopProfiler::mark(stage)
+#define LOOP_PROFILE_END()          LoopProfiler::end()
+#else
+#define LOOP_PROFILE_BEGIN()
+#define LOOP_PROFILE_MARK(stage)
+#define LOOP_PROFILE_END()
+#endif
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#ifndef SEQLOCK_H_
+#define SEQLOCK_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+#include <type_traits>
+
+/**
+ * @brief Latest value of T, written by one side and read by any number of others without either one blocking.
+ *
+ * The value is double buffered: the writer makes the sequence odd, copies the new value into the buffer the
+ * last completed write did not use, and makes the sequence even again. A reader copies out the buffer of the
+ * last completed write, so a write under way does not hold it up at all; it only tries again when a second
+ * write reached the buffer it was copying, and it never returns a mix of two writes.
+ *
+ * Both buffers are kept as 32 bit words each read and written atomically, which keeps concurrent access
+ * defined behaviour. Every write bumps the sequence by two, so it doubles as a version: a reader that remembers
+ * the version it last read can tell whether there is anything new without copying the value.
+ */
+template <typename T>
+class SeqLock {
+	static_assert(std::is_trivially_copyable<T>::value, "SeqLock values are copied word by word");
+public:
+	SeqLock() {}
+	explicit SeqLock(const T& value) { write(value); }
+
+	// Writer only
+	void write(const T& value) {
+		uint32_t buffer[WORDS] = { };
+		memcpy(buffer, &value, sizeof(T));
+
+		uint32_t current = sequence.load(std::memory_order_relaxed);
+		std::atomic<uint32_t>* slot = words[((current >> 1) + 1) & 1];
+		sequence.store(current + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		for (uint32_t i = 0; i < WORDS; i++) {
+			slot[i].store(buffer[i], std::memory_order_relaxed);
+		}
+		sequence.store(current + 2, std::memory_order_release);
+	}
+
+	// Copy the latest value out, returns its version (0 before the first write)
+	uint32_t read(T& value) const {
+		uint32_t buffer[WORDS];
+		uint32_t current;
+		while (true) {
+			current = sequence.load(std::memory_order_acquire) & ~1u;
+			const std::atomic<uint32_t>* slot = words[(current >> 1) & 1];
+			for (uint32_t i = 0; i < WORDS; i++) {
+				buffer[i] = slot[i].load(std::memory_order_relaxed);
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			// the write after the next one is the first to reuse this buffer
+			if (sequence.load(std::memory_order_relaxed) - current <= 2) break;
+		}
+		memcpy(&value, buffer, sizeof(T));
+		return current;
+	}
+
+	T read() const {
+		T value;
+		read(value);
+		return value;
+	}
+
+	// Version of the last completed write, the one read returns
+	uint32_t version() const { return sequence.load(std::memory_order_acquire) & ~1u; }
+private:
+	static constexpr uint32_t WORDS = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+	std::atomic<uint32_t> sequence{0};
+	std::atomic<uint32_t> words[2][WORDS] = { };
+};
+
+#endif
@@ -0,0 +1,77 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#ifndef SPSCQUEUE_H_
+#define SPSCQUEUE_H_
+
+#include <stdint.h>
+
+#include <atomic>
+
+/**
+ * @brief Lock-free ring of N items between one producer and one consumer, usually one on each core.
+ *
+ * Only the producer calls push/reserve/publish and only the consumer calls pop/peek/consume. Neither side ever
+ * waits for the other: push fails when the ring is full and pop when it is empty. The head is only written by
+ * the producer and the tail only by the consumer, both with plain loads and stores, so nothing needs the
+ * exclusive load/store instructions the Cortex-M0+ doesn't have.
+ *
+ * Indices run freely and wrap at 2^32, N must be a power of two.
+ */
+template <typename T, uint32_t N>
+class SPSCQueue {
+	static_assert(N > 0 && (N & (N - 1)) == 0, "SPSCQueue size must be a power of two");
+public:
+	// Producer: copy item in, false when the ring is full
+	bool push(const T& item) {
+		T* slot = reserve();
+		if (slot == nullptr) return false;
+		*slot = item;
+		publish();
+		return true;
+	}
+
+	// Producer: slot to build the next item in, nullptr when the ring is full. publish makes it visible.
+	T* reserve() {
+		uint32_t current = head.load(std::memory_order_relaxed);
+		if (current - tail.load(std::memory_order_acquire) == N) return nullptr;
+		return &items[current & (N - 1)];
+	}
+
+	void publish() {
+		head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	// Consumer: copy the oldest item out, false when the ring is empty
+	bool pop(T& item) {
+		const T* slot = peek();
+		if (slot == nullptr) return false;
+		item = *slot;
+		consume();
+		return true;
+	}
+
+	// Consumer: oldest item in place, nullptr when the ring is empty. consume hands its slot back.
+	const T* peek() const {
+		uint32_t current = tail.load(std::memory_order_relaxed);
+		if (current == head.load(std::memory_order_acquire)) return nullptr;
+		return &items[current & (N - 1)];
+	}
+
+	void consume() {
+		tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	// Either side, only a snapshot while the other one keeps going
+	uint32_t size() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+	bool empty() const { return size() == 0; }
+	static constexpr uint32_t capacity() { return N; }
+private:
+	T items[N];
+	std::atomic<uint32_t> head{0}; // next slot the producer writes
+	std::atomic<uint32_t> tail{0}; // next slot the consumer reads
+};
+
+#endif
@@ -15,13 +15,19 @@
 #include "gamepad.h"
 
 #include "config.pb.h"
-#include <atomic>
-#include "pico/critical_section.h"
 #include "eventmanager.h"
+#include "seqlock.h"
 #include "GPStorageSaveEvent.h"
 
 #define SI Storage::getInstance()
 
+// Parts of the aux state a core1 add-on drives, core0 enables them for the drivers (Storage::requestProcessedAux)
+#define PROCESSED_AUX_PLAYER_ID      (1U << 0)
+#define PROCESSED_AUX_STATUS_LIGHT   (1U << 1)
+#define PROCESSED_AUX_LEFT_ACTUATOR  (1U << 2)
+#define PROCESSED_AUX_RIGHT_ACTUATOR (1U << 3)
+#define PROCESSED_AUX_PART_COUNT     4
+
 // Storage manager for board, LED options, and thread-safe settings
 class Storage {
 public:
@@ -67,6 +73,18 @@ public:
 	void SetProcessedGamepad(Gamepad *); // MPGS Processed Gamepad Get/Set
 	Gamepad * GetProcessedGamepad();
 
+	// Processed state core0 sent last, the other core reads it here instead of from the processed gamepad
+	void publishProcessedState(const GamepadState& state); // core0 only
+	uint32_t readProcessedState(GamepadState& state) const;
+	uint32_t getProcessedStateVersion() const { return processedState.version(); }
+
+	// Aux state of the processed gamepad (player LEDs, rumble, status light, turbo LED) is only touched by core0,
+	// the drivers and add-ons there write it and core0 publishes it after the driver ran; core1 reads it here
+	void requestProcessedAux(uint32_t parts); // any core, PROCESSED_AUX_* mask
+	void publishProcessedAuxState(GamepadAuxState& auxState); // core0 only, enables requested parts, publishes on a change
+	uint32_t readProcessedAuxState(GamepadAuxState& auxState) const;
+	uint32_t getProcessedAuxStateVersion() const { return processedAuxState.version(); }
+
 	bool setProfile(const uint32_t);		// profile support for multiple mappings
 	void nextProfile();
 	void previousProfile();
@@ -80,13 +98,19 @@ private:
 	bool CONFIG_MODE = false; 			// Config mode (boot)
 	Gamepad * gamepad = nullptr;    		// Gamepad data
 	Gamepad * processedGamepad = nullptr; // Gamepad with ONLY processed data
+	SeqLock<GamepadState> processedState;
+	SeqLock<GamepadAuxState> processedAuxState;
+	GamepadAuxState publishedAuxState; // core0 only, last aux state published
+	// a flag per PROCESSED_AUX_* part, only ever set, so a request is a plain store (no read-modify-write on the M0+)
+	std::atomic<uint8_t> processedAuxRequested[PROCESSED_AUX_PART_COUNT] = { };
+	uint32_t processedAuxEnabled = 0; // core0 only, parts already enabled
 	uint8_t featureData[32]; // USB X-Input Feature Data
 	DisplayOptions previewDisplayOptions;
 	Config config;
-	std::atomic<bool> animationOptionsSavePending;
-	critical_section_t animationOptionsCs;
+	// written by core1, core0 saves every version it hasn't saved yet
+	SeqLock<AnimationOptions> animationOptionsToSave;
+	uint32_t animationOptionsSavedVersion = 0;
 	uint32_t animationOptionsCrc = 0;
-	AnimationOptions animationOptionsToSave = {};
 	GpioMappingInfo functionalPinMappings[NUM_BANK0_GPIOS];
 };
 
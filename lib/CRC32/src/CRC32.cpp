@@ -6,6 +6,27 @@
 
 #include "CRC32.h"
 
+#define CRC32_ENGINE_NIBBLE 0
+#define CRC32_ENGINE_SLICE8 1
+#define CRC32_ENGINE_DMA    2
+
+#ifndef CRC32_ENGINE
+#define CRC32_ENGINE CRC32_ENGINE_SLICE8
+#endif
+
+#if CRC32_ENGINE == CRC32_ENGINE_DMA
+#include "hardware/dma.h"
+#include "hardware/sync.h"
+#include "pico/platform.h"
+#endif
+
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "CRC32 slice-by-8 reads the data a word at a time in little endian order"
+#endif
+
+#define CRC32_POLYNOMIAL 0xedb88320
+
+#if CRC32_ENGINE == CRC32_ENGINE_NIBBLE
 static const uint32_t crc32_table[] = {
 	0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac,
 	0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
@@ -13,6 +34,120 @@ static const uint32_t crc32_table[] = {
 	0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c
 };
 
+static uint32_t updateNibble(uint32_t state, const uint8_t *data, uint32_t size) {
+	// via http://forum.arduino.cc/index.php?topic=91179.0
+	for (uint32_t i = 0; i < size; i++) {
+		uint8_t tbl_idx = 0;
+
+		tbl_idx = state ^ (data[i] >> (0 * 4));
+		state = *(uint32_t *)(crc32_table + (tbl_idx & 0x0f)) ^ (state >> 4);
+		tbl_idx = state ^ (data[i] >> (1 * 4));
+		state = *(uint32_t *)(crc32_table + (tbl_idx & 0x0f)) ^ (state >> 4);
+	}
+	return state;
+}
+#else
+// Table n is the CRC of a byte followed by n zero bytes, eight of them fold in 8 bytes with one lookup each
+struct SliceTables {
+	uint32_t table[8][256];
+};
+
+static constexpr SliceTables makeSliceTables() {
+	SliceTables tables = {};
+	for (uint32_t i = 0; i < 256; i++) {
+		uint32_t crc = i;
+		for (uint32_t bit = 0; bit < 8; bit++)
+			crc = (crc >> 1) ^ (CRC32_POLYNOMIAL & (0 - (crc & 1)));
+		tables.table[0][i] = crc;
+	}
+	for (uint32_t slice = 1; slice < 8; slice++) {
+		for (uint32_t i = 0; i < 256; i++) {
+			const uint32_t crc = tables.table[slice - 1][i];
+			tables.table[slice][i] = (crc >> 8) ^ tables.table[0][crc & 0xff];
+		}
+	}
+	return tables;
+}
+
+static constexpr SliceTables sliceTables = makeSliceTables();
+
+static uint32_t updateSlice8(uint32_t state, const uint8_t *data, uint32_t size) {
+	const uint32_t (&table)[8][256] = sliceTables.table;
+
+	// up to a word boundary a byte at a time, the Cortex-M0+ can't load a word that isn't aligned
+	for (; size > 0 && ((uintptr_t)data & 3) != 0; size--)
+		state = table[0][(state ^ *data++) & 0xff] ^ (state >> 8);
+
+	const uint32_t *words = (const uint32_t *)data;
+	for (; size >= 8; size -= 8) {
+		const uint32_t low = *words++ ^ state;
+		const uint32_t high = *words++;
+		state = table[7][low & 0xff] ^ table[6][(low >> 8) & 0xff] ^ table[5][(low >> 16) & 0xff] ^ table[4][low >> 24] ^
+			table[3][high & 0xff] ^ table[2][(high >> 8) & 0xff] ^ table[1][(high >> 16) & 0xff] ^ table[0][high >> 24];
+	}
+
+	data = (const uint8_t *)words;
+	for (; size > 0; size--)
+		state = table[0][(state ^ *data++) & 0xff] ^ (state >> 8);
+	return state;
+}
+#endif
+
+#if CRC32_ENGINE == CRC32_ENGINE_DMA
+// Below this, setting up the channel takes longer than the tables do
+#define CRC32_DMA_MIN_SIZE 64
+
+static int dmaChannel = -1;
+static bool dmaBusy = false;
+static uint8_t dmaSink;
+
+static uint32_t reverseBits(uint32_t value) {
+	uint32_t reversed = 0;
+	for (uint32_t bit = 0; bit < 32; bit++, value >>= 1)
+		reversed = (reversed << 1) | (value & 1);
+	return reversed;
+}
+
+// The sniffer computes the CRC of what a channel reads into a sink byte. Fed bit reversed data with the seed and
+// result bit reversed as well, it computes the same checksum as the tables. There is only one sniffer, core1 and
+// a call that comes in while it's in use take the tables instead.
+static bool updateDma(uint32_t &state, const uint8_t *data, uint32_t size) {
+	if (size < CRC32_DMA_MIN_SIZE || get_core_num() != 0)
+		return false;
+
+	const uint32_t interrupts = save_and_disable_interrupts();
+	const bool available = !dmaBusy;
+	dmaBusy = true;
+	restore_interrupts(interrupts);
+	if (!available)
+		return false;
+
+	if (dmaChannel < 0)
+		dmaChannel = dma_claim_unused_channel(false);
+	if (dmaChannel < 0) {
+		dmaBusy = false;
+		return false;
+	}
+
+	dma_channel_config config = dma_channel_get_default_config(dmaChannel);
+	channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
+	channel_config_set_read_increment(&config, true);
+	channel_config_set_write_increment(&config, false);
+	channel_config_set_sniff_enable(&config, true);
+
+	dma_sniffer_enable(dmaChannel, DMA_SNIFF_CTRL_CALC_VALUE_CRC32R, true);
+	hw_set_bits(&dma_hw->sniff_ctrl, DMA_SNIFF_CTRL_OUT_REV_BITS);
+	dma_hw->sniff_data = reverseBits(state);
+	dma_channel_configure(dmaChannel, &config, &dmaSink, data, size, true);
+	dma_channel_wait_for_finish_blocking(dmaChannel);
+	state = dma_hw->sniff_data;
+	dma_sniffer_disable();
+
+	dmaBusy = false;
+	return true;
+}
+#endif
+
 CRC32::CRC32() {
 	reset();
 }
@@ -22,13 +157,19 @@ void CRC32::reset() {
 }
 
 void CRC32::update(const uint8_t &data) {
-	// via http://forum.arduino.cc/index.php?topic=91179.0
-	uint8_t tbl_idx = 0;
+	update(&data, 1);
+}
 
-	tbl_idx = _state ^ (data >> (0 * 4));
-	_state = *(uint32_t *)(crc32_table + (tbl_idx & 0x0f)) ^ (_state >> 4);
-	tbl_idx = _state ^ (data >> (1 * 4));
-	_state = *(uint32_t *)(crc32_table + (tbl_idx & 0x0f)) ^ (_state >> 4);
+void CRC32::update(const uint8_t *data, uint32_t size) {
+#if CRC32_ENGINE == CRC32_ENGINE_NIBBLE
+	_state = updateNibble(_state, data, size);
+#else
+#if CRC32_ENGINE == CRC32_ENGINE_DMA
+	if (updateDma(_state, data, size))
+		return;
+#endif
+	_state = updateSlice8(_state, data, size);
+#endif
 }
 
 uint32_t CRC32::finalize() const
@@ -9,6 +9,10 @@
 #include <stdint.h>
 
 /// \brief A class for calculating the CRC32 checksum from arbitrary data.
+///
+/// The engine is picked at build time with CRC32_ENGINE: the 16 entry nibble table (NIBBLE), eight 256 entry
+/// tables taking 8 bytes at a time (SLICE8, the default) or the RP2040 DMA sniffer (DMA). All of them compute the
+/// same checksum.
 /// \sa http://forum.arduino.cc/index.php?topic=91179.0
 class CRC32 {
 public:
@@ -22,6 +26,11 @@ public:
 	/// \param data The data to add to the checksum.
 	void update(const uint8_t &data);
 
+	/// \brief Update the current checksum caclulation with the given data.
+	/// \param data The bytes to add to the checksum.
+	/// \param size Number of bytes to add.
+	void update(const uint8_t *data, uint32_t size);
+
 	/// \brief Update the current checksum caclulation with the given data.
 	/// \tparam Type The data type to read.
 	/// \param data The data to add to the checksum.
@@ -36,13 +45,7 @@ public:
 	/// \param size Size of the array to add.
 	template <typename Type>
 	void update(const Type *data, uint16_t size) {
-		uint16_t nBytes = size * sizeof(Type);
-		const uint8_t *pData = (const uint8_t *)data;
-
-		for (uint16_t i = 0; i < nBytes; i++)
-		{
-			update(pData[i]);
-		}
+		update((const uint8_t *)data, (uint32_t)size * sizeof(Type));
 	}
 
 	/// \returns the caclulated checksum.
@@ -5,26 +5,460 @@
 
 #include "FlashPROM.h"
 
+#include <stddef.h>
+
+#include "CRC32.h"
+
+#define EEPROM_PAGES_PER_SECTOR (FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE)
+#define EEPROM_CHUNK_COUNT      (EEPROM_SIZE_BYTES / EEPROM_CHUNK_SIZE)
+
+#define NO_PAGE 0xffff
+
+// Data of a delta record, a run of changed bytes
+struct DeltaRun
+{
+	uint16_t offset;
+	uint16_t size;
+};
+
 uint8_t FlashPROM::writeCache[EEPROM_SIZE_BYTES];
-volatile static alarm_id_t flashWriteAlarm = 0;
 volatile static spin_lock_t *flashLock = nullptr;
 
-int64_t writeToFlash(alarm_id_t id, void *flashCache)
+static const uint8_t* const flashStart = reinterpret_cast<const uint8_t*>(EEPROM_ADDRESS_START);
+static const uint32_t flashOffset = (intptr_t)EEPROM_ADDRESS_START - (intptr_t)XIP_BASE;
+
+static uint32_t imageSize = 0;              // size of the cache as of the last commit
+static uint32_t savedSize = 0;              // size of the cache as of the last record
+static uint32_t sequence = 0;               // of the last record
+static uint16_t headPage = 0;               // where the next record goes, the rest of its sector is erased
+static uint16_t chainPage = 0;              // the full record the saved state starts from
+static uint16_t previousPage = 0;           // the full record of the generation before, kept up to chainPage
+static uint16_t chainDeltas = 0;            // deltas after it
+static bool hasChain = false;
+static bool hasPrevious = false;
+static bool eraseBlock = false;
+static uint32_t dirtyChunks[EEPROM_CHUNK_COUNT / 32];
+
+// Stats of this boot, the previous boot's are copied out on start
+struct FlashPROMStatsTable
+{
+	uint32_t magic;
+	uint32_t size;
+	FlashPROMStats stats;
+};
+
+#define EEPROM_STATS_MAGIC 0x46505331 // "FPS1"
+
+// not cleared on boot, a watchdog reboot into web config keeps the stats of the session before it
+static FlashPROMStatsTable __uninitialized_ram(bootStats);
+static FlashPROMStats& stats = bootStats.stats;
+static FlashPROMStats previousStats;
+static bool hasPreviousStats = false;
+
+static inline uint16_t recordPages(uint32_t dataSize)
+{
+	return (sizeof(FlashRecordHeader) + dataSize + FLASH_PAGE_SIZE - 1) / FLASH_PAGE_SIZE;
+}
+
+static inline bool isDirty(uint32_t chunk)
+{
+	return dirtyChunks[chunk / 32] & (1u << (chunk % 32));
+}
+
+static void markDirty(uint32_t offset, uint32_t size)
+{
+	for (uint32_t chunk = offset / EEPROM_CHUNK_SIZE; chunk * EEPROM_CHUNK_SIZE < offset + size; chunk++)
+		dirtyChunks[chunk / 32] |= 1u << (chunk % 32);
+}
+
+static bool anyDirty()
+{
+	for (uint32_t word : dirtyChunks)
+		if (word != 0)
+			return true;
+	return false;
+}
+
+// Calls f(offset, size) for each run of changed chunks up to imageSize
+template <typename F>
+static void forEachRun(F f)
+{
+	const uint32_t chunks = (imageSize + EEPROM_CHUNK_SIZE - 1) / EEPROM_CHUNK_SIZE;
+	uint32_t chunk = 0;
+	while (chunk < chunks)
+	{
+		if (!isDirty(chunk))
+		{
+			chunk++;
+			continue;
+		}
+
+		const uint32_t first = chunk;
+		while (chunk < chunks && isDirty(chunk))
+			chunk++;
+		const uint32_t end = (chunk * EEPROM_CHUNK_SIZE < imageSize) ? chunk * EEPROM_CHUNK_SIZE : imageSize;
+		f(first * EEPROM_CHUNK_SIZE, end - first * EEPROM_CHUNK_SIZE);
+	}
+}
+
+static void crcHeader(const FlashRecordHeader& header, CRC32& crc)
+{
+	crc.update(reinterpret_cast<const uint8_t*>(&header), offsetof(FlashRecordHeader, crc));
+}
+
+// The record header at page, if it looks like one, its data isn't checked
+static const FlashRecordHeader* headerAt(uint16_t page)
+{
+	const FlashRecordHeader* header = reinterpret_cast<const FlashRecordHeader*>(flashStart + page * FLASH_PAGE_SIZE);
+	if (header->magic != EEPROM_RECORD_MAGIC ||
+		header->imageSize > EEPROM_MAX_IMAGE_SIZE ||
+		page + recordPages(header->dataSize) > EEPROM_PAGE_COUNT)
+		return nullptr;
+	if (header->type == FLASH_RECORD_FULL ? header->dataSize != header->imageSize : header->type != FLASH_RECORD_DELTA)
+		return nullptr;
+	return header;
+}
+
+// Whether the whole record made it to flash, its CRC is the last thing a save completes
+static bool recordValid(const FlashRecordHeader& header)
+{
+	CRC32 crc;
+	crcHeader(header, crc);
+	crc.update(reinterpret_cast<const uint8_t*>(&header + 1), header.dataSize);
+	stats.startCrcBytes += sizeof(header) + header.dataSize;
+	return crc.finalize() == header.crc;
+}
+
+static bool applyDelta(const FlashRecordHeader& header, uint32_t& size)
+{
+	const uint8_t* data = reinterpret_cast<const uint8_t*>(&header + 1);
+	const uint8_t* end = data + header.dataSize;
+	while (data + sizeof(DeltaRun) <= end)
+	{
+		DeltaRun run;
+		memcpy(&run, data, sizeof(run));
+		data += sizeof(run);
+		if (run.offset + run.size > header.imageSize || data + run.size > end)
+			return false;
+		memcpy(FlashPROM::writeCache + run.offset, data, run.size);
+		data += run.size;
+	}
+
+	if (header.imageSize < size)
+		memset(FlashPROM::writeCache + header.imageSize, 0, size - header.imageSize);
+	size = header.imageSize;
+	return true;
+}
+
+static bool isErased(uint16_t firstPage, uint16_t endPage)
+{
+	const uint8_t* data = flashStart + firstPage * FLASH_PAGE_SIZE;
+	for (uint32_t i = 0; i < (uint32_t)(endPage - firstPage) * FLASH_PAGE_SIZE; i++)
+		if (data[i] != 0xff)
+			return false;
+	return true;
+}
+
+// Whether the sector holds part of the log from page first up to head
+static bool sectorInLog(uint16_t sector, uint16_t first, uint16_t head)
+{
+	for (uint16_t page = sector * EEPROM_PAGES_PER_SECTOR; page < (sector + 1) * EEPROM_PAGES_PER_SECTOR; page++)
+	{
+		if (first < head ? (page >= first && page < head) : (page >= first || page < head))
+			return true;
+	}
+	return false;
+}
+
+// Whether the sector holds part of the chain, from its full record up to head
+static bool sectorInChain(uint16_t sector, uint16_t head)
+{
+	return hasChain && sectorInLog(sector, chainPage, head);
+}
+
+// First page for a record of dataSize after head, or at the start of the block when it doesn't fit before the end,
+// and the sectors to erase for it
+static uint16_t placeRecord(uint16_t head, uint32_t dataSize, uint16_t& firstErase, uint16_t& lastErase, bool& erasesChain)
+{
+	const uint16_t pages = recordPages(dataSize);
+	const uint16_t page = (head + pages > EEPROM_PAGE_COUNT) ? 0 : head;
+
+	firstErase = page / EEPROM_PAGES_PER_SECTOR;
+	if (page == head && page % EEPROM_PAGES_PER_SECTOR != 0)
+		firstErase++;
+	lastErase = (page + pages - 1) / EEPROM_PAGES_PER_SECTOR;
+
+	erasesChain = false;
+	for (uint16_t sector = firstErase; sector <= lastErase; sector++)
+		erasesChain = erasesChain || sectorInChain(sector, head);
+	return page;
+}
+
+// Copies the part of a record that falls on one of its pages
+class PageBuilder
+{
+	public:
+		PageBuilder(uint16_t index, uint8_t* page) : start(index * FLASH_PAGE_SIZE), page(page)
+		{
+			memset(page, 0xff, FLASH_PAGE_SIZE);
+		}
+
+		void put(const void* data, uint32_t size)
+		{
+			const uint32_t first = (position > start) ? position : start;
+			const uint32_t end = (position + size < start + FLASH_PAGE_SIZE) ? position + size : start + FLASH_PAGE_SIZE;
+			if (first < end)
+				memcpy(page + first - start, reinterpret_cast<const uint8_t*>(data) + first - position, end - first);
+			position += size;
+		}
+
+	private:
+		uint32_t position = 0;
+		uint32_t start;
+		uint8_t* page;
+};
+
+// The save being written, planned before its first step so the steps only erase and program
+struct RecordPlan
+{
+	FlashRecordHeader header;
+	uint16_t page;
+	uint16_t pages;
+	uint16_t pagesDone;
+	uint32_t eraseSectors;                  // bit per sector still to erase, only the ones that aren't erased already
+	bool resetBlock;                        // a reset, its erases come first
+	bool write;
+};
+
+static_assert(EEPROM_SECTOR_COUNT <= 32, "RecordPlan::eraseSectors has a bit per sector");
+
+static RecordPlan plan;
+static bool planned = false;
+static bool savePending = false;
+static uint64_t commitUs = 0;               // of the last commit, the save waits EEPROM_WRITE_WAIT after it
+static uint32_t stallBudgetUs = EEPROM_STALL_BUDGET_US;
+static bool aheadErased = false;            // every sector but the last two generations' reads back erased
+static bool newerRecords = false;           // start() found records after the chain, kept until the next full record
+
+static bool sectorErased(uint16_t sector)
+{
+	return isErased(sector * EEPROM_PAGES_PER_SECTOR, (sector + 1) * EEPROM_PAGES_PER_SECTOR);
+}
+
+static void planRecord()
+{
+	plan.eraseSectors = 0;
+	plan.pagesDone = 0;
+	plan.resetBlock = eraseBlock;
+	plan.write = false;
+	if (eraseBlock)
+	{
+		for (uint16_t sector = 0; sector < EEPROM_SECTOR_COUNT; sector++)
+			if (!sectorErased(sector))
+				plan.eraseSectors |= 1u << sector;
+		eraseBlock = false;
+		hasChain = false;
+		hasPrevious = false;
+		headPage = 0;
+		savedSize = 0;
+		if (imageSize == 0)
+			return;
+	}
+
+	uint32_t deltaSize = 0;
+	forEachRun([&](uint32_t offset, uint32_t size) { deltaSize += sizeof(DeltaRun) + size; });
+
+	// A delta goes after the last record as long as it stays smaller than the cache and leaves room for the full
+	// record the chain starts over with, even from the next sector after it (start() moves there past a save cut
+	// short). The full record can't erase any of the chain either, the previous state stays in flash until it's done.
+	// Nor can a delta erase the generation before, the full record that would have to starts the next one instead
+	// and the two newest generations are always in flash.
+	uint16_t firstErase, lastErase;
+	bool erasesChain = true;
+	bool full = !hasChain || chainDeltas >= EEPROM_MAX_DELTAS || deltaSize * 2 >= imageSize;
+	uint16_t page = 0;
+	if (!full)
+	{
+		page = placeRecord(headPage, deltaSize, firstErase, lastErase, erasesChain);
+		for (uint16_t sector = firstErase; sector <= lastErase && hasPrevious; sector++)
+			erasesChain = erasesChain || sectorInLog(sector, previousPage, headPage);
+		const uint16_t nextSector = (page + recordPages(deltaSize) + EEPROM_PAGES_PER_SECTOR - 1) / EEPROM_PAGES_PER_SECTOR;
+		uint16_t fullFirstErase, fullLastErase;
+		bool fullErasesChain;
+		placeRecord(nextSector * EEPROM_PAGES_PER_SECTOR, imageSize, fullFirstErase, fullLastErase, fullErasesChain);
+		full = erasesChain || fullErasesChain;
+	}
+	if (full)
+	{
+		// clears what the block held before the log
+		if (!hasChain)
+			memset(FlashPROM::writeCache + imageSize, 0, EEPROM_SIZE_BYTES - imageSize);
+		page = placeRecord(headPage, imageSize, firstErase, lastErase, erasesChain);
+		// only when the config takes up more than half the block
+		if (erasesChain)
+			stats.unsafeWrites++;
+	}
+
+	// a sector the log hasn't been through since the last erase, or a reset, doesn't need erasing again
+	for (uint16_t sector = firstErase; sector <= lastErase; sector++)
+		if (!sectorErased(sector))
+			plan.eraseSectors |= 1u << sector;
+
+	FlashRecordHeader& header = plan.header;
+	header.magic = EEPROM_RECORD_MAGIC;
+	header.sequence = sequence + 1;
+	header.imageSize = imageSize;
+	header.dataSize = full ? imageSize : deltaSize;
+	header.type = full ? FLASH_RECORD_FULL : FLASH_RECORD_DELTA;
+
+	CRC32 crc;
+	crcHeader(header, crc);
+	if (full)
+	{
+		crc.update(FlashPROM::writeCache, imageSize);
+	}
+	else
+	{
+		forEachRun([&](uint32_t offset, uint32_t size) {
+			const DeltaRun run = { (uint16_t)offset, (uint16_t)size };
+			crc.update(reinterpret_cast<const uint8_t*>(&run), sizeof(run));
+			crc.update(FlashPROM::writeCache + offset, size);
+		});
+	}
+	header.crc = crc.finalize();
+	plan.page = page;
+	plan.pages = recordPages(header.dataSize);
+	plan.write = true;
+}
+
+static void buildPage(uint16_t index, uint8_t* page)
+{
+	PageBuilder builder(index, page);
+	builder.put(&plan.header, sizeof(plan.header));
+	if (plan.header.type == FLASH_RECORD_FULL)
+	{
+		builder.put(FlashPROM::writeCache, plan.header.imageSize);
+	}
+	else
+	{
+		forEachRun([&](uint32_t offset, uint32_t size) {
+			const DeltaRun run = { (uint16_t)offset, (uint16_t)size };
+			builder.put(&run, sizeof(run));
+			builder.put(FlashPROM::writeCache + offset, size);
+		});
+	}
+}
+
+static void finishRecord()
+{
+	planned = false;
+	savePending = false;
+	aheadErased = false;
+	if (!plan.write)
+		return;
+
+	if (plan.header.type == FLASH_RECORD_FULL)
+	{
+		newerRecords = false;
+		previousPage = chainPage;
+		hasPrevious = hasChain;
+		chainPage = plan.page;
+		chainDeltas = 0;
+		hasChain = true;
+		stats.fullRecords++;
+	}
+	else
+	{
+		chainDeltas++;
+		stats.deltaRecords++;
+	}
+	headPage = plan.page + plan.pages;
+	sequence = plan.header.sequence;
+	savedSize = plan.header.imageSize;
+	memset(dirtyChunks, 0, sizeof(dirtyChunks));
+}
+
+// The cache changes under a save that's part way through: the next one starts over after the pages it programmed,
+// with the chunks it was writing still marked
+static void abortRecord()
 {
-	while (is_spin_locked(flashLock));
+	if (!planned)
+		return;
 
+	planned = false;
+	stats.restartedSaves++;
+	if (plan.eraseSectors != 0 && plan.resetBlock)
+		eraseBlock = true;
+	if (plan.pagesDone > 0)
+		headPage = plan.page + plan.pagesDone;
+}
+
+// Runs f with core1 held off and interrupts off, for as long as the one erase or program in it takes
+template <typename F>
+static void runLocked(F f)
+{
+	const uint64_t stallStart = time_us_64();
 	multicore_lockout_start_blocking();
 	uint32_t interrupts = spin_lock_blocking(flashLock);
 
-	flash_range_erase((intptr_t)EEPROM_ADDRESS_START - (intptr_t)XIP_BASE, EEPROM_SIZE_BYTES);
-	flash_range_program((intptr_t)EEPROM_ADDRESS_START - (intptr_t)XIP_BASE, reinterpret_cast<uint8_t *>(flashCache), EEPROM_SIZE_BYTES);
-
-	flashWriteAlarm = 0;
+	f();
 
 	multicore_lockout_end_blocking();
 	spin_unlock(flashLock, interrupts);
 
-	return 0;
+	stats.steps++;
+	stats.lastStallUs = time_us_64() - stallStart;
+	if (stats.lastStallUs > stats.maxStallUs)
+		stats.maxStallUs = stats.lastStallUs;
+}
+
+// Runs the next erase or program of the save under the lockout if it fits the budget, true once the save is done
+static bool runStep(uint32_t budgetUs)
+{
+	if (!planned)
+	{
+		planRecord();
+		planned = true;
+	}
+
+	uint16_t sector = 0;
+	while (sector < EEPROM_SECTOR_COUNT && !(plan.eraseSectors & (1u << sector)))
+		sector++;
+	const bool erase = sector < EEPROM_SECTOR_COUNT;
+	if (!erase && (!plan.write || plan.pagesDone == plan.pages))
+	{
+		// a reset of an erased block
+		finishRecord();
+		return true;
+	}
+
+	// what a step can take at worst has to fit the budget, an erase never does and waits for maintain() or flush()
+	const uint32_t worstUs = erase ? EEPROM_SECTOR_ERASE_MAX_US : EEPROM_PAGE_PROGRAM_MAX_US;
+	if (worstUs > budgetUs)
+	{
+		stats.heldSteps++;
+		return false;
+	}
+
+	if (erase)
+	{
+		runLocked([&]() { flash_range_erase(flashOffset + sector * FLASH_SECTOR_SIZE, FLASH_SECTOR_SIZE); });
+		plan.eraseSectors &= ~(1u << sector);
+		stats.sectorsErased++;
+	}
+	else
+	{
+		uint8_t page[FLASH_PAGE_SIZE];
+		buildPage(plan.pagesDone, page);
+		runLocked([&]() { flash_range_program(flashOffset + (plan.page + plan.pagesDone) * FLASH_PAGE_SIZE, page, FLASH_PAGE_SIZE); });
+		plan.pagesDone++;
+		stats.pagesProgrammed++;
+	}
+
+	if (plan.eraseSectors != 0 || (plan.write && plan.pagesDone < plan.pages))
+		return false;
+	finishRecord();
+	return true;
 }
 
 void FlashPROM::start()
@@ -32,22 +466,280 @@ void FlashPROM::start()
 	if (flashLock == nullptr)
 		flashLock = spin_lock_instance(spin_lock_claim_unused(true));
 
-	memcpy(writeCache, reinterpret_cast<uint8_t *>(EEPROM_ADDRESS_START), EEPROM_SIZE_BYTES);
+	if (bootStats.magic == EEPROM_STATS_MAGIC && bootStats.size == sizeof(FlashPROMStatsTable))
+	{
+		previousStats = bootStats.stats;
+		hasPreviousStats = true;
+	}
+	memset(&stats, 0, sizeof(stats));
+	bootStats.magic = EEPROM_STATS_MAGIC;
+	bootStats.size = sizeof(FlashPROMStatsTable);
+
+	imageSize = 0;
+	savedSize = 0;
+	sequence = 0;
+	headPage = 0;
+	chainDeltas = 0;
+	hasChain = false;
+	hasPrevious = false;
+	eraseBlock = false;
+	planned = false;
+	savePending = false;
+	aheadErased = false;
+	newerRecords = false;
+	memset(dirtyChunks, 0, sizeof(dirtyChunks));
+
+	// Every full record starts a generation, its sequence numbers go up by one with each record. The headers alone
+	// are enough to order them, only the generation that's loaded has its records checked.
+	uint32_t headerPages[EEPROM_PAGE_COUNT / 32] = { };
+	bool anyRecord = false;
+	for (uint16_t page = 0; page < EEPROM_PAGE_COUNT; page++)
+	{
+		const FlashRecordHeader* header = headerAt(page);
+		if (header == nullptr)
+			continue;
+
+		headerPages[page / 32] |= 1u << (page % 32);
+		if (!anyRecord || (int32_t)(header->sequence - sequence) > 0)
+			sequence = header->sequence;
+		anyRecord = true;
+	}
+
+	// The newest full record that holds up, or the one before it, and so on. A full record started over shares its
+	// sequence with the copy cut short, each is tried on its own.
+	uint32_t triedPages[EEPROM_PAGE_COUNT / 32] = { };
+	const FlashRecordHeader* full = nullptr;
+	while (true)
+	{
+		const FlashRecordHeader* candidate = nullptr;
+		uint16_t candidatePage = 0;
+		for (uint16_t page = 0; page < EEPROM_PAGE_COUNT; page++)
+		{
+			if (!(headerPages[page / 32] & (1u << (page % 32))) || (triedPages[page / 32] & (1u << (page % 32))))
+				continue;
+			const FlashRecordHeader* header = reinterpret_cast<const FlashRecordHeader*>(flashStart + page * FLASH_PAGE_SIZE);
+			if (header->type != FLASH_RECORD_FULL || (full != nullptr && (int32_t)(full->sequence - header->sequence) <= 0))
+				continue;
+			if (candidate == nullptr || (int32_t)(header->sequence - candidate->sequence) > 0)
+			{
+				candidate = header;
+				candidatePage = page;
+			}
+		}
+		if (candidate == nullptr)
+			break;
+
+		triedPages[candidatePage / 32] |= 1u << (candidatePage % 32);
+		if (!recordValid(*candidate))
+			continue;
+		if (full != nullptr)
+		{
+			// the generation before the one loaded, kept as long as it is, one given up on doesn't count
+			previousPage = candidatePage;
+			hasPrevious = true;
+			break;
+		}
+		full = candidate;
+		chainPage = candidatePage;
+	}
+
+	if (full == nullptr)
+	{
+		memcpy(writeCache, flashStart, EEPROM_SIZE_BYTES);
+		return;
+	}
+
+	// the deltas stop at the next full record, one that didn't hold up
+	uint32_t generationDeltas = EEPROM_MAX_DELTAS;
+	for (uint16_t page = 0; page < EEPROM_PAGE_COUNT; page++)
+	{
+		if (!(headerPages[page / 32] & (1u << (page % 32))))
+			continue;
+		const FlashRecordHeader* header = reinterpret_cast<const FlashRecordHeader*>(flashStart + page * FLASH_PAGE_SIZE);
+		if (header->type == FLASH_RECORD_FULL && (int32_t)(header->sequence - full->sequence) > 0 &&
+			header->sequence - full->sequence - 1 < generationDeltas)
+			generationDeltas = header->sequence - full->sequence - 1;
+	}
+
+	// the deltas after it, a save cut short and the one after it share a sequence number, only one holds up
+	uint16_t deltaPages[EEPROM_MAX_DELTAS];
+	memset(deltaPages, 0xff, sizeof(deltaPages));
+	for (uint16_t page = 0; page < EEPROM_PAGE_COUNT; page++)
+	{
+		if (!(headerPages[page / 32] & (1u << (page % 32))))
+			continue;
+		const FlashRecordHeader* header = reinterpret_cast<const FlashRecordHeader*>(flashStart + page * FLASH_PAGE_SIZE);
+		const uint32_t index = header->sequence - full->sequence - 1;
+		if (header->type == FLASH_RECORD_DELTA && index < generationDeltas && deltaPages[index] == NO_PAGE &&
+			recordValid(*header))
+			deltaPages[index] = page;
+	}
+
+	memset(writeCache, 0, EEPROM_SIZE_BYTES);
+	memcpy(writeCache, full + 1, full->imageSize);
+	imageSize = full->imageSize;
+	hasChain = true;
+
+	uint16_t tailPage = chainPage;
+	for (; chainDeltas < EEPROM_MAX_DELTAS && deltaPages[chainDeltas] != NO_PAGE; chainDeltas++)
+	{
+		const FlashRecordHeader* delta = reinterpret_cast<const FlashRecordHeader*>(flashStart + deltaPages[chainDeltas] * FLASH_PAGE_SIZE);
+		if (!applyDelta(*delta, imageSize))
+			break;
+		tailPage = deltaPages[chainDeltas];
+	}
+	savedSize = imageSize;
+
+	// A record newer than the last one loaded was cut short, or the generation it belongs to didn't hold up. The
+	// next save starts a generation of its own, numbered after all of them.
+	const FlashRecordHeader* tail = reinterpret_cast<const FlashRecordHeader*>(flashStart + tailPage * FLASH_PAGE_SIZE);
+	if (tail->sequence != sequence)
+	{
+		chainDeltas = EEPROM_MAX_DELTAS;
+		newerRecords = true;
+	}
+
+	// a save cut short leaves programmed pages after the last record, the next one goes to a fresh sector then
+	headPage = tailPage + recordPages(tail->dataSize);
+	const uint16_t sectorEnd = (headPage + EEPROM_PAGES_PER_SECTOR - 1) / EEPROM_PAGES_PER_SECTOR * EEPROM_PAGES_PER_SECTOR;
+	if (!isErased(headPage, sectorEnd))
+		headPage = sectorEnd;
+}
+
+bool FlashPROM::write(uint32_t offset, const uint8_t* data, uint32_t size)
+{
+	if (offset + size > EEPROM_MAX_IMAGE_SIZE)
+		return false;
+
+	while (size > 0)
+	{
+		const uint32_t chunkEnd = (offset / EEPROM_CHUNK_SIZE + 1) * EEPROM_CHUNK_SIZE;
+		const uint32_t count = (offset + size < chunkEnd) ? size : chunkEnd - offset;
+		if (memcmp(writeCache + offset, data, count) != 0)
+		{
+			abortRecord();
+			memcpy(writeCache + offset, data, count);
+			markDirty(offset, count);
+		}
+		offset += count;
+		data += count;
+		size -= count;
+	}
+	return true;
 }
 
 /* We don't have an actual EEPROM, so we need to be extra careful about minimizing writes. Instead
 	of writing when a commit is requested, we update a time to actually commit. That way, if we receive multiple requests
 	to commit in that timeframe, we'll hold off until the user is done sending changes. */
-void FlashPROM::commit()
+void FlashPROM::commit(uint32_t size)
 {
-	while (is_spin_locked(flashLock));
-	if (flashWriteAlarm != 0)
-		cancel_alarm(flashWriteAlarm);
-	flashWriteAlarm = add_alarm_in_ms(EEPROM_WRITE_WAIT, writeToFlash, writeCache, true);
+	if (size > EEPROM_MAX_IMAGE_SIZE)
+		return;
+
+	if (size != imageSize)
+		abortRecord();
+
+	// what was past the end reads as zeros again
+	if (size < imageSize)
+	{
+		memset(writeCache + size, 0, imageSize - size);
+		markDirty(size, imageSize - size);
+	}
+	imageSize = size;
+
+	if (hasChain && !eraseBlock && !planned && imageSize == savedSize && !anyDirty())
+	{
+		savePending = false;
+		return;
+	}
+
+	savePending = true;
+	commitUs = time_us_64();
 }
 
 void FlashPROM::reset()
 {
+	abortRecord();
 	memset(writeCache, 0, EEPROM_SIZE_BYTES);
-	commit();
+	memset(dirtyChunks, 0, sizeof(dirtyChunks));
+	imageSize = 0;
+	eraseBlock = true;
+	savePending = true;
+	commitUs = time_us_64();
+}
+
+void FlashPROM::step(bool inputsActive)
+{
+	if (!savePending || time_us_64() - commitUs < EEPROM_WRITE_WAIT * 1000)
+		return;
+
+	if (inputsActive)
+	{
+		stats.deferredSteps++;
+		return;
+	}
+	runStep(stallBudgetUs);
+}
+
+void FlashPROM::maintain()
+{
+	if (savePending)
+	{
+		if (time_us_64() - commitUs >= EEPROM_WRITE_WAIT * 1000)
+			runStep(UINT32_MAX);
+		return;
+	}
+	// records newer than the chain make the next save start a generation, a reboot before it has to find them too
+	if (aheadErased || !hasChain || newerRecords)
+		return;
+
+	// The sectors the log moves into next, all but the ones the last two generations are in, so the saves made
+	// while the host takes reports find them erased
+	const uint16_t keptPage = hasPrevious ? previousPage : chainPage;
+	for (uint16_t sector = 0; sector < EEPROM_SECTOR_COUNT; sector++)
+	{
+		if (sectorInLog(sector, keptPage, headPage) || sectorErased(sector))
+			continue;
+
+		runLocked([&]() { flash_range_erase(flashOffset + sector * FLASH_SECTOR_SIZE, FLASH_SECTOR_SIZE); });
+		stats.sectorsErased++;
+		stats.erasesAhead++;
+		return;
+	}
+	aheadErased = true;
+}
+
+void FlashPROM::flush()
+{
+	while (savePending)
+		runStep(UINT32_MAX);
+}
+
+bool FlashPROM::pending() const
+{
+	return savePending;
+}
+
+void FlashPROM::setStallBudget(uint32_t budgetUs)
+{
+	if (budgetUs < EEPROM_PAGE_PROGRAM_MAX_US)
+		budgetUs = EEPROM_PAGE_PROGRAM_MAX_US;
+	if (budgetUs > EEPROM_STALL_BUDGET_MAX_US)
+		budgetUs = EEPROM_STALL_BUDGET_MAX_US;
+	stallBudgetUs = budgetUs;
+}
+
+uint32_t FlashPROM::size() const
+{
+	return imageSize;
+}
+
+const FlashPROMStats& FlashPROM::getStats() const
+{
+	return stats;
+}
+
+const FlashPROMStats* FlashPROM::getPreviousStats() const
+{
+	return hasPreviousStats ? &previousStats : nullptr;
 }
@@ -19,12 +19,118 @@
 // Warning: If the write wait is too long it can stall other processes
 #define EEPROM_WRITE_WAIT    50             // Amount of time in ms to wait before blocking core1 and committing to flash
 
+// A save is written one erase or program at a time, each a step of its own between input frames. These are the
+// longest the datasheet allows for them (W25Q16JV), what a step has to fit in the stall budget with.
+#define EEPROM_PAGE_PROGRAM_MAX_US 3000
+#define EEPROM_SECTOR_ERASE_MAX_US 400000
+
+// Longest a step may hold off core1 and the next input frame for while the host takes reports. At least a page
+// program, so a save that needs no erase always gets written; a sector erase never fits and waits for maintain().
+#ifndef EEPROM_STALL_BUDGET_US
+#define EEPROM_STALL_BUDGET_US 3000
+#endif
+#define EEPROM_STALL_BUDGET_MAX_US 10000
+
+#define EEPROM_SECTOR_COUNT  (EEPROM_SIZE_BYTES / FLASH_SECTOR_SIZE)
+#define EEPROM_PAGE_COUNT    (EEPROM_SIZE_BYTES / FLASH_PAGE_SIZE)
+
+// Changes to the cache are tracked in chunks of this size, a delta record carries the chunks that changed
+#define EEPROM_CHUNK_SIZE    32
+
+// Deltas on top of a full record before the next save writes a full record again
+#define EEPROM_MAX_DELTAS    32
+
+#define EEPROM_RECORD_MAGIC  0x464c4f47 // "FLOG"
+
+enum FlashRecordType : uint16_t
+{
+	FLASH_RECORD_FULL = 1,                  // the cache up to imageSize
+	FLASH_RECORD_DELTA = 2,                 // runs of { uint16_t offset, uint16_t size, data } over the previous record
+};
+
+// Every record starts on a flash page with this header, followed by dataSize bytes of data
+struct FlashRecordHeader
+{
+	uint32_t magic;
+	uint32_t sequence;                      // one more than the record before, full or delta
+	uint32_t imageSize;                     // size of the cache once the record is applied
+	uint16_t dataSize;
+	uint16_t type;
+	uint32_t crc;                           // CRC32 of the header up to here and the data
+};
+
+#define EEPROM_MAX_IMAGE_SIZE (EEPROM_SIZE_BYTES - sizeof(FlashRecordHeader))
+
+struct FlashPROMStats
+{
+	uint32_t fullRecords;
+	uint32_t deltaRecords;
+	uint32_t sectorsErased;
+	uint32_t pagesProgrammed;
+	uint32_t unsafeWrites;                  // full records that had to erase a sector the last saved state was in
+	uint32_t steps;                         // erases and programs, each a stall of its own
+	uint32_t lastStallUs;                   // how long the last step held off core1 and interrupts
+	uint32_t maxStallUs;
+	uint32_t deferredSteps;                 // passes a due step waited for the inputs to be idle
+	uint32_t heldSteps;                     // passes a due step over the budget, an erase, waited for maintain()
+	uint32_t erasesAhead;                   // sectors maintain() erased ahead of the log
+	uint32_t restartedSaves;                // saves the cache changed under part way through
+	uint32_t startCrcBytes;                 // of the records start() checked the CRC of
+};
+
+/**
+ * @brief A log of records in the FlashPROM block, replayed into writeCache on start.
+ *
+ * The block is a ring of 4 KB sectors. A save appends one record after the previous one: a full copy of the cache,
+ * or a delta with only the chunks that changed since the last save, usually a single page. A sector is only
+ * erased when the log moves into it, never while it holds the last full record or a delta after it, so a power
+ * cut during a save leaves the previous state in flash.
+ *
+ * Each full record starts a generation, numbered by its sequence, and the deltas after it belong to it. A record
+ * only counts once its CRC holds up, which takes its last page, so the switch to the new state is atomic. start()
+ * orders the generations by their headers alone and checks the newest, falling back to the one before it if that
+ * doesn't hold up. Only the generation it loads and the full record before it are read in full. A delta never
+ * erases the generation before the current one, a full record starts the next generation in its place, so the
+ * last two are always in flash. The deltas replay up to the first one missing or
+ * cut short, and a save after a fallback or a cut starts a new generation numbered after every record seen.
+ *
+ * Sectors that already read back erased are not erased again, and a record is laid out and checksummed before
+ * its first step. step() runs one erase or program per call, locking core1 out for just that one, and none while
+ * the inputs are active. A step has to fit the stall budget at the datasheet's worst case, so while the host takes
+ * reports only page programs run. Erases run in maintain(), where no input frame waits on them: web config, before
+ * the host takes reports, and the sectors the log moves into next are erased there ahead of time. A save that needs
+ * an erase anyway, a full record over the generation before most often, is held until then or until flush() before
+ * a reboot, and is lost if the power goes first. A write to the cache while a save is part way through starts it
+ * over after the pages it programmed.
+ *
+ * Without a record, writeCache is a copy of the block, for reading the formats that came before the log.
+ */
 class FlashPROM
 {
 	public:
 		void start();
-		void commit();
+		// Copy into the cache at offset, marking the chunks that changed
+		bool write(uint32_t offset, const uint8_t* data, uint32_t size);
+		// Save the first size bytes of the cache, if they differ from the last save
+		void commit(uint32_t size);
+		// Erase the block
 		void reset();
+		// Run the next step of a pending save if it fits the budget, call once per input frame after the report went out
+		void step(bool inputsActive);
+		// Run the next step of a pending save, erases included, or erase the next sector ahead of the log. Only where
+		// no input frame waits on the stall.
+		void maintain();
+		// Write a pending save in full, before a reboot
+		void flush();
+		bool pending() const;
+		// Clamped to EEPROM_PAGE_PROGRAM_MAX_US..EEPROM_STALL_BUDGET_MAX_US
+		void setStallBudget(uint32_t budgetUs);
+
+		// Size of the cache as of the last commit or the records replayed on start, 0 if there are none
+		uint32_t size() const;
+		const FlashPROMStats& getStats() const;
+		// Stats of the boot before this one, if RAM kept them over the reboot
+		const FlashPROMStats* getPreviousStats() const;
 
 		static uint8_t writeCache[EEPROM_SIZE_BYTES];
 };
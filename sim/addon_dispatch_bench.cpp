@@ -0,0 +1,237 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Add-on dispatch check and benchmark
+//
+// Loads the core0 add-ons GP2040::setup loads, every one of them enabled, as stand-ins that implement the same
+// hooks the real ones do and leave the others empty. Runs the input and USB report phases of a pass through
+// AddonManager's per-phase dispatch lists and through a copy of the loop over every add-on it replaced.
+// Checks both call the implemented hooks the same number of times in the same order and prints the
+// dispatch time per pass for each. Then loads a real add-on through the static registry, disabled and enabled,
+// and checks it is only constructed when enabled, in its own storage, without a heap allocation for itself.
+//
+//   gp2040ce_addon_dispatch_bench [--passes N]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <new>
+
+#include "addonmanager.h"
+#include "gamepad.h"
+#include "storagemanager.h"
+
+#include "addons/reverse.h"
+
+// Every allocation the bench makes, to tell what loading an add-on takes from the heap
+static uint32_t allocations = 0;
+
+void* operator new(size_t size) {
+	allocations++;
+	void* ptr = malloc(size ? size : 1);
+	if (ptr == nullptr) throw std::bad_alloc();
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { free(ptr); }
+
+// What the implemented hooks saw, summed so both dispatchers can be compared
+struct HookLog {
+	uint64_t calls = 0;
+	uint64_t checksum = 0;
+
+	void record(uint32_t id) {
+		calls++;
+		checksum = checksum * 31 + id;
+	}
+};
+
+class HookAddon : public GPAddon {
+public:
+	HookAddon(const char* addonName, uint8_t hooks, uint32_t id, HookLog& log) : addonName(addonName), hooks(hooks), id(id), log(log) {}
+	virtual bool available() { return true; }
+	virtual void setup() {}
+	virtual void preprocess() { if (hooks & ADDON_HOOK_PREPROCESS) log.record(id * 4); }
+	virtual void process() { if (hooks & ADDON_HOOK_PROCESS) log.record(id * 4 + 1); }
+	virtual void reinit() { if (hooks & ADDON_HOOK_REINIT) log.record(id * 4 + 2); }
+	virtual uint8_t getHooks() { return hooks; }
+private:
+	const char* addonName;
+	uint8_t hooks;
+	uint32_t id;
+	HookLog& log;
+};
+
+struct AddonSpec {
+	const char* name;
+	uint8_t hooks;
+	ADDON_PROCESS process;
+};
+
+// In GP2040::setup order, with the hooks of the add-on it stands in for
+static const AddonSpec addonSpecs[] = {
+	{ "KeyboardHost", ADDON_HOOK_PREPROCESS, CORE0_INPUT },
+	{ "GamepadUSBHost", ADDON_HOOK_PREPROCESS, CORE0_INPUT },
+	{ "Analog", ADDON_HOOK_PROCESS, CORE0_INPUT },
+	{ "BootselButton", ADDON_HOOK_PREPROCESS, CORE0_INPUT },
+	{ "DualDirectional", ADDON_HOOKS_ALL, CORE0_INPUT },
+	{ "FocusMode", ADDON_HOOK_PROCESS, CORE0_INPUT },
+	{ "I2CAnalog", ADDON_HOOK_PROCESS, CORE0_INPUT },
+	{ "SPIAnalog", ADDON_HOOK_PROCESS, CORE0_INPUT },
+	{ "WiiExtension", ADDON_HOOK_PROCESS, CORE0_INPUT },
+	{ "SNESpad", ADDON_HOOK_PROCESS, CORE0_INPUT },
+	{ "PlayerNum", ADDON_HOOK_PROCESS, CORE0_USBREPORT },
+	{ "SliderSOCD", ADDON_HOOK_PROCESS | ADDON_HOOK_REINIT, CORE0_INPUT },
+	{ "Tilt", ADDON_HOOK_PREPROCESS | ADDON_HOOK_PROCESS, CORE0_INPUT },
+	{ "RotaryEncoder", ADDON_HOOK_PROCESS, CORE0_INPUT },
+	{ "PCF8575", ADDON_HOOK_PROCESS, CORE0_INPUT },
+	{ "Reverse", ADDON_HOOK_PROCESS, CORE0_INPUT },
+	{ "Turbo", ADDON_HOOK_PROCESS | ADDON_HOOK_REINIT, CORE0_INPUT },
+	{ "InputMacro", ADDON_HOOK_PREPROCESS | ADDON_HOOK_REINIT, CORE0_INPUT },
+};
+
+static void loadAddons(AddonManager& addons, HookLog& log) {
+	uint32_t id = 0;
+	for (const AddonSpec& spec : addonSpecs) {
+		addons.LoadAddon(new HookAddon(spec.name, spec.hooks, id++, log), spec.process);
+	}
+}
+
+// Same as AddonManager before the dispatch lists, the reference it is checked against
+static void legacyPass(AddonManager& addons) {
+	for (uint8_t i = 0; i < addons.GetAddonCount(); i++) {
+		if ( addons.GetAddonBlock(i).process == CORE0_INPUT )
+			addons.GetAddonBlock(i).ptr->preprocess();
+	}
+	for (uint8_t i = 0; i < addons.GetAddonCount(); i++) {
+		if ( addons.GetAddonBlock(i).process == CORE0_INPUT )
+			addons.GetAddonBlock(i).ptr->process();
+	}
+	for (uint8_t i = 0; i < addons.GetAddonCount(); i++) {
+		if ( addons.GetAddonBlock(i).process == CORE0_USBREPORT )
+			addons.GetAddonBlock(i).ptr->process();
+	}
+}
+
+// A disabled add-on is never constructed, an enabled one lives in its AddonStorage and only allocates what its
+// setup() does, one allocation less than constructing it with new
+static bool checkRegistry() {
+	bool passed = true;
+	Storage::getInstance().init();
+	// lives as long as Storage points at it, kept off the heap the bench counts
+	static Gamepad gamepad;
+	Storage::getInstance().SetGamepad(&gamepad);
+	Storage::getInstance().setFunctionalPinMappings();
+	gamepad.setup();
+	ReverseOptions& options = Storage::getInstance().getAddonOptions().reverseOptions;
+
+	AddonManager disabled;
+	options.enabled = false;
+	uint32_t before = allocations;
+	disabled.LoadAddon<ReverseInput>(CORE0_INPUT);
+	if (disabled.GetAddonCount() != 0 || allocations != before) {
+		printf("FAIL disabled add-on loaded %u times with %lu allocations\n", disabled.GetAddonCount(),
+			(unsigned long)(allocations - before));
+		passed = false;
+	}
+
+	AddonManager registry;
+	options.enabled = true;
+	before = allocations;
+	registry.LoadAddon<ReverseInput>(CORE0_INPUT);
+	uint32_t registryAllocations = allocations - before;
+	if (registry.GetAddon(ADDON_ID_REVERSE) != (GPAddon*)AddonStorage<ReverseInput>::buffer) {
+		printf("FAIL enabled add-on is not in its static storage\n");
+		passed = false;
+	}
+
+	AddonManager heap;
+	before = allocations;
+	heap.LoadAddon(new ReverseInput(), CORE0_INPUT);
+	uint32_t heapAllocations = allocations - before;
+	if (registryAllocations + 1 != heapAllocations) {
+		printf("FAIL loading from the registry took %lu allocations, with new %lu\n", (unsigned long)registryAllocations,
+			(unsigned long)heapAllocations);
+		passed = false;
+	}
+
+	printf("registry   %s loaded in %lu us, %lu allocations in setup (%lu with new)\n",
+		AddonManager::GetAddonName(ADDON_ID_REVERSE), (unsigned long)registry.GetAddonBlock(0).setupUs,
+		(unsigned long)registryAllocations, (unsigned long)heapAllocations);
+	options.enabled = false;
+	return passed;
+}
+
+static void pass(AddonManager& addons) {
+	addons.PreprocessAddons(CORE0_INPUT);
+	addons.ProcessAddons(CORE0_INPUT);
+	addons.ProcessAddons(CORE0_USBREPORT);
+}
+
+int main(int argc, char** argv) {
+	uint32_t passes = 2000000;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) passes = strtoul(argv[++i], nullptr, 0);
+		else {
+			fprintf(stderr, "usage: %s [--passes N]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	bool passed = true;
+
+	AddonManager legacyAddons;
+	HookLog legacyLog;
+	loadAddons(legacyAddons, legacyLog);
+
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < passes; i++) legacyPass(legacyAddons);
+	auto end = std::chrono::steady_clock::now();
+	double legacySeconds = std::chrono::duration<double>(end - start).count();
+
+	AddonManager addons;
+	HookLog log;
+	loadAddons(addons, log);
+
+	start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < passes; i++) pass(addons);
+	end = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(end - start).count();
+
+	if (log.calls != legacyLog.calls || log.checksum != legacyLog.checksum) {
+		printf("MISMATCH hooks called %llu times (legacy %llu), checksum %016llx (legacy %016llx)\n",
+			(unsigned long long)log.calls, (unsigned long long)legacyLog.calls,
+			(unsigned long long)log.checksum, (unsigned long long)legacyLog.checksum);
+		passed = false;
+	}
+
+	// reinit only reaches the add-ons that implement it, in load order
+	HookLog expectedLog = log;
+	uint32_t id = 0;
+	for (const AddonSpec& spec : addonSpecs) {
+		if (spec.process == CORE0_INPUT && (spec.hooks & ADDON_HOOK_REINIT)) expectedLog.record(id * 4 + 2);
+		id++;
+	}
+	addons.ReinitializeAddons(CORE0_INPUT);
+	if (log.calls != expectedLog.calls || log.checksum != expectedLog.checksum) {
+		printf("MISMATCH reinit called %llu hooks, expected %llu\n", (unsigned long long)(log.calls - legacyLog.calls),
+			(unsigned long long)(expectedLog.calls - legacyLog.calls));
+		passed = false;
+	}
+
+	uint32_t calls = 0;
+	for (const AddonSpec& spec : addonSpecs) calls += (spec.process == CORE0_INPUT ? 2 : 1);
+	printf("%lu add-ons, %lu hook calls per pass before, %llu after\n", (unsigned long)(sizeof(addonSpecs) / sizeof(addonSpecs[0])),
+		(unsigned long)calls, (unsigned long long)(legacyLog.calls / passes));
+	printf("legacy     %8.1f ns/pass\n", legacySeconds * 1e9 / passes);
+	printf("dispatch   %8.1f ns/pass\n", seconds * 1e9 / passes);
+	if (!checkRegistry()) passed = false;
+	printf("\n# addon dispatch check %s: %.2fx\n", passed ? "passed" : "FAILED", legacySeconds / seconds);
+	return passed ? 0 : 1;
+}
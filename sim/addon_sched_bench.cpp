@@ -0,0 +1,203 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Add-on scheduling check
+//
+// Runs core0 passes in simulated time with a mixed add-on set: GPIO-only add-ons that cost a few us every pass
+// and bus add-ons standing in for the ADS1219, PCF8575, Wii extension and ADS1256 add-ons, each with the cost
+// of its bus read. The legacy set reads the bus in process() whenever its own timer elapsed, the way those
+// add-ons did before AddonManager scheduled them; the scheduled set reads it in poll(). Prints how long the
+// inputs took from sampling to the report and how long a pass took, and checks that with the scheduler the
+// report time never moves, no pass spends more than its poll budget (or a single poll over it) on polls and no
+// poll waits more than a period plus the longest poll.
+//
+//   gp2040ce_addon_sched_bench [--passes N] [--budget US]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "addonmanager.h"
+#include "simhal.h"
+
+#include "hardware/timer.h"
+#include "pico/time.h"
+
+// inputs read and processed before the report, the part of the pass the add-ons add to
+#define BENCH_FAST_PATH_US 20
+// tud_task and the rest of the pass after the report
+#define BENCH_TAIL_US 10
+
+// Costs a few us every pass, like the GPIO-only input add-ons
+class GpioAddon : public GPAddon {
+public:
+	GpioAddon(const char* addonName, uint32_t costUs) : addonName(addonName), costUs(costUs) {}
+	virtual bool available() { return true; }
+	virtual void setup() {}
+	virtual void preprocess() {}
+	virtual void process() { busy_wait_us_32(costUs); }
+private:
+	const char* addonName;
+	uint32_t costUs;
+};
+
+// A bus read of costUs every periodUs, in process() on its own timer (legacy) or in poll()
+class BusAddon : public GPAddon {
+public:
+	BusAddon(const char* addonName, uint32_t periodUs, uint32_t costUs, AddonPriority priority, bool legacy) :
+		addonName(addonName), periodUs(periodUs), costUs(costUs), priority(priority), legacy(legacy) {}
+	virtual bool available() { return true; }
+	virtual void setup() { nextTimer = time_us_32(); }
+	virtual void preprocess() {}
+	virtual void process() {
+		if (legacy && (int32_t)(time_us_32() - nextTimer) >= 0) {
+			busy_wait_us_32(costUs);
+			nextTimer = time_us_32() + periodUs;
+		}
+		busy_wait_us_32(1); // apply the last read to the gamepad state
+	}
+	virtual void poll() { busy_wait_us_32(costUs); }
+	virtual AddonSchedule getSchedule() {
+		AddonSchedule schedule;
+		if (!legacy) {
+			schedule.periodUs = periodUs;
+			schedule.priority = priority;
+		}
+		return schedule;
+	}
+
+	const char* const addonName;
+	const uint32_t periodUs;
+	const uint32_t costUs;
+private:
+	AddonPriority priority;
+	bool legacy;
+	uint32_t nextTimer = 0;
+};
+
+struct Spread {
+	uint32_t min = UINT32_MAX;
+	uint32_t max = 0;
+	uint64_t sum = 0;
+	uint32_t count = 0;
+
+	void add(uint32_t value) {
+		if (value < min) min = value;
+		if (value > max) max = value;
+		sum += value;
+		count++;
+	}
+
+	uint32_t avg() const { return count ? (uint32_t)(sum / count) : 0; }
+};
+
+struct RunResult {
+	Spread report;      // sampling to report
+	Spread pass;        // whole pass
+	Spread polls;       // time spent in PollAddons
+	uint32_t maxCostUs = 0;
+};
+
+static RunResult run(AddonManager& addons, bool legacy, uint32_t passes, uint32_t budgetUs) {
+	addons.LoadAddon(new GpioAddon("dualDirectional", 3), CORE0_INPUT);
+	addons.LoadAddon(new GpioAddon("slider", 2), CORE0_INPUT);
+	addons.LoadAddon(new BusAddon("ads1219", 1000, 200, ADDON_PRIORITY_NORMAL, legacy), CORE0_INPUT);
+	addons.LoadAddon(new BusAddon("pcf8575", 1000, 120, ADDON_PRIORITY_HIGH, legacy), CORE0_INPUT);
+	addons.LoadAddon(new BusAddon("wiiExtension", 1000, 250, ADDON_PRIORITY_HIGH, legacy), CORE0_INPUT);
+	addons.LoadAddon(new BusAddon("ads1256", 1000, 100, ADDON_PRIORITY_NORMAL, legacy), CORE0_INPUT);
+	addons.LoadAddon(new BusAddon("slowSensor", 20000, 600, ADDON_PRIORITY_LOW, legacy), CORE0_INPUT);
+
+	// every poll is due after setup, GP2040::getBootAction runs them all once before the first pass
+	addons.PollAddons(CORE0_INPUT, UINT32_MAX);
+
+	RunResult result;
+	for (uint8_t i = 0; i < addons.GetAddonCount(); i++) {
+		BusAddon* bus = dynamic_cast<BusAddon*>(addons.GetAddonBlock(i).ptr);
+		if (bus != nullptr && bus->costUs > result.maxCostUs) result.maxCostUs = bus->costUs;
+	}
+
+	for (uint32_t pass = 0; pass < passes; pass++) {
+		uint32_t start = time_us_32();
+		busy_wait_us_32(BENCH_FAST_PATH_US / 2);
+		addons.PreprocessAddons(CORE0_INPUT);
+		busy_wait_us_32(BENCH_FAST_PATH_US / 2);
+		addons.ProcessAddons(CORE0_INPUT);
+		result.report.add(time_us_32() - start);
+
+		busy_wait_us_32(BENCH_TAIL_US);
+		uint32_t pollStart = time_us_32();
+		addons.PollAddons(CORE0_INPUT, budgetUs);
+		result.polls.add(time_us_32() - pollStart);
+		result.pass.add(time_us_32() - start);
+	}
+	return result;
+}
+
+static void printRun(const char* label, const RunResult& result) {
+	printf("%-9s  report us min/avg/max %4lu %4lu %4lu   pass us min/avg/max %4lu %4lu %4lu   polls max %4lu\n", label,
+		(unsigned long)result.report.min, (unsigned long)result.report.avg(), (unsigned long)result.report.max,
+		(unsigned long)result.pass.min, (unsigned long)result.pass.avg(), (unsigned long)result.pass.max,
+		(unsigned long)result.polls.max);
+}
+
+int main(int argc, char** argv) {
+	uint32_t passes = 200000;
+	uint32_t budgetUs = ADDON_POLL_BUDGET_US;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) passes = strtoul(argv[++i], nullptr, 0);
+		else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc) budgetUs = strtoul(argv[++i], nullptr, 0);
+		else {
+			fprintf(stderr, "usage: %s [--passes N] [--budget US]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	bool passed = true;
+
+	AddonManager legacyAddons;
+	RunResult legacy = run(legacyAddons, true, passes, budgetUs);
+	printRun("legacy", legacy);
+
+	AddonManager scheduledAddons;
+	RunResult scheduled = run(scheduledAddons, false, passes, budgetUs);
+	printRun("scheduled", scheduled);
+
+	printf("\n%-14s %7s %9s %8s %9s %8s %8s\n", "addon", "period", "polls", "deferred", "overruns", "max us", "max late");
+	for (uint8_t i = 0; i < scheduledAddons.GetAddonCount(); i++) {
+		const AddonBlock* block = &scheduledAddons.GetAddonBlock(i);
+		if (block->schedule.periodUs == 0) continue;
+		const char* name = ((BusAddon*)block->ptr)->addonName;
+		const AddonPollStats& stats = block->pollStats;
+		printf("%-14s %7lu %9lu %8lu %9lu %8lu %8lu\n", name, (unsigned long)block->schedule.periodUs,
+			(unsigned long)stats.polls, (unsigned long)stats.deferred, (unsigned long)stats.overruns,
+			(unsigned long)stats.maxUs, (unsigned long)stats.maxLateUs);
+
+		// none is left behind by the higher priority ones: at worst it waits out its period behind the others
+		// and then the longest poll that was already running
+		if (stats.polls == 0 || stats.maxLateUs >= block->schedule.periodUs + scheduled.maxCostUs) {
+			printf("FAIL %s polled %lu times, up to %lu us late\n", name, (unsigned long)stats.polls,
+				(unsigned long)stats.maxLateUs);
+			passed = false;
+		}
+	}
+
+	// the bus never reaches the part of the pass between sampling and the report
+	if (scheduled.report.max != scheduled.report.min) {
+		printf("FAIL report time moves between %lu and %lu us\n", (unsigned long)scheduled.report.min,
+			(unsigned long)scheduled.report.max);
+		passed = false;
+	}
+	uint32_t pollBound = budgetUs > scheduled.maxCostUs ? budgetUs : scheduled.maxCostUs;
+	if (scheduled.polls.max > pollBound) {
+		printf("FAIL a pass spent %lu us on polls, bound %lu us\n", (unsigned long)scheduled.polls.max, (unsigned long)pollBound);
+		passed = false;
+	}
+
+	printf("\n# addon scheduling check %s: report jitter %lu us (legacy %lu us), pass at most %lu us (legacy %lu us)\n",
+		passed ? "passed" : "FAILED", (unsigned long)(scheduled.report.max - scheduled.report.min),
+		(unsigned long)(legacy.report.max - legacy.report.min), (unsigned long)scheduled.pass.max, (unsigned long)legacy.pass.max);
+	return passed ? 0 : 1;
+}
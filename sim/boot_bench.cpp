@@ -0,0 +1,316 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Boot timing check
+//
+// Boots on the simulated clock the way main(), GP2040::setup, GP2040Aux::setup and the first passes of
+// GP2040::run do, marking the same BootTimer phases. Core0 runs the simulator's storage, gamepad, add-on and
+// driver setup, with a stand-in for the config load the simulator doesn't do; core1's display, LED and buzzer
+// add-ons are stand-ins taking the time given for their setup. The host starts taking reports once it
+// enumerated the device. Each boot runs in its own process so it starts from reset.
+//
+// Checks the phases add up to the time of the first report, that fast boot gets the first report out
+// earlier by the time core1's add-ons take to set up and sets them up afterwards, and that without a host
+// they are set up once the fast boot timeout is over. The display stand-in registers an event handler from core1
+// the way DisplayAddon does, with fast boot while core0 is already triggering that event every pass; checks every
+// event after it registered reaches it, on core1.
+//
+//   gp2040ce_boot_bench [--enum-us US] [--storage-us US]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "simhal.h"
+
+#include "addonmanager.h"
+#include "eventmanager.h"
+#include "boottimer.h"
+#include "drivermanager.h"
+#include "gamepad.h"
+#include "storagemanager.h"
+
+#include "addons/analog.h"
+#include "addons/dualdirectional.h"
+#include "addons/focus_mode.h"
+#include "addons/input_macro.h"
+#include "addons/reverse.h"
+#include "addons/rotaryencoder.h"
+#include "addons/slider_socd.h"
+#include "addons/tilt.h"
+#include "addons/turbo.h"
+
+#include "hardware/timer.h"
+#include "tusb.h"
+
+// Time of a pass of GP2040::run while booting
+#define BOOT_BENCH_LOOP_US 100
+
+// Passes run after the first report, or until the fast boot timeout without a host
+#define BOOT_BENCH_TAIL_PASSES 20
+
+// Profile changes handled by core1's stand-in, and those that ran on the wrong core
+static uint32_t coreOneEvents = 0;
+static uint32_t wrongCoreEvents = 0;
+
+// Sets up in the given time, like the core1 add-ons it stands in for
+class SetupAddon : public GPAddon {
+public:
+	SetupAddon(uint32_t setupUs, bool handlesEvents) : setupUs(setupUs), handlesEvents(handlesEvents) {}
+	virtual bool available() { return true; }
+	virtual void setup() {
+		busy_wait_us_32(setupUs);
+		if (handlesEvents) {
+			profileChangeHandler = EventManager::getInstance().registerEventHandler(GP_EVENT_PROFILE_CHANGE, [](GPEvent* event) {
+				if (get_core_num() == 1) coreOneEvents++;
+				else wrongCoreEvents++;
+			});
+		}
+	}
+	virtual void preprocess() {}
+	virtual void process() {}
+private:
+	uint32_t setupUs;
+	bool handlesEvents;
+	EventHandlerToken profileChangeHandler;
+};
+
+struct CoreOneAddon {
+	const char* name;
+	uint32_t setupUs;
+	bool handlesEvents;
+};
+
+// Stand-in setup times: the display's init and splash, LED strip and player LEDs, buzzer intro
+static const CoreOneAddon coreOneAddons[] = {
+	{ "Display", 45000, true },
+	{ "NeoPicoLED", 6000, false },
+	{ "PLED", 500, false },
+	{ "BuzzerSpeaker", 1500, false },
+};
+
+struct BootOptions {
+	uint32_t enumUs = 120000;
+	uint32_t storageUs = 20000;
+};
+
+struct BootResult {
+	BootTimes times;
+	bool recorded;
+	bool reportReceived;
+	uint8_t coreOneAddons;
+	uint32_t eventsAfterSetup;  // core0 triggered once core1's handler was registered
+	uint32_t coreOneEvents;
+	uint32_t wrongCoreEvents;
+};
+
+static uint32_t coreOneSetupUs() {
+	uint32_t total = 0;
+	for (const CoreOneAddon& addon : coreOneAddons) total += addon.setupUs;
+	return total;
+}
+
+static void setupCoreOne(AddonManager& addons) {
+	simCoreNum = 1;
+	for (const CoreOneAddon& addon : coreOneAddons) {
+		addons.LoadAddon(new SetupAddon(addon.setupUs, addon.handlesEvents), CORE1_LOOP);
+	}
+	simCoreNum = 0;
+}
+
+// One boot from reset, the same steps in the same order as on the device
+static BootResult boot(const BootOptions& options, bool fastBoot, bool host) {
+	BootTimer::start();
+
+	Storage::getInstance().init();
+	Storage::getInstance().getGamepadOptions().fastBoot = fastBoot;
+	busy_wait_us_32(options.storageUs); // reading the config from flash and migrating it
+	BootTimer::mark(BOOT_PHASE_STORAGE);
+	BootTimer::mark(BOOT_PHASE_PERIPHERALS);
+
+	Gamepad * gamepad = new Gamepad();
+	Gamepad * processedGamepad = new Gamepad();
+	Storage::getInstance().SetGamepad(gamepad);
+	Storage::getInstance().SetProcessedGamepad(processedGamepad);
+	Storage::getInstance().setFunctionalPinMappings();
+	gamepad->setup();
+	BootTimer::mark(BOOT_PHASE_GAMEPAD);
+
+	AddonManager addons;
+	addons.LoadAddon<AnalogInput>(CORE0_INPUT);
+	addons.LoadAddon<DualDirectionalInput>(CORE0_INPUT);
+	addons.LoadAddon<FocusModeAddon>(CORE0_INPUT);
+	addons.LoadAddon<SliderSOCDInput>(CORE0_INPUT);
+	addons.LoadAddon<TiltInput>(CORE0_INPUT);
+	addons.LoadAddon<RotaryEncoderInput>(CORE0_INPUT);
+	addons.LoadAddon<ReverseInput>(CORE0_INPUT);
+	addons.LoadAddon<TurboInput>(CORE0_INPUT);
+	addons.LoadAddon<InputMacro>(CORE0_INPUT);
+	BootTimer::mark(BOOT_PHASE_ADDONS);
+	BootTimer::mark(BOOT_PHASE_BOOT_ACTION);
+
+	DriverManager::getInstance().setup(Storage::getInstance().getGamepadOptions().inputMode);
+	GPDriver * inputDriver = DriverManager::getInstance().getDriver();
+	BootTimer::mark(BOOT_PHASE_DRIVER);
+
+	// core0 waits for GP2040Aux::setup, which only sets the add-ons up without fast boot
+	AddonManager coreOneAddons;
+	bool deferredSetup = Storage::getInstance().getGamepadOptions().fastBoot;
+	if (!deferredSetup) setupCoreOne(coreOneAddons);
+	BootTimer::mark(BOOT_PHASE_CORE1);
+
+	BootResult result = { };
+	bool hostReady = false;
+	if (host) {
+		SimHal::schedule(SimHal::now() + options.enumUs, [&hostReady, &result]() {
+			hostReady = true;
+			SimHal::startHost(1000, 0, [&result](uint64_t time, const uint8_t* report, uint16_t len) { result.reportReceived = true; });
+		});
+	}
+
+	// GP2040::run and GP2040Aux::run side by side, core1's deferred setup doesn't hold core0 up
+	uint32_t tailPasses = 0;
+	while (tailPasses < BOOT_BENCH_TAIL_PASSES) {
+		uint32_t passStart = time_us_32();
+		gamepad->read();
+		addons.PreprocessAddons(CORE0_INPUT);
+		gamepad->process();
+		addons.ProcessAddons(CORE0_INPUT);
+		inputDriver->process(gamepad);
+		if (!BootTimer::firstReportSent() && hostReady) BootTimer::firstReport();
+		EventManager::getInstance().triggerEvent(GPProfileChangeEvent(1, 1));
+		if (!deferredSetup) result.eventsAfterSetup++;
+
+		// GP2040Aux::run, between its passes
+		simCoreNum = 1;
+		EventManager::getInstance().processQueuedEvents();
+		simCoreNum = 0;
+
+		if (deferredSetup && BootTimer::deferredSetupDue()) {
+			uint32_t start = time_us_32();
+			setupCoreOne(coreOneAddons);
+			BootTimer::record(BOOT_PHASE_DEFERRED_ADDONS, start);
+			deferredSetup = false;
+		}
+
+		if (!deferredSetup && (BootTimer::firstReportSent() || !host)) tailPasses++;
+		uint32_t elapsed = time_us_32() - passStart;
+		if (elapsed < BOOT_BENCH_LOOP_US) busy_wait_us_32(BOOT_BENCH_LOOP_US - elapsed);
+	}
+
+	const BootTimes* lastBoot = BootTimer::getLastBootTimes();
+	result.recorded = lastBoot != nullptr;
+	memcpy(&result.times, lastBoot ? lastBoot : &BootTimer::getBootTimes(), sizeof(BootTimes));
+	result.coreOneAddons = coreOneAddons.GetAddonCount();
+	result.coreOneEvents = ::coreOneEvents;
+	result.wrongCoreEvents = ::wrongCoreEvents;
+	return result;
+}
+
+// Boots from reset in a child, the simulated clock and the singletons start over every time
+static bool bootFromReset(const BootOptions& options, bool fastBoot, bool host, BootResult& result) {
+	int fds[2];
+	if (pipe(fds) != 0) return false;
+	fflush(stdout);
+	pid_t pid = fork();
+	if (pid < 0) return false;
+	if (pid == 0) {
+		close(fds[0]);
+		BootResult childResult = boot(options, fastBoot, host);
+		bool written = write(fds[1], &childResult, sizeof(childResult)) == (ssize_t)sizeof(childResult);
+		_exit(written ? 0 : 1);
+	}
+
+	close(fds[1]);
+	bool read = ::read(fds[0], &result, sizeof(result)) == (ssize_t)sizeof(result);
+	close(fds[0]);
+	int status = 0;
+	waitpid(pid, &status, 0);
+	return read && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static void printBoot(const char* label, const BootResult& result) {
+	printf("%s\n", label);
+	for (uint8_t phase = 0; phase < BOOT_PHASE_COUNT; phase++) {
+		printf("  %-15s %8lu us  done at %8lu us\n", BootTimer::getPhaseName((BootPhase)phase),
+			(unsigned long)result.times.phaseUs[phase], (unsigned long)result.times.doneUs[phase]);
+	}
+}
+
+int main(int argc, char** argv) {
+	BootOptions options;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--enum-us") == 0 && i + 1 < argc) options.enumUs = strtoul(argv[++i], nullptr, 0);
+		else if (strcmp(argv[i], "--storage-us") == 0 && i + 1 < argc) options.storageUs = strtoul(argv[++i], nullptr, 0);
+		else {
+			fprintf(stderr, "usage: %s [--enum-us US] [--storage-us US]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	bool passed = true;
+	const uint8_t addonCount = sizeof(coreOneAddons) / sizeof(coreOneAddons[0]);
+	BootResult normal, fast, noHost;
+	if (!bootFromReset(options, false, true, normal) || !bootFromReset(options, true, true, fast) ||
+		!bootFromReset(options, true, false, noHost)) {
+		printf("FAIL a boot did not finish\n");
+		return 1;
+	}
+	printBoot("normal boot", normal);
+	printBoot("fast boot", fast);
+
+	// core0's phases follow each other without a gap, the first report ends the last of them
+	for (const BootResult* result : { &normal, &fast }) {
+		uint32_t sum = 0;
+		for (uint8_t phase = 0; phase <= BOOT_PHASE_FIRST_REPORT; phase++) sum += result->times.phaseUs[phase];
+		if (!result->recorded || !result->reportReceived || sum != result->times.doneUs[BOOT_PHASE_FIRST_REPORT]) {
+			printf("FAIL phases add up to %lu us, first report at %lu us\n", (unsigned long)sum,
+				(unsigned long)result->times.doneUs[BOOT_PHASE_FIRST_REPORT]);
+			passed = false;
+		}
+		if (result->coreOneAddons != addonCount) {
+			printf("FAIL %u of %u core1 add-ons set up\n", result->coreOneAddons, addonCount);
+			passed = false;
+		}
+	}
+
+	// core1's handler gets every event core0 triggered since it registered, late with fast boot or not, and only there
+	for (const BootResult* result : { &normal, &fast, &noHost }) {
+		if (result->coreOneEvents != result->eventsAfterSetup || result->wrongCoreEvents != 0) {
+			printf("FAIL core1 handled %lu of %lu events, %lu ran on core0\n", (unsigned long)result->coreOneEvents,
+				(unsigned long)result->eventsAfterSetup, (unsigned long)result->wrongCoreEvents);
+			passed = false;
+		}
+	}
+
+	// fast boot takes core1's add-on setup out of the way of the first report and does it right after
+	uint32_t saved = normal.times.doneUs[BOOT_PHASE_FIRST_REPORT] - fast.times.doneUs[BOOT_PHASE_FIRST_REPORT];
+	if (saved != coreOneSetupUs() || normal.times.doneUs[BOOT_PHASE_DEFERRED_ADDONS] != 0) {
+		printf("FAIL fast boot saved %lu us, core1 add-ons take %lu us\n", (unsigned long)saved, (unsigned long)coreOneSetupUs());
+		passed = false;
+	}
+	if (fast.times.phaseUs[BOOT_PHASE_DEFERRED_ADDONS] != coreOneSetupUs() ||
+		fast.times.doneUs[BOOT_PHASE_DEFERRED_ADDONS] - fast.times.phaseUs[BOOT_PHASE_DEFERRED_ADDONS] <
+		fast.times.doneUs[BOOT_PHASE_FIRST_REPORT]) {
+		printf("FAIL deferred add-ons set up at %lu us, first report at %lu us\n",
+			(unsigned long)fast.times.doneUs[BOOT_PHASE_DEFERRED_ADDONS], (unsigned long)fast.times.doneUs[BOOT_PHASE_FIRST_REPORT]);
+		passed = false;
+	}
+
+	// without a host nothing is kept for web config, the add-ons still come up after the timeout
+	uint32_t deferredStart = noHost.times.doneUs[BOOT_PHASE_DEFERRED_ADDONS] - noHost.times.phaseUs[BOOT_PHASE_DEFERRED_ADDONS];
+	if (noHost.recorded || noHost.coreOneAddons != addonCount || deferredStart < BOOT_DEFERRED_SETUP_TIMEOUT_MS * 1000 ||
+		deferredStart > BOOT_DEFERRED_SETUP_TIMEOUT_MS * 1000 + BOOT_BENCH_LOOP_US) {
+		printf("FAIL without a host %u add-ons set up at %lu us\n", noHost.coreOneAddons, (unsigned long)deferredStart);
+		passed = false;
+	}
+
+	printf("\n# boot check %s: first report at %lu us, %lu us with fast boot\n", passed ? "passed" : "FAILED",
+		(unsigned long)normal.times.doneUs[BOOT_PHASE_FIRST_REPORT], (unsigned long)fast.times.doneUs[BOOT_PHASE_FIRST_REPORT]);
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Config load check and benchmark
+//
+// Saves configs through FlashPROM the way ConfigUtils::save does, every field present, and times the parts of
+// ConfigUtils::load that build on the host: decoding the config FlashPROM replayed on start, and the save at the
+// end of load that encodes it again only to find nothing changed. A config stamped with the current schema stops
+// after the decode. The legacy config scan, initUnsetPropertiesWithDefaults and the migrations are skipped as well;
+// they need the firmware's dependencies and come on top of what is measured here. Checks the stamp survives a save
+// and load round trip unchanged and that saving the loaded config writes nothing.
+//
+//   gp2040ce_config_bench [--loads N]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+
+#include "FlashPROM.h"
+#include "simconfig.h"
+#include "simhal.h"
+#include "storagemanager.h"
+
+// Same as ConfigUtils, the stamp it writes
+#define BENCH_SCHEMA_VERSION 1
+#define BENCH_BOARD_VERSION "v0.0.0-sim"
+
+static Config config;
+
+static bool isCurrentSchema(const Config& source) {
+	return source.migrations.schemaVersion == BENCH_SCHEMA_VERSION && source.migrations.schemaSize == Config_size &&
+		strncmp(source.boardVersion, BENCH_BOARD_VERSION, sizeof(source.boardVersion)) == 0;
+}
+
+// Save to a fresh flash and boot from it
+static void store(Config& source) {
+	SimHal::eraseFlash();
+	EEPROM.start();
+	SimConfig::save(source);
+	EEPROM.flush();
+	EEPROM.start();
+}
+
+struct LoadResult {
+	uint32_t size = 0;
+	double fullUs = 0;      // decode, then the save check at the end of a full load
+	double stampedUs = 0;   // decode and the stamp check
+	bool passed = true;
+};
+
+static LoadResult measure(Config& source, uint32_t loads) {
+	LoadResult result;
+	strncpy(source.boardVersion, BENCH_BOARD_VERSION, sizeof(source.boardVersion));
+	source.migrations.schemaVersion = BENCH_SCHEMA_VERSION;
+	source.migrations.schemaSize = Config_size;
+	store(source);
+	result.size = EEPROM.size();
+
+	// the stamp is saved with the config and read back the same, and a save of what was loaded changes nothing
+	SimHal::resetFlashStats();
+	if (!SimConfig::load(config) || !isCurrentSchema(config) || !SimConfig::save(config)) {
+		printf("FAIL config of %lu bytes does not load back as saved\n", (unsigned long)result.size);
+		result.passed = false;
+	}
+	EEPROM.flush();
+	if (SimHal::flashStats().pagesProgrammed != 0) {
+		printf("FAIL saving the loaded config of %lu bytes wrote to flash\n", (unsigned long)result.size);
+		result.passed = false;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < loads; i++) {
+		SimConfig::load(config);
+		SimConfig::save(config);
+	}
+	auto end = std::chrono::steady_clock::now();
+	result.fullUs = std::chrono::duration<double>(end - start).count() * 1e6 / loads;
+
+	uint32_t current = 0;
+	start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < loads; i++) {
+		if (SimConfig::load(config) && isCurrentSchema(config)) current++;
+	}
+	end = std::chrono::steady_clock::now();
+	result.stampedUs = std::chrono::duration<double>(end - start).count() * 1e6 / loads;
+	if (current != loads) result.passed = false;
+
+	// an older stamp takes the full path
+	source.migrations.schemaVersion = BENCH_SCHEMA_VERSION - 1;
+	store(source);
+	if (!SimConfig::load(config) || isCurrentSchema(config)) {
+		printf("FAIL config with an older schema is taken as current\n");
+		result.passed = false;
+	}
+	return result;
+}
+
+static void printResult(const char* label, const LoadResult& result) {
+	printf("%-9s %5lu bytes   full load %7.1f us   stamped %7.1f us   %.2fx\n", label, (unsigned long)result.size,
+		result.fullUs, result.stampedUs, result.fullUs / result.stampedUs);
+}
+
+int main(int argc, char** argv) {
+	uint32_t loads = 2000;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--loads") == 0 && i + 1 < argc) loads = strtoul(argv[++i], nullptr, 0);
+		else {
+			fprintf(stderr, "usage: %s [--loads N]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (loads == 0) loads = 1;
+
+	bool passed = true;
+	static Config source;
+
+	SimHal::initFlash();
+
+	Storage::getInstance().init();
+	source = Storage::getInstance().getConfig();
+	LoadResult defaults = measure(source, loads);
+	printResult("defaults", defaults);
+	passed = passed && defaults.passed;
+
+	source = Storage::getInstance().getConfig();
+	SimConfig::fillProfilesAndMacros(source);
+	LoadResult full = measure(source, loads);
+	printResult("profiles", full);
+	passed = passed && full.passed;
+
+	printf("\n# config load check %s: stamped load %.2fx faster with defaults, %.2fx with every profile and macro\n",
+		passed ? "passed" : "FAILED", defaults.fullUs / defaults.stampedUs, full.fullUs / full.stampedUs);
+	return passed ? 0 : 1;
+}
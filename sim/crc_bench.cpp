@@ -0,0 +1,194 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// CRC32 engine check and benchmark
+//
+// Checks the engine CRC32 was built with against the nibble table it replaced: the standard check value, random
+// data of every length up to a few pages at every alignment, the same data fed in random pieces, the footer of a
+// config saved in the format before the FlashPROM log and the records the log writes. Then times both over 32 KB
+// buffers, the size of the FlashPROM block, aligned and not. The DMA sniffer engine only builds for the RP2040,
+// the host build takes the tables.
+//
+//   gp2040ce_crc_bench [--passes N] [--seed S]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+
+#include "CRC32.h"
+#include "FlashPROM.h"
+#include "simconfig.h"
+#include "simhal.h"
+#include "storagemanager.h"
+
+#define BENCH_BUFFER_SIZE 0x8000
+
+// The engine before, one byte as two lookups in a 16 entry table
+static const uint32_t nibbleTable[] = {
+	0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac,
+	0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+	0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c,
+	0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c
+};
+
+static uint32_t nibbleCrc(const uint8_t* data, uint32_t size) {
+	uint32_t state = ~0u;
+	for (uint32_t i = 0; i < size; i++) {
+		state = nibbleTable[(state ^ data[i]) & 0x0f] ^ (state >> 4);
+		state = nibbleTable[(state ^ (data[i] >> 4)) & 0x0f] ^ (state >> 4);
+	}
+	return ~state;
+}
+
+// Footer of the format before the log, see config_utils.cpp
+struct ConfigFooter {
+	uint32_t dataSize;
+	uint32_t dataCrc;
+	uint32_t magic;
+};
+
+static uint8_t buffer[BENCH_BUFFER_SIZE + 8];
+static uint32_t seed = 1;
+
+static uint32_t random32() {
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+
+static uint32_t pieceCrc(const uint8_t* data, uint32_t size) {
+	CRC32 crc;
+	while (size > 0) {
+		uint32_t piece = random32() % 67;
+		if (piece > size) piece = size;
+		if (piece == 1) crc.update(*data);
+		else crc.update(data, piece);
+		data += piece;
+		size -= piece;
+	}
+	return crc.finalize();
+}
+
+static bool checkData() {
+	bool passed = true;
+	if (CRC32::calculate((const uint8_t*)"123456789", 9) != 0xcbf43926) {
+		printf("FAIL check value of \"123456789\" is %08lx\n", (unsigned long)CRC32::calculate((const uint8_t*)"123456789", 9));
+		passed = false;
+	}
+
+	for (uint32_t i = 0; i < sizeof(buffer); i++) buffer[i] = random32();
+	uint32_t mismatches = 0;
+	for (uint32_t size = 0; size <= 4 * FLASH_PAGE_SIZE; size++) {
+		for (uint32_t align = 0; align < 8; align++) {
+			const uint32_t expected = nibbleCrc(buffer + align, size);
+			if (CRC32::calculate(buffer + align, size) != expected || pieceCrc(buffer + align, size) != expected) {
+				if (mismatches++ < 4)
+					printf("FAIL CRC of %lu bytes at offset %lu differs from the nibble table\n", (unsigned long)size,
+						(unsigned long)align);
+			}
+		}
+	}
+	if (CRC32::calculate(buffer, BENCH_BUFFER_SIZE) != nibbleCrc(buffer, BENCH_BUFFER_SIZE)) mismatches++;
+
+	// a type wider than a byte is checksummed as its bytes
+	static AnimationOptions animationOptions;
+	memcpy(&animationOptions, buffer, sizeof(animationOptions));
+	if (CRC32::calculate(&animationOptions) != nibbleCrc((const uint8_t*)&animationOptions, sizeof(animationOptions)))
+		mismatches++;
+	return passed && mismatches == 0;
+}
+
+// A footer written by the nibble table has to check out, and so do the records the log wrote with it
+static bool checkFooters() {
+	static Config config;
+	Storage::getInstance().init();
+	config = Storage::getInstance().getConfig();
+	SimConfig::fillProfilesAndMacros(config);
+
+	ConfigFooter footer;
+	footer.dataSize = SimConfig::encode(config, buffer, BENCH_BUFFER_SIZE - sizeof(footer));
+	footer.dataCrc = nibbleCrc(buffer, footer.dataSize);
+	bool passed = CRC32::calculate(buffer, footer.dataSize) == footer.dataCrc;
+	if (!passed) printf("FAIL footer of a %lu byte config does not check out\n", (unsigned long)footer.dataSize);
+
+	SimHal::initFlash();
+	SimHal::eraseFlash();
+	EEPROM.start();
+	for (uint32_t i = 0; i < 8; i++) {
+		config.animationOptions.brightness = i;
+		SimConfig::save(config);
+		EEPROM.flush();
+	}
+	const uint8_t* flashStart = reinterpret_cast<const uint8_t*>(EEPROM_ADDRESS_START);
+	uint32_t records = 0;
+	for (uint32_t page = 0; page < EEPROM_PAGE_COUNT; page++) {
+		const FlashRecordHeader* header = reinterpret_cast<const FlashRecordHeader*>(flashStart + page * FLASH_PAGE_SIZE);
+		if (header->magic != EEPROM_RECORD_MAGIC) continue;
+		memcpy(buffer, header, offsetof(FlashRecordHeader, crc));
+		memcpy(buffer + offsetof(FlashRecordHeader, crc), header + 1, header->dataSize);
+		if (nibbleCrc(buffer, offsetof(FlashRecordHeader, crc) + header->dataSize) != header->crc) {
+			printf("FAIL FlashPROM record %lu does not check out with the nibble table\n", (unsigned long)header->sequence);
+			passed = false;
+		}
+		records++;
+	}
+	return passed && records == 8;
+}
+
+struct Timing {
+	double nibbleUs = 0;
+	double engineUs = 0;
+};
+
+static Timing measure(uint32_t align, uint32_t passes) {
+	Timing timing;
+	volatile uint32_t sink = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < passes; i++) sink = sink + nibbleCrc(buffer + align, BENCH_BUFFER_SIZE);
+	auto end = std::chrono::steady_clock::now();
+	timing.nibbleUs = std::chrono::duration<double>(end - start).count() * 1e6 / passes;
+
+	start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < passes; i++) sink = sink + CRC32::calculate(buffer + align, BENCH_BUFFER_SIZE);
+	end = std::chrono::steady_clock::now();
+	timing.engineUs = std::chrono::duration<double>(end - start).count() * 1e6 / passes;
+	return timing;
+}
+
+static void printTiming(const char* label, const Timing& timing) {
+	printf("%-9s 32 KB   nibble table %8.1f us %7.1f MB/s   engine %7.1f us %7.1f MB/s   %.1fx\n", label,
+		timing.nibbleUs, BENCH_BUFFER_SIZE / timing.nibbleUs, timing.engineUs, BENCH_BUFFER_SIZE / timing.engineUs,
+		timing.nibbleUs / timing.engineUs);
+}
+
+int main(int argc, char** argv) {
+	uint32_t passes = 200;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) passes = strtoul(argv[++i], nullptr, 0);
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoul(argv[++i], nullptr, 0) | 1;
+		else {
+			fprintf(stderr, "usage: %s [--passes N] [--seed S]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (passes == 0) passes = 1;
+
+	bool passed = checkData();
+	passed = checkFooters() && passed;
+
+	for (uint32_t i = 0; i < sizeof(buffer); i++) buffer[i] = random32();
+	Timing aligned = measure(0, passes);
+	printTiming("aligned", aligned);
+	Timing unaligned = measure(3, passes);
+	printTiming("unaligned", unaligned);
+
+	printf("\n# crc32 check %s: same checksums as the nibble table, %.1fx faster over 32 KB\n",
+		passed ? "passed" : "FAILED", aligned.nibbleUs / aligned.engineUs);
+	return passed ? 0 : 1;
+}
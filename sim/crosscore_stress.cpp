@@ -0,0 +1,417 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Core0/core1 channel stress test
+//
+// Runs a thread per core, spinning threads yield so it also gets through on a single CPU. Pushes numbered items
+// through SPSCQueue, hammers a SeqLock with writes while the other thread reads it, publishes processed gamepad
+// states and aux states through Storage while core1 reads them back the way the LED, rumble and display add-ons
+// do, and sends input frames from core0 to a handler registered on core1 through EventManager while core1 sends
+// save requests back, and has core1 register and release handlers while core0 dispatches the same event type to
+// its own. Every item, snapshot and event carries its number in all of its words, so a torn read or a lost or
+// reordered item shows up as a mismatch.
+//
+//   gp2040ce_crosscore_stress [--items N]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <thread>
+
+#include "eventmanager.h"
+#include "seqlock.h"
+#include "spscqueue.h"
+#include "storagemanager.h"
+
+#include "pico/platform.h"
+
+#define STRESS_WORDS 15
+
+static std::atomic<bool> passed{true};
+
+static void fail(const char* what, uint32_t expected, uint32_t got) {
+	if (passed.exchange(false)) printf("FAIL %s: expected %lu, got %lu\n", what, (unsigned long)expected, (unsigned long)got);
+}
+
+struct StressItem {
+	uint32_t number;
+	uint32_t words[STRESS_WORDS];
+
+	void fill(uint32_t n) {
+		number = n;
+		for (uint32_t i = 0; i < STRESS_WORDS; i++) words[i] = n * (i + 1);
+	}
+
+	bool intact() const {
+		for (uint32_t i = 0; i < STRESS_WORDS; i++) {
+			if (words[i] != number * (i + 1)) return false;
+		}
+		return true;
+	}
+};
+
+// Items come out whole and in order, none lost, the producer never waits on anything but a full ring
+static void stressQueue(uint32_t items) {
+	static SPSCQueue<StressItem, 16> queue;
+	uint32_t full = 0;
+
+	std::thread producer([&]() {
+		simCoreNum = 0;
+		for (uint32_t n = 1; n <= items; n++) {
+			StressItem item;
+			item.fill(n);
+			while (!queue.push(item)) {
+				full++;
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	std::thread consumer([&]() {
+		simCoreNum = 1;
+		uint32_t expected = 1;
+		StressItem item;
+		while (expected <= items) {
+			if (!queue.pop(item)) {
+				std::this_thread::yield();
+				continue;
+			}
+			if (item.number != expected) fail("queue order", expected, item.number);
+			if (!item.intact()) fail("queue item torn", item.number, item.words[STRESS_WORDS - 1]);
+			expected++;
+		}
+	});
+
+	producer.join();
+	consumer.join();
+	if (!queue.empty()) fail("queue left over", 0, queue.size());
+	printf("queue %lu items, producer found the ring full %lu times\n", (unsigned long)items, (unsigned long)full);
+}
+
+// Snapshots are never torn, never go back in time, and match the version they are read with
+static void stressSeqLock(uint32_t writes) {
+	static SeqLock<StressItem> snapshot;
+	std::atomic<bool> done{false};
+	uint32_t reads = 0, changes = 0;
+
+	std::thread writer([&]() {
+		simCoreNum = 0;
+		StressItem item;
+		for (uint32_t n = 1; n <= writes; n++) {
+			item.fill(n);
+			snapshot.write(item);
+			if ((n & 0xF) == 0) std::this_thread::yield();
+		}
+		done.store(true);
+	});
+
+	std::thread reader([&]() {
+		simCoreNum = 1;
+		uint32_t last = 0;
+		StressItem item;
+		while (!done.load()) {
+			uint32_t version = snapshot.read(item);
+			reads++;
+			if (version & 1) fail("seqlock odd version", version + 1, version);
+			if (!item.intact()) fail("seqlock snapshot torn", item.number, item.words[STRESS_WORDS - 1]);
+			if (item.number != version / 2) fail("seqlock version", version / 2, item.number);
+			if (item.number < last) fail("seqlock went back", last, item.number);
+			if (item.number != last) changes++;
+			last = item.number;
+			std::this_thread::yield();
+		}
+	});
+
+	writer.join();
+	reader.join();
+	if (snapshot.read().number != writes) fail("seqlock last write", writes, snapshot.read().number);
+	printf("seqlock %lu writes, %lu reads saw %lu of them\n", (unsigned long)writes, (unsigned long)reads, (unsigned long)changes);
+}
+
+static void fillState(GamepadState& state, uint32_t n) {
+	state.buttons = n;
+	state.dpad = n & GAMEPAD_MASK_DPAD;
+	state.aux = ~n;
+	state.lx = n;
+	state.ly = ~n;
+	state.rx = n >> 16;
+	state.ry = ~n >> 16;
+	state.lt = n;
+	state.rt = ~n;
+	state.ema_1_x = state.ema_2_x = state.lx;
+	state.ema_1_y = state.ema_2_y = state.ly;
+}
+
+// Processed states core0 publishes are never torn or older than the last one read, and a reader that skips
+// while the version stands still misses nothing but repeats of the state it already has
+static void stressProcessedState(uint32_t passes) {
+	Storage& storage = Storage::getInstance();
+	std::atomic<bool> core1Ready{false};
+	std::atomic<bool> done{false};
+	uint32_t published = 0, reads = 0, skipped = 0;
+
+	std::thread core0([&]() {
+		simCoreNum = 0;
+		GamepadState state;
+		while (!core1Ready.load()) std::this_thread::yield();
+		for (uint32_t n = 1; n <= passes; n++) {
+			if ((n & 0xF) == 0) std::this_thread::yield();
+			// a pass that changed nothing publishes nothing, like GP2040::run
+			if ((n & 3) == 0) continue;
+			fillState(state, n);
+			storage.publishProcessedState(state);
+			published++;
+		}
+		done.store(true);
+	});
+
+	std::thread core1([&]() {
+		simCoreNum = 1;
+		uint32_t version = storage.getProcessedStateVersion();
+		uint32_t last = 0;
+		GamepadState state, expected;
+		core1Ready.store(true);
+		while (!done.load()) {
+			if (storage.getProcessedStateVersion() == version) {
+				skipped++;
+				std::this_thread::yield();
+				continue;
+			}
+			uint32_t read = storage.readProcessedState(state);
+			reads++;
+			if (read <= version) fail("processed state version", version + 2, read);
+			fillState(expected, state.buttons);
+			if (memcmp(&state, &expected, sizeof(GamepadState)) != 0) fail("processed state torn", state.buttons, state.lx);
+			if (state.buttons <= last) fail("processed state went back", last + 1, state.buttons);
+			version = read;
+			last = state.buttons;
+			std::this_thread::yield();
+		}
+	});
+
+	core0.join();
+	core1.join();
+	GamepadState state;
+	storage.readProcessedState(state);
+	uint32_t lastPublished = (passes & 3) == 0 ? passes - 1 : passes;
+	if (state.buttons != lastPublished) fail("processed state last publish", lastPublished, state.buttons);
+	printf("processed state %lu published, %lu reads, %lu skipped on an unchanged version\n", (unsigned long)published,
+		(unsigned long)reads, (unsigned long)skipped);
+}
+
+static void fillAuxState(GamepadAuxState& auxState, uint32_t n) {
+	auxState.playerID.value = n;
+	auxState.playerID.ledValue = n * 3;
+	auxState.playerID.ledBlinkOn = n * 5;
+	auxState.playerID.ledBlinkOff = ~n;
+	auxState.sensors.statusLight.color.red = n;
+	auxState.sensors.statusLight.color.green = n >> 8;
+	auxState.sensors.statusLight.color.blue = n >> 16;
+	auxState.haptics.leftActuator.intensity = n;
+	auxState.haptics.rightActuator.intensity = ~n;
+}
+
+// Aux states core0 publishes reach core1 whole, a pass that changed nothing leaves the version alone, and the
+// parts core1 asks for are enabled by core0's next publish without core1 writing the aux state itself
+static void stressProcessedAuxState(uint32_t passes) {
+	Storage& storage = Storage::getInstance();
+	std::atomic<bool> core1Ready{false};
+	std::atomic<bool> done{false};
+	uint32_t published = 0, versions = 0, reads = 0;
+
+	std::thread core0([&]() {
+		simCoreNum = 0;
+		GamepadAuxState auxState;
+		while (!core1Ready.load()) std::this_thread::yield();
+		for (uint32_t n = 1; n <= passes; n++) {
+			if ((n & 0xF) == 0) std::this_thread::yield();
+			if ((n & 3) != 0) {
+				fillAuxState(auxState, n);
+				published++;
+			}
+			uint32_t version = storage.getProcessedAuxStateVersion();
+			storage.publishProcessedAuxState(auxState);
+			if (storage.getProcessedAuxStateVersion() != version) versions++;
+		}
+		done.store(true);
+	});
+
+	std::thread core1([&]() {
+		simCoreNum = 1;
+		uint32_t version = storage.getProcessedAuxStateVersion();
+		uint32_t last = 0;
+		GamepadAuxState auxState, expected;
+		core1Ready.store(true);
+		storage.requestProcessedAux(PROCESSED_AUX_PLAYER_ID | PROCESSED_AUX_STATUS_LIGHT);
+		while (!done.load()) {
+			if (storage.getProcessedAuxStateVersion() == version) {
+				std::this_thread::yield();
+				continue;
+			}
+			uint32_t read = storage.readProcessedAuxState(auxState);
+			// the rumble add-on sets up later than the LEDs, with deferred setup core0 is running by then
+			if (reads++ == 100) storage.requestProcessedAux(PROCESSED_AUX_LEFT_ACTUATOR | PROCESSED_AUX_RIGHT_ACTUATOR);
+			if (read <= version) fail("aux state version", version + 2, read);
+			uint32_t n = auxState.playerID.value;
+			expected = auxState;
+			fillAuxState(expected, n);
+			if (memcmp(&auxState, &expected, sizeof(GamepadAuxState)) != 0) fail("aux state torn", n, auxState.playerID.ledBlinkOff);
+			if (n < last) fail("aux state went back", last, n);
+			version = read;
+			last = n;
+			std::this_thread::yield();
+		}
+	});
+
+	core0.join();
+	core1.join();
+	GamepadAuxState auxState;
+	storage.readProcessedAuxState(auxState);
+	uint32_t lastPublished = (passes & 3) == 0 ? passes - 1 : passes;
+	if (auxState.playerID.value != lastPublished) fail("aux state last publish", lastPublished, auxState.playerID.value);
+	if (!auxState.playerID.enabled || !auxState.sensors.statusLight.enabled) fail("aux LED parts enabled", 1, 0);
+	if (reads > 100 && !(auxState.haptics.leftActuator.enabled && auxState.haptics.rightActuator.enabled))
+		fail("aux actuators enabled", 1, 0);
+	// one extra version for each request that landed on a pass that changed nothing
+	if (versions > published + 2) fail("aux state versions", published + 2, versions);
+	printf("aux state %lu changes, %lu versions, %lu reads\n", (unsigned long)published, (unsigned long)versions,
+		(unsigned long)reads);
+}
+
+// Input frames from core0 reach the handler core1 registered in order and whole, save requests from core1
+// reach the handler core0 registered, each runs on the core that registered it
+static void stressEvents(uint32_t frames) {
+	EventManager& manager = EventManager::getInstance();
+	manager.clearEventHandlers();
+
+	std::atomic<bool> core1Ready{false};
+	std::atomic<bool> core0Done{false};
+	std::atomic<uint32_t> saveRequests{0};
+	uint32_t received = 0, savesHandled = 0;
+
+	std::thread core1([&]() {
+		simCoreNum = 1;
+		uint32_t last = 0;
+		EventHandlerToken inputFrameHandler = manager.registerEventHandler(GP_EVENT_INPUT_FRAME, [&](GPEvent* event) {
+			GPInputFrameEvent* frame = (GPInputFrameEvent*)event;
+			if (get_core_num() != 1) fail("input frame handler core", 1, get_core_num());
+			if (frame->state.buttons <= last) fail("input frame order", last + 1, frame->state.buttons);
+			if (frame->state.aux != (uint16_t)~frame->state.buttons || frame->rawPressed.buttons != frame->state.buttons)
+				fail("input frame torn", frame->state.buttons, frame->rawPressed.buttons);
+			last = frame->state.buttons;
+			if ((++received & 0xFF) == 0) {
+				saveRequests++;
+				EventManager::getInstance().triggerEvent(GPStorageSaveEvent(true));
+			}
+		}, INPUT_FRAME_RAW_PRESSED);
+		core1Ready.store(true);
+
+		while (!core0Done.load()) {
+			manager.processQueuedEvents();
+			std::this_thread::yield();
+		}
+		manager.processQueuedEvents();
+	});
+
+	simCoreNum = 0;
+	while (!core1Ready.load()) std::this_thread::yield();
+	EventHandlerToken storageSaveHandler = manager.registerEventHandler(GP_EVENT_STORAGE_SAVE, [&](GPEvent* event) {
+		if (get_core_num() != 0) fail("save handler core", 0, get_core_num());
+		savesHandled++;
+	});
+
+	for (uint32_t n = 1; n <= frames; n++) {
+		GamepadState previous, current;
+		current.buttons = n;
+		current.aux = ~n;
+		GPInputFrameEvent frame;
+		frame.setRaw(previous, current);
+		frame.setProcessed(previous, current);
+		manager.triggerEvent(frame);
+		if ((n & 0xF) == 0) {
+			manager.processQueuedEvents();
+			std::this_thread::yield();
+		}
+	}
+	core0Done.store(true);
+	core1.join();
+	manager.processQueuedEvents();
+
+	uint32_t dropped = manager.getDroppedEvents(1);
+	if (received + dropped != frames) fail("input frames received and dropped", frames, received + dropped);
+	if (savesHandled + manager.getDroppedEvents(0) != saveRequests.load())
+		fail("save requests handled", saveRequests.load(), savesHandled);
+	printf("events %lu input frames, %lu received, %lu dropped, %lu of %lu save requests handled\n", (unsigned long)frames,
+		(unsigned long)received, (unsigned long)dropped, (unsigned long)savesHandled, (unsigned long)saveRequests.load());
+}
+
+// Core1 registers and releases handlers of an event type over and over, the way the display add-on does once
+// fast boot set it up late, while core0 triggers that event for a handler of its own. Core0 only ever calls its
+// own handler and core1 only its own.
+static void stressRegistration(uint32_t events) {
+	EventManager& manager = EventManager::getInstance();
+	manager.clearEventHandlers();
+
+	std::atomic<bool> core0Done{false};
+	std::atomic<uint32_t> registrations{0};
+
+	std::thread core1([&]() {
+		simCoreNum = 1;
+		while (!core0Done.load()) {
+			EventHandlerToken tokens[EVENTMGR_MAX_HANDLERS];
+			for (uint8_t slot = 0; slot < EVENTMGR_MAX_HANDLERS; slot++) {
+				tokens[slot] = manager.registerEventHandler(GP_EVENT_ENCODER_CHANGE, [](GPEvent* event) {
+					if (get_core_num() != 1) fail("core1 encoder handler core", 1, get_core_num());
+				});
+				if (!tokens[slot].isRegistered()) fail("core1 encoder handler slot", slot, EVENTMGR_MAX_HANDLERS);
+			}
+			registrations += EVENTMGR_MAX_HANDLERS;
+			manager.processQueuedEvents();
+			std::this_thread::yield();
+		}
+		manager.processQueuedEvents();
+	});
+
+	simCoreNum = 0;
+	uint32_t handled = 0;
+	EventHandlerToken encoderHandler = manager.registerEventHandler(GP_EVENT_ENCODER_CHANGE, [&](GPEvent* event) {
+		if (get_core_num() != 0) fail("core0 encoder handler core", 0, get_core_num());
+		handled++;
+	});
+	for (uint32_t n = 1; n <= events; n++) {
+		manager.triggerEvent(GPEncoderChangeEvent(0, 1));
+		if ((n & 0xFF) == 0) std::this_thread::yield();
+	}
+	core0Done.store(true);
+	core1.join();
+
+	if (handled != events) fail("core0 encoder events handled", events, handled);
+	printf("registration %lu core1 handlers registered and released while core0 dispatched %lu events to its own\n",
+		(unsigned long)registrations.load(), (unsigned long)events);
+}
+
+int main(int argc, char** argv) {
+	uint32_t items = 2000000;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--items") == 0 && i + 1 < argc) items = strtoul(argv[++i], nullptr, 0);
+		else {
+			fprintf(stderr, "usage: %s [--items N]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	stressQueue(items);
+	stressSeqLock(items);
+	stressProcessedState(items);
+	stressProcessedAuxState(items);
+	stressEvents(items / 4);
+	stressRegistration(items / 4);
+
+	printf("# crosscore check %s: no torn, lost or reordered items\n", passed.load() ? "passed" : "FAILED");
+	return passed.load() ? 0 : 1;
+}
@@ -0,0 +1,393 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// GPIO debounce check and benchmark
+//
+// Feeds random button traces, mashing with contact bounce at several loop rates and debounce delays, through
+// GpioDebouncer and through a copy of the per-pin timestamp loop it replaced, both behind the same early out
+// GpioInput::debounceGpioGetAll takes, and checks they give the same debounced mask on every pass. Then times a
+// pass of each over a trace of 24 buttons being mashed.
+//
+// Then replays contact bounce traces, presses and releases that bounce the way switches do plus chatter while
+// held, on pins in eager press mode next to pins in standard mode. Eager pins have to report the press on the
+// first sample the pin reads pressed, hold the release for more than the debounce delay after the last bounce
+// and never report the chatter. Standard pins have to debounce as they do without eager pins next to them.
+//
+//   gp2040ce_debounce_bench [--seed N] [--passes N]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <vector>
+
+#include "gpiodebouncer.h"
+#include "pico/platform.h"
+#include "types.h"
+
+static uint32_t rngState = 1;
+
+static uint32_t nextRandom() {
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 17;
+	rngState ^= rngState << 5;
+	return rngState;
+}
+
+// One loop pass: the ms clock and the active low GPIO sample NOTed, as debounceGpioGetAll sees them
+struct Sample {
+	uint32_t millis;
+	Mask_t raw;
+};
+
+struct TraceOptions {
+	uint32_t passesPerMs;       // loop passes in a ms, 0 for a pass every few ms
+	uint32_t pressChance;       // 1 in N chance a button changes state in a ms
+	uint32_t bounceMs;          // longest contact bounce after a change
+	uint32_t startMillis;
+};
+
+// Buttons on the watched pins that get pressed and released at random and bounce for a while after each change,
+// with the odd stall of the loop. The other pins float.
+static std::vector<Sample> randomTrace(uint32_t length, Mask_t watched, const TraceOptions& options) {
+	std::vector<Sample> trace;
+	uint32_t bounceUntil[NUM_BANK0_GPIOS] = {};
+	Mask_t held = 0;
+	Mask_t raw = 0;
+	uint32_t millis = options.startMillis;
+	while (trace.size() < length) {
+		if ((nextRandom() & 0xFF) == 0) millis += nextRandom() % 40; // something held the loop up
+
+		for (Pin_t pin = 0; pin < (Pin_t)NUM_BANK0_GPIOS; pin++) {
+			Mask_t pinMask = 1 << pin;
+			if (!(watched & pinMask)) {
+				if ((nextRandom() & 0x3F) == 0) raw ^= pinMask;
+				continue;
+			}
+			if (nextRandom() % options.pressChance == 0) {
+				held ^= pinMask;
+				bounceUntil[pin] = millis + (options.bounceMs ? nextRandom() % (options.bounceMs + 1) : 0);
+			}
+		}
+
+		uint32_t passes = options.passesPerMs ? options.passesPerMs : 1;
+		for (uint32_t pass = 0; pass < passes && trace.size() < length; pass++) {
+			Mask_t bouncing = 0;
+			for (Pin_t pin = 0; pin < (Pin_t)NUM_BANK0_GPIOS; pin++) {
+				if ((watched & (1 << pin)) && (int32_t)(bounceUntil[pin] - millis) > 0) bouncing |= 1 << pin;
+			}
+			raw = (raw & ~watched) | (held & ~bouncing) | (nextRandom() & bouncing);
+			trace.push_back({ millis, raw });
+		}
+		millis += options.passesPerMs ? 1 : 1 + nextRandom() % 4;
+	}
+	return trace;
+}
+
+// Same as GP2040::debounceGpioGetAll before GpioDebouncer, the reference it is checked against
+struct LegacyDebouncer {
+	uint32_t gpioDebounceTime[NUM_BANK0_GPIOS] = {};
+
+	void debounce(Mask_t& debouncedGpio, Mask_t raw_gpio, Mask_t buttonGpios, uint32_t now, uint32_t debounceDelay) {
+		// return if state isn't different than the actual
+		if (debouncedGpio == (raw_gpio & buttonGpios)) return;
+
+		// check each button use case GPIO for state
+		for (Pin_t pin = 0; pin < (Pin_t)NUM_BANK0_GPIOS; pin++) {
+			Mask_t pin_mask = 1 << pin;
+			if (buttonGpios & pin_mask) {
+				// Allow debouncer to change state if button state changed and debounce delay threshold met
+				if ((debouncedGpio & pin_mask) != \
+						(raw_gpio & pin_mask) && ((now - gpioDebounceTime[pin]) > debounceDelay)) {
+					debouncedGpio ^= pin_mask;
+					gpioDebounceTime[pin] = now;
+				}
+			}
+		}
+	}
+};
+
+// Same as GpioInput::debounceGpioGetAll
+static void vectorDebounce(GpioDebouncer& debouncer, Mask_t& debouncedGpio, Mask_t raw_gpio, Mask_t buttonGpios,
+		Mask_t eagerGpios, uint32_t now, uint32_t debounceDelay) {
+	if (debouncedGpio != (raw_gpio & buttonGpios) || debouncer.pendingReleases() != 0)
+		debouncedGpio = debouncer.debounce(debouncedGpio, raw_gpio, buttonGpios, eagerGpios, now, debounceDelay);
+}
+
+static Mask_t randomWatched(uint32_t pins) {
+	Mask_t watched = 0;
+	while ((uint32_t)__builtin_popcount(watched) < pins) watched |= 1 << (nextRandom() % NUM_BANK0_GPIOS);
+	return watched;
+}
+
+static bool compare(const std::vector<Sample>& trace, Mask_t watched, uint32_t delay, const char* label) {
+	LegacyDebouncer legacy;
+	GpioDebouncer debouncer;
+	Mask_t expected = 0;
+	Mask_t actual = 0;
+	for (size_t i = 0; i < trace.size(); i++) {
+		legacy.debounce(expected, trace[i].raw, watched, trace[i].millis, delay);
+		vectorDebounce(debouncer, actual, trace[i].raw, watched, 0, trace[i].millis, delay);
+		if (expected != actual) {
+			printf("MISMATCH %s delay=%u pass %zu at %u ms raw=%08x expected=%08x got=%08x\n", label, delay, i,
+				trace[i].millis, trace[i].raw, expected, actual);
+			return false;
+		}
+	}
+	return true;
+}
+
+struct Timing {
+	double legacyNs;
+	double vectorNs;
+	uint32_t debounced;         // passes that got past the early out
+};
+
+static Timing measure(const std::vector<Sample>& trace, Mask_t watched, uint32_t delay) {
+	Timing timing = { 0, 0, 0 };
+	volatile Mask_t sink = 0;
+
+	LegacyDebouncer legacy;
+	Mask_t debounced = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (const Sample& sample : trace) {
+		if (debounced != (sample.raw & watched)) timing.debounced++;
+		legacy.debounce(debounced, sample.raw, watched, sample.millis, delay);
+		sink = sink + debounced;
+	}
+	auto end = std::chrono::steady_clock::now();
+	timing.legacyNs = std::chrono::duration<double, std::nano>(end - start).count() / trace.size();
+
+	GpioDebouncer debouncer;
+	debounced = 0;
+	start = std::chrono::steady_clock::now();
+	for (const Sample& sample : trace) {
+		vectorDebounce(debouncer, debounced, sample.raw, watched, 0, sample.millis, delay);
+		sink = sink + debounced;
+	}
+	end = std::chrono::steady_clock::now();
+	timing.vectorNs = std::chrono::duration<double, std::nano>(end - start).count() / trace.size();
+	return timing;
+}
+
+// Contact bounce of a switch changing state, the times in us the contacts toggle starting with the new state
+struct BounceShape {
+	uint8_t count;
+	uint32_t us[7];
+};
+
+static const BounceShape pressBounces[] = {
+	{ 1, { 0 } },                                   // clean
+	{ 5, { 0, 40, 95, 180, 260 } },                 // microswitch
+	{ 7, { 0, 150, 380, 620, 700, 950, 990 } },     // leaf switch
+	{ 5, { 0, 300, 520, 880, 910 } },               // worn contacts
+};
+
+static const BounceShape releaseBounces[] = {
+	{ 1, { 0 } },
+	{ 5, { 0, 60, 130, 240, 300 } },
+	{ 7, { 0, 210, 450, 700, 820, 1400, 1450 } },
+	{ 5, { 0, 500, 900, 1600, 1650 } },
+};
+
+struct Edge {
+	uint32_t us;
+	bool pressed;
+};
+
+struct Press {
+	uint32_t pressUs;           // first contact
+	uint32_t releaseUs;         // last bounce of the release
+};
+
+struct PinTrace {
+	std::vector<Edge> edges;
+	std::vector<Press> presses;
+	size_t nextEdge = 0;
+	bool pressed = false;
+};
+
+static void addBounce(PinTrace& pin, uint32_t us, const BounceShape& shape, bool pressed) {
+	for (uint8_t i = 0; i < shape.count; i++) pin.edges.push_back({ us + shape.us[i], (i & 1) ? !pressed : pressed });
+}
+
+// Presses held for 10 to 160 ms, a third of them with the contacts opening for up to a ms while held, and
+// rests long enough for the release to go through before the next press
+static PinTrace bouncyPinTrace(uint32_t presses, uint32_t delay) {
+	PinTrace pin;
+	uint32_t us = 5000 + nextRandom() % 20000;
+	for (uint32_t i = 0; i < presses; i++) {
+		Press press;
+		press.pressUs = us;
+		addBounce(pin, us, pressBounces[nextRandom() % 4], true);
+		uint32_t holdUs = 10000 + nextRandom() % 150000;
+		if (nextRandom() % 3 == 0) {
+			uint32_t chatterUs = us + holdUs / 2;
+			pin.edges.push_back({ chatterUs, false });
+			pin.edges.push_back({ chatterUs + 100 + nextRandom() % 800, true });
+		}
+		const BounceShape& release = releaseBounces[nextRandom() % 4];
+		addBounce(pin, us + holdUs, release, false);
+		press.releaseUs = us + holdUs + release.us[release.count - 1];
+		pin.presses.push_back(press);
+		us = press.releaseUs + delay * 1000 + 2000 + nextRandom() % 100000;
+	}
+	return pin;
+}
+
+struct ReplayResult {
+	bool passed;
+	uint32_t presses;
+	uint32_t minHoldUs;         // release reported after the first sample of the pin released for good
+	uint32_t maxHoldUs;
+};
+
+// Eager pins checked against the bounce traces, standard pins against the per-pin loop watching them alone
+static ReplayResult replay(Mask_t eager, Mask_t standard, uint32_t delay) {
+	ReplayResult result = { true, 0, UINT32_MAX, 0 };
+	PinTrace pins[NUM_BANK0_GPIOS];
+	uint32_t endUs = 0;
+	for (Pin_t pin = 0; pin < (Pin_t)NUM_BANK0_GPIOS; pin++) {
+		if ((eager | standard) & (1 << pin)) {
+			pins[pin] = bouncyPinTrace(200, delay);
+			if (pins[pin].presses.back().releaseUs > endUs) endUs = pins[pin].presses.back().releaseUs;
+		}
+	}
+	endUs += (delay + 2) * 1000;
+
+	GpioDebouncer debouncer;
+	LegacyDebouncer legacy;
+	Mask_t debounced = 0;
+	Mask_t expected = 0;
+	Mask_t prevRaw = 0;
+	size_t nextPress[NUM_BANK0_GPIOS] = {};
+	bool reported[NUM_BANK0_GPIOS] = {};
+	uint32_t releasedUs[NUM_BANK0_GPIOS] = {};  // first sample released since the pin was last sampled pressed
+	for (uint32_t us = 0; us < endUs && result.passed; us += 100 + nextRandom() % 200) {
+		Mask_t raw = 0;
+		for (Pin_t pin = 0; pin < (Pin_t)NUM_BANK0_GPIOS; pin++) {
+			PinTrace& trace = pins[pin];
+			while (trace.nextEdge < trace.edges.size() && trace.edges[trace.nextEdge].us <= us)
+				trace.pressed = trace.edges[trace.nextEdge++].pressed;
+			if (trace.pressed) raw |= 1 << pin;
+			else if (prevRaw & (1 << pin)) releasedUs[pin] = us;
+		}
+		prevRaw = raw;
+
+		Mask_t before = debounced;
+		vectorDebounce(debouncer, debounced, raw, eager | standard, eager, us / 1000, delay);
+		legacy.debounce(expected, raw, standard, us / 1000, delay);
+		if ((debounced & standard) != (expected & standard)) {
+			printf("MISMATCH standard pins next to eager ones delay=%u at %u us expected=%08x got=%08x\n", delay, us,
+				expected & standard, debounced & standard);
+			result.passed = false;
+		}
+
+		for (Pin_t pin = 0; pin < (Pin_t)NUM_BANK0_GPIOS && result.passed; pin++) {
+			Mask_t pinMask = 1 << pin;
+			if (!(eager & pinMask) || nextPress[pin] >= pins[pin].presses.size()) continue;
+			const Press& press = pins[pin].presses[nextPress[pin]];
+			if (!reported[pin]) {
+				if ((before ^ debounced) & pinMask) {
+					if (!(raw & pinMask) || us < press.pressUs) {
+						printf("FAIL eager pin %d delay=%u reported a press at %u us without one\n", pin, delay, us);
+						result.passed = false;
+					}
+				} else if (us >= press.pressUs && (raw & pinMask)) {
+					printf("FAIL eager pin %d delay=%u missed the first pressed sample at %u us\n", pin, delay, us);
+					result.passed = false;
+				}
+				reported[pin] = (debounced & pinMask) != 0;
+			} else if (!(debounced & pinMask)) {
+				// the release needs the pin sampled released for more than the delay, a bounce no sample saw doesn't
+				// count. The ms clock it counts on adds up to a ms and the sample falls somewhere in the next pass.
+				uint32_t holdUs = us - releasedUs[pin];
+				if (us < press.releaseUs || holdUs <= delay * 1000 || holdUs > (delay + 1) * 1000 + 300) {
+					printf("FAIL eager pin %d delay=%u released at %u us, the last bounce ends at %u us, sampled "
+						"released %u us\n", pin, delay, us, press.releaseUs, holdUs);
+					result.passed = false;
+				}
+				if (holdUs < result.minHoldUs) result.minHoldUs = holdUs;
+				if (holdUs > result.maxHoldUs) result.maxHoldUs = holdUs;
+				result.presses++;
+				reported[pin] = false;
+				nextPress[pin]++;
+			}
+		}
+	}
+
+	for (Pin_t pin = 0; pin < (Pin_t)NUM_BANK0_GPIOS && result.passed; pin++) {
+		if ((eager & (1 << pin)) && nextPress[pin] < pins[pin].presses.size()) {
+			printf("FAIL eager pin %d delay=%u reported %zu of %zu presses\n", pin, delay, nextPress[pin],
+				pins[pin].presses.size());
+			result.passed = false;
+		}
+	}
+	return result;
+}
+
+int main(int argc, char** argv) {
+	uint32_t seed = 1;
+	uint32_t passes = 200000;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoul(argv[++i], nullptr, 0);
+		else if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) passes = strtoul(argv[++i], nullptr, 0);
+		else {
+			fprintf(stderr, "usage: %s [--seed N] [--passes N]\n", argv[0]);
+			return 2;
+		}
+	}
+	rngState = seed ? seed : 1;
+	if (passes == 0) passes = 1;
+
+	static const uint32_t delays[] = { 1, 2, 5, 10, 20, 100 };
+	static const struct {
+		const char* label;
+		TraceOptions options;
+	} traces[] = {
+		{ "mashing",  { 8, 20, 4, 1000 } },
+		{ "bouncy",   { 4, 200, 15, 1000 } },
+		{ "slow",     { 0, 10, 3, 1000 } },
+		{ "boot",     { 8, 50, 4, 0 } },          // the ms clock starting at 0 with the last change time
+		{ "wrap",     { 8, 20, 4, 0xFFFFFF00 } }, // the ms clock wrapping mid trace
+	};
+
+	bool passed = true;
+	uint32_t compared = 0;
+	for (const auto& trace : traces) {
+		for (uint32_t delay : delays) {
+			Mask_t watched = randomWatched(1 + nextRandom() % 24);
+			std::vector<Sample> samples = randomTrace(passes, watched, trace.options);
+			passed = compare(samples, watched, delay, trace.label) && passed;
+			compared++;
+		}
+	}
+
+	// 24 buttons mashed on a leverless, the loop running at 8 passes per ms
+	Mask_t watched = randomWatched(24);
+	TraceOptions mashing = { 8, 20, 4, 1000 };
+	std::vector<Sample> samples = randomTrace(passes, watched, mashing);
+	Timing timing = measure(samples, watched, 5);
+	printf("# passes debounced legacy_ns vertical_ns\n");
+	printf("%u %u %.2f %.2f\n", passes, timing.debounced, timing.legacyNs, timing.vectorNs);
+
+	// the d-pad of the Pico board in eager mode, the buttons next to it in standard mode
+	static const uint32_t replayDelays[] = { 2, 5, 10, 20 };
+	uint32_t eagerPresses = 0;
+	printf("# delay presses release_hold_min_us release_hold_max_us\n");
+	for (uint32_t delay : replayDelays) {
+		ReplayResult result = replay(0x3C, 0xCC0, delay);
+		passed = result.passed && passed;
+		eagerPresses += result.presses;
+		printf("%u %u %u %u\n", delay, result.presses, result.minHoldUs, result.maxHoldUs);
+	}
+
+	printf("# debounce check %s: %u traces of %u passes match the per-pin loop, %.2fx per pass, "
+		"%u bouncy eager presses reported on their first sample\n",
+		passed ? "passed" : "FAILED", compared, passes, timing.legacyNs / timing.vectorNs, eagerPresses);
+	return passed ? 0 : 1;
+}
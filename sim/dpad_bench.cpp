@@ -0,0 +1,270 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// D-pad history check and benchmark
+//
+// Feeds random d-pad sequences through DpadResolver and through a copy of the std::list and function-static
+// code it replaced, checking 4-way mode and every SOCD mode give the same output on every read. Counts the
+// heap allocations each makes on the way and times them.
+//
+//   gp2040ce_dpad_bench [--seed N] [--reads N]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <list>
+#include <new>
+#include <vector>
+
+#include "GamepadState.h"
+
+static uint64_t heapAllocations = 0;
+
+void* operator new(size_t size) {
+	heapAllocations++;
+	void* ptr = malloc(size ? size : 1);
+	if (ptr == nullptr) throw std::bad_alloc();
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t size) noexcept { free(ptr); }
+
+static uint32_t rngState = 1;
+
+static uint32_t nextRandom() {
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 17;
+	rngState ^= rngState << 5;
+	return rngState;
+}
+
+// Same as updateDpad, filterToFourWayMode and runSOCDCleaner before DpadResolver, the reference it is
+// checked against
+
+static uint8_t legacyUpdateDpad(uint8_t dpad, DpadDirection direction)
+{
+	static bool inList[] = {false, false, false, false, false}; // correspond to DpadDirection: none, up, down, left, right
+	static std::list<DpadDirection> dpadList;
+
+	if(dpad & getMaskFromDirection(direction))
+	{
+		if(!inList[direction])
+		{
+			dpadList.push_back(direction);
+			inList[direction] = true;
+		}
+	}
+	else
+	{
+		if(inList[direction])
+		{
+			dpadList.remove(direction);
+			inList[direction] = false;
+		}
+	}
+
+	if(dpadList.empty()) {
+		return 0;
+	}
+	else {
+		return getMaskFromDirection(dpadList.back());
+	}
+}
+
+static uint8_t legacyFilterToFourWayMode(uint8_t dpad)
+{
+	legacyUpdateDpad(dpad, DIRECTION_UP);
+	legacyUpdateDpad(dpad, DIRECTION_DOWN);
+	legacyUpdateDpad(dpad, DIRECTION_LEFT);
+	return legacyUpdateDpad(dpad, DIRECTION_RIGHT);
+}
+
+static uint8_t legacyRunSOCDCleaner(SOCDMode mode, uint8_t dpad)
+{
+	if (mode == SOCD_MODE_BYPASS) {
+		return dpad;
+	}
+
+	static DpadDirection lastUD = DIRECTION_NONE;
+	static DpadDirection lastLR = DIRECTION_NONE;
+	uint8_t newDpad = 0;
+
+	switch (dpad & (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN))
+	{
+		case (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN):
+			if (mode == SOCD_MODE_UP_PRIORITY)
+			{
+				newDpad |= GAMEPAD_MASK_UP;
+				lastUD = DIRECTION_UP;
+			}
+			else if (mode == SOCD_MODE_SECOND_INPUT_PRIORITY && lastUD != DIRECTION_NONE)
+				newDpad |= (lastUD == DIRECTION_UP) ? GAMEPAD_MASK_DOWN : GAMEPAD_MASK_UP;
+			else if (mode == SOCD_MODE_FIRST_INPUT_PRIORITY && lastUD != DIRECTION_NONE)
+				newDpad |= (lastUD == DIRECTION_UP) ? GAMEPAD_MASK_UP : GAMEPAD_MASK_DOWN;
+			else
+				lastUD = DIRECTION_NONE;
+			break;
+
+		case GAMEPAD_MASK_UP:
+			newDpad |= GAMEPAD_MASK_UP;
+			lastUD = DIRECTION_UP;
+			break;
+
+		case GAMEPAD_MASK_DOWN:
+			newDpad |= GAMEPAD_MASK_DOWN;
+			lastUD = DIRECTION_DOWN;
+			break;
+
+		default:
+			lastUD = DIRECTION_NONE;
+			break;
+	}
+
+	switch (dpad & (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT))
+	{
+		case (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT):
+			if (mode == SOCD_MODE_SECOND_INPUT_PRIORITY && lastLR != DIRECTION_NONE)
+				newDpad |= (lastLR == DIRECTION_LEFT) ? GAMEPAD_MASK_RIGHT : GAMEPAD_MASK_LEFT;
+			else if (mode == SOCD_MODE_FIRST_INPUT_PRIORITY && lastLR != DIRECTION_NONE)
+				newDpad |= (lastLR == DIRECTION_LEFT) ? GAMEPAD_MASK_LEFT : GAMEPAD_MASK_RIGHT;
+			else
+				lastLR = DIRECTION_NONE;
+			break;
+
+		case GAMEPAD_MASK_LEFT:
+			newDpad |= GAMEPAD_MASK_LEFT;
+			lastLR = DIRECTION_LEFT;
+			break;
+
+		case GAMEPAD_MASK_RIGHT:
+			newDpad |= GAMEPAD_MASK_RIGHT;
+			lastLR = DIRECTION_RIGHT;
+			break;
+
+		default:
+			lastLR = DIRECTION_NONE;
+			break;
+	}
+
+	return newDpad;
+}
+
+// A held d-pad that changes one direction at a time, like hands on a stick or buttons do, with the occasional
+// jump to anything including the dpad-only bits Gamepad::read sets for digital directions. Starts released,
+// which clears the history the reference keeps in statics between runs.
+static std::vector<uint8_t> randomSequence(uint32_t length) {
+	std::vector<uint8_t> sequence;
+	uint8_t dpad = 0;
+	sequence.push_back(dpad);
+	for (uint32_t i = 1; i < length; i++) {
+		uint32_t r = nextRandom();
+		if ((r & 0x1F) == 0)
+			dpad = (r >> 8) & 0xFF;
+		else if ((r & 0x3) != 0)
+			dpad ^= 1 << ((r >> 8) & 0x3);
+		sequence.push_back(dpad);
+	}
+	return sequence;
+}
+
+struct RunResult {
+	bool matched;
+	uint64_t allocations;
+	double legacyNs;
+	double resolverNs;
+};
+
+// Four-way mode into the SOCD cleaner, the way Gamepad::process runs them
+static RunResult run(const std::vector<uint8_t>& sequence, SOCDMode mode, bool fourWay) {
+	RunResult result = { true, 0, 0, 0 };
+	std::vector<uint8_t> expected(sequence.size());
+	std::vector<uint8_t> actual(sequence.size());
+
+	uint64_t allocationsBefore = heapAllocations;
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < sequence.size(); i++) {
+		uint8_t dpad = sequence[i];
+		if (fourWay) dpad = legacyFilterToFourWayMode(dpad);
+		expected[i] = legacyRunSOCDCleaner(mode, dpad);
+	}
+	auto end = std::chrono::steady_clock::now();
+	result.allocations = heapAllocations - allocationsBefore;
+	result.legacyNs = std::chrono::duration<double, std::nano>(end - start).count() / sequence.size();
+
+	DpadResolver resolver;
+	allocationsBefore = heapAllocations;
+	start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < sequence.size(); i++) {
+		uint8_t dpad = sequence[i];
+		if (fourWay) dpad = resolver.filterToFourWayMode(dpad);
+		actual[i] = resolver.runSOCDCleaner(mode, dpad);
+	}
+	end = std::chrono::steady_clock::now();
+	if (heapAllocations != allocationsBefore) {
+		printf("FAIL DpadResolver made %llu heap allocations\n", (unsigned long long)(heapAllocations - allocationsBefore));
+		result.matched = false;
+	}
+	result.resolverNs = std::chrono::duration<double, std::nano>(end - start).count() / sequence.size();
+
+	for (size_t i = 0; i < sequence.size(); i++) {
+		if (expected[i] != actual[i]) {
+			printf("MISMATCH mode=%d four-way=%d read %zu dpad=%02x expected=%02x got=%02x\n",
+				mode, fourWay, i, sequence[i], expected[i], actual[i]);
+			result.matched = false;
+			break;
+		}
+	}
+
+	return result;
+}
+
+int main(int argc, char** argv) {
+	uint32_t seed = 1;
+	uint32_t reads = 2000000;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoul(argv[++i], nullptr, 0);
+		else if (strcmp(argv[i], "--reads") == 0 && i + 1 < argc) reads = strtoul(argv[++i], nullptr, 0);
+		else {
+			fprintf(stderr, "usage: %s [--seed N] [--reads N]\n", argv[0]);
+			return 2;
+		}
+	}
+	rngState = seed ? seed : 1;
+
+	std::vector<uint8_t> sequence = randomSequence(reads);
+	bool passed = true;
+
+	printf("# mode four-way legacy_ns resolver_ns legacy_allocs\n");
+	for (int mode = _SOCDMode_MIN; mode <= _SOCDMode_MAX; mode++) {
+		for (int fourWay = 0; fourWay <= 1; fourWay++) {
+			RunResult result = run(sequence, (SOCDMode)mode, fourWay);
+			passed = passed && result.matched;
+			printf("%d %d %.2f %.2f %llu\n", mode, fourWay, result.legacyNs, result.resolverNs,
+				(unsigned long long)result.allocations);
+		}
+	}
+
+	// resolvers keep their own history: one interleaved with another gives what it gives alone
+	std::vector<uint8_t> other = randomSequence(sequence.size());
+	DpadResolver alone, shared, interleaved;
+	for (size_t i = 0; i < sequence.size(); i++) {
+		uint8_t expected = alone.runSOCDCleaner(SOCD_MODE_SECOND_INPUT_PRIORITY, alone.filterToFourWayMode(sequence[i]));
+		interleaved.runSOCDCleaner(SOCD_MODE_FIRST_INPUT_PRIORITY, interleaved.filterToFourWayMode(other[i]));
+		uint8_t actual = shared.runSOCDCleaner(SOCD_MODE_SECOND_INPUT_PRIORITY, shared.filterToFourWayMode(sequence[i]));
+		if (expected != actual) {
+			printf("MISMATCH resolver history shared between instances at read %zu\n", i);
+			passed = false;
+			break;
+		}
+	}
+
+	printf("# dpad check %s: %u reads per mode, %zu bytes per resolver, no heap use\n",
+		passed ? "passed" : "FAILED", reads, sizeof(DpadResolver));
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,216 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Event dispatch check and benchmark
+//
+// Runs the events of a busy core0 loop (button and analog changes every pass, the odd encoder step and menu
+// navigation) through EventManager, one input frame event per pass, and through a copy of the list search and
+// new/delete dispatch it replaced, with the five button and analog events per pass the loop sent back then.
+// Handlers are registered the way the firmware registers them. Checks both call the same handlers with the
+// same events, that EventManager makes no heap allocation while dispatching, and prints passes per second for
+// each.
+//
+//   gp2040ce_event_bench [--passes N]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <new>
+#include <vector>
+
+#include "eventmanager.h"
+
+static uint64_t heapAllocations = 0;
+
+void* operator new(size_t size) {
+	heapAllocations++;
+	void* ptr = malloc(size ? size : 1);
+	if (ptr == nullptr) throw std::bad_alloc();
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t size) noexcept { free(ptr); }
+
+// Same as EventManager before the handler table, the reference it is checked against
+class LegacyEventManager {
+	public:
+		typedef std::function<void(GPEvent* event)> EventFunction;
+		typedef std::pair<GPEventType, std::vector<EventFunction>> EventEntry;
+
+		void registerEventHandler(GPEventType eventType, EventFunction handler) {
+			typename std::vector<EventEntry>::iterator it = std::find_if(eventList.begin(), eventList.end(), [&eventType](const EventEntry& entry) { return entry.first == eventType; });
+
+			if (it != eventList.end()) {
+				it->second.push_back(handler);
+			} else {
+				eventList.emplace_back(eventType, std::vector<EventFunction>{handler});
+			}
+		}
+
+		void triggerEvent(GPEvent* event) {
+			GPEventType eventType = event->eventType();
+			for (typename std::vector<EventEntry>::const_iterator it = eventList.begin(); it != eventList.end(); ++it) {
+				if (it->first == eventType) {
+					const std::vector<EventFunction>& handlers = it->second;
+					for (typename std::vector<EventFunction>::const_iterator handler = handlers.begin(); handler != handlers.end(); ++handler) {
+						(*handler)(event);
+					}
+				}
+			}
+			delete event;
+		}
+	private:
+		std::vector<EventEntry> eventList;
+};
+
+// What the handlers saw, summed so both dispatchers can be compared
+struct HandlerLog {
+	uint64_t calls = 0;
+	uint64_t checksum = 0;
+
+	void record(GPEvent* event) {
+		calls++;
+		checksum = checksum * 31 + event->eventType();
+		switch (event->eventType()) {
+			case GP_EVENT_ENCODER_CHANGE: checksum += ((GPEncoderChangeEvent*)event)->direction; break;
+			case GP_EVENT_MENU_NAVIGATE: checksum += ((GPMenuNavigateEvent*)event)->menuAction; break;
+			case GP_EVENT_STORAGE_SAVE: checksum += ((GPStorageSaveEvent*)event)->forceSave; break;
+			default: break;
+		}
+	}
+};
+
+// The handlers a firmware with display and keyboard driver has: storage save (GP2040), restart and menu
+// navigation (display), profile change and USB host (button layout screen), encoder (keyboard driver)
+static const GPEventType handledTypes[] = { GP_EVENT_STORAGE_SAVE, GP_EVENT_RESTART, GP_EVENT_MENU_NAVIGATE,
+	GP_EVENT_PROFILE_CHANGE, GP_EVENT_USBHOST_MOUNT, GP_EVENT_USBHOST_UNMOUNT, GP_EVENT_ENCODER_CHANGE };
+static const size_t handledTypeCount = sizeof(handledTypes) / sizeof(handledTypes[0]);
+
+static void registerHandlers(LegacyEventManager& manager, HandlerLog& log) {
+	for (GPEventType eventType : handledTypes) {
+		manager.registerEventHandler(eventType, [&log](GPEvent* event) { log.record(event); });
+	}
+}
+
+// the handlers stay registered while their tokens live
+static void registerHandlers(EventManager& manager, HandlerLog& log, EventHandlerToken* tokens) {
+	for (size_t i = 0; i < handledTypeCount; i++) {
+		tokens[i] = manager.registerEventHandler(handledTypes[i], [&log](GPEvent* event) { log.record(event); });
+	}
+}
+
+// Input state of pass i, buttons and sticks change every pass
+static void fillState(GamepadState& state, uint32_t i) {
+	state.dpad = i & 0xF;
+	state.buttons = i & 0x3FFF;
+	state.lx = state.ly = state.rx = state.ry = i;
+}
+
+// A button and analog event of the loop before GPInputFrameEvent, as big as one: raw down and up, processed
+// down and up and analog move, each new'd every pass. Their types are gone and none had a handler.
+class LegacyGamepadEvent : public GPEvent {
+	public:
+		LegacyGamepadEvent(uint32_t i) { fillState(state, i); }
+
+		GPEventType eventType() { return GP_EVENT_BASE; }
+	private:
+		GamepadState state;
+};
+
+#define LEGACY_GAMEPAD_EVENTS 5
+
+// Besides the input changes, an encoder step every 16 passes and a menu navigation every 256
+static GPEventType extraEventAt(uint32_t pass) {
+	if ((pass & 0xFF) == 0) return GP_EVENT_MENU_NAVIGATE;
+	if ((pass & 0xF) == 0) return GP_EVENT_ENCODER_CHANGE;
+	return GP_EVENT_BASE;
+}
+
+static uint32_t triggerLegacy(LegacyEventManager& manager, uint32_t pass) {
+	for (uint32_t i = 0; i < LEGACY_GAMEPAD_EVENTS; i++) manager.triggerEvent(new LegacyGamepadEvent(pass));
+	switch (extraEventAt(pass)) {
+		case GP_EVENT_ENCODER_CHANGE: manager.triggerEvent(new GPEncoderChangeEvent(0, (pass & 0x40) ? 1 : -1)); return LEGACY_GAMEPAD_EVENTS + 1;
+		case GP_EVENT_MENU_NAVIGATE: manager.triggerEvent(new GPMenuNavigateEvent(GpioAction::MENU_NAVIGATION_DOWN)); return LEGACY_GAMEPAD_EVENTS + 1;
+		default: return LEGACY_GAMEPAD_EVENTS;
+	}
+}
+
+static uint32_t trigger(EventManager& manager, uint32_t pass) {
+	GamepadState prevState, currState;
+	fillState(prevState, pass - 1);
+	fillState(currState, pass);
+	GPInputFrameEvent inputFrame;
+	inputFrame.setRaw(prevState, currState);
+	inputFrame.setProcessed(prevState, currState);
+	manager.triggerEvent(inputFrame);
+	switch (extraEventAt(pass)) {
+		case GP_EVENT_ENCODER_CHANGE: manager.triggerEvent(GPEncoderChangeEvent(0, (pass & 0x40) ? 1 : -1)); return 2;
+		case GP_EVENT_MENU_NAVIGATE: manager.triggerEvent(GPMenuNavigateEvent(GpioAction::MENU_NAVIGATION_DOWN)); return 2;
+		default: return 1;
+	}
+}
+
+int main(int argc, char** argv) {
+	uint32_t passes = 1000000;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) passes = strtoul(argv[++i], nullptr, 0);
+		else {
+			fprintf(stderr, "usage: %s [--passes N]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	bool passed = true;
+
+	LegacyEventManager legacy;
+	HandlerLog legacyLog;
+	registerHandlers(legacy, legacyLog);
+
+	uint64_t allocationsBefore = heapAllocations;
+	auto start = std::chrono::steady_clock::now();
+	uint32_t legacyEvents = 0;
+	for (uint32_t i = 1; i <= passes; i++) legacyEvents += triggerLegacy(legacy, i);
+	auto end = std::chrono::steady_clock::now();
+	uint64_t legacyAllocations = heapAllocations - allocationsBefore;
+	double legacySeconds = std::chrono::duration<double>(end - start).count();
+
+	EventManager& manager = EventManager::getInstance();
+	HandlerLog log;
+	EventHandlerToken tokens[handledTypeCount];
+	registerHandlers(manager, log, tokens);
+
+	allocationsBefore = heapAllocations;
+	start = std::chrono::steady_clock::now();
+	uint32_t events = 0;
+	for (uint32_t i = 1; i <= passes; i++) events += trigger(manager, i);
+	end = std::chrono::steady_clock::now();
+	uint64_t allocations = heapAllocations - allocationsBefore;
+	double seconds = std::chrono::duration<double>(end - start).count();
+
+	if (allocations != 0) {
+		printf("FAIL EventManager made %llu heap allocations while dispatching\n", (unsigned long long)allocations);
+		passed = false;
+	}
+	if (log.calls != legacyLog.calls || log.checksum != legacyLog.checksum) {
+		printf("MISMATCH handlers called %llu times (legacy %llu), checksum %016llx (legacy %016llx)\n",
+			(unsigned long long)log.calls, (unsigned long long)legacyLog.calls,
+			(unsigned long long)log.checksum, (unsigned long long)legacyLog.checksum);
+		passed = false;
+	}
+
+	printf("# dispatcher passes_per_s ns_per_pass events allocations handler_calls\n");
+	printf("legacy %.0f %.2f %u %llu %llu\n", passes / legacySeconds, legacySeconds * 1e9 / passes, legacyEvents,
+		(unsigned long long)legacyAllocations, (unsigned long long)legacyLog.calls);
+	printf("table %.0f %.2f %u %llu %llu\n", passes / seconds, seconds * 1e9 / passes, events,
+		(unsigned long long)allocations, (unsigned long long)log.calls);
+	printf("# event check %s: %u passes, no heap use while dispatching\n", passed ? "passed" : "FAILED", passes);
+	return passed ? 0 : 1;
+}
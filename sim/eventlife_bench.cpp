@@ -0,0 +1,270 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Event handler lifetime check
+//
+// Creates and deletes a screen-like object that registers its handlers in init and keeps the tokens, the way
+// ButtonLayoutScreen does, thousands of times while the rest of the firmware keeps its handlers. Checks handler
+// counts go back to where they were after every cycle, nothing is allocated once the first cycle is done,
+// dispatch takes as long in the last cycles as in the first, and a deleted screen is never called. Also checks
+// handlers unregistering themselves and others while an event is dispatched, the slot cap, and that tokens
+// left over from before clearEventHandlers don't unregister whoever got their slot since, and that handlers
+// registered with a mask skip the input frames they didn't ask for.
+//
+//   gp2040ce_eventlife_bench [--cycles N] [--events N]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <new>
+
+#include "eventmanager.h"
+
+static uint64_t heapAllocations = 0;
+
+void* operator new(size_t size) {
+	heapAllocations++;
+	void* ptr = malloc(size ? size : 1);
+	if (ptr == nullptr) throw std::bad_alloc();
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t size) noexcept { free(ptr); }
+
+static bool passed = true;
+
+#define CHECK(cond, ...) do { if (!(cond)) { printf("FAIL " __VA_ARGS__); printf("\n"); passed = false; } } while (0)
+
+// Set while a screen is alive, a handler of a deleted screen running shows up as a call with no live screen
+static uint32_t liveScreens = 0;
+static uint64_t deadScreenCalls = 0;
+static uint64_t screenCalls = 0;
+
+class TestScreen {
+	public:
+		TestScreen() : alive(true) { liveScreens++; }
+		~TestScreen() { alive = false; liveScreens--; }
+
+		void init() {
+			profileChangeHandler = EventManager::getInstance().registerEventHandler(GP_EVENT_PROFILE_CHANGE, GPEVENT_CALLBACK(this->handle(event)));
+			usbMountHandler = EventManager::getInstance().registerEventHandler(GP_EVENT_USBHOST_MOUNT, GPEVENT_CALLBACK(this->handle(event)));
+			usbUnmountHandler = EventManager::getInstance().registerEventHandler(GP_EVENT_USBHOST_UNMOUNT, GPEVENT_CALLBACK(this->handle(event)));
+		}
+	private:
+		void handle(GPEvent* e) {
+			if (!alive || liveScreens == 0) deadScreenCalls++;
+			else screenCalls++;
+		}
+
+		bool alive;
+		EventHandlerToken profileChangeHandler;
+		EventHandlerToken usbMountHandler;
+		EventHandlerToken usbUnmountHandler;
+};
+
+static uint64_t firmwareCalls = 0;
+
+static uint32_t totalHandlers() {
+	uint32_t total = 0;
+	for (uint8_t eventType = 0; eventType < _GPEventType_ARRAYSIZE; eventType++)
+		total += EventManager::getInstance().getHandlerCount((GPEventType)eventType);
+	return total;
+}
+
+static void triggerAll(uint32_t events) {
+	EventManager& manager = EventManager::getInstance();
+	for (uint32_t i = 0; i < events; i++) {
+		switch (i % 4) {
+			case 0: manager.triggerEvent(GPProfileChangeEvent(1, 2)); break;
+			case 1: manager.triggerEvent(GPUSBHostMountEvent(1, 0x0F0D, 0x0092)); break;
+			case 2: manager.triggerEvent(GPUSBHostUnmountEvent(1, 0x0F0D, 0x0092)); break;
+			default: manager.triggerEvent(GPStorageSaveEvent(false)); break;
+		}
+	}
+}
+
+// Screens coming and going the way DisplayAddon switches them, with the firmware handlers registered all along
+static void checkScreenCycles(uint32_t cycles, uint32_t events) {
+	EventManager& manager = EventManager::getInstance();
+	manager.clearEventHandlers();
+
+	EventHandlerToken firmware[] = {
+		manager.registerEventHandler(GP_EVENT_STORAGE_SAVE, [](GPEvent*) { firmwareCalls++; }),
+		manager.registerEventHandler(GP_EVENT_RESTART, [](GPEvent*) { firmwareCalls++; }),
+		manager.registerEventHandler(GP_EVENT_MENU_NAVIGATE, [](GPEvent*) { firmwareCalls++; }),
+		manager.registerEventHandler(GP_EVENT_ENCODER_CHANGE, [](GPEvent*) { firmwareCalls++; }),
+	};
+
+	uint8_t baseline[_GPEventType_ARRAYSIZE];
+	for (uint8_t eventType = 0; eventType < _GPEventType_ARRAYSIZE; eventType++)
+		baseline[eventType] = manager.getHandlerCount((GPEventType)eventType);
+
+	// the first cycle may allocate (std::function storage), none after it may
+	uint64_t allocationsAfterWarmup = 0;
+	uint32_t timedCycles = cycles / 10 ? cycles / 10 : 1;
+	double firstNs = 0, lastNs = 0;
+
+	for (uint32_t cycle = 0; cycle < cycles; cycle++) {
+		if (cycle == 1) allocationsAfterWarmup = heapAllocations;
+
+		TestScreen* screen = new TestScreen();
+		screen->init();
+
+		CHECK(manager.getHandlerCount(GP_EVENT_PROFILE_CHANGE) == baseline[GP_EVENT_PROFILE_CHANGE] + 1,
+			"cycle %u: %u profile change handlers with a screen up", cycle, manager.getHandlerCount(GP_EVENT_PROFILE_CHANGE));
+
+		auto start = std::chrono::steady_clock::now();
+		triggerAll(events);
+		auto end = std::chrono::steady_clock::now();
+		double ns = std::chrono::duration<double, std::nano>(end - start).count() / events;
+		if (cycle < timedCycles) firstNs += ns / timedCycles;
+		if (cycle >= cycles - timedCycles) lastNs += ns / timedCycles;
+
+		delete screen;
+		// once the screen is gone its handlers must be too
+		triggerAll(4);
+
+		for (uint8_t eventType = 0; eventType < _GPEventType_ARRAYSIZE; eventType++) {
+			if (manager.getHandlerCount((GPEventType)eventType) != baseline[eventType]) {
+				CHECK(false, "cycle %u: event type %u has %u handlers, %u before the screen", cycle, eventType,
+					manager.getHandlerCount((GPEventType)eventType), baseline[eventType]);
+				return;
+			}
+		}
+	}
+
+	// the screen's new/delete is the only allocation a cycle may make
+	uint64_t cycleAllocations = cycles > 1 ? heapAllocations - allocationsAfterWarmup : 0;
+	CHECK(cycleAllocations == cycles - 1, "%llu heap allocations in %u cycles after the first, expected one per screen",
+		(unsigned long long)cycleAllocations, cycles - 1);
+	CHECK(deadScreenCalls == 0, "handlers of deleted screens called %llu times", (unsigned long long)deadScreenCalls);
+	CHECK(screenCalls == (uint64_t)cycles * (events - events / 4), "screen handlers called %llu times, expected %llu",
+		(unsigned long long)screenCalls, (unsigned long long)cycles * (events - events / 4));
+	// dispatch cost must not grow with the number of screens that came and went
+	CHECK(lastNs < firstNs * 1.5 + 5, "dispatch went from %.2f ns to %.2f ns per event", firstNs, lastNs);
+
+	printf("# cycles events_per_cycle first_ns last_ns handlers allocations_after_first\n");
+	printf("%u %u %.2f %.2f %u %llu\n", cycles, events, firstNs, lastNs, totalHandlers(),
+		(unsigned long long)(cycleAllocations - (cycles - 1)));
+}
+
+// Handlers unregistering themselves and each other in the middle of a dispatch
+static void checkUnregisterWhileDispatching() {
+	EventManager& manager = EventManager::getInstance();
+	manager.clearEventHandlers();
+
+	static EventHandlerToken first, second, third;
+	static uint32_t firstCalls, secondCalls, thirdCalls;
+	firstCalls = secondCalls = thirdCalls = 0;
+
+	// first releases itself and second, which comes after it in the same dispatch and must not run
+	first = manager.registerEventHandler(GP_EVENT_RESTART, [](GPEvent*) { firstCalls++; first.release(); second.release(); });
+	second = manager.registerEventHandler(GP_EVENT_RESTART, [](GPEvent*) { secondCalls++; });
+	third = manager.registerEventHandler(GP_EVENT_RESTART, [](GPEvent*) {
+		thirdCalls++;
+		// a nested dispatch must not free the slots of the outer one
+		EventManager::getInstance().triggerEvent(GPStorageSaveEvent(false));
+	});
+
+	manager.triggerEvent(GPRestartEvent());
+	CHECK(firstCalls == 1 && secondCalls == 0 && thirdCalls == 1, "dispatch with self-unregister called %u/%u/%u",
+		firstCalls, secondCalls, thirdCalls);
+	CHECK(manager.getHandlerCount(GP_EVENT_RESTART) == 1, "%u restart handlers left, expected 1",
+		manager.getHandlerCount(GP_EVENT_RESTART));
+
+	manager.triggerEvent(GPRestartEvent());
+	CHECK(firstCalls == 1 && secondCalls == 0 && thirdCalls == 2, "second dispatch called %u/%u/%u",
+		firstCalls, secondCalls, thirdCalls);
+
+	// the freed slots are reused
+	EventHandlerToken again = manager.registerEventHandler(GP_EVENT_RESTART, [](GPEvent*) { firstCalls++; });
+	CHECK(again.isRegistered(), "freed slot not reused");
+	third.release();
+	again.release();
+	CHECK(manager.getHandlerCount(GP_EVENT_RESTART) == 0, "%u restart handlers left, expected 0",
+		manager.getHandlerCount(GP_EVENT_RESTART));
+}
+
+// Slots are capped, and a token from before clearEventHandlers doesn't touch the handler now in its slot
+static void checkCapAndGenerations() {
+	EventManager& manager = EventManager::getInstance();
+	manager.clearEventHandlers();
+
+	EventHandlerToken tokens[EVENTMGR_MAX_HANDLERS];
+	for (uint8_t slot = 0; slot < EVENTMGR_MAX_HANDLERS; slot++)
+		tokens[slot] = manager.registerEventHandler(GP_EVENT_ENCODER_CHANGE, [](GPEvent*) {});
+	EventHandlerToken overflow = manager.registerEventHandler(GP_EVENT_ENCODER_CHANGE, [](GPEvent*) {});
+	CHECK(!overflow.isRegistered(), "registered a handler past EVENTMGR_MAX_HANDLERS");
+	CHECK(manager.getHandlerCount(GP_EVENT_ENCODER_CHANGE) == EVENTMGR_MAX_HANDLERS, "%u encoder handlers, expected %u",
+		manager.getHandlerCount(GP_EVENT_ENCODER_CHANGE), EVENTMGR_MAX_HANDLERS);
+
+	manager.clearEventHandlers();
+	EventHandlerToken current = manager.registerEventHandler(GP_EVENT_ENCODER_CHANGE, [](GPEvent*) {});
+	for (uint8_t slot = 0; slot < EVENTMGR_MAX_HANDLERS; slot++) tokens[slot].release();
+	CHECK(current.isRegistered() && manager.getHandlerCount(GP_EVENT_ENCODER_CHANGE) == 1,
+		"stale tokens unregistered the handler registered after clearEventHandlers");
+}
+
+// Handlers registered with a mask only see input frames that changed one of its bits
+static void checkEventMasks() {
+	EventManager& manager = EventManager::getInstance();
+	manager.clearEventHandlers();
+
+	static uint32_t allCalls, analogCalls, pressedCalls;
+	allCalls = analogCalls = pressedCalls = 0;
+	EventHandlerToken all = manager.registerEventHandler(GP_EVENT_INPUT_FRAME, [](GPEvent*) { allCalls++; });
+	EventHandlerToken analog = manager.registerEventHandler(GP_EVENT_INPUT_FRAME, [](GPEvent*) { analogCalls++; },
+		INPUT_FRAME_ANALOG_MOVED);
+	EventHandlerToken pressed = manager.registerEventHandler(GP_EVENT_INPUT_FRAME, [](GPEvent*) { pressedCalls++; },
+		INPUT_FRAME_RAW_PRESSED | INPUT_FRAME_PROCESSED_PRESSED);
+
+	GamepadState released, held, moved;
+	held.buttons = GAMEPAD_MASK_B1;
+	moved.lx = 0;
+
+	GPInputFrameEvent press;
+	press.setRaw(released, held);
+	press.setProcessed(released, held);
+	manager.triggerEvent(press);
+	GPInputFrameEvent move;
+	move.setProcessed(released, moved);
+	manager.triggerEvent(move);
+	GPInputFrameEvent release;
+	release.setRaw(held, released);
+	manager.triggerEvent(release);
+
+	CHECK(allCalls == 3 && analogCalls == 1 && pressedCalls == 1, "masked handlers called %u/%u/%u, expected 3/1/1",
+		allCalls, analogCalls, pressedCalls);
+	CHECK(move.analogDeltas.lx == -GAMEPAD_JOYSTICK_MID && move.changes == INPUT_FRAME_ANALOG_MOVED,
+		"analog delta %d changes %02x", move.analogDeltas.lx, move.changes);
+}
+
+int main(int argc, char** argv) {
+	uint32_t cycles = 10000;
+	uint32_t events = 400;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--cycles") == 0 && i + 1 < argc) cycles = strtoul(argv[++i], nullptr, 0);
+		else if (strcmp(argv[i], "--events") == 0 && i + 1 < argc) events = strtoul(argv[++i], nullptr, 0);
+		else {
+			fprintf(stderr, "usage: %s [--cycles N] [--events N]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (cycles == 0) cycles = 1;
+	events = (events + 3) & ~3u;
+
+	checkScreenCycles(cycles, events);
+	checkUnregisterWhileDispatching();
+	checkCapAndGenerations();
+	checkEventMasks();
+
+	printf("# event lifetime check %s: %u screen cycles, %u handler slots per event type\n",
+		passed ? "passed" : "FAILED", cycles, EVENTMGR_MAX_HANDLERS);
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,638 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// FlashPROM log check and benchmark
+//
+// Saves a config through FlashPROM over and over on the simulated flash, each save a small edit like the ones web
+// config and the hotkeys make, and reboots every few saves. Prints the bytes a save erased and the pages it
+// programmed, the flash time at the datasheet's typical times and the steps it took, and how often the most worn
+// sector was erased, next to what the whole block erase and program of every save cost before the log. Checks
+// every reboot replays the config that was saved, that the first save to an erased block and a reset of one erase
+// nothing, and that every step is a single erase or program.
+//
+// Then plays half an hour of 1 ms input frames, stretches of play with hotkey saves and idle stretches between,
+// stepping the saves after each frame, once with the default stall budget and once with one below a page program's
+// worst case, which FlashPROM raises to it. Checks no step runs in a frame with the inputs active and none takes
+// longer than the budget, so no erase runs while playing, and that the reboot at the end writes what was held.
+// Prints the longest stall, how long a save took to get written and how many sectors the boot erased ahead.
+//
+// Then cuts the power at random points of random saves and checks the config after the reboot is either the one
+// before the save or the one it was writing, and that the log carries on. Then corrupts the newest full record
+// after random runs of saves, each followed by the erases ahead a boot makes, and checks the reboot falls back to
+// the last config of the generation before it, that the log carries on from there, and how much of the block start() read to find it. Then starts from a block in the
+// format before the log and cuts the power at every point of the first save, which has to leave the old config
+// readable. Then starts a full save over part way through and checks the reboot loads the copy written in full.
+// Last, checks a stall budget set out of range is clamped to one that holds erases and lets page programs run.
+//
+//   gp2040ce_flashprom_bench [--saves N] [--seed S]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <vector>
+
+#include "CRC32.h"
+#include "FlashPROM.h"
+#include "simconfig.h"
+#include "simhal.h"
+#include "storagemanager.h"
+
+// Before the log: erase and program the whole block on every save that changed the config
+#define BENCH_BLOCK_PAGES (EEPROM_SIZE_BYTES / FLASH_PAGE_SIZE)
+#define BENCH_ERASE_US 45000
+#define BENCH_PROGRAM_US 400
+
+// Footer of the format before the log, see config_utils.cpp
+struct ConfigFooter {
+	uint32_t dataSize;
+	uint32_t dataCrc;
+	uint32_t magic;
+};
+
+static const uint32_t FOOTER_MAGIC = 0xd2f1e365;
+static const uint32_t flashOffset = EEPROM_ADDRESS_START - XIP_BASE;
+
+static Config config;
+static uint8_t saved[EEPROM_SIZE_BYTES];
+static uint32_t savedSize = 0;
+static uint32_t seed = 1;
+
+static uint32_t random32() {
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+
+// The edits a session of web config and hotkeys makes, some of them change the encoded size
+static void edit(Config& target, uint32_t step) {
+	switch (step % 6) {
+		case 0: target.animationOptions.brightness = (target.animationOptions.brightness + 1) % 10; break;
+		case 1: target.gamepadOptions.socdMode = (SOCDMode)((target.gamepadOptions.socdMode + 1) % 3); break;
+		case 2: target.ledOptions.brightnessMaximum = 128 + (step * 7) % 128; break;
+		case 3: target.gamepadOptions.invertXAxis = !target.gamepadOptions.invertXAxis; break;
+		case 4: snprintf(target.gpioMappings.profileLabel, sizeof(target.gpioMappings.profileLabel), (step / 6) % 2 ? "Main" : "Tournament"); break;
+		case 5: target.displayOptions.displaySaverTimeout = (step / 6) % 20; break;
+	}
+}
+
+// Save and write it out in one go, keeping what the cache holds now as what a reboot has to find
+static void save(Config& source) {
+	SimConfig::save(source);
+	savedSize = EEPROM.size();
+	memcpy(saved, EEPROM.writeCache, savedSize);
+	EEPROM.flush();
+}
+
+// The passes of a boot before the host takes reports, each erases a sector ahead of the log if one needs it
+static void bootPasses() {
+	for (uint32_t pass = 0; pass <= EEPROM_SECTOR_COUNT; pass++)
+		EEPROM.maintain();
+}
+
+static bool bootMatches(const uint8_t* image, uint32_t size) {
+	return EEPROM.size() == size && memcmp(EEPROM.writeCache, image, size) == 0;
+}
+
+struct WearResult {
+	uint32_t size = 0;
+	uint32_t saves = 0;
+	uint32_t maxSectorErases = 0;
+	uint32_t steps = 0;
+	uint32_t maxStepUs = 0;     // longest a single erase or program stalled for
+	SimHal::FlashStats flash;
+	FlashPROMStats records;
+	bool passed = true;
+};
+
+static WearResult runWear(const Config& start, uint32_t saves) {
+	WearResult result;
+	SimHal::eraseFlash();
+	EEPROM.start();
+	config = start;
+	SimHal::resetFlashStats();
+	save(config);
+	result.size = savedSize;
+	if (SimHal::flashStats().sectorsErased != 0) {
+		printf("FAIL the first save to an erased block erased %lu sectors\n", (unsigned long)SimHal::flashStats().sectorsErased);
+		result.passed = false;
+	}
+
+	SimHal::resetFlashStats();
+	for (uint32_t i = 0; i < saves; i++) {
+		edit(config, i);
+		// the stats start over with every boot, only what this save added counts
+		const FlashPROMStats before = EEPROM.getStats();
+		const SimHal::FlashStats flashBefore = SimHal::flashStats();
+		save(config);
+		const FlashPROMStats& after = EEPROM.getStats();
+		const SimHal::FlashStats& flashAfter = SimHal::flashStats();
+		result.records.fullRecords += after.fullRecords - before.fullRecords;
+		result.records.deltaRecords += after.deltaRecords - before.deltaRecords;
+		result.records.unsafeWrites += after.unsafeWrites - before.unsafeWrites;
+		result.steps += after.steps - before.steps;
+		if (after.maxStallUs > result.maxStepUs) result.maxStepUs = after.maxStallUs;
+
+		// every erase and program is a step of its own, the stall of one is that operation and nothing else
+		const uint32_t operations = flashAfter.sectorsErased - flashBefore.sectorsErased + flashAfter.pagesProgrammed -
+			flashBefore.pagesProgrammed;
+		if (after.steps - before.steps != operations || after.maxStallUs > BENCH_ERASE_US) {
+			printf("FAIL save %lu took %lu steps for %lu flash operations, longest stall %lu us\n", (unsigned long)i,
+				(unsigned long)(after.steps - before.steps), (unsigned long)operations, (unsigned long)after.maxStallUs);
+			result.passed = false;
+			break;
+		}
+
+		if (i % 7 == 6) {
+			EEPROM.start();
+			if (!bootMatches(saved, savedSize)) {
+				printf("FAIL save %lu of a %lu byte config did not boot back\n", (unsigned long)i, (unsigned long)savedSize);
+				result.passed = false;
+				break;
+			}
+		}
+	}
+
+	result.saves = saves;
+	result.flash = SimHal::flashStats();
+	for (uint32_t sector = 0; sector < EEPROM_SECTOR_COUNT; sector++) {
+		uint32_t erases = SimHal::sectorErases(flashOffset + sector * FLASH_SECTOR_SIZE);
+		if (erases > result.maxSectorErases) result.maxSectorErases = erases;
+	}
+	if (result.records.unsafeWrites != 0) {
+		printf("FAIL %lu saves of a %lu byte config erased the last saved state\n", (unsigned long)result.records.unsafeWrites,
+			(unsigned long)result.size);
+		result.passed = false;
+	}
+	return result;
+}
+
+static void printWear(const char* label, const WearResult& result) {
+	const double saves = result.saves;
+	printf("%-9s %5lu bytes  %lu saves: %lu deltas %lu full, per save %6.0f bytes erased %.2f pages programmed %.1f ms flash time in %.2f steps, longest step %.1f ms, most erased sector %lu times\n",
+		label, (unsigned long)result.size, (unsigned long)result.saves, (unsigned long)result.records.deltaRecords,
+		(unsigned long)result.records.fullRecords, result.flash.sectorsErased * FLASH_SECTOR_SIZE / saves,
+		result.flash.pagesProgrammed / saves, result.flash.busyUs / saves / 1000.0, result.steps / saves,
+		result.maxStepUs / 1000.0, (unsigned long)result.maxSectorErases);
+}
+
+struct PowerLossResult {
+	uint32_t cuts = 0;
+	uint32_t kept = 0;          // came back with the config before the save
+	uint32_t written = 0;       // came back with the config the save was writing
+	uint32_t lost = 0;
+};
+
+static PowerLossResult runPowerLoss(const Config& start, uint32_t saves) {
+	PowerLossResult result;
+	SimHal::eraseFlash();
+	EEPROM.start();
+	config = start;
+	save(config);
+
+	static uint8_t before[EEPROM_SIZE_BYTES];
+	for (uint32_t i = 0; i < saves; i++) {
+		const uint32_t beforeSize = savedSize;
+		memcpy(before, saved, beforeSize);
+
+		edit(config, random32());
+		// one save in four is cut short, a cut after its last erase or program doesn't hit it
+		if (random32() % 4 == 0) SimHal::powerLossAfter(random32() % 8);
+		save(config);
+		const bool cut = !SimHal::flashPowered();
+		SimHal::powerOn();
+		if (!cut) continue;
+
+		result.cuts++;
+		EEPROM.start();
+		if (bootMatches(before, beforeSize)) {
+			result.kept++;
+		} else if (bootMatches(saved, savedSize)) {
+			result.written++;
+		} else {
+			result.lost++;
+			printf("FAIL power cut in save %lu came back with neither config\n", (unsigned long)i);
+			break;
+		}
+
+		// carry on from what the board came back with
+		savedSize = EEPROM.size();
+		memcpy(saved, EEPROM.writeCache, savedSize);
+		SimConfig::load(config);
+	}
+	return result;
+}
+
+// Page of the newest record in the block, of the given type or any, -1 if there is none
+static int32_t newestRecord(uint16_t type) {
+	const uint8_t* flashStart = reinterpret_cast<const uint8_t*>(EEPROM_ADDRESS_START);
+	int32_t newest = -1;
+	for (uint32_t page = 0; page < EEPROM_PAGE_COUNT; page++) {
+		const FlashRecordHeader* header = reinterpret_cast<const FlashRecordHeader*>(flashStart + page * FLASH_PAGE_SIZE);
+		if (header->magic != EEPROM_RECORD_MAGIC || (type != 0 && header->type != type)) continue;
+		const FlashRecordHeader* current = reinterpret_cast<const FlashRecordHeader*>(flashStart + newest * FLASH_PAGE_SIZE);
+		if (newest < 0 || (int32_t)(header->sequence - current->sequence) > 0) newest = page;
+	}
+	return newest;
+}
+
+struct GenerationResult {
+	uint32_t corruptions = 0;
+	uint32_t fellBack = 0;              // came back with the last config of the generation before
+	uint32_t boots = 0;
+	uint64_t crcBytes = 0;              // start() checked the CRC of
+	uint64_t recordBytes = 0;           // of every record in the block at those boots
+	bool passed = true;
+};
+
+// Corrupt the newest full record now and then, every reboot after has to come back with the config the save that
+// wrote it started from, the last one of the generation before
+static GenerationResult runGenerations(const Config& start, uint32_t saves) {
+	GenerationResult result;
+	const uint8_t* flashStart = reinterpret_cast<const uint8_t*>(EEPROM_ADDRESS_START);
+	std::map<uint32_t, std::vector<uint8_t>> before;    // config before each full record, by its sequence
+	SimHal::eraseFlash();
+	EEPROM.start();
+	config = start;
+	save(config);
+
+	bool reboot = false;
+	for (uint32_t i = 0; i < saves; i++) {
+		std::vector<uint8_t> previous(saved, saved + savedSize);
+		edit(config, random32());
+		const uint32_t fullRecords = EEPROM.getStats().fullRecords;
+		save(config);
+		// the erases ahead a boot makes, the generation before has to stay in flash. They take the records of a
+		// generation that didn't hold up with them, its sequence numbers come round again.
+		bootPasses();
+		if (EEPROM.getStats().fullRecords != fullRecords) {
+			const FlashRecordHeader* newest = reinterpret_cast<const FlashRecordHeader*>(flashStart +
+				newestRecord(FLASH_RECORD_FULL) * FLASH_PAGE_SIZE);
+			before[newest->sequence] = previous;
+		}
+		if (reboot) {
+			EEPROM.start();
+			if (!bootMatches(saved, savedSize)) {
+				printf("FAIL the save after falling back to an older generation did not boot back\n");
+				result.passed = false;
+				break;
+			}
+			reboot = false;
+		}
+
+		if (random32() % 8 != 0) continue;
+		const int32_t fullPage = newestRecord(FLASH_RECORD_FULL);
+		const FlashRecordHeader* full = reinterpret_cast<const FlashRecordHeader*>(flashStart + fullPage * FLASH_PAGE_SIZE);
+		auto expected = before.find(full->sequence);
+		if (expected == before.end()) continue;
+
+		// clear a bit in its data, the way a worn cell or a cut mid-program reads back
+		const uint32_t offset = fullPage * FLASH_PAGE_SIZE + sizeof(FlashRecordHeader) + random32() % full->dataSize;
+		if (flashStart[offset] == 0) continue;
+		uint8_t page[FLASH_PAGE_SIZE];
+		memset(page, 0xff, sizeof(page));
+		page[offset % FLASH_PAGE_SIZE] = flashStart[offset] & (flashStart[offset] - 1);
+		flash_range_program(flashOffset + offset / FLASH_PAGE_SIZE * FLASH_PAGE_SIZE, page, sizeof(page));
+		result.corruptions++;
+
+		EEPROM.start();
+		result.boots++;
+		result.crcBytes += EEPROM.getStats().startCrcBytes;
+		for (uint32_t p = 0; p < EEPROM_PAGE_COUNT; p++) {
+			const FlashRecordHeader* header = reinterpret_cast<const FlashRecordHeader*>(flashStart + p * FLASH_PAGE_SIZE);
+			if (header->magic == EEPROM_RECORD_MAGIC) result.recordBytes += sizeof(FlashRecordHeader) + header->dataSize;
+		}
+		if (!bootMatches(expected->second.data(), expected->second.size())) {
+			printf("FAIL corrupt full record %lu did not fall back to the generation before it\n", (unsigned long)full->sequence);
+			result.passed = false;
+			break;
+		}
+		result.fellBack++;
+
+		// carry on from there, the next save starts a generation of its own and has to boot back
+		savedSize = EEPROM.size();
+		memcpy(saved, EEPROM.writeCache, savedSize);
+		SimConfig::load(config);
+		reboot = true;
+	}
+	return result;
+}
+
+struct SessionResult {
+	uint32_t saves = 0;
+	uint32_t steps = 0;
+	uint32_t activeStalls = 0;          // steps in passes with the inputs active, has to stay 0
+	uint32_t maxStallUs = 0;            // longest step while playing, has to fit the budget
+	uint32_t erasesAhead = 0;           // in the passes before the host took reports
+	uint32_t heldSteps = 0;             // passes a due erase waited for the reboot
+	uint64_t heldSinceUs = 0;           // into the session, of the save still held at the end, 0 if none was
+	uint64_t maxSaveUs = 0;             // longest a save took from the commit to the last step
+	uint32_t restarted = 0;             // saves started over when the next one came part way through
+	bool passed = true;
+};
+
+// A session of 1 ms input frames, stretches of play with a hotkey save now and then and idle stretches between,
+// stepping FlashPROM after each frame the way GP2040::run does once the host takes reports
+static SessionResult runSession(const Config& start, uint32_t budgetUs, uint32_t seconds) {
+	SessionResult result;
+	// on from the log the runs before left, a boot erases the sectors ahead
+	EEPROM.start();
+	config = start;
+	save(config);
+	const uint32_t erasesAhead = EEPROM.getStats().erasesAhead;
+	bootPasses();
+	result.erasesAhead = EEPROM.getStats().erasesAhead - erasesAhead;
+	EEPROM.setStallBudget(budgetUs);
+
+	bool active = false;
+	uint64_t stretchEnd = SimHal::now();
+	uint64_t saveStart = 0;
+	const uint64_t begin = SimHal::now();
+	const uint64_t end = begin + (uint64_t)seconds * 1000000;
+	const uint32_t heldSteps = EEPROM.getStats().heldSteps;
+	while (SimHal::now() < end) {
+		const uint64_t now = SimHal::now();
+		if (now >= stretchEnd) {
+			active = !active;
+			stretchEnd = now + (active ? 2000 + random32() % 18000 : 100 + random32() % 4000) * 1000ull;
+		}
+		if (active && random32() % 3000 == 0) {
+			edit(config, random32());
+			SimConfig::save(config);
+			savedSize = EEPROM.size();
+			memcpy(saved, EEPROM.writeCache, savedSize);
+			if (saveStart == 0 && EEPROM.pending()) saveStart = now;
+			result.saves++;
+		}
+
+		const uint32_t steps = EEPROM.getStats().steps;
+		EEPROM.step(active);
+		const uint64_t stallUs = SimHal::now() - now;
+		result.steps += EEPROM.getStats().steps - steps;
+		if (stallUs > result.maxStallUs) result.maxStallUs = stallUs;
+		if (active && stallUs > 0) result.activeStalls++;
+		if (saveStart != 0 && !EEPROM.pending()) {
+			if (SimHal::now() - saveStart > result.maxSaveUs) result.maxSaveUs = SimHal::now() - saveStart;
+			saveStart = 0;
+		}
+
+		SimHal::advanceTo(now + 1000);
+	}
+	result.heldSteps = EEPROM.getStats().heldSteps - heldSteps;
+	if (EEPROM.pending()) result.heldSinceUs = saveStart - begin;
+
+	// below a page program the budget is raised to one, or no save would get written
+	const uint32_t effectiveUs = budgetUs < EEPROM_PAGE_PROGRAM_MAX_US ? EEPROM_PAGE_PROGRAM_MAX_US : budgetUs;
+	if (result.maxStallUs > effectiveUs) {
+		printf("FAIL budget %lu us: %lu steps while playing, the longest %lu us\n", (unsigned long)budgetUs,
+			(unsigned long)result.steps, (unsigned long)result.maxStallUs);
+		result.passed = false;
+	}
+	if (result.activeStalls != 0) {
+		printf("FAIL %lu steps ran while the inputs were active\n", (unsigned long)result.activeStalls);
+		result.passed = false;
+	}
+
+	// a reboot writes what was held
+	EEPROM.flush();
+	result.restarted = EEPROM.getStats().restartedSaves;
+	EEPROM.start();
+	if (!bootMatches(saved, savedSize)) {
+		printf("FAIL the last save of the session did not boot back\n");
+		result.passed = false;
+	}
+	EEPROM.setStallBudget(EEPROM_STALL_BUDGET_US);
+	return result;
+}
+
+static void printSession(uint32_t budgetUs, const SessionResult& result) {
+	printf("budget %4lu us  %lu hotkey saves in %lu steps after %lu sectors erased ahead at boot: none while active, longest step %.1f ms, no erase while playing (held %lu passes), ",
+		(unsigned long)budgetUs, (unsigned long)result.saves, (unsigned long)result.steps, (unsigned long)result.erasesAhead,
+		result.maxStallUs / 1000.0, (unsigned long)result.heldSteps);
+	if (result.heldSinceUs != 0) printf("saves from %.0f s on held until the reboot, ", result.heldSinceUs / 1000000.0);
+	printf("%lu restarted, longest save written while playing %.1f s\n", (unsigned long)result.restarted,
+		result.maxSaveUs / 1000000.0);
+}
+
+// A full save the cache changes under part way through starts over after the pages it programmed, with the same
+// sequence as the copy cut short. The reboot after has to load the copy written in full.
+static bool runRestart(const Config& first, const Config& second) {
+	SimHal::eraseFlash();
+	EEPROM.start();
+	config = first;
+	save(config);
+
+	config = second;
+	SimConfig::save(config);
+	const FlashPROMStats before = EEPROM.getStats();
+	for (uint32_t pass = 0; pass < 1000 && EEPROM.getStats().pagesProgrammed - before.pagesProgrammed < 3; pass++) {
+		SimHal::advanceTo(SimHal::now() + 1000);
+		EEPROM.step(false);
+	}
+	edit(config, 0);
+	save(config);
+
+	const FlashPROMStats& after = EEPROM.getStats();
+	bool passed = after.restartedSaves - before.restartedSaves == 1 && after.fullRecords - before.fullRecords == 1;
+	EEPROM.start();
+	passed = passed && bootMatches(saved, savedSize);
+	if (!passed) printf("FAIL a full save started over did not boot back\n");
+	return passed;
+}
+
+// The stall budget is clamped: set above its ceiling an erase still waits for maintain(), set below a page program
+// a save that needs no erase still gets written
+static bool runBudgetClamp(const Config& start) {
+	SimHal::eraseFlash();
+	EEPROM.start();
+	config = start;
+	save(config);
+
+	// the rest of the block holds something, the next save has to erase a sector first
+	uint8_t page[FLASH_PAGE_SIZE];
+	memset(page, 0, sizeof(page));
+	for (uint32_t p = (sizeof(FlashRecordHeader) + savedSize + FLASH_PAGE_SIZE - 1) / FLASH_PAGE_SIZE; p < EEPROM_PAGE_COUNT; p++)
+		flash_range_program(flashOffset + p * FLASH_PAGE_SIZE, page, sizeof(page));
+	EEPROM.start();
+
+	edit(config, 0);
+	SimConfig::save(config);
+	savedSize = EEPROM.size();
+	memcpy(saved, EEPROM.writeCache, savedSize);
+	SimHal::advanceTo(SimHal::now() + EEPROM_WRITE_WAIT * 1000);
+	const FlashPROMStats before = EEPROM.getStats();
+	EEPROM.setStallBudget(UINT32_MAX);
+	EEPROM.step(false);
+	bool passed = EEPROM.getStats().steps == before.steps && EEPROM.getStats().heldSteps == before.heldSteps + 1;
+
+	EEPROM.maintain();
+	EEPROM.setStallBudget(0);
+	EEPROM.step(false);
+	const FlashPROMStats& after = EEPROM.getStats();
+	passed = passed && after.sectorsErased == before.sectorsErased + 1 && after.pagesProgrammed == before.pagesProgrammed + 1 &&
+		!EEPROM.pending();
+	EEPROM.setStallBudget(EEPROM_STALL_BUDGET_US);
+
+	EEPROM.start();
+	passed = passed && bootMatches(saved, savedSize);
+	if (!passed) printf("FAIL the stall budget let an erase run while playing, or held a page program\n");
+	return passed;
+}
+
+// Lay the config out the way ConfigUtils::save did before the log
+static void writeFooterFormat(Config& source) {
+	static uint8_t block[EEPROM_SIZE_BYTES];
+	memset(block, 0, sizeof(block));
+	ConfigFooter footer;
+	footer.dataSize = SimConfig::encode(source, block, sizeof(block) - sizeof(footer));
+	footer.dataCrc = CRC32::calculate(block, footer.dataSize);
+	footer.magic = FOOTER_MAGIC;
+	memmove(block + sizeof(block) - sizeof(footer) - footer.dataSize, block, footer.dataSize);
+	memset(block, 0, sizeof(block) - sizeof(footer) - footer.dataSize);
+	memcpy(block + sizeof(block) - sizeof(footer), &footer, sizeof(footer));
+
+	SimHal::eraseFlash();
+	flash_range_program(flashOffset, block, sizeof(block));
+}
+
+static bool footerIntact() {
+	const uint8_t* flashEnd = reinterpret_cast<const uint8_t*>(EEPROM_ADDRESS_START) + EEPROM_SIZE_BYTES;
+	const ConfigFooter& footer = *reinterpret_cast<const ConfigFooter*>(flashEnd - sizeof(ConfigFooter));
+	return footer.magic == FOOTER_MAGIC && footer.dataSize + sizeof(ConfigFooter) <= EEPROM_SIZE_BYTES &&
+		CRC32::calculate(flashEnd - sizeof(ConfigFooter) - footer.dataSize, footer.dataSize) == footer.dataCrc;
+}
+
+// Every power cut in the first save after an update leaves the old format readable or the log written
+static bool runMigration(const Config& start, uint32_t& cuts) {
+	bool passed = true;
+	for (cuts = 0; ; cuts++) {
+		config = start;
+		EEPROM.start();
+		writeFooterFormat(config);
+		EEPROM.start();
+		if (EEPROM.size() != 0 || !footerIntact()) {
+			printf("FAIL the format before the log is not read as such\n");
+			return false;
+		}
+
+		edit(config, cuts);
+		SimHal::powerLossAfter(cuts);
+		save(config);
+		const bool cut = !SimHal::flashPowered();
+		SimHal::powerOn();
+
+		EEPROM.start();
+		const bool migrated = bootMatches(saved, savedSize);
+		if (!migrated && (EEPROM.size() != 0 || !footerIntact())) {
+			printf("FAIL power cut after %lu operations of the first save lost the config\n", (unsigned long)cuts);
+			passed = false;
+		}
+		if (!cut) {
+			if (!migrated) {
+				printf("FAIL the first save did not move the config to the log\n");
+				passed = false;
+			}
+			break;
+		}
+	}
+	return passed;
+}
+
+// A reset erases the sectors the log is in and no others
+static bool runReset(const Config& start) {
+	SimHal::eraseFlash();
+	EEPROM.start();
+	SimHal::resetFlashStats();
+	EEPROM.reset();
+	EEPROM.flush();
+	bool passed = SimHal::flashStats().sectorsErased == 0;
+
+	config = start;
+	save(config);
+	const uint32_t used = (savedSize + sizeof(FlashRecordHeader) + FLASH_SECTOR_SIZE - 1) / FLASH_SECTOR_SIZE;
+	SimHal::resetFlashStats();
+	EEPROM.reset();
+	EEPROM.flush();
+	passed = passed && SimHal::flashStats().sectorsErased == used;
+	EEPROM.start();
+	passed = passed && EEPROM.size() == 0;
+	if (!passed) printf("FAIL a reset erased sectors the log was not in, or left it readable\n");
+	return passed;
+}
+
+int main(int argc, char** argv) {
+	uint32_t saves = 2000;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--saves") == 0 && i + 1 < argc) saves = strtoul(argv[++i], nullptr, 0);
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoul(argv[++i], nullptr, 0) | 1;
+		else {
+			fprintf(stderr, "usage: %s [--saves N] [--seed S]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	bool passed = true;
+	static Config defaults;
+	static Config profiles;
+
+	SimHal::initFlash();
+	Storage::getInstance().init();
+	defaults = Storage::getInstance().getConfig();
+	profiles = defaults;
+	SimConfig::fillProfilesAndMacros(profiles);
+
+	WearResult defaultsWear = runWear(defaults, saves);
+	printWear("defaults", defaultsWear);
+	WearResult profilesWear = runWear(profiles, saves);
+	printWear("profiles", profilesWear);
+	printf("%-9s %5s        every save: %6u bytes erased %u pages programmed %.1f ms stall, every sector erased on each\n",
+		"before", "", EEPROM_SIZE_BYTES, BENCH_BLOCK_PAGES,
+		(EEPROM_SECTOR_COUNT * BENCH_ERASE_US + BENCH_BLOCK_PAGES * BENCH_PROGRAM_US) / 1000.0);
+	passed = passed && defaultsWear.passed && profilesWear.passed;
+
+	SessionResult session = runSession(profiles, EEPROM_STALL_BUDGET_US, 1800);
+	printf("\n");
+	printSession(EEPROM_STALL_BUDGET_US, session);
+	SessionResult tightSession = runSession(profiles, 1000, 1800);
+	printSession(1000, tightSession);
+	passed = passed && session.passed && tightSession.passed;
+
+	PowerLossResult defaultsLoss = runPowerLoss(defaults, saves);
+	PowerLossResult profilesLoss = runPowerLoss(profiles, saves);
+	printf("\npower cut %lu saves: %lu kept the config before, %lu the one being saved, %lu lost\n",
+		(unsigned long)(defaultsLoss.cuts + profilesLoss.cuts), (unsigned long)(defaultsLoss.kept + profilesLoss.kept),
+		(unsigned long)(defaultsLoss.written + profilesLoss.written), (unsigned long)(defaultsLoss.lost + profilesLoss.lost));
+	passed = passed && defaultsLoss.lost == 0 && profilesLoss.lost == 0;
+
+	GenerationResult defaultsGenerations = runGenerations(defaults, saves);
+	GenerationResult profilesGenerations = runGenerations(profiles, saves);
+	printf("corrupt full record %lu times: %lu fell back to the generation before, boot checked %.0f%% of the record bytes\n",
+		(unsigned long)(defaultsGenerations.corruptions + profilesGenerations.corruptions),
+		(unsigned long)(defaultsGenerations.fellBack + profilesGenerations.fellBack),
+		100.0 * (defaultsGenerations.crcBytes + profilesGenerations.crcBytes) /
+			(defaultsGenerations.recordBytes + profilesGenerations.recordBytes));
+	passed = passed && defaultsGenerations.passed && profilesGenerations.passed &&
+		defaultsGenerations.fellBack == defaultsGenerations.corruptions &&
+		profilesGenerations.fellBack == profilesGenerations.corruptions;
+
+	uint32_t migrationCuts = 0;
+	bool migrated = runMigration(profiles, migrationCuts);
+	printf("migration power cut at each of the %lu operations of the first save, the config before the log stays readable\n",
+		(unsigned long)migrationCuts);
+	passed = passed && migrated && runReset(profiles);
+	bool restarted = runRestart(defaults, profiles);
+	printf("full save started over part way through, the reboot %s the copy written in full\n", restarted ? "loads" : "does not load");
+	passed = passed && restarted && runBudgetClamp(defaults);
+
+	printf("\n# flashprom check %s: %.0f bytes erased per save (was %u), longest stall while playing %.1f ms (was %.1f ms), most worn sector %lu erases in %lu saves\n",
+		passed ? "passed" : "FAILED", profilesWear.flash.sectorsErased * FLASH_SECTOR_SIZE / (double)profilesWear.saves,
+		EEPROM_SIZE_BYTES, session.maxStallUs / 1000.0,
+		(EEPROM_SECTOR_COUNT * BENCH_ERASE_US + BENCH_BLOCK_PAGES * BENCH_PROGRAM_US) / 1000.0,
+		(unsigned long)profilesWear.maxSectorErases, (unsigned long)saves);
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,329 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#include "simhal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include <map>
+#include <utility>
+
+#include "pico/time.h"
+#include "hardware/adc.h"
+#include "hardware/flash.h"
+#include "hardware/gpio.h"
+#include "hardware/pio.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "hardware/watchdog.h"
+#include "hardware/structs/usb.h"
+#include "tusb.h"
+#include "device/usbd_pvt.h"
+
+// Full speed USB, the host sends a SOF every ms
+#define SIM_FRAME_US 1000
+
+// Reading the SOF frame number takes this long, enough for a spin on it to reach the next frame
+#define SIM_SOF_READ_US 1
+
+#define SIM_ADC_CHANNELS 5
+
+// 2 MB, as on the Pico, with the typical sector erase and page program times of its W25Q16JV
+#define SIM_FLASH_SIZE (2u * 1024 * 1024)
+#define SIM_FLASH_ERASE_US 45000
+#define SIM_FLASH_PROGRAM_US 400
+
+// key is (time, sequence) so events at the same time keep their scheduling order
+typedef std::pair<uint64_t, uint64_t> EventKey;
+
+thread_local uint simCoreNum = 0;
+
+static uint64_t simTime = 0;
+static uint64_t sequence = 0;
+static std::map<EventKey, std::function<void()>> events;
+
+static uint32_t pinLevels = ~0u; // every input pulled up
+static uint16_t adcValues[SIM_ADC_CHANNELS] = { };
+static uint adcInput = 0;
+
+static uint8_t inflightReport[CFG_TUD_ENDPOINT0_SIZE];
+static uint16_t inflightLen = 0;
+static bool inflight = false;
+static uint32_t pollInterval = SIM_FRAME_US;
+static SimHal::ReportSink reportSink;
+
+static uint8_t* flash = nullptr;
+static SimHal::FlashStats flashCounters;
+static uint32_t sectorEraseCounts[SIM_FLASH_SIZE / FLASH_SECTOR_SIZE];
+static uint32_t flashOpsToPowerLoss = 0;
+static bool flashPower = true;
+static uint32_t flashNoise = 0x2545f491;
+
+uint64_t SimHal::now() {
+	return simTime;
+}
+
+void SimHal::advanceTo(uint64_t time) {
+	while (!events.empty() && events.begin()->first.first <= time) {
+		auto event = events.begin();
+		std::function<void()> callback = std::move(event->second);
+		// an event due while a flash operation held the clock up runs late
+		if (event->first.first > simTime) simTime = event->first.first;
+		events.erase(event);
+		callback();
+	}
+
+	if (time > simTime) simTime = time;
+}
+
+void SimHal::advance(uint64_t us) {
+	advanceTo(simTime + us);
+}
+
+void SimHal::schedule(uint64_t time, std::function<void()> callback) {
+	events.emplace(EventKey(time, sequence++), std::move(callback));
+}
+
+void SimHal::setButton(uint8_t pin, bool pressed) {
+	if (pressed)
+		pinLevels &= ~(1u << pin);
+	else
+		pinLevels |= (1u << pin);
+}
+
+void SimHal::setAdc(uint8_t channel, uint16_t value) {
+	if (channel < SIM_ADC_CHANNELS) adcValues[channel] = value & 0xfff;
+}
+
+uint16_t SimHal::frameNumber() {
+	return (simTime / SIM_FRAME_US) & USB_SOF_RD_BITS;
+}
+
+static void hostPoll() {
+	if (inflight) {
+		inflight = false;
+		if (reportSink) reportSink(simTime, inflightReport, inflightLen);
+		tud_hid_report_complete_cb(0, inflightReport, inflightLen);
+	}
+
+	SimHal::schedule(simTime + pollInterval, hostPoll);
+}
+
+void SimHal::startHost(uint32_t interval, uint32_t offset, ReportSink sink) {
+	pollInterval = interval;
+	reportSink = sink;
+
+	// first poll in the frame after the current one, offset from its SOF
+	uint64_t frame = (simTime / SIM_FRAME_US) + 1;
+	schedule(frame * SIM_FRAME_US + (offset % SIM_FRAME_US), hostPoll);
+}
+
+void SimHal::initFlash() {
+	if (flash != nullptr) return;
+
+	void* mapped = mmap((void*)(uintptr_t)XIP_BASE, SIM_FLASH_SIZE, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+	if (mapped != (void*)(uintptr_t)XIP_BASE) {
+		fprintf(stderr, "could not map the flash at 0x%08x\n", XIP_BASE);
+		abort();
+	}
+	flash = (uint8_t*)mapped;
+	memset(flash, 0xff, SIM_FLASH_SIZE);
+}
+
+void SimHal::eraseFlash() {
+	initFlash();
+	memset(flash, 0xff, SIM_FLASH_SIZE);
+}
+
+const SimHal::FlashStats& SimHal::flashStats() {
+	return flashCounters;
+}
+
+uint32_t SimHal::sectorErases(uint32_t flash_offs) {
+	return (flash_offs < SIM_FLASH_SIZE) ? sectorEraseCounts[flash_offs / FLASH_SECTOR_SIZE] : 0;
+}
+
+void SimHal::resetFlashStats() {
+	flashCounters = FlashStats();
+	memset(sectorEraseCounts, 0, sizeof(sectorEraseCounts));
+}
+
+void SimHal::powerLossAfter(uint32_t ops) {
+	flashOpsToPowerLoss = ops + 1;
+}
+
+bool SimHal::flashPowered() {
+	return flashPower;
+}
+
+void SimHal::powerOn() {
+	flashPower = true;
+	flashOpsToPowerLoss = 0;
+}
+
+// Whether the next erase or program goes through in full, the one the power cut hits is torn and leaves random bits
+static bool flashOperation(bool& torn) {
+	torn = false;
+	if (!flashPower) return false;
+	if (flashOpsToPowerLoss != 0 && --flashOpsToPowerLoss == 0) {
+		flashPower = false;
+		torn = true;
+	}
+	return true;
+}
+
+static uint8_t noise() {
+	flashNoise ^= flashNoise << 13;
+	flashNoise ^= flashNoise >> 17;
+	flashNoise ^= flashNoise << 5;
+	return (uint8_t)flashNoise;
+}
+
+// Pico SDK
+
+uint64_t time_us_64(void) { return simTime; }
+uint32_t time_us_32(void) { return (uint32_t)simTime; }
+
+void sleep_us(uint64_t us) { SimHal::advance(us); }
+void sleep_ms(uint32_t ms) { SimHal::advance((uint64_t)ms * 1000); }
+void busy_wait_us(uint64_t us) { SimHal::advance(us); }
+void busy_wait_us_32(uint32_t us) { SimHal::advance(us); }
+void busy_wait_ms(uint32_t ms) { SimHal::advance((uint64_t)ms * 1000); }
+
+static alarm_id_t nextAlarmId = 1;
+static std::map<alarm_id_t, bool> activeAlarms;
+
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+	alarm_id_t id = nextAlarmId++;
+	activeAlarms[id] = true;
+	SimHal::schedule(simTime + (uint64_t)ms * 1000, [id, callback, user_data]() {
+		if (activeAlarms.erase(id) != 0) callback(id, user_data);
+	});
+	return id;
+}
+
+bool cancel_alarm(alarm_id_t alarm_id) {
+	return activeAlarms.erase(alarm_id) != 0;
+}
+
+uint32_t gpio_get_all(void) { return pinLevels; }
+bool gpio_get(uint gpio) { return (pinLevels >> gpio) & 1; }
+void gpio_put(uint gpio, bool value) {}
+void gpio_init(uint gpio) {}
+void gpio_deinit(uint gpio) {}
+void gpio_set_dir(uint gpio, bool out) {}
+void gpio_pull_up(uint gpio) {}
+void gpio_pull_down(uint gpio) {}
+void gpio_disable_pulls(uint gpio) {}
+void gpio_set_function(uint gpio, enum gpio_function fn) {}
+enum gpio_function gpio_get_function(uint gpio) { return GPIO_FUNC_SIO; }
+
+void adc_init(void) {}
+void adc_gpio_init(uint gpio) {}
+void adc_select_input(uint input) { adcInput = input; }
+uint adc_get_selected_input(void) { return adcInput; }
+uint16_t adc_read(void) { return (adcInput < SIM_ADC_CHANNELS) ? adcValues[adcInput] : 0; }
+void adc_set_temp_sensor_enabled(bool enable) {}
+
+spin_lock_t sim_spin_locks[NUM_SPIN_LOCKS];
+static uint nextSpinLock = 0;
+
+int spin_lock_claim_unused(bool required) {
+	if (nextSpinLock < NUM_SPIN_LOCKS) return nextSpinLock++;
+	if (required) abort();
+	return -1;
+}
+
+void flash_range_erase(uint32_t flash_offs, size_t count) {
+	SimHal::initFlash();
+	if ((flash_offs | count) % FLASH_SECTOR_SIZE != 0 || flash_offs + count > SIM_FLASH_SIZE) {
+		fprintf(stderr, "flash_range_erase(0x%x, 0x%zx) is not sector aligned\n", flash_offs, count);
+		abort();
+	}
+
+	for (size_t offset = 0; offset < count; offset += FLASH_SECTOR_SIZE) {
+		bool torn;
+		if (!flashOperation(torn)) return;
+		uint8_t* sector = flash + flash_offs + offset;
+		for (uint32_t i = 0; i < FLASH_SECTOR_SIZE; i++) sector[i] = torn ? (sector[i] | noise()) : 0xff;
+		flashCounters.sectorsErased++;
+		sectorEraseCounts[(flash_offs + offset) / FLASH_SECTOR_SIZE]++;
+		flashCounters.busyUs += SIM_FLASH_ERASE_US;
+		simTime += SIM_FLASH_ERASE_US;
+	}
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count) {
+	SimHal::initFlash();
+	if ((flash_offs | count) % FLASH_PAGE_SIZE != 0 || flash_offs + count > SIM_FLASH_SIZE) {
+		fprintf(stderr, "flash_range_program(0x%x, 0x%zx) is not page aligned\n", flash_offs, count);
+		abort();
+	}
+
+	for (size_t offset = 0; offset < count; offset += FLASH_PAGE_SIZE) {
+		bool torn;
+		if (!flashOperation(torn)) return;
+		uint8_t* page = flash + flash_offs + offset;
+		for (uint32_t i = 0; i < FLASH_PAGE_SIZE; i++) page[i] &= torn ? (data[offset + i] | noise()) : data[offset + i];
+		flashCounters.pagesProgrammed++;
+		flashCounters.busyUs += SIM_FLASH_PROGRAM_US;
+		simTime += SIM_FLASH_PROGRAM_US;
+	}
+}
+
+void watchdog_reboot(uint32_t pc, uint32_t sp, uint32_t delay_ms) {
+	printf("# t_us=%llu watchdog reboot\n", (unsigned long long)simTime);
+}
+
+pio_hw_t sim_pio_hw[2];
+
+static usb_hw_t simUsbHw;
+usb_hw_t *const usb_hw = &simUsbHw;
+
+sim_sof_rd_t::operator uint32_t() const {
+	SimHal::advance(SIM_SOF_READ_US);
+	return SimHal::frameNumber();
+}
+
+// TinyUSB device, always mounted and never suspended
+
+bool tud_init(uint8_t rhport) { return true; }
+void tud_task(void) {}
+bool tud_mounted(void) { return true; }
+bool tud_ready(void) { return true; }
+bool tud_suspended(void) { return false; }
+bool tud_remote_wakeup(void) { return true; }
+
+bool tud_hid_n_ready(uint8_t instance) {
+	return !inflight;
+}
+
+bool tud_hid_n_report(uint8_t instance, uint8_t report_id, void const* report, uint16_t len) {
+	if (inflight) return false;
+
+	// the report ID goes in front of the report, like TinyUSB does
+	uint16_t offset = 0;
+	if (report_id != 0) inflightReport[offset++] = report_id;
+	if (len > sizeof(inflightReport) - offset) len = sizeof(inflightReport) - offset;
+	memcpy(inflightReport + offset, report, len);
+	inflightLen = len + offset;
+	inflight = true;
+	return true;
+}
+
+bool usbd_edpt_xfer(uint8_t rhport, uint8_t ep_addr, uint8_t * buffer, uint16_t total_bytes) { return false; }
+bool usbd_edpt_busy(uint8_t rhport, uint8_t ep_addr) { return false; }
+bool usbd_edpt_claim(uint8_t rhport, uint8_t ep_addr) { return true; }
+bool usbd_edpt_release(uint8_t rhport, uint8_t ep_addr) { return true; }
+
+void hidd_init(void) {}
+void hidd_reset(uint8_t rhport) {}
+uint16_t hidd_open(uint8_t rhport, tusb_desc_interface_t const * desc_intf, uint16_t max_len) { return 0; }
+bool hidd_control_xfer_cb(uint8_t rhport, uint8_t stage, tusb_control_request_t const * request) { return false; }
+bool hidd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t event, uint32_t xferred_bytes) { return true; }
@@ -0,0 +1,38 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Simulator stand-in for the TinyUSB header of the same name, reports are captured by the simulated host
+
+#ifndef SIM_CLASS_HID_DEVICE_H_
+#define SIM_CLASS_HID_DEVICE_H_
+
+#include "common/tusb_types.h"
+#include "class/hid/hid.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+bool tud_hid_n_ready(uint8_t instance);
+bool tud_hid_n_report(uint8_t instance, uint8_t report_id, void const* report, uint16_t len);
+
+static inline bool tud_hid_ready(void) { return tud_hid_n_ready(0); }
+static inline bool tud_hid_report(uint8_t report_id, void const* report, uint16_t len) { return tud_hid_n_report(0, report_id, report, len); }
+
+// Invoked when an IN report reached the host
+void tud_hid_report_complete_cb(uint8_t instance, uint8_t const* report, uint16_t len);
+
+// class driver entry points, unused by the simulated host but referenced by the drivers' class_driver tables
+void     hidd_init(void);
+void     hidd_reset(uint8_t rhport);
+uint16_t hidd_open(uint8_t rhport, tusb_desc_interface_t const * desc_intf, uint16_t max_len);
+bool     hidd_control_xfer_cb(uint8_t rhport, uint8_t stage, tusb_control_request_t const * request);
+bool     hidd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t event, uint32_t xferred_bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,55 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Simulator stand-in for the TinyUSB header of the same name
+
+#ifndef SIM_TUSB_TYPES_H_
+#define SIM_TUSB_TYPES_H_
+
+#include <stdint.h>
+
+typedef enum {
+	XFER_RESULT_SUCCESS = 0,
+	XFER_RESULT_FAILED,
+	XFER_RESULT_STALLED,
+	XFER_RESULT_TIMEOUT,
+	XFER_RESULT_INVALID
+} xfer_result_t;
+
+typedef enum {
+	CONTROL_STAGE_IDLE = 0,
+	CONTROL_STAGE_SETUP,
+	CONTROL_STAGE_DATA,
+	CONTROL_STAGE_ACK
+} tusb_control_stage_t;
+
+typedef struct __attribute__ ((packed)) {
+	union {
+		struct __attribute__ ((packed)) {
+			uint8_t recipient :  5;
+			uint8_t type      :  2;
+			uint8_t direction :  1;
+		} bmRequestType_bit;
+		uint8_t bmRequestType;
+	};
+	uint8_t  bRequest;
+	uint16_t wValue;
+	uint16_t wIndex;
+	uint16_t wLength;
+} tusb_control_request_t;
+
+typedef struct __attribute__ ((packed)) {
+	uint8_t bLength;
+	uint8_t bDescriptorType;
+	uint8_t bInterfaceNumber;
+	uint8_t bAlternateSetting;
+	uint8_t bNumEndpoints;
+	uint8_t bInterfaceClass;
+	uint8_t bInterfaceSubClass;
+	uint8_t bInterfaceProtocol;
+	uint8_t iInterface;
+} tusb_desc_interface_t;
+
+#endif
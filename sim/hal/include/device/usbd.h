@@ -0,0 +1,28 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Simulator stand-in for the TinyUSB header of the same name, the device state is driven by the simulated host
+
+#ifndef SIM_DEVICE_USBD_H_
+#define SIM_DEVICE_USBD_H_
+
+#include "common/tusb_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+bool tud_init(uint8_t rhport);
+void tud_task(void);
+bool tud_mounted(void);
+bool tud_ready(void);
+bool tud_suspended(void);
+bool tud_remote_wakeup(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,38 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Simulator stand-in for the TinyUSB header of the same name, IN transfers are captured by the simulated host
+
+#ifndef SIM_DEVICE_USBD_PVT_H_
+#define SIM_DEVICE_USBD_PVT_H_
+
+#include "common/tusb_types.h"
+
+typedef struct {
+#if CFG_TUSB_DEBUG >= 2
+	char const* name;
+#endif
+	void     (* init            ) (void);
+	void     (* reset           ) (uint8_t rhport);
+	uint16_t (* open            ) (uint8_t rhport, tusb_desc_interface_t const * desc_intf, uint16_t max_len);
+	bool     (* control_xfer_cb ) (uint8_t rhport, uint8_t stage, tusb_control_request_t const * request);
+	bool     (* xfer_cb         ) (uint8_t rhport, uint8_t ep_addr, xfer_result_t result, uint32_t xferred_bytes);
+	void     (* sof             ) (uint8_t rhport, uint32_t frame_count);
+} usbd_class_driver_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+bool usbd_edpt_xfer(uint8_t rhport, uint8_t ep_addr, uint8_t * buffer, uint16_t total_bytes);
+bool usbd_edpt_busy(uint8_t rhport, uint8_t ep_addr);
+bool usbd_edpt_claim(uint8_t rhport, uint8_t ep_addr);
+bool usbd_edpt_release(uint8_t rhport, uint8_t ep_addr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
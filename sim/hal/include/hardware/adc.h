@@ -0,0 +1,28 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Simulator stand-in for the Pico SDK header of the same name, readings come from the simulated channels
+
+#ifndef SIM_HARDWARE_ADC_H_
+#define SIM_HARDWARE_ADC_H_
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void adc_init(void);
+void adc_gpio_init(uint gpio);
+void adc_select_input(uint input);
+uint adc_get_selected_input(void);
+uint16_t adc_read(void);
+void adc_set_temp_sensor_enabled(bool enable);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,49 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Simulator stand-in for the Pico SDK header of the same name, state machines accept everything and do nothing
+
+#ifndef SIM_HARDWARE_PIO_H_
+#define SIM_HARDWARE_PIO_H_
+
+#include "pico/types.h"
+
+typedef struct pio_hw { uint32_t unused; } pio_hw_t;
+typedef pio_hw_t *PIO;
+
+extern pio_hw_t sim_pio_hw[2];
+#define pio0 (&sim_pio_hw[0])
+#define pio1 (&sim_pio_hw[1])
+
+struct pio_program {
+	const uint16_t *instructions;
+	uint8_t length;
+	int8_t origin;
+};
+
+typedef struct { uint32_t unused; } pio_sm_config;
+
+enum pio_fifo_join { PIO_FIFO_JOIN_NONE = 0, PIO_FIFO_JOIN_TX = 1, PIO_FIFO_JOIN_RX = 2 };
+
+static inline pio_sm_config pio_get_default_sm_config(void) { pio_sm_config c = { 0 }; return c; }
+static inline void sm_config_set_wrap(pio_sm_config *c, uint wrap_target, uint wrap) {}
+static inline void sm_config_set_sideset(pio_sm_config *c, uint bit_count, bool optional, bool pindirs) {}
+static inline void sm_config_set_sideset_pins(pio_sm_config *c, uint sideset_base) {}
+static inline void sm_config_set_out_pins(pio_sm_config *c, uint out_base, uint out_count) {}
+static inline void sm_config_set_set_pins(pio_sm_config *c, uint set_base, uint set_count) {}
+static inline void sm_config_set_out_shift(pio_sm_config *c, bool shift_right, bool autopull, uint pull_threshold) {}
+static inline void sm_config_set_fifo_join(pio_sm_config *c, enum pio_fifo_join join) {}
+static inline void sm_config_set_clkdiv(pio_sm_config *c, float div) {}
+
+static inline bool pio_can_add_program(PIO pio, const struct pio_program *program) { return true; }
+static inline uint pio_add_program(PIO pio, const struct pio_program *program) { return 0; }
+static inline int pio_claim_unused_sm(PIO pio, bool required) { return 0; }
+static inline void pio_gpio_init(PIO pio, uint pin) {}
+static inline int pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base, uint pin_count, bool is_out) { return 0; }
+static inline int pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config) { return 0; }
+static inline void pio_sm_set_enabled(PIO pio, uint sm, bool enabled) {}
+static inline void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data) {}
+
+#endif
@@ -0,0 +1,26 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Simulator stand-in for the Pico SDK header of the same name, only the SOF frame number register
+
+#ifndef SIM_HARDWARE_STRUCTS_USB_H_
+#define SIM_HARDWARE_STRUCTS_USB_H_
+
+#include "pico/types.h"
+
+#define USB_SOF_RD_BITS 0x000007ffu
+
+// Reading the frame number also lets the simulated clock move, so code spinning on it for the next SOF ends
+struct sim_sof_rd_t {
+	operator uint32_t() const;
+};
+
+typedef struct {
+	sim_sof_rd_t sof_rd;
+} usb_hw_t;
+
+extern usb_hw_t *const usb_hw;
+
+#endif
@@ -0,0 +1,28 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Simulator stand-in for the Pico SDK header of the same name, the simulator runs a single core
+
+#ifndef SIM_HARDWARE_SYNC_H_
+#define SIM_HARDWARE_SYNC_H_
+
+#include "pico/types.h"
+
+#define NUM_SPIN_LOCKS 32u
+
+typedef volatile uint32_t spin_lock_t;
+
+extern spin_lock_t sim_spin_locks[NUM_SPIN_LOCKS];
+
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+static inline void restore_interrupts(uint32_t status) {}
+
+static inline spin_lock_t *spin_lock_instance(uint lock_num) { return &sim_spin_locks[lock_num]; }
+static inline bool is_spin_locked(spin_lock_t *lock) { return *lock != 0; }
+static inline uint32_t spin_lock_blocking(spin_lock_t *lock) { *lock = 1; return 0; }
+static inline void spin_unlock(spin_lock_t *lock, uint32_t saved_irq) { *lock = 0; }
+int spin_lock_claim_unused(bool required);
+
+#endif
@@ -0,0 +1,17 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Simulator stand-in for the TinyUSB header of the same name, the simulator has no USB host port
+
+#ifndef SIM_HOST_USBH_PVT_H_
+#define SIM_HOST_USBH_PVT_H_
+
+#include "common/tusb_types.h"
+
+typedef struct {
+	void (* init)(void);
+} usbh_class_driver_t;
+
+#endif
@@ -0,0 +1,20 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Simulator stand-in for the Pico SDK header of the same name, the simulator runs a single core
+
+#ifndef SIM_PICO_CRITICAL_SECTION_H_
+#define SIM_PICO_CRITICAL_SECTION_H_
+
+#include "pico/types.h"
+
+typedef struct { uint32_t save; } critical_section_t;
+
+static inline void critical_section_init(critical_section_t *crit_sec) {}
+static inline void critical_section_enter_blocking(critical_section_t *crit_sec) {}
+static inline void critical_section_exit(critical_section_t *crit_sec) {}
+static inline void critical_section_deinit(critical_section_t *crit_sec) {}
+
+#endif
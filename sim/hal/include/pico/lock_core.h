@@ -0,0 +1,15 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Simulator stand-in for the Pico SDK header of the same name
+
+#ifndef SIM_PICO_LOCK_CORE_H_
+#define SIM_PICO_LOCK_CORE_H_
+
+#include "pico/platform.h"
+#include "pico/time.h"
+#include "hardware/sync.h"
+
+#endif
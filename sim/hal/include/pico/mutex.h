@@ -0,0 +1,20 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Simulator stand-in for the Pico SDK header of the same name, the simulator runs a single core
+
+#ifndef SIM_PICO_MUTEX_H_
+#define SIM_PICO_MUTEX_H_
+
+#include "pico/types.h"
+
+typedef struct { bool owned; } mutex_t;
+
+static inline void mutex_init(mutex_t *mtx) { mtx->owned = false; }
+static inline void mutex_enter_blocking(mutex_t *mtx) { mtx->owned = true; }
+static inline bool mutex_try_enter(mutex_t *mtx, uint32_t *owner_out) { if (mtx->owned) return false; mtx->owned = true; return true; }
+static inline void mutex_exit(mutex_t *mtx) { mtx->owned = false; }
+
+#endif
@@ -0,0 +1,37 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Simulator stand-in for the Pico SDK header of the same name
+
+#ifndef SIM_PICO_PLATFORM_H_
+#define SIM_PICO_PLATFORM_H_
+
+#include <assert.h>
+
+#include "pico/types.h"
+
+#define NUM_BANK0_GPIOS 30
+#define NUM_ADC_CHANNELS 5
+#define SRAM_END 0x20042000u
+
+#define _u(x) x ## u
+
+#define __not_in_flash_func(func) func
+#define __no_inline_not_in_flash_func(func) func
+#define __time_critical_func(func) func
+#define __uninitialized_ram(group) group
+#define __force_inline inline
+
+static inline void tight_loop_contents(void) {}
+static inline void __wfe(void) {}
+static inline void __sev(void) {}
+
+#ifdef __cplusplus
+// Core the calling thread stands for, 0 unless a host tool running a thread per core sets it
+extern thread_local uint simCoreNum;
+static inline uint get_core_num(void) { return simCoreNum; }
+#endif
+
+#endif
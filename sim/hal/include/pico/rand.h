@@ -0,0 +1,21 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Simulator stand-in for the Pico SDK header of the same name, a fixed sequence so runs stay reproducible
+
+#ifndef SIM_PICO_RAND_H_
+#define SIM_PICO_RAND_H_
+
+#include "pico/types.h"
+
+static inline uint32_t get_rand_32(void) {
+	static uint32_t state = 0x2040ce01u;
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+#endif
@@ -0,0 +1,21 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Simulator stand-in for the Pico SDK header of the same name
+
+#ifndef SIM_PICO_UNIQUE_ID_H_
+#define SIM_PICO_UNIQUE_ID_H_
+
+#include <string.h>
+
+#include "pico/types.h"
+
+#define PICO_UNIQUE_BOARD_ID_SIZE_BYTES 8
+
+typedef struct { uint8_t id[PICO_UNIQUE_BOARD_ID_SIZE_BYTES]; } pico_unique_board_id_t;
+
+static inline void pico_get_unique_board_id(pico_unique_board_id_t *id_out) { memset(id_out->id, 0x5a, sizeof(id_out->id)); }
+
+#endif
@@ -0,0 +1,15 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Simulator stand-in for the Pico-PIO-USB header of the same name, the simulator has no USB host port
+
+#ifndef SIM_PIO_USB_H_
+#define SIM_PIO_USB_H_
+
+#include <stdint.h>
+
+typedef struct { uint8_t unused; } usb_device_t;
+
+#endif
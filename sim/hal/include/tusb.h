@@ -0,0 +1,48 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Simulator stand-in for the TinyUSB header of the same name, only the device API the gamepad drivers use
+
+#ifndef SIM_TUSB_H_
+#define SIM_TUSB_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#define OPT_MCU_NONE            0
+
+#define OPT_OS_NONE             1
+#define OPT_OS_PICO             5
+
+#define OPT_MODE_NONE           0x00
+#define OPT_MODE_DEVICE         0x01
+#define OPT_MODE_HOST           0x02
+#define OPT_MODE_FULL_SPEED     0x00
+#define OPT_MODE_HIGH_SPEED     0x04
+#define OPT_MODE_DEFAULT_SPEED  OPT_MODE_FULL_SPEED
+
+#define TUD_OPT_RHPORT          0
+
+#define TU_ATTR_PACKED          __attribute__ ((packed))
+#define TU_ATTR_WEAK            __attribute__ ((weak))
+#define TU_ARRAY_SIZE(_arr)     (sizeof(_arr) / sizeof(_arr[0]))
+#define TU_MIN(_x, _y)          (((_x) < (_y)) ? (_x) : (_y))
+#define TU_MAX(_x, _y)          (((_x) > (_y)) ? (_x) : (_y))
+#define TU_VERIFY(_cond, ...)   do { if (!(_cond)) return __VA_ARGS__; } while (0)
+#define TU_ASSERT(_cond, ...)   TU_VERIFY(_cond, __VA_ARGS__)
+
+#define TUSB_DIR_IN_MASK        0x80
+
+// the firmware's TinyUSB configuration
+#include "tusb_config.h"
+
+#include "common/tusb_types.h"
+#include "device/usbd.h"
+#include "class/hid/hid.h"
+#include "class/hid/hid_device.h"
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#ifndef SIMHAL_H_
+#define SIMHAL_H_
+
+#include <stdint.h>
+#include <functional>
+
+/**
+ * @brief The simulated board behind the SDK and TinyUSB stand-ins in sim/hal/include.
+ *
+ * Time only moves when the simulator says so: advancing the clock (directly, or through sleep_us, busy_wait_us
+ * or a read of the SOF frame number) runs every scheduled event up to the new time in order, so a run only
+ * depends on its inputs.
+ *
+ * The USB host polls the IN endpoint every pollInterval us, offset by pollOffset us from the frame's SOF,
+ * taking the report the driver armed with tud_hid_report and completing the transfer. Until then
+ * tud_hid_ready returns false, like on the device.
+ *
+ * The flash is mapped at XIP_BASE, so code reading it through pointers works as on the device. Erasing and
+ * programming behave like NOR flash (erase sets a whole sector to 0xff, programming only clears bits) and are
+ * take the typical times of the Pico's W25Q16JV: the clock moves on by that much without running any event, the
+ * way the CPU waits on the flash with interrupts off, and whatever came due meanwhile runs late. A power cut can be set up to hit a later erase or
+ * program: that one is left half done and the flash ignores everything after it until the power comes back.
+ */
+namespace SimHal {
+	typedef std::function<void(uint64_t time, const uint8_t* report, uint16_t len)> ReportSink;
+
+	// Current simulated time in us
+	uint64_t now();
+	// Move the clock forward, running all events scheduled up to the new time
+	void advance(uint64_t us);
+	void advanceTo(uint64_t time);
+	// Run callback at time, events with the same time run in the order they were scheduled
+	void schedule(uint64_t time, std::function<void()> callback);
+
+	// Drive a button, pressed pulls the pin low as the switch to ground would
+	void setButton(uint8_t pin, bool pressed);
+	// Set the 12 bit value an ADC channel reads
+	void setAdc(uint8_t channel, uint16_t value);
+
+	// Start polling the device, reports are handed to sink as the host receives them
+	void startHost(uint32_t pollInterval, uint32_t pollOffset, ReportSink sink);
+	// Frame number the host sent with the last SOF
+	uint16_t frameNumber();
+
+	struct FlashStats {
+		uint32_t sectorsErased = 0;
+		uint32_t pagesProgrammed = 0;
+		uint64_t busyUs = 0;        // erasing and programming at the typical datasheet times
+	};
+
+	// Map the flash, erased, if it isn't yet. Flash operations do this on their own, reads through XIP
+	// pointers before the first one need it called.
+	void initFlash();
+	// Erase all of it, without counting
+	void eraseFlash();
+	const FlashStats& flashStats();
+	// Times the sector at flash_offs was erased
+	uint32_t sectorErases(uint32_t flash_offs);
+	void resetFlashStats();
+	// Cut the power during the sector erase or page program after the next ops ones
+	void powerLossAfter(uint32_t ops);
+	bool flashPowered();
+	void powerOn();
+}
+
+#endif
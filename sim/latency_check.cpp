@@ -0,0 +1,286 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Latency tracer check
+//
+// Drives LatencyTracer with known timestamps instead of the loop: a latency at each edge of the histogram
+// buckets, the oldest unsent change being the one a report carries, a change arriving while the report before
+// it is in flight, reports the driver drops, the us timer wrapping and stats per input mode kept over init.
+// Then random sample, queue and complete sequences against a model of the tracer, comparing count, min, max,
+// sum and every histogram bucket of both trace points.
+//
+//   gp2040ce_latency_check [--seed N] [--events N]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "latencytracer.h"
+
+static uint32_t rngState = 1;
+
+static uint32_t nextRandom() {
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 17;
+	rngState ^= rngState << 5;
+	return rngState;
+}
+
+static bool passed = true;
+
+// Bucket of a latency counted out bit by bit, the tracer takes it from the leading zeros
+static uint8_t bucketOf(uint32_t elapsed) {
+	uint8_t bits = 0;
+	while (bits < 32 && ((uint64_t)1 << bits) <= elapsed) bits++;
+	return bits < LATENCY_TRACER_HISTOGRAM_BUCKETS ? bits : LATENCY_TRACER_HISTOGRAM_BUCKETS - 1;
+}
+
+static void record(LatencyStats& stats, uint32_t elapsed) {
+	if (stats.count == 0 || elapsed < stats.min) stats.min = elapsed;
+	if (elapsed > stats.max) stats.max = elapsed;
+	stats.sum += elapsed;
+	stats.count++;
+	stats.histogram[bucketOf(elapsed)]++;
+}
+
+static bool sameStats(const LatencyStats& expected, InputMode mode, LatencyTracePoint point, const char* label) {
+	const LatencyStats& actual = LatencyTracer::getStats(mode, point);
+	const char* pointName = point == LATENCY_POINT_QUEUED ? "queued" : "completed";
+	if (actual.count != expected.count || actual.sum != expected.sum ||
+			(expected.count != 0 && (actual.min != expected.min || actual.max != expected.max))) {
+		printf("FAIL %s: %s latency of mode %d count %u min %u max %u sum %llu, expected %u %u %u %llu\n", label,
+			pointName, mode, actual.count, actual.min, actual.max, (unsigned long long)actual.sum, expected.count,
+			expected.min, expected.max, (unsigned long long)expected.sum);
+		return false;
+	}
+	for (uint8_t bucket = 0; bucket < LATENCY_TRACER_HISTOGRAM_BUCKETS; bucket++) {
+		if (actual.histogram[bucket] != expected.histogram[bucket]) {
+			printf("FAIL %s: %s latency of mode %d has %u in bucket %u, expected %u\n", label, pointName, mode,
+				actual.histogram[bucket], bucket, expected.histogram[bucket]);
+			return false;
+		}
+	}
+	return true;
+}
+
+static void check(bool condition, const char* label) {
+	if (!condition) {
+		printf("FAIL %s\n", label);
+		passed = false;
+	}
+}
+
+// One change sampled at sampleUs, queued at queuedUs and completed at completedUs
+static void traceReport(uint32_t sampleUs, uint32_t queuedUs, uint32_t completedUs) {
+	LatencyTracer::sample(sampleUs);
+	LatencyTracer::stateChanged(true);
+	LatencyTracer::reportQueued(queuedUs);
+	LatencyTracer::reportCompleted(completedUs);
+}
+
+static void checkBuckets() {
+	static const struct {
+		uint32_t elapsed;
+		uint8_t bucket;
+	} edges[] = {
+		{ 0, 0 }, { 1, 1 }, { 2, 2 }, { 3, 2 }, { 4, 3 }, { 7, 3 }, { 8, 4 }, { 125, 7 }, { 999, 10 },
+		{ 1023, 10 }, { 1024, 11 }, { 8191, 13 }, { 8192, 14 }, { 16383, 14 }, { 16384, 15 }, { 1000000, 15 },
+		{ UINT32_MAX, 15 },
+	};
+
+	for (const auto& edge : edges) {
+		LatencyTracer::reset();
+		LatencyTracer::init(INPUT_MODE_SWITCH);
+		// queued after the latency, completed a ms after that, the completed latency lands a bucket of its own
+		traceReport(5000, 5000 + edge.elapsed, 5000 + edge.elapsed + 1000);
+		const LatencyStats& queued = LatencyTracer::getStats(INPUT_MODE_SWITCH, LATENCY_POINT_QUEUED);
+		const LatencyStats& completed = LatencyTracer::getStats(INPUT_MODE_SWITCH, LATENCY_POINT_COMPLETED);
+		if (queued.count != 1 || queued.histogram[edge.bucket] != 1 || queued.min != edge.elapsed ||
+				queued.max != edge.elapsed) {
+			printf("FAIL a queued latency of %u us is not counted in bucket %u alone\n", edge.elapsed, edge.bucket);
+			passed = false;
+		}
+		uint32_t completedUs = edge.elapsed + 1000;
+		if (completed.count != 1 || completed.histogram[bucketOf(completedUs)] != 1) {
+			printf("FAIL a completed latency of %u us is not counted in bucket %u\n", completedUs, bucketOf(completedUs));
+			passed = false;
+		}
+	}
+}
+
+static void checkSequences() {
+	LatencyStats queued = {};
+	LatencyStats completed = {};
+	LatencyTracer::reset();
+	LatencyTracer::init(INPUT_MODE_XINPUT);
+
+	// a pass without a change stamps nothing, its report has nothing to carry
+	LatencyTracer::sample(1000);
+	LatencyTracer::stateChanged(false);
+	LatencyTracer::reportQueued(1200);
+	LatencyTracer::reportCompleted(2000);
+	passed = sameStats(queued, INPUT_MODE_XINPUT, LATENCY_POINT_QUEUED, "no change") && passed;
+
+	// the report carries the first of three changes sampled before it went out
+	LatencyTracer::sample(3000);
+	LatencyTracer::stateChanged(true);
+	LatencyTracer::sample(3100);
+	LatencyTracer::stateChanged(true);
+	LatencyTracer::sample(3200);
+	LatencyTracer::stateChanged(false);
+	LatencyTracer::reportQueued(3250);
+	record(queued, 250);
+	LatencyTracer::reportCompleted(4000);
+	record(completed, 1000);
+	passed = sameStats(queued, INPUT_MODE_XINPUT, LATENCY_POINT_QUEUED, "oldest change") && passed;
+	passed = sameStats(completed, INPUT_MODE_XINPUT, LATENCY_POINT_COMPLETED, "oldest change") && passed;
+
+	// a change sampled while the report before it is in flight waits for its own report
+	LatencyTracer::sample(5000);
+	LatencyTracer::stateChanged(true);
+	LatencyTracer::reportQueued(5040);
+	record(queued, 40);
+	LatencyTracer::sample(5100);
+	LatencyTracer::stateChanged(true);
+	LatencyTracer::reportCompleted(5600);
+	record(completed, 600);
+	LatencyTracer::reportQueued(6010);
+	record(queued, 910);
+	LatencyTracer::reportCompleted(6900);
+	record(completed, 1800);
+	passed = sameStats(queued, INPUT_MODE_XINPUT, LATENCY_POINT_QUEUED, "change in flight") && passed;
+	passed = sameStats(completed, INPUT_MODE_XINPUT, LATENCY_POINT_COMPLETED, "change in flight") && passed;
+
+	// a report the driver found unchanged drops the stamp, the next change starts a new one
+	LatencyTracer::sample(8000);
+	LatencyTracer::stateChanged(true);
+	LatencyTracer::reportUnchanged();
+	LatencyTracer::reportCompleted(8500);
+	LatencyTracer::sample(9000);
+	LatencyTracer::stateChanged(true);
+	LatencyTracer::reportQueued(9003);
+	record(queued, 3);
+	passed = sameStats(queued, INPUT_MODE_XINPUT, LATENCY_POINT_QUEUED, "unchanged report") && passed;
+	passed = sameStats(completed, INPUT_MODE_XINPUT, LATENCY_POINT_COMPLETED, "unchanged report") && passed;
+
+	// the us timer wraps between the sample and the transfer
+	LatencyTracer::reportCompleted(9500);
+	record(completed, 500);
+	traceReport(0xFFFFFF00, 0x100, 0x500);
+	record(queued, 0x200);
+	record(completed, 0x600);
+	passed = sameStats(queued, INPUT_MODE_XINPUT, LATENCY_POINT_QUEUED, "timer wrap") && passed;
+	passed = sameStats(completed, INPUT_MODE_XINPUT, LATENCY_POINT_COMPLETED, "timer wrap") && passed;
+	check(LatencyTracer::getAverage(INPUT_MODE_XINPUT, LATENCY_POINT_QUEUED) == queued.sum / queued.count,
+		"average of the queued latency");
+
+	// a reboot keeps the stats of every mode, the next mode counts in its own
+	LatencyTracer::init(INPUT_MODE_PS4);
+	traceReport(20000, 20100, 21000);
+	LatencyStats ps4Queued = {};
+	LatencyStats ps4Completed = {};
+	record(ps4Queued, 100);
+	record(ps4Completed, 1000);
+	passed = sameStats(queued, INPUT_MODE_XINPUT, LATENCY_POINT_QUEUED, "kept over init") && passed;
+	passed = sameStats(ps4Queued, INPUT_MODE_PS4, LATENCY_POINT_QUEUED, "mode of its own") && passed;
+	passed = sameStats(ps4Completed, INPUT_MODE_PS4, LATENCY_POINT_COMPLETED, "mode of its own") && passed;
+
+	// a stamp taken before init is not carried into the new mode
+	LatencyTracer::sample(30000);
+	LatencyTracer::stateChanged(true);
+	LatencyTracer::init(INPUT_MODE_PS4);
+	LatencyTracer::reportQueued(30500);
+	passed = sameStats(ps4Queued, INPUT_MODE_PS4, LATENCY_POINT_QUEUED, "stamp dropped by init") && passed;
+
+	// web config isn't traced
+	LatencyTracer::init(INPUT_MODE_CONFIG);
+	traceReport(40000, 40100, 41000);
+	passed = sameStats(ps4Queued, INPUT_MODE_PS4, LATENCY_POINT_QUEUED, "config mode") && passed;
+	check(LatencyTracer::getStats(INPUT_MODE_CONFIG, LATENCY_POINT_QUEUED).count == 0, "config mode has no stats");
+
+	LatencyTracer::reset();
+	check(LatencyTracer::getStats(INPUT_MODE_XINPUT, LATENCY_POINT_QUEUED).count == 0 &&
+		LatencyTracer::getStats(INPUT_MODE_PS4, LATENCY_POINT_COMPLETED).count == 0, "reset clears every mode");
+}
+
+// The loop at random: passes that change the state or not, reports queued, dropped or not sent at all and
+// transfers completing, over latencies from none to tens of ms
+static uint32_t checkRandom(uint32_t events) {
+	LatencyStats queued = {};
+	LatencyStats completed = {};
+	uint32_t sampleUs = 0, pendingUs = 0, inflightUs = 0;
+	bool pending = false, inflight = false;
+	uint32_t now = nextRandom();
+
+	LatencyTracer::reset();
+	LatencyTracer::init(INPUT_MODE_SWITCH);
+	for (uint32_t i = 0; i < events; i++) {
+		uint32_t r = nextRandom();
+		now += (r & 0x100) ? (r >> 20) : ((r >> 24) & 0x3F);
+		switch (r % 6) {
+			case 0:
+			case 1:
+				sampleUs = now;
+				LatencyTracer::sample(now);
+				if (r & 0x200) {
+					if (!pending) pendingUs = sampleUs;
+					pending = true;
+				}
+				LatencyTracer::stateChanged(r & 0x200);
+				break;
+			case 2:
+				if (pending) {
+					record(queued, now - pendingUs);
+					inflightUs = pendingUs;
+					inflight = true;
+					pending = false;
+				}
+				LatencyTracer::reportQueued(now);
+				break;
+			case 3:
+				if (r & 0x400) {
+					pending = false;
+					LatencyTracer::reportUnchanged();
+				}
+				break;
+			default:
+				if (inflight) record(completed, now - inflightUs);
+				inflight = false;
+				LatencyTracer::reportCompleted(now);
+				break;
+		}
+	}
+
+	passed = sameStats(queued, INPUT_MODE_SWITCH, LATENCY_POINT_QUEUED, "random") && passed;
+	passed = sameStats(completed, INPUT_MODE_SWITCH, LATENCY_POINT_COMPLETED, "random") && passed;
+
+	printf("# bucket queued completed\n");
+	for (uint8_t bucket = 0; bucket < LATENCY_TRACER_HISTOGRAM_BUCKETS; bucket++)
+		printf("%u %u %u\n", bucket, queued.histogram[bucket], completed.histogram[bucket]);
+	return queued.count + completed.count;
+}
+
+int main(int argc, char** argv) {
+	uint32_t seed = 1;
+	uint32_t events = 1000000;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoul(argv[++i], nullptr, 0);
+		else if (strcmp(argv[i], "--events") == 0 && i + 1 < argc) events = strtoul(argv[++i], nullptr, 0);
+		else {
+			fprintf(stderr, "usage: %s [--seed N] [--events N]\n", argv[0]);
+			return 2;
+		}
+	}
+	rngState = seed ? seed : 1;
+
+	checkBuckets();
+	checkSequences();
+	uint32_t recorded = checkRandom(events);
+
+	printf("# latency tracer check %s: bucket edges, report sequences and %u random latencies\n",
+		passed ? "passed" : "FAILED", recorded);
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,558 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// GP2040-CE input pipeline simulator
+//
+// Replays a scripted pin trace through the same steps GP2040::setup and GP2040::run take on core0 (debounce,
+// read, add-ons, process, driver) on a simulated clock, and prints every report the simulated USB host
+// receives. The output only depends on the trace and the options, so runs can be diffed.
+//
+// --compare-latch runs the trace free running and late-latched, each in a process of its own, and prints how old
+// the sample each report was built from is when the host takes it. It fails if late-latch doesn't lower the
+// average age. --random replaces the trace with random button changes for a long run.
+//
+// Trace lines, comments start with #:
+//   <time_us> <gpio> <0|1>          release (0) or press (1) the button on gpio
+//   <time_us> adc <channel> <value> set the 12 bit reading of an ADC channel
+//   <time_us> end                   stop the run (default: 100ms after the last line)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "simhal.h"
+
+#include "addonmanager.h"
+#include "drivermanager.h"
+#include "eventmanager.h"
+#include "framecontext.h"
+#include "framescheduler.h"
+#include "gamepad.h"
+#include "gpioinput.h"
+#include "latencytracer.h"
+#include "storagemanager.h"
+#include "types.h"
+
+#include "addons/analog.h"
+#include "addons/dualdirectional.h"
+#include "addons/focus_mode.h"
+#include "addons/input_macro.h"
+#include "addons/reverse.h"
+#include "addons/rotaryencoder.h"
+#include "addons/slider_socd.h"
+#include "addons/tilt.h"
+#include "addons/turbo.h"
+
+#include "hardware/adc.h"
+#include "hardware/gpio.h"
+#include "tusb.h"
+
+// Time after the last trace line the run continues for, when the trace has no end line
+#define SIM_DEFAULT_TAIL_US 100000
+
+// Stages of a pass --stage-us is charged for: read, add-on preprocess, process
+#define SIM_PIPELINE_STAGES 3
+
+// Input age histogram: buckets a tenth of the poll interval wide, the last one also counts everything above
+#define SIM_AGE_BUCKETS 12
+
+// Random button changes of --random, the time between them
+#define SIM_RANDOM_MIN_GAP_US 2000
+#define SIM_RANDOM_MAX_GAP_US 40000
+
+struct SimOptions {
+	InputMode inputMode = INPUT_MODE_SWITCH;
+	uint32_t loopUs = 100;
+	uint32_t stageUs = 0;
+	uint32_t pollUs = 1000;
+	uint32_t pollOffsetUs = 0;
+	int32_t debounceDelay = -1;
+	int32_t socdMode = -1;
+	int32_t lateLatchLeadUs = -1;
+	int32_t encoderPinA = -1;
+	int32_t encoderPinB = -1;
+	uint32_t listenerUs = 0;
+	int32_t compareLeadUs = -1;
+	uint32_t randomChanges = 0;
+	uint32_t seed = 1;
+	const char* tracePath = nullptr;
+};
+
+// Time from the sample a report was built from to the host poll taking it
+struct InputAgeStats {
+	uint32_t count;
+	uint32_t max;
+	uint64_t sum;
+	uint32_t histogram[SIM_AGE_BUCKETS];
+};
+
+static const struct {
+	const char* name;
+	InputMode mode;
+} simModes[] = {
+	{ "switch", INPUT_MODE_SWITCH },
+	{ "hid", INPUT_MODE_GENERIC },
+	{ "ps3", INPUT_MODE_PS3 },
+	{ "psclassic", INPUT_MODE_PSCLASSIC },
+	{ "astro", INPUT_MODE_ASTRO },
+	{ "egret", INPUT_MODE_EGRET },
+	{ "mdmini", INPUT_MODE_MDMINI },
+	{ "neogeo", INPUT_MODE_NEOGEO },
+	{ "pcemini", INPUT_MODE_PCEMINI },
+};
+
+static const struct {
+	const char* name;
+	SOCDMode mode;
+} simSocdModes[] = {
+	{ "neutral", SOCD_MODE_NEUTRAL },
+	{ "up", SOCD_MODE_UP_PRIORITY },
+	{ "second", SOCD_MODE_SECOND_INPUT_PRIORITY },
+	{ "first", SOCD_MODE_FIRST_INPUT_PRIORITY },
+	{ "bypass", SOCD_MODE_BYPASS },
+};
+
+/**
+ * @brief The core0 side of GP2040, with the steps of GP2040::run split so the clock can move between them.
+ */
+class Simulator {
+public:
+	void setup(const SimOptions& options);
+	void loop();
+	uint32_t getOverruns() const { return frameScheduler.getOverruns(); }
+	// Sample time of the pass that armed the report in flight
+	uint64_t getArmedSampleTime() const { return armedSampleTime; }
+private:
+	void stage() { if (stageUs > 0) SimHal::advance(stageUs); }
+
+	AddonManager addons;
+	GpioInput gpioInput;
+	FrameScheduler frameScheduler;
+	GamepadState prevRawState;
+	EventHandlerToken listenerHandler;
+	uint32_t loopUs = 0;
+	uint32_t stageUs = 0;
+	uint64_t armedSampleTime = 0;
+	bool lateLatch = false;
+};
+
+void Simulator::setup(const SimOptions& options) {
+	Storage::getInstance().init();
+
+	GamepadOptions& gamepadOptions = Storage::getInstance().getGamepadOptions();
+	gamepadOptions.inputMode = options.inputMode;
+	if (options.debounceDelay >= 0) gamepadOptions.debounceDelay = options.debounceDelay;
+	if (options.socdMode >= 0) gamepadOptions.socdMode = (SOCDMode)options.socdMode;
+	if (options.lateLatchLeadUs >= 0) {
+		gamepadOptions.inputSamplingMode = INPUT_SAMPLING_SOF_LATE_LATCH;
+		gamepadOptions.lateLatchLeadUs = options.lateLatchLeadUs;
+	}
+
+	// an encoder on the left stick's X axis, its pins are the add-on's and not in the pin mapping
+	if (options.encoderPinA >= 0) {
+		RotaryOptions& rotaryOptions = Storage::getInstance().getAddonOptions().rotaryOptions;
+		rotaryOptions.enabled = true;
+		rotaryOptions.encoderOne.enabled = true;
+		rotaryOptions.encoderOne.pinA = options.encoderPinA;
+		rotaryOptions.encoderOne.pinB = options.encoderPinB;
+		rotaryOptions.encoderOne.mode = ENCODER_MODE_LEFT_ANALOG_X;
+		rotaryOptions.encoderOne.pulsesPerRevolution = 96;
+		rotaryOptions.encoderOne.multiplier = ENCODER_ONE_MULTIPLIER;
+		Storage::getInstance().getGpioMappings().pins[options.encoderPinA].action = GpioAction::ASSIGNED_TO_ADDON;
+		Storage::getInstance().getGpioMappings().pins[options.encoderPinB].action = GpioAction::ASSIGNED_TO_ADDON;
+	}
+
+	Gamepad * gamepad = new Gamepad();
+	Gamepad * processedGamepad = new Gamepad();
+	Storage::getInstance().SetGamepad(gamepad);
+	Storage::getInstance().SetProcessedGamepad(processedGamepad);
+	Storage::getInstance().publishProcessedState(processedGamepad->state);
+	Storage::getInstance().publishProcessedAuxState(processedGamepad->auxState);
+
+	Storage::getInstance().setFunctionalPinMappings();
+	gamepad->setup();
+	gpioInput.initializeStandardGpio();
+
+	adc_init();
+
+	// the input add-ons that build on the host, in the order GP2040::setup loads them
+	addons.LoadAddon<AnalogInput>(CORE0_INPUT);
+	addons.LoadAddon<DualDirectionalInput>(CORE0_INPUT);
+	addons.LoadAddon<FocusModeAddon>(CORE0_INPUT);
+	addons.LoadAddon<SliderSOCDInput>(CORE0_INPUT);
+	addons.LoadAddon<TiltInput>(CORE0_INPUT);
+	addons.LoadAddon<RotaryEncoderInput>(CORE0_INPUT);
+	addons.LoadAddon<ReverseInput>(CORE0_INPUT);
+	addons.LoadAddon<TurboInput>(CORE0_INPUT);
+	addons.LoadAddon<InputMacro>(CORE0_INPUT);
+
+	DriverManager::getInstance().setup(gamepadOptions.inputMode);
+
+	loopUs = options.loopUs;
+	stageUs = options.stageUs;
+	lateLatch = gamepadOptions.inputSamplingMode == INPUT_SAMPLING_SOF_LATE_LATCH;
+	frameScheduler.setLead(gamepadOptions.lateLatchLeadUs);
+
+	// a listener like the display's, taking listenerUs every time the inputs change
+	if (options.listenerUs > 0) {
+		uint32_t listenerUs = options.listenerUs;
+		listenerHandler = EventManager::getInstance().registerEventHandler(GP_EVENT_INPUT_FRAME,
+			[listenerUs](GPEvent* event) { SimHal::advance(listenerUs); });
+	}
+
+	prevRawState = gamepad->state;
+
+	tud_init(TUD_OPT_RHPORT);
+}
+
+/**
+ * @brief One pass of the GP2040::run loop, the whole pipeline is charged loopUs between sampling and the driver.
+ */
+void Simulator::loop() {
+	GPDriver * inputDriver = DriverManager::getInstance().getDriver();
+	Gamepad * gamepad = Storage::getInstance().GetGamepad();
+	Gamepad * processedGamepad = Storage::getInstance().GetProcessedGamepad();
+
+	if (lateLatch) frameScheduler.waitForLatch();
+
+	Storage::getInstance().performEnqueuedSaves();
+
+	FrameContext::capture();
+	LATENCY_TRACE_SAMPLE();
+	uint64_t sampleTime = SimHal::now();
+	gpioInput.debounceGpioGetAll();
+	gamepad->read();
+	GPInputFrameEvent inputFrame;
+	inputFrame.setRaw(prevRawState, gamepad->state);
+	prevRawState = gamepad->state;
+	stage();
+
+	addons.PreprocessAddons(ADDON_PROCESS::CORE0_INPUT);
+	stage();
+	gamepad->hotkey();
+	gamepad->process();
+	stage();
+	addons.ProcessAddons(ADDON_PROCESS::CORE0_INPUT);
+
+	inputFrame.setProcessed(processedGamepad->state, gamepad->state);
+	bool processedChanged = memcmp(&processedGamepad->state, &gamepad->state, sizeof(GamepadState)) != 0;
+	LATENCY_TRACE_STATE(processedChanged);
+	if (processedChanged) {
+		memcpy(&processedGamepad->state, &gamepad->state, sizeof(GamepadState));
+		Storage::getInstance().publishProcessedState(gamepad->state);
+	}
+
+	SimHal::advance(loopUs - SIM_PIPELINE_STAGES * stageUs);
+
+	bool ready = tud_hid_ready();
+	inputDriver->process(gamepad);
+	if (ready && !tud_hid_ready()) armedSampleTime = sampleTime;
+	Storage::getInstance().publishProcessedAuxState(processedGamepad->auxState);
+	if (inputFrame.changes != 0) EventManager::getInstance().triggerEvent(inputFrame);
+	addons.ProcessAddons(ADDON_PROCESS::CORE0_USBREPORT);
+	tud_task();
+	addons.PollAddons(ADDON_PROCESS::CORE0_INPUT);
+
+	if (lateLatch) {
+		if (tud_ready())
+			frameScheduler.syncToFrame();
+		else
+			frameScheduler.unlock();
+	}
+}
+
+static bool loadTrace(const char* path, uint64_t& endTime) {
+	FILE* file = fopen(path, "r");
+	if (file == nullptr) {
+		fprintf(stderr, "cannot open trace %s\n", path);
+		return false;
+	}
+
+	char line[256];
+	uint32_t lineNumber = 0;
+	uint64_t lastTime = 0;
+	bool hasEnd = false;
+	while (fgets(line, sizeof(line), file) != nullptr) {
+		lineNumber++;
+		char* comment = strchr(line, '#');
+		if (comment != nullptr) *comment = '\0';
+
+		unsigned long long time;
+		char what[16];
+		int consumed = 0;
+		if (sscanf(line, " %llu %15s %n", &time, what, &consumed) < 2) {
+			if (strspn(line, " \t\r\n") == strlen(line)) continue;
+			fprintf(stderr, "%s:%lu: expected <time_us> <gpio|adc|end> ...\n", path, (unsigned long)lineNumber);
+			fclose(file);
+			return false;
+		}
+
+		if (time < lastTime) {
+			fprintf(stderr, "%s:%lu: time goes backwards\n", path, (unsigned long)lineNumber);
+			fclose(file);
+			return false;
+		}
+		lastTime = time;
+
+		unsigned channel, value;
+		if (strcmp(what, "end") == 0) {
+			endTime = time;
+			hasEnd = true;
+			break;
+		} else if (strcmp(what, "adc") == 0 && sscanf(line + consumed, "%u %u", &channel, &value) == 2) {
+			SimHal::schedule(time, [channel, value]() { SimHal::setAdc(channel, value); });
+		} else if (sscanf(what, "%u", &channel) == 1 && channel < NUM_BANK0_GPIOS && sscanf(line + consumed, "%u", &value) == 1) {
+			SimHal::schedule(time, [channel, value]() { SimHal::setButton(channel, value != 0); });
+		} else {
+			fprintf(stderr, "%s:%lu: bad trace line\n", path, (unsigned long)lineNumber);
+			fclose(file);
+			return false;
+		}
+	}
+
+	fclose(file);
+	if (!hasEnd) endTime = lastTime + SIM_DEFAULT_TAIL_US;
+	return true;
+}
+
+static void usage(const char* name) {
+	fprintf(stderr,
+		"usage: %s [options] trace\n"
+		"  --mode NAME            input mode: switch, hid, ps3, psclassic, astro, egret, mdmini, neogeo, pcemini\n"
+		"  --loop-us N            time one pass of the input pipeline takes (default 100)\n"
+		"  --stage-us N           part of --loop-us charged after each of read, add-on preprocess and process,\n"
+		"                         so trace edges can land in the middle of a pass (default 0)\n"
+		"  --poll-us N            USB host poll interval (default 1000)\n"
+		"  --poll-offset-us N     time from a frame's SOF to the host's poll (default 0)\n"
+		"  --debounce MS          debounce delay (default 5)\n"
+		"  --socd NAME            SOCD mode: neutral, up, second, first, bypass\n"
+		"  --late-latch LEAD_US   sample the inputs LEAD_US before each SOF instead of free running\n"
+		"  --encoder PIN_A:PIN_B  rotary encoder on the left stick X axis\n"
+		"  --listener-us N        register an input event listener that takes N us per call\n"
+		"  --compare-latch LEAD_US  run free running and late-latched LEAD_US before each SOF, print the input age\n"
+		"                         of both and fail if late-latch doesn't lower it\n"
+		"  --random N             N random button changes on the mapped pins instead of a trace\n"
+		"  --seed N               seed of --random (default 1)\n",
+		name);
+}
+
+static bool parseOptions(int argc, char** argv, SimOptions& options) {
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--mode" && hasValue) {
+			const char* name = argv[++i];
+			bool found = false;
+			for (const auto& simMode : simModes) {
+				if (strcmp(simMode.name, name) == 0) {
+					options.inputMode = simMode.mode;
+					found = true;
+				}
+			}
+			if (!found) return false;
+		} else if (arg == "--socd" && hasValue) {
+			const char* name = argv[++i];
+			for (const auto& simSocdMode : simSocdModes) {
+				if (strcmp(simSocdMode.name, name) == 0) options.socdMode = simSocdMode.mode;
+			}
+			if (options.socdMode < 0) return false;
+		} else if (arg == "--loop-us" && hasValue) {
+			options.loopUs = strtoul(argv[++i], nullptr, 0);
+		} else if (arg == "--stage-us" && hasValue) {
+			options.stageUs = strtoul(argv[++i], nullptr, 0);
+		} else if (arg == "--encoder" && hasValue) {
+			int pinA, pinB;
+			if (sscanf(argv[++i], "%d:%d", &pinA, &pinB) != 2 || pinA < 0 || pinA >= NUM_BANK0_GPIOS ||
+				pinB < 0 || pinB >= NUM_BANK0_GPIOS || pinA == pinB) return false;
+			options.encoderPinA = pinA;
+			options.encoderPinB = pinB;
+		} else if (arg == "--listener-us" && hasValue) {
+			options.listenerUs = strtoul(argv[++i], nullptr, 0);
+		} else if (arg == "--poll-us" && hasValue) {
+			options.pollUs = strtoul(argv[++i], nullptr, 0);
+		} else if (arg == "--poll-offset-us" && hasValue) {
+			options.pollOffsetUs = strtoul(argv[++i], nullptr, 0);
+		} else if (arg == "--debounce" && hasValue) {
+			options.debounceDelay = strtoul(argv[++i], nullptr, 0);
+		} else if (arg == "--late-latch" && hasValue) {
+			options.lateLatchLeadUs = strtoul(argv[++i], nullptr, 0);
+		} else if (arg == "--compare-latch" && hasValue) {
+			options.compareLeadUs = strtoul(argv[++i], nullptr, 0);
+		} else if (arg == "--random" && hasValue) {
+			options.randomChanges = strtoul(argv[++i], nullptr, 0);
+		} else if (arg == "--seed" && hasValue) {
+			options.seed = strtoul(argv[++i], nullptr, 0);
+		} else if (arg[0] != '-' && options.tracePath == nullptr) {
+			options.tracePath = argv[i];
+		} else {
+			return false;
+		}
+	}
+
+	return (options.tracePath != nullptr || options.randomChanges > 0) && options.loopUs > SIM_PIPELINE_STAGES * options.stageUs && options.pollUs > 0;
+}
+
+static void printLatency(InputMode mode) {
+	static const char* pointNames[LATENCY_POINT_COUNT] = { "queued", "completed" };
+	for (uint8_t point = 0; point < LATENCY_POINT_COUNT; point++) {
+		const LatencyStats& stats = LatencyTracer::getStats(mode, (LatencyTracePoint)point);
+		printf("# latency %s count=%lu min=%lu avg=%lu max=%lu\n", pointNames[point], (unsigned long)stats.count,
+			(unsigned long)stats.min, (unsigned long)LatencyTracer::getAverage(mode, (LatencyTracePoint)point), (unsigned long)stats.max);
+	}
+}
+
+/**
+ * @brief Press and release the mapped buttons at random, one change every few ms.
+ */
+static void scheduleRandomChanges(uint32_t changes, uint32_t seed, uint64_t& endTime) {
+	GpioMappingInfo* pinMappings = Storage::getInstance().getProfilePinMappings();
+	uint8_t pins[NUM_BANK0_GPIOS];
+	uint8_t pinCount = 0;
+	for (Pin_t pin = 0; pin < (Pin_t)NUM_BANK0_GPIOS; pin++) {
+		if (pinMappings[pin].action > 0) pins[pinCount++] = pin;
+	}
+
+	uint32_t state = seed ? seed : 1;
+	uint32_t pressed = 0;
+	uint64_t time = SimHal::now();
+	for (uint32_t i = 0; i < changes && pinCount > 0; i++) {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		time += SIM_RANDOM_MIN_GAP_US + state % (SIM_RANDOM_MAX_GAP_US - SIM_RANDOM_MIN_GAP_US);
+		uint8_t pin = pins[(state >> 16) % pinCount];
+		pressed ^= 1u << pin;
+		bool press = (pressed >> pin) & 1;
+		SimHal::schedule(time, [pin, press]() { SimHal::setButton(pin, press); });
+	}
+	endTime = time + SIM_DEFAULT_TAIL_US;
+}
+
+static void recordAge(InputAgeStats& ages, uint32_t age, uint32_t pollUs) {
+	uint32_t bucketUs = pollUs >= 10 ? pollUs / 10 : 1;
+	uint32_t bucket = age / bucketUs;
+	ages.histogram[bucket < SIM_AGE_BUCKETS ? bucket : SIM_AGE_BUCKETS - 1]++;
+	if (age > ages.max) ages.max = age;
+	ages.sum += age;
+	ages.count++;
+}
+
+/**
+ * @brief Replay the trace and print the reports, or only collect their input age when ages is set.
+ */
+static int runSimulation(const SimOptions& options, InputAgeStats* ages) {
+	uint64_t endTime = 0;
+	if (options.randomChanges == 0 && !loadTrace(options.tracePath, endTime)) return 1;
+
+	Simulator simulator;
+	simulator.setup(options);
+	if (DriverManager::getInstance().getDriver() == nullptr) {
+		fprintf(stderr, "input mode not available in the simulator\n");
+		return 1;
+	}
+	if (options.randomChanges > 0) scheduleRandomChanges(options.randomChanges, options.seed, endTime);
+
+	uint32_t reports = 0;
+	SimHal::startHost(options.pollUs, options.pollOffsetUs, [&reports, &simulator, ages, &options](uint64_t time,
+			const uint8_t* report, uint16_t len) {
+		reports++;
+		if (ages != nullptr) {
+			recordAge(*ages, time - simulator.getArmedSampleTime(), options.pollUs);
+			return;
+		}
+		printf("t_us=%llu len=%u data=", (unsigned long long)time, len);
+		for (uint16_t i = 0; i < len; i++) printf("%02x", report[i]);
+		printf("\n");
+	});
+
+	while (SimHal::now() < endTime) {
+		simulator.loop();
+	}
+
+	if (ages == nullptr) {
+		printf("# reports=%lu overruns=%lu\n", (unsigned long)reports, (unsigned long)simulator.getOverruns());
+		printLatency(options.inputMode);
+	}
+	return 0;
+}
+
+/**
+ * @brief Collect the input age of a run in a child process, the simulated board and its singletons start over.
+ */
+static bool runForAge(const SimOptions& options, InputAgeStats& ages) {
+	int fds[2];
+	if (pipe(fds) != 0) return false;
+
+	pid_t pid = fork();
+	if (pid < 0) return false;
+	if (pid == 0) {
+		close(fds[0]);
+		InputAgeStats childAges = {};
+		int result = runSimulation(options, &childAges);
+		if (result == 0 && write(fds[1], &childAges, sizeof(childAges)) != sizeof(childAges)) result = 1;
+		_exit(result);
+	}
+
+	close(fds[1]);
+	ssize_t got = read(fds[0], &ages, sizeof(ages));
+	close(fds[0]);
+	int status = 0;
+	waitpid(pid, &status, 0);
+	return got == sizeof(ages) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static uint32_t averageAge(const InputAgeStats& ages) {
+	return ages.count == 0 ? 0 : (uint32_t)(ages.sum / ages.count);
+}
+
+static int compareLatch(const SimOptions& options) {
+	SimOptions freeRunning = options;
+	freeRunning.lateLatchLeadUs = -1;
+	SimOptions lateLatched = options;
+	lateLatched.lateLatchLeadUs = options.compareLeadUs;
+
+	InputAgeStats freeAges = {};
+	InputAgeStats lateAges = {};
+	if (!runForAge(freeRunning, freeAges) || !runForAge(lateLatched, lateAges)) {
+		fprintf(stderr, "simulation failed\n");
+		return 1;
+	}
+
+	uint32_t bucketUs = options.pollUs >= 10 ? options.pollUs / 10 : 1;
+	printf("# age_us free_running late_latched\n");
+	for (uint32_t bucket = 0; bucket < SIM_AGE_BUCKETS; bucket++) {
+		if (bucket + 1 < SIM_AGE_BUCKETS)
+			printf("%lu-%lu", (unsigned long)(bucket * bucketUs), (unsigned long)((bucket + 1) * bucketUs - 1));
+		else
+			printf("%lu+", (unsigned long)(bucket * bucketUs));
+		printf(" %lu %lu\n", (unsigned long)freeAges.histogram[bucket], (unsigned long)lateAges.histogram[bucket]);
+	}
+	printf("# free_running reports=%lu avg=%lu max=%lu\n", (unsigned long)freeAges.count,
+		(unsigned long)averageAge(freeAges), (unsigned long)freeAges.max);
+	printf("# late_latched reports=%lu avg=%lu max=%lu\n", (unsigned long)lateAges.count,
+		(unsigned long)averageAge(lateAges), (unsigned long)lateAges.max);
+
+	bool passed = freeAges.count > 0 && lateAges.count > 0 && averageAge(lateAges) < averageAge(freeAges);
+	printf("# input age check %s: late-latch %lu us before the SOF takes the average age from %lu us to %lu us\n",
+		passed ? "passed" : "FAILED", (unsigned long)options.compareLeadUs, (unsigned long)averageAge(freeAges),
+		(unsigned long)averageAge(lateAges));
+	return passed ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+	SimOptions options;
+	if (!parseOptions(argc, argv, options)) {
+		usage(argv[0]);
+		return 2;
+	}
+
+	if (options.compareLeadUs >= 0) return compareLatch(options);
+	return runSimulation(options, nullptr);
+}
@@ -0,0 +1,328 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Pin mapping check and benchmark
+//
+// Checks that the compiled GamepadMappingPlan Gamepad::read resolves the debounced pins with gives the same
+// state, bit for bit, as testing every GamepadButtonMapping in turn did. Every GpioAction is tried alone on
+// every pin, custom button combos with random masks, then random profiles mixing all of them, each against
+// single pins and random pin masks. Then times both ways of reading on the host.
+//
+//   gp2040ce_mapping_bench [--seed N] [--profiles N] [--reads N]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <vector>
+
+#include "gamepad.h"
+#include "storagemanager.h"
+#include "types.h"
+
+struct MappedState {
+	GamepadState state;
+	DpadMode dpadMode;
+	bool fourWayToggle;
+};
+
+static uint32_t rngState = 1;
+
+static uint32_t nextRandom() {
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 17;
+	rngState ^= rngState << 5;
+	return rngState;
+}
+
+// Same as Gamepad::read before the mapping plan, the reference the plan is checked against
+static void legacyRead(const Gamepad& gamepad, Mask_t values, DpadMode optionsDpadMode, MappedState& out) {
+	uint16_t joystickMid = GAMEPAD_JOYSTICK_MID;
+	GamepadState& state = out.state;
+
+	state.aux = 0
+		| (values & gamepad.mapButtonFn->pinMask)   ? gamepad.mapButtonFn->buttonMask : 0;
+
+	state.dpad = 0
+		| ((values & gamepad.mapDpadUp->pinMask)       ? gamepad.mapDpadUp->buttonMask                                                      : 0)
+		| ((values & gamepad.mapDpadDown->pinMask)     ? gamepad.mapDpadDown->buttonMask                                                    : 0)
+		| ((values & gamepad.mapDpadLeft->pinMask)     ? gamepad.mapDpadLeft->buttonMask                                                    : 0)
+		| ((values & gamepad.mapDpadRight->pinMask)    ? gamepad.mapDpadRight->buttonMask                                                   : 0)
+		| ((values & gamepad.mapDigitalUp->pinMask)    ? (gamepad.mapDigitalUp->buttonMask) | (gamepad.mapDigitalUp->buttonMask << 4)       : 0)
+		| ((values & gamepad.mapDigitalDown->pinMask)  ? (gamepad.mapDigitalDown->buttonMask) | (gamepad.mapDigitalDown->buttonMask << 4)   : 0)
+		| ((values & gamepad.mapDigitalLeft->pinMask)  ? (gamepad.mapDigitalLeft->buttonMask) | (gamepad.mapDigitalLeft->buttonMask << 4)   : 0)
+		| ((values & gamepad.mapDigitalRight->pinMask) ? (gamepad.mapDigitalRight->buttonMask) | (gamepad.mapDigitalRight->buttonMask << 4) : 0)
+	;
+
+	state.buttons = 0
+		| ((values & gamepad.mapButtonB1->pinMask)  ? gamepad.mapButtonB1->buttonMask  : 0)
+		| ((values & gamepad.mapButtonB2->pinMask)  ? gamepad.mapButtonB2->buttonMask  : 0)
+		| ((values & gamepad.mapButtonB3->pinMask)  ? gamepad.mapButtonB3->buttonMask  : 0)
+		| ((values & gamepad.mapButtonB4->pinMask)  ? gamepad.mapButtonB4->buttonMask  : 0)
+		| ((values & gamepad.mapButtonL1->pinMask)  ? gamepad.mapButtonL1->buttonMask  : 0)
+		| ((values & gamepad.mapButtonR1->pinMask)  ? gamepad.mapButtonR1->buttonMask  : 0)
+		| ((values & gamepad.mapButtonL2->pinMask)  ? gamepad.mapButtonL2->buttonMask  : 0)
+		| ((values & gamepad.mapButtonR2->pinMask)  ? gamepad.mapButtonR2->buttonMask  : 0)
+		| ((values & gamepad.mapButtonS1->pinMask)  ? gamepad.mapButtonS1->buttonMask  : 0)
+		| ((values & gamepad.mapButtonS2->pinMask)  ? gamepad.mapButtonS2->buttonMask  : 0)
+		| ((values & gamepad.mapButtonL3->pinMask)  ? gamepad.mapButtonL3->buttonMask  : 0)
+		| ((values & gamepad.mapButtonR3->pinMask)  ? gamepad.mapButtonR3->buttonMask  : 0)
+		| ((values & gamepad.mapButtonA1->pinMask)  ? gamepad.mapButtonA1->buttonMask  : 0)
+		| ((values & gamepad.mapButtonA2->pinMask)  ? gamepad.mapButtonA2->buttonMask  : 0)
+		| ((values & gamepad.mapButtonA3->pinMask)  ? gamepad.mapButtonA3->buttonMask  : 0)
+		| ((values & gamepad.mapButtonA4->pinMask)  ? gamepad.mapButtonA4->buttonMask  : 0)
+		| ((values & gamepad.mapButtonE1->pinMask)  ? gamepad.mapButtonE1->buttonMask  : 0)
+		| ((values & gamepad.mapButtonE2->pinMask)  ? gamepad.mapButtonE2->buttonMask  : 0)
+		| ((values & gamepad.mapButtonE3->pinMask)  ? gamepad.mapButtonE3->buttonMask  : 0)
+		| ((values & gamepad.mapButtonE4->pinMask)  ? gamepad.mapButtonE4->buttonMask  : 0)
+		| ((values & gamepad.mapButtonE5->pinMask)  ? gamepad.mapButtonE5->buttonMask  : 0)
+		| ((values & gamepad.mapButtonE6->pinMask)  ? gamepad.mapButtonE6->buttonMask  : 0)
+		| ((values & gamepad.mapButtonE7->pinMask)  ? gamepad.mapButtonE7->buttonMask  : 0)
+		| ((values & gamepad.mapButtonE8->pinMask)  ? gamepad.mapButtonE8->buttonMask  : 0)
+		| ((values & gamepad.mapButtonE9->pinMask)  ? gamepad.mapButtonE9->buttonMask  : 0)
+		| ((values & gamepad.mapButtonE10->pinMask) ? gamepad.mapButtonE10->buttonMask : 0)
+		| ((values & gamepad.mapButtonE11->pinMask) ? gamepad.mapButtonE11->buttonMask : 0)
+		| ((values & gamepad.mapButtonE12->pinMask) ? gamepad.mapButtonE12->buttonMask : 0)
+	;
+
+	if (values & gamepad.mapButtonDP->pinMask)	out.dpadMode = DpadMode::DPAD_MODE_DIGITAL;
+	else if (values & gamepad.mapButtonLS->pinMask)	out.dpadMode = DpadMode::DPAD_MODE_LEFT_ANALOG;
+	else if (values & gamepad.mapButtonRS->pinMask)	out.dpadMode = DpadMode::DPAD_MODE_RIGHT_ANALOG;
+	else						out.dpadMode = optionsDpadMode;
+
+	out.fourWayToggle = (values & gamepad.map48WayMode->pinMask);
+
+	if (values & gamepad.mapAnalogLSXNeg->pinMask) {
+		state.lx = GAMEPAD_JOYSTICK_MIN;
+	} else if (values & gamepad.mapAnalogLSXPos->pinMask) {
+		state.lx = GAMEPAD_JOYSTICK_MAX;
+	} else {
+		state.lx = joystickMid;
+	}
+	if (values & gamepad.mapAnalogLSYNeg->pinMask) {
+		state.ly = GAMEPAD_JOYSTICK_MIN;
+	} else if (values & gamepad.mapAnalogLSYPos->pinMask) {
+		state.ly = GAMEPAD_JOYSTICK_MAX;
+	} else {
+		state.ly = joystickMid;
+	}
+
+	if (values & gamepad.mapAnalogRSXNeg->pinMask) {
+		state.rx = GAMEPAD_JOYSTICK_MIN;
+	} else if (values & gamepad.mapAnalogRSXPos->pinMask) {
+		state.rx = GAMEPAD_JOYSTICK_MAX;
+	} else {
+		state.rx = joystickMid;
+	}
+	if (values & gamepad.mapAnalogRSYNeg->pinMask) {
+		state.ry = GAMEPAD_JOYSTICK_MIN;
+	} else if (values & gamepad.mapAnalogRSYPos->pinMask) {
+		state.ry = GAMEPAD_JOYSTICK_MAX;
+	} else {
+		state.ry = joystickMid;
+	}
+
+	state.lt = 0;
+	state.rt = 0;
+}
+
+static bool sameState(const GamepadState& a, const GamepadState& b) {
+	return a.dpad == b.dpad && a.buttons == b.buttons && a.aux == b.aux &&
+		a.lx == b.lx && a.ly == b.ly && a.rx == b.rx && a.ry == b.ry &&
+		a.lt == b.lt && a.rt == b.rt;
+}
+
+class MappingCheck {
+public:
+	MappingCheck(Gamepad* gamepad) : gamepad(gamepad) {}
+
+	// Load the profile into the gamepad and check it against every value
+	bool checkProfile(const char* label, const std::vector<Mask_t>& values);
+
+	uint32_t profiles = 0;
+	uint64_t reads = 0;
+
+private:
+	bool checkValue(const char* label, Mask_t value);
+
+	Gamepad* gamepad;
+	GamepadMappingPlan plan;
+};
+
+bool MappingCheck::checkProfile(const char* label, const std::vector<Mask_t>& values) {
+	gamepad->reinit();
+	plan.compile(*gamepad);
+	profiles++;
+
+	for (Mask_t value : values) {
+		if (!checkValue(label, value)) return false;
+	}
+	return true;
+}
+
+bool MappingCheck::checkValue(const char* label, Mask_t value) {
+	DpadMode optionsDpadMode = gamepad->getOptions().dpadMode;
+
+	MappedState expected = { };
+	legacyRead(*gamepad, value, optionsDpadMode, expected);
+
+	gamepad->debouncedGpio = value;
+	gamepad->read();
+	reads++;
+
+	// read() covers everything but the 4/8-way toggle, which only the plan shows
+	bool fourWayToggle = (plan.lookup(value).flags & GAMEPAD_MAPPING_4_8_WAY_MODE) != 0;
+
+	if (!sameState(expected.state, gamepad->state) ||
+		expected.dpadMode != gamepad->getActiveDpadMode() ||
+		expected.fourWayToggle != fourWayToggle) {
+		printf("MISMATCH %s pins=%08x\n", label, value);
+		printf("  expected dpad=%02x buttons=%08x aux=%04x lx=%04x ly=%04x rx=%04x ry=%04x mode=%d 4/8=%d\n",
+			expected.state.dpad, expected.state.buttons, expected.state.aux,
+			expected.state.lx, expected.state.ly, expected.state.rx, expected.state.ry,
+			expected.dpadMode, expected.fourWayToggle);
+		printf("  got      dpad=%02x buttons=%08x aux=%04x lx=%04x ly=%04x rx=%04x ry=%04x mode=%d 4/8=%d\n",
+			gamepad->state.dpad, gamepad->state.buttons, gamepad->state.aux,
+			gamepad->state.lx, gamepad->state.ly, gamepad->state.rx, gamepad->state.ry,
+			gamepad->getActiveDpadMode(), fourWayToggle);
+		return false;
+	}
+	return true;
+}
+
+static void clearProfile(GpioMappingInfo* pinMappings) {
+	for (Pin_t pin = 0; pin < (Pin_t)NUM_BANK0_GPIOS; pin++) {
+		pinMappings[pin] = GpioMappingInfo_init_default;
+		pinMappings[pin].action = GpioAction::NONE;
+	}
+}
+
+static void assignAction(GpioMappingInfo& mapping, GpioAction action) {
+	mapping.action = action;
+	if (action == GpioAction::CUSTOM_BUTTON_COMBO) {
+		mapping.customDpadMask = nextRandom() & 0xF;
+		mapping.customButtonMask = nextRandom();
+	} else {
+		mapping.customDpadMask = 0;
+		mapping.customButtonMask = 0;
+	}
+}
+
+static std::vector<Mask_t> testValues(uint32_t randomCount) {
+	std::vector<Mask_t> values;
+	values.push_back(0);
+	values.push_back(~0u);
+	for (uint8_t bit = 0; bit < 32; bit++) {
+		values.push_back(1u << bit);
+		values.push_back(~(1u << bit));
+	}
+	for (uint32_t i = 0; i < randomCount; i++) {
+		// sparse masks like real button presses, and dense ones
+		Mask_t value = nextRandom() & nextRandom() & nextRandom();
+		values.push_back(value);
+		values.push_back(nextRandom());
+	}
+	return values;
+}
+
+template <typename ReadFn>
+static double timeReads(const std::vector<Mask_t>& values, uint32_t rounds, ReadFn readFn) {
+	uint32_t sink = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t round = 0; round < rounds; round++) {
+		for (Mask_t value : values) sink += readFn(value);
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	// keep the reads from being optimized away
+	if (sink == 0x12345678) printf("#\n");
+
+	double ns = std::chrono::duration<double, std::nano>(end - start).count();
+	return ns / ((double)rounds * values.size());
+}
+
+int main(int argc, char** argv) {
+	uint32_t seed = 1;
+	uint32_t randomProfiles = 2000;
+	uint32_t benchReads = 20000000;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoul(argv[++i], nullptr, 0);
+		else if (strcmp(argv[i], "--profiles") == 0 && i + 1 < argc) randomProfiles = strtoul(argv[++i], nullptr, 0);
+		else if (strcmp(argv[i], "--reads") == 0 && i + 1 < argc) benchReads = strtoul(argv[++i], nullptr, 0);
+		else {
+			fprintf(stderr, "usage: %s [--seed N] [--profiles N] [--reads N]\n", argv[0]);
+			return 2;
+		}
+	}
+	rngState = seed ? seed : 1;
+
+	Storage::getInstance().init();
+	Gamepad * gamepad = new Gamepad();
+	Storage::getInstance().SetGamepad(gamepad);
+	Storage::getInstance().setFunctionalPinMappings();
+	gamepad->setup();
+
+	MappingCheck check(gamepad);
+	GpioMappingInfo* pinMappings = Storage::getInstance().getProfilePinMappings();
+	char label[64];
+
+	// the board's own profile
+	if (!check.checkProfile("board", testValues(256))) return 1;
+
+	// every action alone on every pin
+	for (int action = _GpioAction_MIN; action <= _GpioAction_MAX; action++) {
+		for (Pin_t pin = 0; pin < (Pin_t)NUM_BANK0_GPIOS; pin++) {
+			clearProfile(pinMappings);
+			assignAction(pinMappings[pin], (GpioAction)action);
+			snprintf(label, sizeof(label), "action %d on pin %d", action, pin);
+			if (!check.checkProfile(label, testValues(16))) return 1;
+		}
+	}
+
+	// random profiles, with several pins on the same action
+	for (uint32_t profile = 0; profile < randomProfiles; profile++) {
+		for (Pin_t pin = 0; pin < (Pin_t)NUM_BANK0_GPIOS; pin++) {
+			int action = _GpioAction_MIN + (int)(nextRandom() % (_GpioAction_MAX - _GpioAction_MIN + 1));
+			assignAction(pinMappings[pin], (GpioAction)action);
+		}
+		snprintf(label, sizeof(label), "random profile %u", profile);
+		if (!check.checkProfile(label, testValues(64))) return 1;
+	}
+
+	printf("# mapping check passed: %u profiles, %llu reads\n", check.profiles, (unsigned long long)check.reads);
+
+	// time both on the board profile
+	Storage::getInstance().setFunctionalPinMappings();
+	gamepad->reinit();
+
+	GamepadMappingPlan plan;
+	plan.compile(*gamepad);
+	DpadMode optionsDpadMode = gamepad->getOptions().dpadMode;
+	std::vector<Mask_t> values = testValues(2048);
+	uint32_t rounds = benchReads / values.size() + 1;
+
+	double legacyNs = timeReads(values, rounds, [&](Mask_t value) {
+		MappedState mapped;
+		legacyRead(*gamepad, value, optionsDpadMode, mapped);
+		return mapped.state.buttons ^ mapped.state.dpad ^ mapped.state.lx;
+	});
+	double planNs = timeReads(values, rounds, [&](Mask_t value) {
+		GamepadMappingEntry mapped = plan.lookup(value);
+		return mapped.buttons ^ mapped.dpad ^ mapped.flags;
+	});
+	double readNs = timeReads(values, rounds, [&](Mask_t value) {
+		gamepad->debouncedGpio = value;
+		gamepad->read();
+		return gamepad->state.buttons ^ gamepad->state.dpad ^ gamepad->state.lx;
+	});
+
+	printf("# per mapping tests  %6.2f ns/read\n", legacyNs);
+	printf("# plan lookup        %6.2f ns/read\n", planNs);
+	printf("# Gamepad::read      %6.2f ns/read\n", readNs);
+
+	return 0;
+}
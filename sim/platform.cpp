@@ -0,0 +1,89 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Firmware pieces the simulator replaces: the system queries, the driver selection (limited to the
+// drivers that build on the host) and the USB host port, which the simulated board doesn't have.
+
+#include <malloc.h>
+#include <stdio.h>
+
+#include "system.h"
+#include "drivermanager.h"
+#include "usbhostmanager.h"
+#include "latencytracer.h"
+#include "hardware/timer.h"
+
+#include "drivers/astro/AstroDriver.h"
+#include "drivers/egret/EgretDriver.h"
+#include "drivers/hid/HIDDriver.h"
+#include "drivers/mdmini/MDMiniDriver.h"
+#include "drivers/neogeo/NeoGeoDriver.h"
+#include "drivers/pcengine/PCEngineDriver.h"
+#include "drivers/psclassic/PSClassicDriver.h"
+#include "drivers/ps3/PS3Driver.h"
+#include "drivers/switch/SwitchDriver.h"
+
+uint32_t System::getTotalFlash() { return 0; }
+uint32_t System::getUsedFlash() { return 0; }
+uint32_t System::getPhysicalFlash() { return 0; }
+uint32_t System::getStaticAllocs() { return 0; }
+uint32_t System::getTotalHeap() { return 0; }
+uint32_t System::getUsedHeap() { return (uint32_t)mallinfo2().uordblks; }
+
+void System::reboot(BootMode bootMode) {
+	printf("# t_us=%lu reboot mode=0x%08lx\n", (unsigned long)time_us_32(), (unsigned long)bootMode);
+}
+
+System::BootMode System::takeBootMode() {
+	return BootMode::DEFAULT;
+}
+
+void DriverManager::setup(InputMode mode) {
+	switch (mode) {
+		case INPUT_MODE_ASTRO:
+			driver = new AstroDriver();
+			break;
+		case INPUT_MODE_EGRET:
+			driver = new EgretDriver();
+			break;
+		case INPUT_MODE_GENERIC:
+			driver = new HIDDriver();
+			break;
+		case INPUT_MODE_MDMINI:
+			driver = new MDMiniDriver();
+			break;
+		case INPUT_MODE_NEOGEO:
+			driver = new NeoGeoDriver();
+			break;
+		case INPUT_MODE_PSCLASSIC:
+			driver = new PSClassicDriver();
+			break;
+		case INPUT_MODE_PCEMINI:
+			driver = new PCEngineDriver();
+			break;
+		case INPUT_MODE_PS3:
+			driver = new PS3Driver();
+			break;
+		case INPUT_MODE_SWITCH:
+			driver = new SwitchDriver();
+			break;
+		default:
+			driver = nullptr;
+			return;
+	}
+
+	// Initialize our chosen driver
+	driver->initialize();
+	inputMode = mode;
+	LATENCY_TRACE_INIT(mode);
+}
+
+// Same as usbdriver.cpp, the simulated host calls this when it took the armed report
+void tud_hid_report_complete_cb(uint8_t instance, uint8_t const *report, uint16_t len) {
+	LATENCY_TRACE_COMPLETED();
+}
+
+void USBHostManager::pushListener(USBListener * usbListener) {}
+void USBHostManager::process() {}
@@ -0,0 +1,92 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#include "simconfig.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "FlashPROM.h"
+
+#include "pb_common.h"
+#include "pb_decode.h"
+#include "pb_encode.h"
+
+// Same as ConfigUtils::save, every field is saved
+static void setHasFlags(const pb_msgdesc_t* fields, void* s) {
+	pb_field_iter_t iter;
+	if (!pb_field_iter_begin(&iter, fields, s)) return;
+
+	do {
+		if (PB_HTYPE(iter.type) == PB_HTYPE_OPTIONAL) {
+			*reinterpret_cast<bool*>(iter.pSize) = true;
+			if (PB_LTYPE(iter.type) == PB_LTYPE_SUBMESSAGE) setHasFlags(iter.submsg_desc, iter.pData);
+		} else if (PB_HTYPE(iter.type) == PB_HTYPE_REPEATED && PB_LTYPE(iter.type) == PB_LTYPE_SUBMESSAGE) {
+			const pb_size_t count = *reinterpret_cast<pb_size_t*>(iter.pSize);
+			pb_byte_t* item = reinterpret_cast<pb_byte_t*>(iter.pData);
+			for (pb_size_t i = 0; i < count; i++, item += iter.data_size) setHasFlags(iter.submsg_desc, item);
+		}
+	} while (pb_field_iter_next(&iter));
+}
+
+// Same as ConfigUtils::save, sub-message streams count bytes_written from 0 so the offset is in the shared state
+static bool writeToCache(pb_ostream_t* stream, const pb_byte_t* buf, size_t count) {
+	uint32_t& offset = *reinterpret_cast<uint32_t*>(stream->state);
+	if (!EEPROM.write(offset, buf, count)) return false;
+	offset += count;
+	return true;
+}
+
+bool SimConfig::load(Config& config) {
+	config = Config Config_init_zero;
+	if (EEPROM.size() == 0) return false;
+	pb_istream_t stream = pb_istream_from_buffer(EEPROM.writeCache, EEPROM.size());
+	return pb_decode(&stream, Config_fields, &config);
+}
+
+bool SimConfig::save(Config& config) {
+	setHasFlags(Config_fields, &config);
+	uint32_t offset = 0;
+	pb_ostream_t stream = {};
+	stream.callback = &writeToCache;
+	stream.state = &offset;
+	stream.max_size = EEPROM_MAX_IMAGE_SIZE;
+	if (!pb_encode(&stream, Config_fields, &config)) return false;
+	EEPROM.commit(stream.bytes_written);
+	return true;
+}
+
+uint32_t SimConfig::encode(Config& config, uint8_t* buffer, uint32_t size) {
+	setHasFlags(Config_fields, &config);
+	pb_ostream_t stream = pb_ostream_from_buffer(buffer, size);
+	return pb_encode(&stream, Config_fields, &config) ? stream.bytes_written : 0;
+}
+
+void SimConfig::fillProfilesAndMacros(Config& config) {
+	ProfileOptions& profiles = config.profileOptions;
+	profiles.gpioMappingsSets_count = sizeof(profiles.gpioMappingsSets) / sizeof(profiles.gpioMappingsSets[0]);
+	for (pb_size_t i = 0; i < profiles.gpioMappingsSets_count; i++) {
+		GpioMappings& set = profiles.gpioMappingsSets[i];
+		memcpy(set.pins, config.gpioMappings.pins, sizeof(set.pins));
+		set.pins_count = config.gpioMappings.pins_count;
+		snprintf(set.profileLabel, sizeof(set.profileLabel), "Profile %u", (unsigned)(i + 2));
+		set.enabled = true;
+	}
+
+	MacroOptions& macros = config.addonOptions.macroOptions;
+	macros.macroList_count = sizeof(macros.macroList) / sizeof(macros.macroList[0]);
+	for (pb_size_t i = 0; i < macros.macroList_count; i++) {
+		Macro& macro = macros.macroList[i];
+		snprintf(macro.macroLabel, sizeof(macro.macroLabel), "Combo %u", (unsigned)(i + 1));
+		macro.macroInputs_count = sizeof(macro.macroInputs) / sizeof(macro.macroInputs[0]);
+		for (pb_size_t j = 0; j < macro.macroInputs_count; j++) {
+			macro.macroInputs[j].buttonMask = 1u << (j % 18);
+			macro.macroInputs[j].duration = 16666;
+			macro.macroInputs[j].waitDuration = 16666;
+		}
+		macro.enabled = true;
+		macro.macroTriggerButton = 1u << i;
+	}
+}
@@ -0,0 +1,30 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#ifndef SIMCONFIG_H_
+#define SIMCONFIG_H_
+
+#include <stdint.h>
+
+#include "config.pb.h"
+
+/**
+ * @brief ConfigUtils::load and save for the host tools, without the legacy config and migrations of
+ * config_utils.cpp (it needs ArduinoJson and mbedtls).
+ *
+ * The config goes through FlashPROM's cache the same way, encoded with every field set.
+ */
+namespace SimConfig {
+	// Decode the config FlashPROM replayed on start, false if it holds none
+	bool load(Config& config);
+	// Encode the config into FlashPROM's cache and commit it, it is written once the commit wait runs out
+	bool save(Config& config);
+	// Encode the config the way save does into buffer, returns the size or 0 if it doesn't fit
+	uint32_t encode(Config& config, uint8_t* buffer, uint32_t size);
+	// Every profile and macro in use, the largest configs users keep
+	void fillProfilesAndMacros(Config& config);
+}
+
+#endif
@@ -0,0 +1,302 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// Storage for the simulator: the config lives in RAM only, starts from the board's default pin
+// mapping and the defaults below, and saves go nowhere.
+
+#include "storagemanager.h"
+
+#include "BoardConfig.h"
+#include "eventmanager.h"
+#include "config.pb.h"
+#include "types.h"
+
+#ifndef GPIO_PIN_00
+    #define GPIO_PIN_00 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_01
+    #define GPIO_PIN_01 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_02
+    #define GPIO_PIN_02 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_03
+    #define GPIO_PIN_03 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_04
+    #define GPIO_PIN_04 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_05
+    #define GPIO_PIN_05 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_06
+    #define GPIO_PIN_06 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_07
+    #define GPIO_PIN_07 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_08
+    #define GPIO_PIN_08 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_09
+    #define GPIO_PIN_09 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_10
+    #define GPIO_PIN_10 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_11
+    #define GPIO_PIN_11 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_12
+    #define GPIO_PIN_12 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_13
+    #define GPIO_PIN_13 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_14
+    #define GPIO_PIN_14 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_15
+    #define GPIO_PIN_15 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_16
+    #define GPIO_PIN_16 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_17
+    #define GPIO_PIN_17 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_18
+    #define GPIO_PIN_18 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_19
+    #define GPIO_PIN_19 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_20
+    #define GPIO_PIN_20 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_21
+    #define GPIO_PIN_21 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_22
+    #define GPIO_PIN_22 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_23
+    #define GPIO_PIN_23 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_24
+    #define GPIO_PIN_24 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_25
+    #define GPIO_PIN_25 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_26
+    #define GPIO_PIN_26 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_27
+    #define GPIO_PIN_27 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_28
+    #define GPIO_PIN_28 GpioAction::NONE
+#endif
+#ifndef GPIO_PIN_29
+    #define GPIO_PIN_29 GpioAction::NONE
+#endif
+
+void Storage::init() {
+	config = Config_init_default;
+
+	// the gamepad options the input pipeline reads, with the firmware's defaults (see config_utils.cpp)
+	GamepadOptions& gamepadOptions = config.gamepadOptions;
+	gamepadOptions.inputMode = INPUT_MODE_SWITCH;
+	gamepadOptions.dpadMode = DPAD_MODE_DIGITAL;
+	gamepadOptions.socdMode = SOCD_MODE_NEUTRAL;
+	gamepadOptions.profileNumber = 1;
+	gamepadOptions.debounceDelay = 5;
+	gamepadOptions.debounceModeButtons = DEBOUNCE_MODE_STANDARD;
+	gamepadOptions.debounceModeDirections = DEBOUNCE_MODE_STANDARD;
+	gamepadOptions.inputSamplingMode = INPUT_SAMPLING_FREE_RUN;
+	gamepadOptions.lateLatchLeadUs = 250;
+	gamepadOptions.fastBoot = false;
+	gamepadOptions.flashStallBudgetUs = EEPROM_STALL_BUDGET_US;
+
+	// hotkeys and add-ons stay off, the zeroed options disable them
+
+	const GpioAction boardConfig[NUM_BANK0_GPIOS] = {
+		GPIO_PIN_00, GPIO_PIN_01, GPIO_PIN_02, GPIO_PIN_03, GPIO_PIN_04, GPIO_PIN_05,
+		GPIO_PIN_06, GPIO_PIN_07, GPIO_PIN_08, GPIO_PIN_09, GPIO_PIN_10, GPIO_PIN_11,
+		GPIO_PIN_12, GPIO_PIN_13, GPIO_PIN_14, GPIO_PIN_15, GPIO_PIN_16, GPIO_PIN_17,
+		GPIO_PIN_18, GPIO_PIN_19, GPIO_PIN_20, GPIO_PIN_21, GPIO_PIN_22, GPIO_PIN_23,
+		GPIO_PIN_24, GPIO_PIN_25, GPIO_PIN_26, GPIO_PIN_27, GPIO_PIN_28, GPIO_PIN_29
+	};
+
+	config.gpioMappings.pins_count = NUM_BANK0_GPIOS;
+	for (Pin_t pin = 0; pin < (Pin_t)NUM_BANK0_GPIOS; pin++) {
+		config.gpioMappings.pins[pin].action = boardConfig[pin];
+	}
+}
+
+bool Storage::save()
+{
+	return save(false);
+}
+
+bool Storage::save(const bool force) {
+	return true;
+}
+
+void Storage::performEnqueuedSaves()
+{
+	animationOptionsSavedVersion = animationOptionsToSave.version();
+}
+
+void Storage::enqueueAnimationOptionsSave(const AnimationOptions& animationOptions)
+{
+}
+
+void Storage::ResetSettings()
+{
+	init();
+}
+
+bool Storage::setProfile(const uint32_t profileNum)
+{
+	// is this profile defined?
+	uint32_t profileCeiling = config.profileOptions.gpioMappingsSets_count + 1;
+	if (profileNum >= 1 && profileNum <= profileCeiling) {
+		// profile 1 (core) is always enabled, others we must check
+		if (profileNum == 1 || config.profileOptions.gpioMappingsSets[profileNum-2].enabled) {
+			EventManager::getInstance().triggerEvent(GPProfileChangeEvent(this->config.gamepadOptions.profileNumber, profileNum));
+			this->config.gamepadOptions.profileNumber = profileNum;
+			return true;
+		}
+	}
+	return false;
+}
+
+void Storage::nextProfile()
+{
+	uint32_t profileCeiling = config.profileOptions.gpioMappingsSets_count + 1;
+	uint32_t requestedProfile = (this->config.gamepadOptions.profileNumber % profileCeiling) + 1;
+	while (!setProfile(requestedProfile)) {
+		requestedProfile = (requestedProfile % profileCeiling) + 1;
+	}
+}
+
+void Storage::previousProfile()
+{
+	uint32_t profileCeiling = config.profileOptions.gpioMappingsSets_count + 1;
+	uint32_t requestedProfile = this->config.gamepadOptions.profileNumber > 1 ?
+			config.gamepadOptions.profileNumber - 1 : profileCeiling;
+	while (!setProfile(requestedProfile)) {
+		requestedProfile = requestedProfile > 1 ? requestedProfile - 1 : profileCeiling;
+	}
+}
+
+char* Storage::currentProfileLabel() {
+	if (this->config.gamepadOptions.profileNumber == 1)
+		return this->config.gpioMappings.profileLabel;
+	else
+		return this->config.profileOptions.gpioMappingsSets[config.gamepadOptions.profileNumber-2].profileLabel;
+}
+
+void Storage::setFunctionalPinMappings()
+{
+	GpioMappingInfo* alts = nullptr;
+	uint32_t profileCeiling = config.profileOptions.gpioMappingsSets_count + 1;
+	if (config.gamepadOptions.profileNumber >= 2 &&
+			config.gamepadOptions.profileNumber <= profileCeiling) {
+		if (config.profileOptions.gpioMappingsSets[config.gamepadOptions.profileNumber-2].enabled) {
+			alts = config.profileOptions.gpioMappingsSets[config.gamepadOptions.profileNumber-2].pins;
+		}
+	}
+
+	// same rules as the firmware, profiles can't move RESERVED or ASSIGNED_TO_ADDON pins
+	for (Pin_t pin = 0; pin < (Pin_t)NUM_BANK0_GPIOS; pin++) {
+		if (alts != nullptr &&
+				alts[pin].action != GpioAction::RESERVED &&
+				alts[pin].action != GpioAction::ASSIGNED_TO_ADDON &&
+				this->config.gpioMappings.pins[pin].action != GpioAction::RESERVED &&
+				this->config.gpioMappings.pins[pin].action != GpioAction::ASSIGNED_TO_ADDON) {
+			functionalPinMappings[pin] = alts[pin];
+		} else {
+			functionalPinMappings[pin] = this->config.gpioMappings.pins[pin];
+		}
+	}
+}
+
+void Storage::SetConfigMode(bool mode) {
+	CONFIG_MODE = mode;
+	previewDisplayOptions = config.displayOptions;
+}
+
+bool Storage::GetConfigMode()
+{
+	return CONFIG_MODE;
+}
+
+void Storage::SetGamepad(Gamepad * newpad)
+{
+	gamepad = newpad;
+}
+
+Gamepad * Storage::GetGamepad()
+{
+	return gamepad;
+}
+
+void Storage::SetProcessedGamepad(Gamepad * newpad)
+{
+	processedGamepad = newpad;
+}
+
+Gamepad * Storage::GetProcessedGamepad()
+{
+	return processedGamepad;
+}
+
+void Storage::publishProcessedState(const GamepadState& state)
+{
+	processedState.write(state);
+}
+
+uint32_t Storage::readProcessedState(GamepadState& state) const
+{
+	return processedState.read(state);
+}
+
+void Storage::requestProcessedAux(uint32_t parts)
+{
+	for (uint32_t part = 0; part < PROCESSED_AUX_PART_COUNT; part++) {
+		if (parts & (1U << part)) processedAuxRequested[part].store(1, std::memory_order_relaxed);
+	}
+}
+
+void Storage::publishProcessedAuxState(GamepadAuxState& auxState)
+{
+	if (processedAuxEnabled != (1U << PROCESSED_AUX_PART_COUNT) - 1) {
+		for (uint32_t part = 0; part < PROCESSED_AUX_PART_COUNT; part++) {
+			if ((processedAuxEnabled & (1U << part)) || processedAuxRequested[part].load(std::memory_order_relaxed) == 0)
+				continue;
+			processedAuxEnabled |= 1U << part;
+			switch (1U << part) {
+				case PROCESSED_AUX_PLAYER_ID: auxState.playerID.enabled = true; break;
+				case PROCESSED_AUX_STATUS_LIGHT: auxState.sensors.statusLight.enabled = true; break;
+				case PROCESSED_AUX_LEFT_ACTUATOR: auxState.haptics.leftActuator.enabled = true; break;
+				case PROCESSED_AUX_RIGHT_ACTUATOR: auxState.haptics.rightActuator.enabled = true; break;
+			}
+		}
+	}
+
+	// most passes change nothing, those leave the version alone
+	if (processedAuxState.version() != 0 && memcmp(&auxState, &publishedAuxState, sizeof(GamepadAuxState)) == 0)
+		return;
+	memcpy(&publishedAuxState, &auxState, sizeof(GamepadAuxState));
+	processedAuxState.write(auxState);
+}
+
+uint32_t Storage::readProcessedAuxState(GamepadAuxState& auxState) const
+{
+	return processedAuxState.read(auxState);
+}
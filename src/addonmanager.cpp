@@ -1,57 +1,223 @@
 #include "addonmanager.h"
 #include "usbhostmanager.h"
+#include "loopprofiler.h"
+#include "system.h"
 
-bool AddonManager::LoadAddon(GPAddon* addon, ADDON_PROCESS processAt) {
-    if (addon->available()) {
-        AddonBlock * block = new AddonBlock;
-        addon->setup();
-        block->ptr = addon;
-        block->process = processAt;
-        addons.push_back(block);
-        return true;
-    } else {
-        delete addon; // Don't use the memory if we don't have to   
+#include <string.h>
+
+#include "hardware/timer.h"
+#include "pico/platform.h"
+
+#if LOOP_PROFILER_ENABLED
+#define ADDON_TIMING_START()        uint32_t timingStart = time_us_32()
+#define ADDON_TIMING_RECORD(stats)  recordTiming(stats, time_us_32() - timingStart)
+
+static inline void recordTiming(AddonTimingStats& stats, uint32_t elapsed) {
+    if (elapsed > stats.max) stats.max = elapsed;
+    stats.sum += elapsed;
+    stats.count++;
+}
+#else
+#define ADDON_TIMING_START()
+#define ADDON_TIMING_RECORD(stats)
+#endif
+
+const AddonManager * AddonManager::coreManagers[2] = { nullptr, nullptr };
+
+static const char * const addonNames[ADDON_ID_COUNT] = {
+    "KeyboardHost",
+    "GamepadUSBHost",
+    "Analog",
+    "BootselButton",
+    "DualDirectional",
+    "FocusMode",
+    "I2CAnalog",
+    "SPIAnalogADS1256",
+    "WiiExtension",
+    "SNESpad",
+    "PlayerNum",
+    "SliderSOCD",
+    "Tilt",
+    "Rotary",
+    "PCF8575",
+    "Input Reverse",
+    "Turbo",
+    "Input Macro",
+    "Display",
+    "NeoPicoLED",
+    "PLED",
+    "OnBoardLed",
+    "BuzzerSpeaker",
+    "DRV8833Rumble",
+    "ReactiveLED",
+};
+
+void AddonDispatchList::add(ADDON_PROCESS process, const AddonDispatch& entry) {
+    // move the later phases up one to make room at the end of this one
+    uint8_t at = ends[process];
+    for (uint8_t i = ends[ADDON_PROCESS_COUNT - 1]; i > at; i--) {
+        entries[i] = entries[i - 1];
     }
+    entries[at] = entry;
+    for (uint8_t phase = process; phase < ADDON_PROCESS_COUNT; phase++) {
+        ends[phase]++;
+    }
+}
 
-    return false;
+bool AddonManager::LoadAddon(GPAddon* addon, ADDON_PROCESS processAt) {
+    if ( addonCount == ADDONMGR_MAX_ADDONS ) {
+        delete addon;
+        return false;
+    }
+    return LoadBlock(addon, ADDON_ID_NONE, processAt, false, true);
 }
 
-bool AddonManager::LoadUSBAddon(GPAddon* addon, ADDON_PROCESS processAt) {
-    bool ret = LoadAddon(addon, processAt);
-    if ( ret == true )
+bool AddonManager::LoadBlock(GPAddon * addon, AddonId id, ADDON_PROCESS processAt, bool usbListener, bool onHeap) {
+    uint32_t start = time_us_32();
+    int32_t heapBefore = (int32_t)System::getUsedHeap();
+    if ( !addon->available() ) {
+        if ( onHeap )
+            delete addon; // Don't use the memory if we don't have to
+        else
+            addon->~GPAddon();
+        loadUs += time_us_32() - start;
+        loadHeap += (int32_t)System::getUsedHeap() - heapBefore;
+        return false;
+    }
+
+    addon->setup();
+    if ( usbListener )
         USBHostManager::getInstance().pushListener(addon->getListener());
-    return ret;
+
+    AddonBlock * block = &blocks[addonCount++];
+    *block = AddonBlock{};
+    block->ptr = addon;
+    block->id = id;
+    block->process = processAt;
+    block->hooks = addon->getHooks();
+    block->schedule = addon->getSchedule();
+    block->nextPollUs = time_us_32(); // first poll is due right away
+    block->setupUs = time_us_32() - start;
+    block->setupHeap = (int32_t)System::getUsedHeap() - heapBefore;
+    loadUs += block->setupUs;
+    loadHeap += block->setupHeap;
+
+    AddonDispatch entry = { addon, block };
+    if ( block->hooks & ADDON_HOOK_PREPROCESS )
+        preprocessList.add(processAt, entry);
+    if ( block->hooks & ADDON_HOOK_PROCESS )
+        processList.add(processAt, entry);
+    if ( block->hooks & ADDON_HOOK_REINIT )
+        reinitList.add(processAt, entry);
+    if ( block->schedule.periodUs != 0 )
+        pollList.add(processAt, entry);
+    coreManagers[get_core_num()] = this;
+    return true;
 }
 
 void AddonManager::ReinitializeAddons(ADDON_PROCESS processType) {
-    // Loop through all addons and process any that match our type
-    for (std::vector<AddonBlock*>::iterator it = addons.begin(); it != addons.end(); it++) {
-        if ( (*it)->process == processType )
-            (*it)->ptr->reinit();
+    for (AddonDispatch * it = reinitList.begin(processType); it != reinitList.end(processType); it++) {
+        it->ptr->reinit();
     }
 }
 
 void AddonManager::PreprocessAddons(ADDON_PROCESS processType) {
-    // Loop through all addons and process any that match our type
-    for (std::vector<AddonBlock*>::iterator it = addons.begin(); it != addons.end(); it++) {
-        if ( (*it)->process == processType )
-            (*it)->ptr->preprocess();
+    for (AddonDispatch * it = preprocessList.begin(processType); it != preprocessList.end(processType); it++) {
+        ADDON_TIMING_START();
+        it->ptr->preprocess();
+        ADDON_TIMING_RECORD(it->block->preprocessTiming);
     }
 }
 
 void AddonManager::ProcessAddons(ADDON_PROCESS processType) {
-    // Loop through all addons and process any that match our type
-    for (std::vector<AddonBlock*>::iterator it = addons.begin(); it != addons.end(); it++) {
-        if ( (*it)->process == processType )
-            (*it)->ptr->process();
+    for (AddonDispatch * it = processList.begin(processType); it != processList.end(processType); it++) {
+        ADDON_TIMING_START();
+        it->ptr->process();
+        ADDON_TIMING_RECORD(it->block->processTiming);
     }
 }
 
-// HACK : change this for NeoPicoLED
-GPAddon * AddonManager::GetAddon(std::string name) { // hack for NeoPicoLED
-    for (std::vector<AddonBlock*>::iterator it = addons.begin(); it != addons.end(); it++) {
-        if ( (*it)->ptr->name() == name )
-            return (*it)->ptr;
+void AddonManager::PollAddons(ADDON_PROCESS processType, uint32_t budgetUs) {
+    uint32_t start = time_us_32();
+    bool first = true;
+    while (true) {
+        // Most urgent poll that was due when the call started, one that ran since has its deadline after that.
+        // A poll half a period late goes first whatever its priority, so lower priorities can't starve.
+        uint32_t now = time_us_32();
+        AddonBlock * next = nullptr;
+        bool nextOverdue = false;
+        for (AddonDispatch * it = pollList.begin(processType); it != pollList.end(processType); it++) {
+            AddonBlock * block = it->block;
+            if ( (int32_t)(start - block->nextPollUs) < 0 )
+                continue;
+            bool overdue = (now - block->nextPollUs) >= block->schedule.periodUs / 2;
+            if ( next == nullptr || (overdue && !nextOverdue) ||
+                (overdue == nextOverdue && (block->schedule.priority > next->schedule.priority ||
+                (block->schedule.priority == next->schedule.priority && (int32_t)(block->nextPollUs - next->nextPollUs) < 0))) ) {
+                next = block;
+                nextOverdue = overdue;
+            }
+        }
+        if ( next == nullptr )
+            return;
+
+        // Leave this and every other due poll for a later pass if it wouldn't fit what is left of the budget
+        if ( !first && (now - start) + next->pollStats.lastUs > budgetUs ) {
+            for (AddonDispatch * it = pollList.begin(processType); it != pollList.end(processType); it++) {
+                if ( (int32_t)(start - it->block->nextPollUs) >= 0 )
+                    it->block->pollStats.deferred++;
+            }
+            return;
+        }
+
+        AddonPollStats& stats = next->pollStats;
+        uint32_t late = now - next->nextPollUs;
+        if ( late > stats.maxLateUs )
+            stats.maxLateUs = late;
+
+        next->ptr->poll();
+
+        uint32_t end = time_us_32();
+        stats.lastUs = end - now;
+        if ( stats.lastUs > stats.maxUs )
+            stats.maxUs = stats.lastUs;
+        stats.polls++;
+
+        // Keep to the period, a poll a whole period late starts over from now instead of catching up
+        if ( late >= next->schedule.periodUs ) {
+            stats.overruns++;
+            next->nextPollUs = end + next->schedule.periodUs;
+        } else {
+            next->nextPollUs += next->schedule.periodUs;
+        }
+        first = false;
+    }
+}
+
+void AddonManager::ResetStats() {
+    for (uint8_t i = 0; i < addonCount; i++) {
+        AddonBlock * block = &blocks[i];
+        // the scheduler still needs the last poll time to fit polls in the budget
+        uint32_t lastUs = block->pollStats.lastUs;
+        memset(&block->pollStats, 0, sizeof(AddonPollStats));
+        block->pollStats.lastUs = lastUs;
+        memset(&block->preprocessTiming, 0, sizeof(AddonTimingStats));
+        memset(&block->processTiming, 0, sizeof(AddonTimingStats));
+    }
+}
+
+GPAddon * AddonManager::GetAddon(AddonId id) {
+    for (uint8_t i = 0; i < addonCount; i++) {
+        if ( blocks[i].id == id )
+            return blocks[i].ptr;
     }
     return nullptr;
 }
+
+const char * AddonManager::GetAddonName(AddonId id) {
+    return (id < ADDON_ID_COUNT) ? addonNames[id] : "";
+}
+
+const AddonManager * AddonManager::GetCoreManager(uint8_t core) {
+    return (core < 2) ? coreManagers[core] : nullptr;
+}
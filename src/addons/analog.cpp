@@ -4,7 +4,7 @@
 #include "hardware/adc.h"
 #include "helper.h"
 #include "storagemanager.h"
-#include "drivermanager.h"
+#include "framecontext.h"
 
 #include <math.h>
 
@@ -14,7 +14,7 @@
 #define ANALOG_CENTER 0.5f
 #define ANALOG_MINIMUM 0.0f
 
-bool AnalogInput::available() {
+bool AnalogInput::isEnabled() {
     return Storage::getInstance().getAddonOptions().analogOptions.enabled;
 }
 
@@ -75,10 +75,7 @@ void AnalogInput::setup() {
 void AnalogInput::process() {
     Gamepad * gamepad = Storage::getInstance().GetGamepad();
     
-    uint16_t joystickMid = GAMEPAD_JOYSTICK_MID;
-    if ( DriverManager::getInstance().getDriver() != nullptr ) {
-        joystickMid = DriverManager::getInstance().getDriver()->GetJoystickMidValue();
-    }
+    uint16_t joystickMid = FrameContext::current().joystickMid;
 
     for(int i = 0; i < ADC_COUNT; i++) {
         // Read X-Axis
@@ -5,7 +5,7 @@
 #include "helper.h"
 #include "config.pb.h"
 
-bool BoardLedAddon::available() {
+bool BoardLedAddon::isEnabled() {
     const OnBoardLedOptions& options = Storage::getInstance().getAddonOptions().onBoardLedOptions;
     return options.enabled && options.mode != OnBoardLedMode::ON_BOARD_LED_MODE_OFF; // Available only when it's not set to off
 }
@@ -23,23 +23,24 @@ void BoardLedAddon::setup() {
 
 void BoardLedAddon::process() {
     bool state = 0;
-    Gamepad * processedGamepad;
+    GamepadState processedState;
+    InputMode inputMode;
     uint16_t joystickMid = GAMEPAD_JOYSTICK_MID;
     if ( DriverManager::getInstance().getDriver() != nullptr ) {
         joystickMid = DriverManager::getInstance().getDriver()->GetJoystickMidValue();
     }
     switch (onBoardLedMode) {
         case OnBoardLedMode::ON_BOARD_LED_MODE_INPUT_TEST: // Blinks on input
-            processedGamepad = Storage::getInstance().GetProcessedGamepad();
-            state =    (processedGamepad->state.buttons != 0)
-                    || (processedGamepad->state.dpad    != 0)
-                    || (processedGamepad->state.lx      != joystickMid)
-                    || (processedGamepad->state.rx      != joystickMid)
-                    || (processedGamepad->state.ly      != joystickMid)
-                    || (processedGamepad->state.ry      != joystickMid)
-                    || (processedGamepad->state.lt      != 0)
-                    || (processedGamepad->state.rt      != 0)
-                    || (processedGamepad->state.aux     != 0);
+            Storage::getInstance().readProcessedState(processedState);
+            state =    (processedState.buttons != 0)
+                    || (processedState.dpad    != 0)
+                    || (processedState.lx      != joystickMid)
+                    || (processedState.rx      != joystickMid)
+                    || (processedState.ly      != joystickMid)
+                    || (processedState.ry      != joystickMid)
+                    || (processedState.lt      != 0)
+                    || (processedState.rt      != 0)
+                    || (processedState.aux     != 0);
             if (prevState != state) {
                 gpio_put(BOARD_LED_PIN, state ? 1 : 0);
             }
@@ -70,9 +71,9 @@ void BoardLedAddon::process() {
             }
             break;
         case OnBoardLedMode::ON_BOARD_LED_MODE_PS_AUTH:
-            processedGamepad = Storage::getInstance().GetProcessedGamepad();
-            if(processedGamepad->getOptions().inputMode == INPUT_MODE_PS4 ||
-                processedGamepad->getOptions().inputMode == INPUT_MODE_PS5) {
+            inputMode = Storage::getInstance().getGamepadOptions().inputMode;
+            if(inputMode == INPUT_MODE_PS4 ||
+                inputMode == INPUT_MODE_PS5) {
                 state = ((PS4Driver*)DriverManager::getInstance().getDriver())->getAuthSent() == true;
             }
             if (prevState != state) {
@@ -37,7 +37,7 @@ bool __no_inline_not_in_flash_func(BootselButtonAddon::isBootselPressed)() {
 	return button_state;
 }
 
-bool BootselButtonAddon::available() {
+bool BootselButtonAddon::isEnabled() {
     const BootselButtonOptions& options = Storage::getInstance().getAddonOptions().bootselButtonOptions;
 	return options.enabled && options.buttonMap != 0;
 }
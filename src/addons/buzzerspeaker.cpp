@@ -7,7 +7,7 @@
 #include "helper.h"
 #include "config.pb.h"
 
-bool BuzzerSpeakerAddon::available() {
+bool BuzzerSpeakerAddon::isEnabled() {
     const BuzzerOptions& options = Storage::getInstance().getAddonOptions().buzzerOptions;
 	return options.enabled && isValidPin(options.pin);
 }
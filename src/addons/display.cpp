@@ -16,16 +16,16 @@
 #include "config.pb.h"
 #include "class/hid/hid.h"
 
+bool DisplayAddon::isEnabled() {
+    return Storage::getInstance().getDisplayOptions().enabled;
+}
+
 bool DisplayAddon::available() {
-    const DisplayOptions& options = Storage::getInstance().getDisplayOptions();
-    bool result = false;
-    if (options.enabled) {
-        // create the gfx interface
-        gpDisplay = new GPGFX();
-        gpOptions = gpDisplay->getAvailableDisplay(GPGFX_DisplayType::DISPLAY_TYPE_NONE);
-        result = (gpOptions.displayType != GPGFX_DisplayType::DISPLAY_TYPE_NONE);
-        if (!result) delete gpDisplay;
-    }
+    // create the gfx interface
+    gpDisplay = new GPGFX();
+    gpOptions = gpDisplay->getAvailableDisplay(GPGFX_DisplayType::DISPLAY_TYPE_NONE);
+    bool result = (gpOptions.displayType != GPGFX_DisplayType::DISPLAY_TYPE_NONE);
+    if (!result) delete gpDisplay;
     return result;
 }
 
@@ -77,8 +77,8 @@ void DisplayAddon::setup() {
     gpScreen = nullptr;
     updateDisplayScreen();
 
-    EventManager::getInstance().registerEventHandler(GP_EVENT_RESTART, GPEVENT_CALLBACK(this->handleSystemRestart(event)));
-    EventManager::getInstance().registerEventHandler(GP_EVENT_MENU_NAVIGATE, GPEVENT_CALLBACK(this->handleMenuNavigation(event)));
+    restartHandler = EventManager::getInstance().registerEventHandler(GP_EVENT_RESTART, GPEVENT_CALLBACK(this->handleSystemRestart(event)));
+    menuNavigationHandler = EventManager::getInstance().registerEventHandler(GP_EVENT_MENU_NAVIGATE, GPEVENT_CALLBACK(this->handleMenuNavigation(event)));
 }
 
 bool DisplayAddon::updateDisplayScreen() {
@@ -200,8 +200,13 @@ void DisplayAddon::process() {
         return;
     }
 
-    int8_t screenReturn = gpScreen->update();
-    gpScreen->draw();
+    // Screens that only show the processed state skip the passes where core0 published nothing new
+    bool stateChanged = GPGFX_UI::refreshProcessedGamepad();
+    int8_t screenReturn = -1;
+    if (gpScreen->needsRedraw(stateChanged)) {
+        screenReturn = gpScreen->update();
+        gpScreen->draw();
+    }
 
     if (!configMode && screenReturn < 0) {
         Mask_t values = Storage::getInstance().GetGamepad()->debouncedGpio;
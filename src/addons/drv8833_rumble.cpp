@@ -10,14 +10,14 @@
 #include <stdio.h>
 #include "pico/stdlib.h"
 
-bool DRV8833RumbleAddon::available() {
+bool DRV8833RumbleAddon::isEnabled() {
 	const DRV8833RumbleOptions& options = Storage::getInstance().getAddonOptions().drv8833RumbleOptions;
 	return options.enabled && (isValidPin(options.leftMotorPin) && isValidPin(options.rightMotorPin));
 }
 
 void DRV8833RumbleAddon::setup() {
 	const DRV8833RumbleOptions& options = Storage::getInstance().getAddonOptions().drv8833RumbleOptions;
-    Gamepad * gamepad = Storage::getInstance().GetProcessedGamepad();
+	uint32_t auxParts = 0;
 
 	leftMotorPin = options.leftMotorPin;
 	rightMotorPin = options.rightMotorPin;
@@ -40,7 +40,7 @@ void DRV8833RumbleAddon::setup() {
 		leftMotorPinChannel = pwm_gpio_to_channel (leftMotorPin);
 		pwmSetFreqDuty(leftMotorPinSlice, leftMotorPinChannel, pwmFrequency, 0);
 		pwm_set_enabled(leftMotorPinSlice, true);
-		gamepad->auxState.haptics.leftActuator.enabled = true;
+		auxParts |= PROCESSED_AUX_LEFT_ACTUATOR;
 	}
 
 	if(isValidPin(rightMotorPin)) {
@@ -49,7 +49,7 @@ void DRV8833RumbleAddon::setup() {
 		rightMotorPinChannel = pwm_gpio_to_channel (rightMotorPin);
 		pwmSetFreqDuty(rightMotorPinSlice, rightMotorPinChannel, pwmFrequency, 0);
 		pwm_set_enabled(rightMotorPinSlice, true);
-		gamepad->auxState.haptics.rightActuator.enabled = true;
+		auxParts |= PROCESSED_AUX_RIGHT_ACTUATOR;
 	}
 
 	if(isValidPin(motorSleepPin)) {
@@ -58,24 +58,27 @@ void DRV8833RumbleAddon::setup() {
 		// turn on sleep mode
 		gpio_put(motorSleepPin, false);
 	}
+
+	// core0 enables the actuators for the driver, this core only reads the aux state
+	Storage::getInstance().requestProcessedAux(auxParts);
 }
 
-bool DRV8833RumbleAddon::compareRumbleState(Gamepad * gamepad) {
-	if (currentRumbleState.leftActuator.active == gamepad->auxState.haptics.leftActuator.active && 
-		currentRumbleState.leftActuator.intensity == gamepad->auxState.haptics.leftActuator.intensity && 
-		currentRumbleState.rightActuator.active == gamepad->auxState.haptics.rightActuator.active && 
-		currentRumbleState.rightActuator.intensity == gamepad->auxState.haptics.rightActuator.intensity)
+bool DRV8833RumbleAddon::compareRumbleState(const GamepadAuxHaptics& haptics) {
+	if (currentRumbleState.leftActuator.active == haptics.leftActuator.active && 
+		currentRumbleState.leftActuator.intensity == haptics.leftActuator.intensity && 
+		currentRumbleState.rightActuator.active == haptics.rightActuator.active && 
+		currentRumbleState.rightActuator.intensity == haptics.rightActuator.intensity)
 		return true;
 
 	return false;
 
 }
 
-void DRV8833RumbleAddon::setRumbleState(Gamepad * gamepad) {
-	currentRumbleState.leftActuator.active = gamepad->auxState.haptics.leftActuator.active;
-	currentRumbleState.leftActuator.intensity = gamepad->auxState.haptics.leftActuator.intensity;
-	currentRumbleState.rightActuator.active = gamepad->auxState.haptics.rightActuator.active;
-	currentRumbleState.rightActuator.intensity = gamepad->auxState.haptics.rightActuator.intensity;
+void DRV8833RumbleAddon::setRumbleState(const GamepadAuxHaptics& haptics) {
+	currentRumbleState.leftActuator.active = haptics.leftActuator.active;
+	currentRumbleState.leftActuator.intensity = haptics.leftActuator.intensity;
+	currentRumbleState.rightActuator.active = haptics.rightActuator.active;
+	currentRumbleState.rightActuator.intensity = haptics.rightActuator.intensity;
 }
 
 void DRV8833RumbleAddon::disableMotors() {
@@ -87,9 +90,9 @@ void DRV8833RumbleAddon::disableMotors() {
 	pwmSetFreqDuty(rightMotorPinSlice, rightMotorPinChannel, pwmFrequency, 0);
 }
 
-void DRV8833RumbleAddon::enableMotors(Gamepad * gamepad) {
-	pwmSetFreqDuty(leftMotorPinSlice, leftMotorPinChannel, pwmFrequency, (gamepad->auxState.haptics.leftActuator.intensity == 0) ? 0 : scaleDuty(motorToDuty(gamepad->auxState.haptics.leftActuator.intensity), dutyMin, dutyMax));
-	pwmSetFreqDuty(rightMotorPinSlice, rightMotorPinChannel, pwmFrequency, (gamepad->auxState.haptics.rightActuator.intensity == 0) ? 0 : scaleDuty(motorToDuty(gamepad->auxState.haptics.rightActuator.intensity), dutyMin, dutyMax));
+void DRV8833RumbleAddon::enableMotors(const GamepadAuxHaptics& haptics) {
+	pwmSetFreqDuty(leftMotorPinSlice, leftMotorPinChannel, pwmFrequency, (haptics.leftActuator.intensity == 0) ? 0 : scaleDuty(motorToDuty(haptics.leftActuator.intensity), dutyMin, dutyMax));
+	pwmSetFreqDuty(rightMotorPinSlice, rightMotorPinChannel, pwmFrequency, (haptics.rightActuator.intensity == 0) ? 0 : scaleDuty(motorToDuty(haptics.rightActuator.intensity), dutyMin, dutyMax));
 
 	// if motorSleepPin set and any motors are on, disable motor driver sleep mode
 	if (isValidPin(motorSleepPin))
@@ -97,15 +100,17 @@ void DRV8833RumbleAddon::enableMotors(Gamepad * gamepad) {
 }
 
 void DRV8833RumbleAddon::process() {
-	Gamepad * gamepad = Storage::getInstance().GetProcessedGamepad();
+	// Rumble set by the driver on core0, nothing to do until it publishes a new aux state
+	if (Storage::getInstance().getProcessedAuxStateVersion() == auxStateVersion) return;
+	auxStateVersion = Storage::getInstance().readProcessedAuxState(auxState);
 
-	if (!compareRumbleState(gamepad)) {
-		setRumbleState(gamepad);
-		if (!(gamepad->auxState.haptics.leftActuator.active || gamepad->auxState.haptics.rightActuator.active)) {
+	if (!compareRumbleState(auxState.haptics)) {
+		setRumbleState(auxState.haptics);
+		if (!(auxState.haptics.leftActuator.active || auxState.haptics.rightActuator.active)) {
 			disableMotors();
 			return;
 		}
-		enableMotors(gamepad);
+		enableMotors(auxState.haptics);
 	}
 }
 
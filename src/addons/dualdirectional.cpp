@@ -1,10 +1,11 @@
 #include "addons/dualdirectional.h"
 #include "storagemanager.h"
+#include "framecontext.h"
 #include "helper.h"
 #include "config.pb.h"
 #include "types.h"
 
-bool DualDirectionalInput::available() {
+bool DualDirectionalInput::isEnabled() {
     return Storage::getInstance().getAddonOptions().dualDirectionalOptions.enabled;
 }
 
@@ -30,11 +31,8 @@ void DualDirectionalInput::setup() {
 
     dualState = 0;
 
-    lastGPUD = DIRECTION_NONE;
-    lastGPLR = DIRECTION_NONE;
-
-    lastDualUD = DIRECTION_NONE;
-    lastDualLR = DIRECTION_NONE;
+    dualResolver.reset();
+    gamepadResolver.reset();
 }
 
 /**
@@ -49,54 +47,6 @@ void DualDirectionalInput::reinit()
     this->setup();
 }
 
-
-uint8_t DualDirectionalInput::updateDpadDDI(uint8_t dpad, DpadDirection direction)
-{
-	static bool inList[] = {false, false, false, false, false}; // correspond to DpadDirection: none, up, down, left, right
-	static list<DpadDirection> dpadList;
-
-	if(dpad & getMaskFromDirection(direction))
-	{
-		if(!inList[direction])
-		{
-			dpadList.push_back(direction);
-			inList[direction] = true;
-		}
-	}
-	else
-	{
-		if(inList[direction])
-		{
-			dpadList.remove(direction);
-			inList[direction] = false;
-		}
-	}
-
-	if(dpadList.empty()) {
-		return 0;
-	}
-	else {
-		return getMaskFromDirection(dpadList.back());
-	}
-}
-
-/**
- * @brief Filter diagonals out of the dpad, making the device work as a 4-way lever.
- *
- * The most recent cardinal direction wins.
- *
- * @param dpad The GameState.dpad value.
- * @return uint8_t The new dpad value.
- */
-uint8_t DualDirectionalInput::filterToFourWayModeDDI(uint8_t dpad)
-{
-	updateDpadDDI(dpad, DIRECTION_UP);
-	updateDpadDDI(dpad, DIRECTION_DOWN);
-	updateDpadDDI(dpad, DIRECTION_LEFT);
-	return updateDpadDDI(dpad, DIRECTION_RIGHT);
-}
-
-
 void DualDirectionalInput::preprocess()
 {
     const DualDirectionalOptions& options = Storage::getInstance().getAddonOptions().dualDirectionalOptions;
@@ -109,15 +59,15 @@ void DualDirectionalInput::preprocess()
             | ((values & mapDpadLeft->pinMask)  ? mapDpadLeft->buttonMask : 0)
             | ((values & mapDpadRight->pinMask) ? mapDpadRight->buttonMask : 0);
 
-    const SOCDMode socdMode = getSOCDMode(gamepad->getOptions());
+    const SOCDMode socdMode = FrameContext::current().socdMode;
 
     // 4-way before SOCD, might have better history without losing any coherent functionality
     if (options.fourWayMode) {
-        dualState = filterToFourWayModeDDI(dualState);
+        dualState = dualResolver.filterToFourWayMode(dualState);
     }
 
     // SOCD clean the dual inputs based on the mode in the gamepad config
-    SOCDDualClean(socdMode);
+    dualState = dualResolver.runSOCDCleaner(socdMode, dualState);
 }
 
 void DualDirectionalInput::process()
@@ -125,7 +75,7 @@ void DualDirectionalInput::process()
     const DualDirectionalOptions& options = Storage::getInstance().getAddonOptions().dualDirectionalOptions;
     Gamepad * gamepad = Storage::getInstance().GetGamepad();
     uint8_t dualOut = dualState;
-    const SOCDMode socdMode = getSOCDMode(gamepad->getOptions());
+    const SOCDMode socdMode = FrameContext::current().socdMode;
     uint8_t gamepadDpad = gpadToBinary(gamepad->getActiveDpadMode(), gamepad->state);
 
     // in mixed mode, we need to combine/re-clean the gamepad and DDI outputs to create a coherent behavior
@@ -139,7 +89,7 @@ void DualDirectionalInput::process()
             dualOut = SOCDCombine(socdMode, gamepadDpad);
         } else if ( socdMode != SOCD_MODE_BYPASS ) {
             // else if not bypass, what's left is first/last input wins SOCD, which need a complicated re-clean
-            dualOut = SOCDGamepadClean(dualOut | gamepadDpad, socdMode == SOCD_MODE_SECOND_INPUT_PRIORITY);
+            dualOut = gamepadResolver.runSOCDCleaner(socdMode, dualOut | gamepadDpad);
         } else {
             // this is bypass SOCD, just OR them together
             dualOut |= gamepadDpad;
@@ -175,49 +125,6 @@ void DualDirectionalInput::OverrideGamepad(Gamepad * gamepad, DpadMode mode, uin
     }
 }
 
-uint8_t DualDirectionalInput::SOCDGamepadClean(uint8_t gamepadState, bool isLastWin) {
-    // Gamepad SOCD Last-Win OR First-Win Clean
-    switch (gamepadState & (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN)) {
-        case (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN): // If last state was Up or Down, exclude it from our gamepad
-            if (isLastWin) gamepadState ^= (lastGPUD == DIRECTION_UP) ? GAMEPAD_MASK_UP : GAMEPAD_MASK_DOWN;
-            else gamepadState ^= (lastGPUD == DIRECTION_UP) ? GAMEPAD_MASK_DOWN : GAMEPAD_MASK_UP;
-            break;
-        case GAMEPAD_MASK_UP:
-            gamepadState |= GAMEPAD_MASK_UP;
-            lastGPUD = DIRECTION_UP;
-            break;
-        case GAMEPAD_MASK_DOWN:
-            gamepadState |= GAMEPAD_MASK_DOWN;
-            lastGPUD = DIRECTION_DOWN;
-            break;
-        default:
-            lastGPUD = DIRECTION_NONE;
-            break;
-    }
-    switch (gamepadState & (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT)) {
-        case (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT):
-            if (lastGPLR != DIRECTION_NONE)
-                if (isLastWin) gamepadState ^= (lastGPLR == DIRECTION_LEFT) ? GAMEPAD_MASK_LEFT : GAMEPAD_MASK_RIGHT;
-                else gamepadState ^= (lastGPLR == DIRECTION_LEFT) ? GAMEPAD_MASK_RIGHT : GAMEPAD_MASK_LEFT;
-            else
-                lastGPLR = DIRECTION_NONE;
-            break;
-        case GAMEPAD_MASK_LEFT:
-            gamepadState |= GAMEPAD_MASK_LEFT;
-            lastGPLR = DIRECTION_LEFT;
-            break;
-        case GAMEPAD_MASK_RIGHT:
-            gamepadState |= GAMEPAD_MASK_RIGHT;
-            lastGPLR = DIRECTION_RIGHT;
-            break;
-        default:
-            lastGPLR = DIRECTION_NONE;
-            break;
-    }
-    return gamepadState;
-}
-
-
 uint8_t DualDirectionalInput::SOCDCombine(SOCDMode mode, uint8_t gamepadState) {
     uint8_t outState = dualState | gamepadState;
 
@@ -246,61 +153,6 @@ uint8_t DualDirectionalInput::SOCDCombine(SOCDMode mode, uint8_t gamepadState) {
     return outState;
 }
 
-void DualDirectionalInput::SOCDDualClean(SOCDMode socdMode) { 
-    if (socdMode == SOCD_MODE_BYPASS) {
-        return;
-    }
-
-    // Dual SOCD Last-Win Clean
-    switch (dualState & (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN)) {
-        case (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN): // If last state was Up or Down, exclude it from our gamepad
-            if ( socdMode == SOCD_MODE_UP_PRIORITY ) {
-                dualState ^= GAMEPAD_MASK_DOWN; // Remove Down
-                lastDualUD = DIRECTION_UP; // We're in UP mode
-            } else if ( socdMode == SOCD_MODE_SECOND_INPUT_PRIORITY && lastDualUD != DIRECTION_NONE ) {
-                dualState ^= (lastDualUD == DIRECTION_UP) ? GAMEPAD_MASK_UP : GAMEPAD_MASK_DOWN;
-            } else if ( socdMode == SOCD_MODE_FIRST_INPUT_PRIORITY && lastDualUD != DIRECTION_NONE ) {
-                dualState ^= (lastDualUD == DIRECTION_UP) ? GAMEPAD_MASK_DOWN : GAMEPAD_MASK_UP;
-            } else {
-                dualState ^= (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN); // Remove UP and Down in Neutral
-                lastDualUD = DIRECTION_NONE;
-            }
-            break;
-        case GAMEPAD_MASK_UP:
-            lastDualUD = DIRECTION_UP;
-            break;
-        case GAMEPAD_MASK_DOWN:
-            lastDualUD = DIRECTION_DOWN;
-            break;
-        default:
-            lastDualUD = DIRECTION_NONE;
-            break;
-    }
-    switch (dualState & (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT)) {
-        case (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT):
-            if ( socdMode == SOCD_MODE_UP_PRIORITY || socdMode == SOCD_MODE_NEUTRAL ) {
-                dualState ^= (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT); // Remove L + R to Neutral
-                lastDualLR = DIRECTION_NONE;
-            } else if ( socdMode == SOCD_MODE_SECOND_INPUT_PRIORITY || socdMode == SOCD_MODE_FIRST_INPUT_PRIORITY ) {
-                if (lastDualLR != DIRECTION_NONE)
-                    if (socdMode == SOCD_MODE_SECOND_INPUT_PRIORITY) dualState ^= (lastDualLR == DIRECTION_LEFT) ? GAMEPAD_MASK_LEFT : GAMEPAD_MASK_RIGHT; // Last Win
-                    else dualState ^= (lastDualLR == DIRECTION_LEFT) ? GAMEPAD_MASK_RIGHT : GAMEPAD_MASK_LEFT; // First Win
-                else
-                    lastDualLR = DIRECTION_NONE;
-            }
-            break;
-        case GAMEPAD_MASK_LEFT:
-            lastDualLR = DIRECTION_LEFT;
-            break;
-        case GAMEPAD_MASK_RIGHT:
-            lastDualLR = DIRECTION_RIGHT;
-            break;
-        default:
-            lastDualLR = DIRECTION_NONE;
-            break;
-    }
-}
-
 uint8_t DualDirectionalInput::gpadToBinary(DpadMode dpadMode, GamepadState state) {
     uint8_t out = 0;
     switch(dpadMode) { // Convert gamepad to dual if we're in mixed
@@ -335,7 +187,3 @@ uint8_t DualDirectionalInput::gpadToBinary(DpadMode dpadMode, GamepadState state
 
     return out;
 }
-
-const SOCDMode DualDirectionalInput::getSOCDMode(const GamepadOptions& options) {
-    return Gamepad::resolveSOCDMode(options);
-}
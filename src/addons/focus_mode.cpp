@@ -2,7 +2,7 @@
 #include "storagemanager.h"
 #include "hardware/gpio.h"
 
-bool FocusModeAddon::available() {
+bool FocusModeAddon::isEnabled() {
 	const FocusModeOptions& options = Storage::getInstance().getAddonOptions().focusModeOptions;
 	return options.enabled && options.buttonLockMask != 0;
 }
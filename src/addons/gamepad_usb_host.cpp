@@ -6,7 +6,7 @@
 #include "peripheralmanager.h"
 #include "class/hid/hid_host.h"
 
-bool GamepadUSBHostAddon::available()
+bool GamepadUSBHostAddon::isEnabled()
 {
     const GamepadUSBHostOptions& gamepadUSBHostOptions = Storage::getInstance().getAddonOptions().gamepadUSBHostOptions;
     return gamepadUSBHostOptions.enabled && PeripheralManager::getInstance().isUSBEnabled(0);
@@ -3,19 +3,19 @@
 #include "helper.h"
 #include "config.pb.h"
 
+bool PCF8575Addon::isEnabled() {
+    return Storage::getInstance().getAddonOptions().pcf8575Options.enabled;
+}
+
 bool PCF8575Addon::available() {
-    const DisplayOptions& displayOptions = Storage::getInstance().getDisplayOptions();
-    const PCF8575Options& options = Storage::getInstance().getAddonOptions().pcf8575Options;
-    if (options.enabled) {
-        pcf = new PCF8575();
-        PeripheralI2CScanResult result = PeripheralManager::getInstance().scanForI2CDevice(pcf->getDeviceAddresses());
-        if (result.address > -1) {
-            pcf->setAddress(result.address);
-            pcf->setI2C(PeripheralManager::getInstance().getI2C(result.block));
-            return true;
-        } else {
-            delete pcf;
-        }
+    pcf = new PCF8575();
+    PeripheralI2CScanResult result = PeripheralManager::getInstance().scanForI2CDevice(pcf->getDeviceAddresses());
+    if (result.address > -1) {
+        pcf->setAddress(result.address);
+        pcf->setI2C(PeripheralManager::getInstance().getI2C(result.block));
+        return true;
+    } else {
+        delete pcf;
     }
     return false;
 }
@@ -30,6 +30,7 @@ void PCF8575Addon::setup() {
         GpioMappingInfo pin = gpioMappings[i];
         if ((pin.action != GpioAction::NONE) && (pin.action != GpioAction::RESERVED) && (pin.action != GpioAction::ASSIGNED_TO_ADDON)) {
             pinRef.insert({i,pin});
+            if (pin.direction == GpioDirection::GPIO_DIRECTION_OUTPUT) hasOutputs = true;
         }
     }
 
@@ -41,13 +42,18 @@ void PCF8575Addon::setup() {
     }
 }
 
-void PCF8575Addon::process()
+void PCF8575Addon::preprocess()
 {
-    Gamepad * gamepad = Storage::getInstance().GetGamepad();
-
+    // buttons are read in front of the report like the GPIO buttons, one read of all 16 pins instead of one per pin
+    bool received = false;
+    uint16_t pinsRaw = 0;
     for (std::map<uint8_t, GpioMappingInfo>::iterator pin = pinRef.begin(); pin != pinRef.end(); ++pin) {
         if (pin->second.direction == GpioDirection::GPIO_DIRECTION_INPUT) {
-            uint8_t pinRaw = pcf->getPin(pin->first);
+            if (!received) {
+                pinsRaw = pcf->receive();
+                received = true;
+            }
+            uint8_t pinRaw = (pinsRaw >> pin->first) & 1;
             bool pinValue = (bool)(!(pinRaw == 1));
             switch (pin->second.action) {
                 case GpioAction::BUTTON_PRESS_UP:    inputButtonUp = pinValue; break;
@@ -71,7 +77,17 @@ void PCF8575Addon::process()
                 case GpioAction::BUTTON_PRESS_FN:    inputButtonFN = pinValue; break;
                 default:                             break;
             }
-        } else if (pin->second.direction == GpioDirection::GPIO_DIRECTION_OUTPUT) {
+        }
+    }
+}
+
+void PCF8575Addon::poll()
+{
+    Gamepad * gamepad = Storage::getInstance().GetGamepad();
+
+    // outputs only mirror the gamepad state, they can follow the report
+    for (std::map<uint8_t, GpioMappingInfo>::iterator pin = pinRef.begin(); pin != pinRef.end(); ++pin) {
+        if (pin->second.direction == GpioDirection::GPIO_DIRECTION_OUTPUT) {
             switch (pin->second.action) {
                 case GpioAction::BUTTON_PRESS_UP:    pcf->setPin(pin->first, !((gamepad->state.dpad & GAMEPAD_MASK_UP) == GAMEPAD_MASK_UP)); break;
                 case GpioAction::BUTTON_PRESS_DOWN:  pcf->setPin(pin->first, !((gamepad->state.dpad & GAMEPAD_MASK_DOWN) == GAMEPAD_MASK_DOWN)); break;
@@ -93,10 +109,13 @@ void PCF8575Addon::process()
                 case GpioAction::BUTTON_PRESS_A2:    pcf->setPin(pin->first, !((gamepad->state.buttons & GAMEPAD_MASK_A2) == GAMEPAD_MASK_A2)); break;
                 default:                             break;
             }
-        } else {
-            // NYI
         }
     }
+}
+
+void PCF8575Addon::process()
+{
+    Gamepad * gamepad = Storage::getInstance().GetGamepad();
 
     if (inputButtonUp) gamepad->state.dpad |= GAMEPAD_MASK_UP;
     if (inputButtonDown) gamepad->state.dpad |= GAMEPAD_MASK_DOWN;
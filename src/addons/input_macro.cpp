@@ -1,10 +1,11 @@
 #include "addons/input_macro.h"
 #include "storagemanager.h"
+#include "framecontext.h"
 #include "GamepadState.h"
 
 #include "hardware/gpio.h"
 
-bool InputMacro::available() {
+bool InputMacro::isEnabled() {
     // Macro Button initialized by void Gamepad::setup()
     GpioMappingInfo* pinMappings = Storage::getInstance().getProfilePinMappings();
     for (Pin_t pin = 0; pin < (Pin_t)NUM_BANK0_GPIOS; pin++)
@@ -158,7 +159,7 @@ void InputMacro::checkMacroAction() {
         uint32_t macroInputDuration = macroInput.duration + macroInput.waitDuration;
         macroInputHoldTime = macroInputDuration <= 0 ? INPUT_HOLD_US : macroInputDuration;
         isMacroRunning = true;
-        macroStartTime = getMicro(); // current time
+        macroStartTime = FrameContext::current().micros; // current time
     }
 }
 
@@ -179,7 +180,7 @@ void InputMacro::runCurrentMacro() {
 
     MacroInput& macroInput = macro.macroInputs[macroInputPosition];
     Gamepad * gamepad = Storage::getInstance().GetGamepad();
-    currentMicros = getMicro();
+    currentMicros = FrameContext::current().micros;
 
     if (!macro.interruptible && macro.exclusive) {
         // Prevent any other inputs from modifying our input (Exclusive)
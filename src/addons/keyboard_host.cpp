@@ -6,7 +6,7 @@
 #include "peripheralmanager.h"
 #include "class/hid/hid_host.h"
 
-bool KeyboardHostAddon::available() {
+bool KeyboardHostAddon::isEnabled() {
   const KeyboardHostOptions& keyboardHostOptions = Storage::getInstance().getAddonOptions().keyboardHostOptions;
 	return keyboardHostOptions.enabled && PeripheralManager::getInstance().isUSBEnabled(0);
 }
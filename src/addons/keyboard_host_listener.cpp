@@ -1,5 +1,5 @@
 #include "addons/keyboard_host_listener.h"
-#include "drivermanager.h"
+#include "framecontext.h"
 #include "storagemanager.h"
 #include "class/hid/hid_host.h"
 
@@ -155,10 +155,7 @@ uint8_t KeyboardHostListener::getKeycodeFromModifier(uint8_t modifier) {
 
 void KeyboardHostListener::preprocess_report()
 {
-  uint16_t joystickMid = GAMEPAD_JOYSTICK_MID;
-  if ( DriverManager::getInstance().getDriver() != nullptr ) {
-    joystickMid = DriverManager::getInstance().getDriver()->GetJoystickMidValue();
-  }
+  uint16_t joystickMid = FrameContext::current().joystickMid;
 
   _keyboard_host_state.dpad = 0;
   _keyboard_host_state.buttons = 0;
@@ -116,7 +116,7 @@ PLEDAnimationState getXInputAnimationNEOPICO(uint16_t ledState)
     return animationState;
 }
 
-PLEDAnimationState getXBoneAnimationNEOPICO(Gamepad * gamepad)
+PLEDAnimationState getXBoneAnimationNEOPICO(uint32_t ledValue)
 {
     PLEDAnimationState animationState =
     {
@@ -124,7 +124,7 @@ PLEDAnimationState getXBoneAnimationNEOPICO(Gamepad * gamepad)
         .animation = PLED_ANIM_OFF
     };
 
-    if ( gamepad->auxState.playerID.ledValue == 1 ) { 
+    if ( ledValue == 1 ) { 
         animationState.animation = PLED_ANIM_SOLID;
     }
 
@@ -191,7 +191,7 @@ PLEDAnimationState getPS4AnimationNEOPICO(uint32_t flashOn, uint32_t flashOff)
     return animationState;
 }
 
-bool NeoPicoLEDAddon::available() {
+bool NeoPicoLEDAddon::isEnabled() {
     const LEDOptions& ledOptions = Storage::getInstance().getLedOptions();
     return isValidPin(ledOptions.dataPin);
 }
@@ -205,9 +205,8 @@ void NeoPicoLEDAddon::setup()
     // Get turbo options (turbo RGB led)
     const TurboOptions& turboOptions = Storage::getInstance().getAddonOptions().turboOptions;
 
-    Gamepad * gamepad = Storage::getInstance().GetProcessedGamepad();
-    gamepad->auxState.playerID.enabled = true;
-    gamepad->auxState.sensors.statusLight.enabled = true;
+    // Ask for player ID and status light reports, core0 turns them on with its next aux state publish
+    Storage::getInstance().requestProcessedAux(PROCESSED_AUX_PLAYER_ID | PROCESSED_AUX_STATUS_LIGHT);
 
     if ( ledOptions.pledType == PLED_TYPE_RGB ) {
         neoPLEDs = new NeoPicoPlayerLEDs();
@@ -231,24 +230,30 @@ void NeoPicoLEDAddon::process()
     // Get turbo options (turbo RGB led)
     const TurboOptions& turboOptions = Storage::getInstance().getAddonOptions().turboOptions;
 
-    Gamepad * gamepad = Storage::getInstance().GetProcessedGamepad();
-    AnimationHotkey action = animationHotkeys(gamepad);
+    // Pressed buttons from the processed state core0 published, player LEDs and turbo from the aux state
+    if (Storage::getInstance().getProcessedStateVersion() != processedStateVersion)
+        processedStateVersion = Storage::getInstance().readProcessedState(processedState);
+    if (Storage::getInstance().getProcessedAuxStateVersion() != processedAuxStateVersion)
+        processedAuxStateVersion = Storage::getInstance().readProcessedAuxState(processedAuxState);
+    GamepadState state = processedState;
+    const GamepadAuxState& auxState = processedAuxState;
+    AnimationHotkey action = animationHotkeys(state);
     if (ledOptions.pledType == PLED_TYPE_RGB) {
-        inputMode = gamepad->getOptions().inputMode; // HACK
-        if (gamepad->auxState.playerID.enabled && gamepad->auxState.playerID.active) {
+        inputMode = Storage::getInstance().getGamepadOptions().inputMode; // HACK
+        if (auxState.playerID.enabled && auxState.playerID.active) {
             switch (inputMode) {
                 case INPUT_MODE_XINPUT:
-                    animationState = getXInputAnimationNEOPICO(gamepad->auxState.playerID.ledValue);
+                    animationState = getXInputAnimationNEOPICO(auxState.playerID.ledValue);
                     break;
                 case INPUT_MODE_PS3:
-                    animationState = getPS3AnimationNEOPICO(gamepad->auxState.playerID.ledValue);
+                    animationState = getPS3AnimationNEOPICO(auxState.playerID.ledValue);
                     break;
                 case INPUT_MODE_PS4:
                 case INPUT_MODE_PS5:
-                    animationState = getPS4AnimationNEOPICO(gamepad->auxState.playerID.ledBlinkOn, gamepad->auxState.playerID.ledBlinkOff);
+                    animationState = getPS4AnimationNEOPICO(auxState.playerID.ledBlinkOn, auxState.playerID.ledBlinkOff);
                     break;
                 case INPUT_MODE_XBONE:
-                    animationState = getXBoneAnimationNEOPICO(gamepad);
+                    animationState = getXBoneAnimationNEOPICO(auxState.playerID.ledValue);
                     break;
                 default:
                     break;
@@ -264,7 +269,7 @@ void NeoPicoLEDAddon::process()
         as.HandleEvent(action);
     }
 
-    uint32_t buttonState = gamepad->state.dpad << 16 | gamepad->state.buttons;
+    uint32_t buttonState = state.dpad << 16 | state.buttons;
     vector<Pixel> pressed;
     for (auto row : matrix.pixels)
     {
@@ -298,8 +303,8 @@ void NeoPicoLEDAddon::process()
 
             float level = (static_cast<float>(PLED_MAX_LEVEL - neoPLEDs->getLedLevels()[i]) / static_cast<float>(PLED_MAX_LEVEL));
             float brightness = as.GetBrightnessX() * level;
-            if (gamepad->auxState.sensors.statusLight.enabled && gamepad->auxState.sensors.statusLight.active) {
-                rgbPLEDValues[i] = (RGB(gamepad->auxState.sensors.statusLight.color.red, gamepad->auxState.sensors.statusLight.color.green, gamepad->auxState.sensors.statusLight.color.blue)).value(neopico->GetFormat(), brightness);
+            if (auxState.sensors.statusLight.enabled && auxState.sensors.statusLight.active) {
+                rgbPLEDValues[i] = (RGB(auxState.sensors.statusLight.color.red, auxState.sensors.statusLight.color.green, auxState.sensors.statusLight.color.blue)).value(neopico->GetFormat(), brightness);
             } else {
                 rgbPLEDValues[i] = ((RGB)ledOptions.pledColor).value(neopico->GetFormat(), brightness);
             }
@@ -309,7 +314,7 @@ void NeoPicoLEDAddon::process()
 
     // Turbo LED is a separate RGB that is on if turbo is on, and off if its off
     if ( turboOptions.turboLedType == PLED_TYPE_RGB ) { // RGB or PWM?
-        if ( gamepad->auxState.turbo.activity == 1) { // Turbo is on (active sensor)
+        if ( auxState.turbo.activity == 1) { // Turbo is on (active sensor)
             if (turboOptions.turboLedIndex >= 0 && turboOptions.turboLedIndex < 100) { // Double check index value
                 float brightness = as.GetBrightnessX();
                 frame[turboOptions.turboLedIndex] = ((RGB)turboOptions.turboLedColor).value(neopico->GetFormat(), brightness);
@@ -649,61 +654,61 @@ void NeoPicoLEDAddon::configureLEDs()
     as.SetMode(as.options.baseAnimationIndex);
 }
 
-AnimationHotkey animationHotkeys(Gamepad *gamepad)
+AnimationHotkey animationHotkeys(GamepadState& state)
 {
     AnimationHotkey action = HOTKEY_LEDS_NONE;
 
-    if (gamepad->pressedS1() && gamepad->pressedS2())
+    if ((state.buttons & GAMEPAD_MASK_S1) && (state.buttons & GAMEPAD_MASK_S2))
     {
-        if (gamepad->pressedB3())
+        if (state.buttons & GAMEPAD_MASK_B3)
         {
             action = HOTKEY_LEDS_ANIMATION_UP;
-            gamepad->state.buttons &= ~(GAMEPAD_MASK_B3 | GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2);
+            state.buttons &= ~(GAMEPAD_MASK_B3 | GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2);
         }
-        else if (gamepad->pressedB1())
+        else if (state.buttons & GAMEPAD_MASK_B1)
         {
             action = HOTKEY_LEDS_ANIMATION_DOWN;
-            gamepad->state.buttons &= ~(GAMEPAD_MASK_B1 | GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2);
+            state.buttons &= ~(GAMEPAD_MASK_B1 | GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2);
         }
-        else if (gamepad->pressedB4())
+        else if (state.buttons & GAMEPAD_MASK_B4)
         {
             action = HOTKEY_LEDS_BRIGHTNESS_UP;
-            gamepad->state.buttons &= ~(GAMEPAD_MASK_B4 | GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2);
+            state.buttons &= ~(GAMEPAD_MASK_B4 | GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2);
         }
-        else if (gamepad->pressedB2())
+        else if (state.buttons & GAMEPAD_MASK_B2)
         {
             action = HOTKEY_LEDS_BRIGHTNESS_DOWN;
-            gamepad->state.buttons &= ~(GAMEPAD_MASK_B2 | GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2);
+            state.buttons &= ~(GAMEPAD_MASK_B2 | GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2);
         }
-        else if (gamepad->pressedR1())
+        else if (state.buttons & GAMEPAD_MASK_R1)
         {
             action = HOTKEY_LEDS_PARAMETER_UP;
-            gamepad->state.buttons &= ~(GAMEPAD_MASK_R1 | GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2);
+            state.buttons &= ~(GAMEPAD_MASK_R1 | GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2);
         }
-        else if (gamepad->pressedR2())
+        else if (state.buttons & GAMEPAD_MASK_R2)
         {
             action = HOTKEY_LEDS_PARAMETER_DOWN;
-            gamepad->state.buttons &= ~(GAMEPAD_MASK_R2 | GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2);
+            state.buttons &= ~(GAMEPAD_MASK_R2 | GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2);
         }
-        else if (gamepad->pressedL1())
+        else if (state.buttons & GAMEPAD_MASK_L1)
         {
             action = HOTKEY_LEDS_PRESS_PARAMETER_UP;
-            gamepad->state.buttons &= ~(GAMEPAD_MASK_L1 | GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2);
+            state.buttons &= ~(GAMEPAD_MASK_L1 | GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2);
         }
-        else if (gamepad->pressedL2())
+        else if (state.buttons & GAMEPAD_MASK_L2)
         {
             action = HOTKEY_LEDS_PRESS_PARAMETER_DOWN;
-            gamepad->state.buttons &= ~(GAMEPAD_MASK_L2 | GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2);
+            state.buttons &= ~(GAMEPAD_MASK_L2 | GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2);
         }
-        else if (gamepad->pressedL3())
+        else if (state.buttons & GAMEPAD_MASK_L3)
         {
             action = HOTKEY_LEDS_FADETIME_DOWN;
-            gamepad->state.buttons &= ~(GAMEPAD_MASK_L3 | GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2);
+            state.buttons &= ~(GAMEPAD_MASK_L3 | GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2);
         }
-        else if (gamepad->pressedR3())
+        else if (state.buttons & GAMEPAD_MASK_R3)
         {
             action = HOTKEY_LEDS_FADETIME_UP;
-            gamepad->state.buttons &= ~(GAMEPAD_MASK_R3 | GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2);
+            state.buttons &= ~(GAMEPAD_MASK_R3 | GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2);
         }
     }
 
@@ -92,7 +92,7 @@ PLEDAnimationState getXInputAnimationPWM(uint16_t ledState)
 	return animationState;
 }
 
-bool PlayerLEDAddon::available() {
+bool PlayerLEDAddon::isEnabled() {
 	return Storage::getInstance().getLedOptions().pledType != PLED_TYPE_NONE;
 }
 
@@ -100,9 +100,8 @@ void PlayerLEDAddon::setup() {
 	const LEDOptions& ledOptions = Storage::getInstance().getLedOptions();
 	turnOffWhenSuspended = ledOptions.turnOffWhenSuspended;
 
-	Gamepad * gamepad = Storage::getInstance().GetProcessedGamepad();
-	gamepad->auxState.playerID.enabled = true;
-    gamepad->auxState.sensors.statusLight.enabled = true;
+	// core0 enables the player ID and status light for the driver, this core only reads the aux state
+	Storage::getInstance().requestProcessedAux(PROCESSED_AUX_PLAYER_ID | PROCESSED_AUX_STATUS_LIGHT);
 
 	switch (ledOptions.pledType)
 	{
@@ -124,7 +123,6 @@ void PlayerLEDAddon::process()
 {
 	if (turnOffWhenSuspended && get_usb_suspended()) return;
 
-	Gamepad * gamepad = Storage::getInstance().GetProcessedGamepad();
 	const LEDOptions& ledOptions = Storage::getInstance().getLedOptions();
 
 	// Player LEDs can be PWM or driven by NeoPixel
@@ -132,9 +130,12 @@ void PlayerLEDAddon::process()
 		if (pwmLEDs != nullptr)
 			pwmLEDs->display();
 
-		if (gamepad->auxState.playerID.enabled && gamepad->auxState.playerID.active) {
-			if (gamepad->getOptions().inputMode == INPUT_MODE_XINPUT) {
-				animationState = getXInputAnimationPWM(gamepad->auxState.playerID.ledValue);
+		// Player ID the driver set on core0
+		if (Storage::getInstance().getProcessedAuxStateVersion() != auxStateVersion)
+			auxStateVersion = Storage::getInstance().readProcessedAuxState(auxState);
+		if (auxState.playerID.enabled && auxState.playerID.active) {
+			if (Storage::getInstance().getGamepadOptions().inputMode == INPUT_MODE_XINPUT) {
+				animationState = getXInputAnimationPWM(auxState.playerID.ledValue);
 			}
 		}
 
@@ -24,7 +24,7 @@ typedef enum
 	XINPUT_PLED_ALTERNATE = 0x0D, // Alternating (e.g. 1+4-2+3), then back to previous*
 } XInputPLEDPattern;
 
-bool PlayerNumAddon::available() {
+bool PlayerNumAddon::isEnabled() {
     return Storage::getInstance().getAddonOptions().playerNumberOptions.enabled;
 }
 
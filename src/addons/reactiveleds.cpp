@@ -5,7 +5,7 @@
 #include "helper.h"
 #include "config.pb.h"
 
-bool ReactiveLEDAddon::available() {
+bool ReactiveLEDAddon::isEnabled() {
     bool pinsEnabled = false;
     const ReactiveLEDOptions& options = Storage::getInstance().getAddonOptions().reactiveLEDOptions;
     for (uint8_t led = 0; led < REACTIVE_LED_COUNT; led++) {
@@ -44,7 +44,10 @@ void ReactiveLEDAddon::setup() {
 }
 
 void ReactiveLEDAddon::process() {
-    Gamepad * gamepad = Storage::getInstance().GetProcessedGamepad();
+    // Nothing to update until core0 publishes a new processed state, unless an LED is still fading
+    if (!fading && Storage::getInstance().getProcessedStateVersion() == stateVersion) return;
+    stateVersion = Storage::getInstance().readProcessedState(state);
+    fading = false;
 
     uint32_t currUpdate = to_ms_since_boot(get_absolute_time());
 
@@ -52,24 +55,24 @@ void ReactiveLEDAddon::process() {
         if (isValidPin(ledPins[led].pinNumber) && ledPins[led].action != GpioAction::NONE) {
             ledPins[led].currUpdate = currUpdate;
             switch (ledPins[led].action) {
-                case BUTTON_PRESS_UP: setLEDByMode(ledPins[led], gamepad->pressedDpad(GAMEPAD_MASK_UP)); break;
-                case BUTTON_PRESS_DOWN: setLEDByMode(ledPins[led], gamepad->pressedDpad(GAMEPAD_MASK_DOWN)); break;
-                case BUTTON_PRESS_LEFT: setLEDByMode(ledPins[led], gamepad->pressedDpad(GAMEPAD_MASK_LEFT)); break;
-                case BUTTON_PRESS_RIGHT: setLEDByMode(ledPins[led], gamepad->pressedDpad(GAMEPAD_MASK_RIGHT)); break;
-                case BUTTON_PRESS_B1: setLEDByMode(ledPins[led], gamepad->pressedButton(GAMEPAD_MASK_B1)); break;
-                case BUTTON_PRESS_B2: setLEDByMode(ledPins[led], gamepad->pressedButton(GAMEPAD_MASK_B2)); break;
-                case BUTTON_PRESS_B3: setLEDByMode(ledPins[led], gamepad->pressedButton(GAMEPAD_MASK_B3)); break;
-                case BUTTON_PRESS_B4: setLEDByMode(ledPins[led], gamepad->pressedButton(GAMEPAD_MASK_B4)); break;
-                case BUTTON_PRESS_L1: setLEDByMode(ledPins[led], gamepad->pressedButton(GAMEPAD_MASK_L1)); break;
-                case BUTTON_PRESS_R1: setLEDByMode(ledPins[led], gamepad->pressedButton(GAMEPAD_MASK_R1)); break;
-                case BUTTON_PRESS_L2: setLEDByMode(ledPins[led], gamepad->pressedButton(GAMEPAD_MASK_L2)); break;
-                case BUTTON_PRESS_R2: setLEDByMode(ledPins[led], gamepad->pressedButton(GAMEPAD_MASK_R2)); break;
-                case BUTTON_PRESS_S1: setLEDByMode(ledPins[led], gamepad->pressedButton(GAMEPAD_MASK_S1)); break;
-                case BUTTON_PRESS_S2: setLEDByMode(ledPins[led], gamepad->pressedButton(GAMEPAD_MASK_S2)); break;
-                case BUTTON_PRESS_A1: setLEDByMode(ledPins[led], gamepad->pressedButton(GAMEPAD_MASK_A1)); break;
-                case BUTTON_PRESS_A2: setLEDByMode(ledPins[led], gamepad->pressedButton(GAMEPAD_MASK_A2)); break;
-                case BUTTON_PRESS_L3: setLEDByMode(ledPins[led], gamepad->pressedButton(GAMEPAD_MASK_L3)); break;
-                case BUTTON_PRESS_R3: setLEDByMode(ledPins[led], gamepad->pressedButton(GAMEPAD_MASK_R3)); break;
+                case BUTTON_PRESS_UP: setLEDByMode(ledPins[led], (state.dpad & GAMEPAD_MASK_UP)); break;
+                case BUTTON_PRESS_DOWN: setLEDByMode(ledPins[led], (state.dpad & GAMEPAD_MASK_DOWN)); break;
+                case BUTTON_PRESS_LEFT: setLEDByMode(ledPins[led], (state.dpad & GAMEPAD_MASK_LEFT)); break;
+                case BUTTON_PRESS_RIGHT: setLEDByMode(ledPins[led], (state.dpad & GAMEPAD_MASK_RIGHT)); break;
+                case BUTTON_PRESS_B1: setLEDByMode(ledPins[led], (state.buttons & GAMEPAD_MASK_B1)); break;
+                case BUTTON_PRESS_B2: setLEDByMode(ledPins[led], (state.buttons & GAMEPAD_MASK_B2)); break;
+                case BUTTON_PRESS_B3: setLEDByMode(ledPins[led], (state.buttons & GAMEPAD_MASK_B3)); break;
+                case BUTTON_PRESS_B4: setLEDByMode(ledPins[led], (state.buttons & GAMEPAD_MASK_B4)); break;
+                case BUTTON_PRESS_L1: setLEDByMode(ledPins[led], (state.buttons & GAMEPAD_MASK_L1)); break;
+                case BUTTON_PRESS_R1: setLEDByMode(ledPins[led], (state.buttons & GAMEPAD_MASK_R1)); break;
+                case BUTTON_PRESS_L2: setLEDByMode(ledPins[led], (state.buttons & GAMEPAD_MASK_L2)); break;
+                case BUTTON_PRESS_R2: setLEDByMode(ledPins[led], (state.buttons & GAMEPAD_MASK_R2)); break;
+                case BUTTON_PRESS_S1: setLEDByMode(ledPins[led], (state.buttons & GAMEPAD_MASK_S1)); break;
+                case BUTTON_PRESS_S2: setLEDByMode(ledPins[led], (state.buttons & GAMEPAD_MASK_S2)); break;
+                case BUTTON_PRESS_A1: setLEDByMode(ledPins[led], (state.buttons & GAMEPAD_MASK_A1)); break;
+                case BUTTON_PRESS_A2: setLEDByMode(ledPins[led], (state.buttons & GAMEPAD_MASK_A2)); break;
+                case BUTTON_PRESS_L3: setLEDByMode(ledPins[led], (state.buttons & GAMEPAD_MASK_L3)); break;
+                case BUTTON_PRESS_R3: setLEDByMode(ledPins[led], (state.buttons & GAMEPAD_MASK_R3)); break;
                 default: break;
             }
         }
@@ -95,6 +98,7 @@ void ReactiveLEDAddon::setLEDByMode(ReactiveLEDPinState &ledState, bool pressed)
 
                 ledState.lastUpdate = ledState.currUpdate;
             }
+            if (ledState.value < REACTIVE_LED_MAX_BRIGHTNESS) fading = true;
             break;
         case ReactiveLEDMode::REACTIVE_LED_FADE_OUT:
             if (ledState.currUpdate - ledState.lastUpdate >= REACTIVE_LED_DELAY) {
@@ -105,6 +109,7 @@ void ReactiveLEDAddon::setLEDByMode(ReactiveLEDPinState &ledState, bool pressed)
 
                 ledState.lastUpdate = ledState.currUpdate;
             }
+            if (ledState.value > 0) fading = true;
             break;
     }
 
@@ -4,7 +4,7 @@
 #include "helper.h"
 #include "config.pb.h"
 
-bool ReverseInput::available() {
+bool ReverseInput::isEnabled() {
     const ReverseOptions& options = Storage::getInstance().getAddonOptions().reverseOptions;
 	return options.enabled;
 }
@@ -1,6 +1,7 @@
 #include "addons/rotaryencoder.h"
 
 #include "eventmanager.h"
+#include "framecontext.h"
 #include "storagemanager.h"
 #include "GPEncoderEvent.h"
 #include "types.h"
@@ -9,7 +10,7 @@
 #include "helper.h"
 #include "config.pb.h"
 
-bool RotaryEncoderInput::available() {
+bool RotaryEncoderInput::isEnabled() {
     const RotaryOptions& options = Storage::getInstance().getAddonOptions().rotaryOptions;
     return options.enabled;
 }
@@ -69,15 +70,17 @@ void RotaryEncoderInput::process()
 {
     Gamepad * gamepad = Storage::getInstance().GetGamepad();
 
-    uint32_t now = getMillis();
+    // one pin sample per pass, shared with the debouncer
+    const FrameContext & frame = FrameContext::current();
+    uint32_t now = frame.millis;
 
     for (uint8_t i = 0; i < MAX_ENCODERS; i++) {
         if (encoderMap[i].enabled) {
             uint32_t lastUpdate = now - encoderState[i].updateTime;
 
             if (lastUpdate >= encoderState[i].delay) {
-                bool pinAValue = gpio_get(encoderMap[i].pinA);
-                bool pinBValue = gpio_get(encoderMap[i].pinB);
+                bool pinAValue = !(frame.rawGpio & (1 << encoderMap[i].pinA));
+                bool pinBValue = !(frame.rawGpio & (1 << encoderMap[i].pinB));
 
                 uint32_t encoderIncrement = (ENCODER_RADIUS / (encoderMap[i].pulsesPerRevolution / (ENCODER_PRECISION * encoderMap[i].multiplier)));
 
@@ -132,9 +135,9 @@ void RotaryEncoderInput::process()
                 encoderState[i].changeTime = now;
 
                 if ((encoderValues[i] - prevValues[i]) > 0) {
-                    EventManager::getInstance().triggerEvent(new GPEncoderChangeEvent(i, 1));
+                    EventManager::getInstance().triggerEvent(GPEncoderChangeEvent(i, 1));
                 } else if ((encoderValues[i] - prevValues[i]) < 0) {
-                    EventManager::getInstance().triggerEvent(new GPEncoderChangeEvent(i, -1));
+                    EventManager::getInstance().triggerEvent(GPEncoderChangeEvent(i, -1));
                 }
             }
 
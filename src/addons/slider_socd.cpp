@@ -8,7 +8,7 @@
 
 #define SOCD_MODE_MASK (SOCD_MODE_UP_PRIORITY & SOCD_MODE_SECOND_INPUT_PRIORITY & SOCD_MODE_FIRST_INPUT_PRIORITY & SOCD_MODE_NEUTRAL)
 
-bool SliderSOCDInput::available() {
+bool SliderSOCDInput::isEnabled() {
     const SOCDSliderOptions& options = Storage::getInstance().getAddonOptions().socdSliderOptions;
     return options.enabled;
 }
@@ -1,10 +1,10 @@
 #include "addons/snes_input.h"
-#include "drivermanager.h"
+#include "framecontext.h"
 #include "storagemanager.h"
 #include "hardware/gpio.h"
 #include "helper.h"
 
-bool SNESpadInput::available() {
+bool SNESpadInput::isEnabled() {
     const SNESOptions& snesOptions = Storage::getInstance().getAddonOptions().snesOptions;
 
     return (snesOptions.enabled &&
@@ -15,14 +15,11 @@ bool SNESpadInput::available() {
 
 void SNESpadInput::setup() {
     const SNESOptions& snesOptions = Storage::getInstance().getAddonOptions().snesOptions;
-    nextTimer = getMillis();
 
 #if SNES_PAD_DEBUG==true
     stdio_init_all();
 #endif
 
-    uIntervalMS = 0;
-
     snes = new SNESpad(
         snesOptions.clockPin,
         snesOptions.latchPin,
@@ -80,70 +77,65 @@ void SNESpadInput::setup() {
     }
 }
 
-void SNESpadInput::process() {
-    if (nextTimer < getMillis()) {
-        snes->poll();
-
-        uint16_t joystickMid = GAMEPAD_JOYSTICK_MID;
-        if ( DriverManager::getInstance().getDriver() != nullptr ) {
-            joystickMid = DriverManager::getInstance().getDriver()->GetJoystickMidValue();
-        }
-
-        leftX = joystickMid;
-        leftY = joystickMid;
-        rightX = joystickMid;
-        rightY = joystickMid;
-
-        if (snes->type == SNES_PAD_BASIC) {
-            buttonA = snes->buttonA;
-            buttonB = snes->buttonB;
-            buttonX = snes->buttonX;
-            buttonY = snes->buttonY;
-            buttonL = snes->buttonL;
-            buttonR = snes->buttonR;
-            dpadUp = snes->directionUp;
-            dpadDown = snes->directionDown;
-            dpadLeft = snes->directionLeft;
-            dpadRight = snes->directionRight;
-            buttonSelect = snes->buttonSelect;
-            buttonStart = snes->buttonStart;
-
-        } else if (snes->type == SNES_PAD_NES) {
-            buttonA = snes->buttonA;
-            buttonB = snes->buttonB;
-            buttonX = false;
-            buttonY = false;
-            buttonL = false;
-            buttonR = false;
-            dpadUp = snes->directionUp;
-            dpadDown = snes->directionDown;
-            dpadLeft = snes->directionLeft;
-            dpadRight = snes->directionRight;
-            buttonSelect = snes->buttonSelect;
-            buttonStart = snes->buttonStart;
-
-        } else if (snes->type == SNES_PAD_MOUSE){
-            buttonA = snes->buttonA;
-            buttonB = snes->buttonB;
-            buttonX = false;
-            buttonY = false;
-            buttonL = false;
-            buttonR = false;
-            dpadUp = false;
-            dpadDown = false;
-            dpadLeft = false;
-            dpadRight = false;
-            buttonSelect = false;
-            buttonStart = false;
-
-            leftX = map(snes->mouseX,0,255,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
-            leftY = map(snes->mouseY,0,255,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
-
-        }
-
-        nextTimer = getMillis() + uIntervalMS;
+void SNESpadInput::poll() {
+    snes->poll();
+
+    uint16_t joystickMid = FrameContext::current().joystickMid;
+
+    leftX = joystickMid;
+    leftY = joystickMid;
+    rightX = joystickMid;
+    rightY = joystickMid;
+
+    if (snes->type == SNES_PAD_BASIC) {
+        buttonA = snes->buttonA;
+        buttonB = snes->buttonB;
+        buttonX = snes->buttonX;
+        buttonY = snes->buttonY;
+        buttonL = snes->buttonL;
+        buttonR = snes->buttonR;
+        dpadUp = snes->directionUp;
+        dpadDown = snes->directionDown;
+        dpadLeft = snes->directionLeft;
+        dpadRight = snes->directionRight;
+        buttonSelect = snes->buttonSelect;
+        buttonStart = snes->buttonStart;
+
+    } else if (snes->type == SNES_PAD_NES) {
+        buttonA = snes->buttonA;
+        buttonB = snes->buttonB;
+        buttonX = false;
+        buttonY = false;
+        buttonL = false;
+        buttonR = false;
+        dpadUp = snes->directionUp;
+        dpadDown = snes->directionDown;
+        dpadLeft = snes->directionLeft;
+        dpadRight = snes->directionRight;
+        buttonSelect = snes->buttonSelect;
+        buttonStart = snes->buttonStart;
+
+    } else if (snes->type == SNES_PAD_MOUSE){
+        buttonA = snes->buttonA;
+        buttonB = snes->buttonB;
+        buttonX = false;
+        buttonY = false;
+        buttonL = false;
+        buttonR = false;
+        dpadUp = false;
+        dpadDown = false;
+        dpadLeft = false;
+        dpadRight = false;
+        buttonSelect = false;
+        buttonStart = false;
+
+        leftX = map(snes->mouseX,0,255,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
+        leftY = map(snes->mouseY,0,255,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
+
     }
+}
 
+void SNESpadInput::process() {
     Gamepad * gamepad = Storage::getInstance().GetGamepad();
 
     gamepad->state.lx = leftX;
@@ -1,7 +1,7 @@
 #include "spi_analog_ads1256.h"
 #include "storagemanager.h"
 
-bool SPIAnalog1256Input::available() {
+bool SPIAnalog1256Input::isEnabled() {
     const AnalogADS1256Options& options = Storage::getInstance().getAddonOptions().analogADS1256Options;
     return (options.enabled && PeripheralManager::getInstance().isSPIEnabled(options.spiBlock));
 }
@@ -12,6 +12,7 @@ void SPIAnalog1256Input::setup() {
     enableTriggers = options.enableTriggers;
     readChannelCount = 4 + (enableTriggers ? 2 : 0);
     analogMax = options.avdd;
+    pollPeriodUs = std::clamp(options.pollPeriodUs, (uint32_t)SPI_ANALOG1256_MIN_POLL_US, (uint32_t)SPI_ANALOG1256_MAX_POLL_US);
 
     Gamepad * gamepad = Storage::getInstance().GetGamepad();
     gamepad->hasAnalogTriggers = enableTriggers;
@@ -19,9 +20,12 @@ void SPIAnalog1256Input::setup() {
     // Init our ADS1256 library
     ads = new ADS1256(spi, options.drdyPin, -1, -1, options.csPin, (float)ADS1256_VREF_VOLTAGE);
     ads->init(ADS1256_DRATE_30000SPS, ADS1256_PGA_1, true);
+
+    // First values for process() until the first scheduled poll
+    poll();
 }
 
-void SPIAnalog1256Input::process() {
+void SPIAnalog1256Input::poll() {
     // Read the first X channels
     for (uint8_t i = 0; i < readChannelCount; i++) {
         values[i] = ads->convertToVoltage(ads->cycleSingle());
@@ -30,7 +34,9 @@ void SPIAnalog1256Input::process() {
     // Tells the ADC we're done sampling and flags to reset
     // the read cycle next time an ADC read is performed
     ads->stopConversion();
+}
 
+void SPIAnalog1256Input::process() {
     Gamepad * gamepad = Storage::getInstance().GetGamepad();
 
     gamepad->state.lx = convert24to16bit(values[0]);
@@ -1,10 +1,10 @@
 #include "addons/tilt.h"
-#include "drivermanager.h"
+#include "framecontext.h"
 #include "storagemanager.h"
 #include "helper.h"
 #include "config.pb.h"
 
-bool TiltInput::available() {
+bool TiltInput::isEnabled() {
     const TiltOptions& options = Storage::getInstance().getAddonOptions().tiltOptions;
     return options.enabled;
 }
@@ -57,11 +57,8 @@ void TiltInput::setup() {
 	lastGPUD = DIRECTION_NONE;
 	lastGPLR = DIRECTION_NONE;
 
-	leftLastTiltUD = DIRECTION_NONE;
-	leftLastTiltLR = DIRECTION_NONE;
-
-	rightLastTiltUD = DIRECTION_NONE;
-	rightLastTiltLR = DIRECTION_NONE;
+	leftTiltResolver.reset();
+	rightTiltResolver.reset();
 
 	uint32_t now = getMillis();
 	for (int i = 0; i < 4; i++) {
@@ -119,10 +116,7 @@ void TiltInput::OverrideGamepad(Gamepad* gamepad, uint8_t dpad1, uint8_t dpad2)
 	double scaledTilt2FactorRightX = 1.0 - (tilt2FactorRightX / 100.0);
 	double scaledTilt2FactorRightY = 1.0 - (tilt2FactorRightY / 100.0);
 
-	uint16_t midValue = GAMEPAD_JOYSTICK_MID;
-	if ( DriverManager::getInstance().getDriver() != nullptr ) {
-		midValue = DriverManager::getInstance().getDriver()->GetJoystickMidValue();
-	}
+	uint16_t midValue = FrameContext::current().joystickMid;
 
 	uint16_t leftXValue = midValue;
 	uint16_t leftYValue = midValue;
@@ -172,10 +166,7 @@ void TiltInput::OverrideGamepad(Gamepad* gamepad, uint8_t dpad1, uint8_t dpad2)
 }
 
 uint16_t TiltInput::getAnalogValue(bool isMin, bool isMax) {
-	uint16_t midValue = GAMEPAD_JOYSTICK_MID;
-	if ( DriverManager::getInstance().getDriver() != nullptr ) {
-		midValue = DriverManager::getInstance().getDriver()->GetJoystickMidValue();
-	}
+	uint16_t midValue = FrameContext::current().joystickMid;
 
 	if (isMin && !isMax) {
 		return GAMEPAD_JOYSTICK_MIN;
@@ -187,104 +178,9 @@ uint16_t TiltInput::getAnalogValue(bool isMin, bool isMax) {
 }
 
 void TiltInput::SOCDTiltClean(SOCDMode socdMode) {
-    // Left Stick SOCD Cleaning
-	// Tilt SOCD Last-Win Clean
-	switch (tiltLeftState & (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN)) {
-	case (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN): // If last state was Up or Down, exclude it from our gamepad
-		if (socdMode == SOCD_MODE_UP_PRIORITY) {
-			tiltLeftState ^= GAMEPAD_MASK_DOWN; // Remove Down
-			leftLastTiltUD = DIRECTION_UP; // We're in UP mode
-		}
-		else if (socdMode == SOCD_MODE_SECOND_INPUT_PRIORITY && leftLastTiltUD != DIRECTION_NONE) {
-			tiltLeftState ^= (leftLastTiltUD == DIRECTION_UP) ? GAMEPAD_MASK_UP : GAMEPAD_MASK_DOWN;
-		}
-		else {
-			tiltLeftState ^= (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN); // Remove UP and Down in Neutral
-			leftLastTiltUD = DIRECTION_NONE;
-		}
-		break;
-	case GAMEPAD_MASK_UP:
-		leftLastTiltUD = DIRECTION_UP;
-		break;
-	case GAMEPAD_MASK_DOWN:
-		leftLastTiltUD = DIRECTION_DOWN;
-		break;
-	default:
-		leftLastTiltUD = DIRECTION_NONE;
-		break;
-	}
-	switch (tiltLeftState & (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT)) {
-	case (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT):
-		if (socdMode == SOCD_MODE_UP_PRIORITY || socdMode == SOCD_MODE_NEUTRAL) {
-			tiltLeftState ^= (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT); // Remove L + R to Neutral
-			leftLastTiltLR = DIRECTION_NONE;
-		}
-		else if (socdMode == SOCD_MODE_SECOND_INPUT_PRIORITY) {
-			if (leftLastTiltLR != DIRECTION_NONE)
-				tiltLeftState ^= (leftLastTiltLR == DIRECTION_LEFT) ? GAMEPAD_MASK_LEFT : GAMEPAD_MASK_RIGHT; // Last Win
-			else
-				leftLastTiltLR = DIRECTION_NONE;
-		}
-		break;
-	case GAMEPAD_MASK_LEFT:
-		leftLastTiltLR = DIRECTION_LEFT;
-		break;
-	case GAMEPAD_MASK_RIGHT:
-		leftLastTiltLR = DIRECTION_RIGHT;
-		break;
-	default:
-		leftLastTiltLR = DIRECTION_NONE;
-		break;
-	}
+	// Left Stick SOCD Cleaning
+	tiltLeftState = leftTiltResolver.runSOCDCleaner(socdMode, tiltLeftState);
+
 	// Right Stick SOCD Cleaning
-	// Tilt SOCD Last-Win Clean
-	switch (tiltRightState & (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN)) {
-	case (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN): // If last state was Up or Down, exclude it from our gamepad
-		if (socdMode == SOCD_MODE_UP_PRIORITY) {
-			tiltRightState ^= GAMEPAD_MASK_DOWN; // Remove Down
-			rightLastTiltUD = DIRECTION_UP; // We're in UP mode
-		}
-		else if (socdMode == SOCD_MODE_SECOND_INPUT_PRIORITY && rightLastTiltUD != DIRECTION_NONE) {
-			tiltRightState ^= (rightLastTiltUD == DIRECTION_UP) ? GAMEPAD_MASK_UP : GAMEPAD_MASK_DOWN;
-		}
-		else {
-			tiltRightState ^= (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN); // Remove UP and Down in Neutral
-			rightLastTiltUD = DIRECTION_NONE;
-		}
-		break;
-	case GAMEPAD_MASK_UP:
-		rightLastTiltUD = DIRECTION_UP;
-		break;
-	case GAMEPAD_MASK_DOWN:
-		rightLastTiltUD = DIRECTION_DOWN;
-		break;
-	default:
-		rightLastTiltUD = DIRECTION_NONE;
-		break;
-	}
-    
-	switch (tiltRightState & (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT)) {
-	case (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT):
-		if (socdMode == SOCD_MODE_UP_PRIORITY || socdMode == SOCD_MODE_NEUTRAL) {
-			tiltRightState ^= (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT); // Remove L + R to Neutral
-			rightLastTiltLR = DIRECTION_NONE;
-		}
-		else if (socdMode == SOCD_MODE_SECOND_INPUT_PRIORITY) {
-			if (rightLastTiltLR != DIRECTION_NONE)
-				tiltRightState ^= (rightLastTiltLR == DIRECTION_LEFT) ? GAMEPAD_MASK_LEFT : GAMEPAD_MASK_RIGHT; // Last Win
-			else
-				rightLastTiltLR = DIRECTION_NONE;
-		}
-		break;
-	case GAMEPAD_MASK_LEFT:
-		rightLastTiltLR = DIRECTION_LEFT;
-		break;
-	case GAMEPAD_MASK_RIGHT:
-		rightLastTiltLR = DIRECTION_RIGHT;
-		break;
-	default:
-		rightLastTiltLR = DIRECTION_NONE;
-		break;
-	}
+	tiltRightState = rightTiltResolver.runSOCDCleaner(socdMode, tiltRightState);
 }
-
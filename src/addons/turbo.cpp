@@ -3,6 +3,7 @@
 #include "hardware/adc.h"
 
 #include "storagemanager.h"
+#include "framecontext.h"
 #include "helper.h"
 #include "config.pb.h"
 
@@ -22,7 +23,7 @@
 #define TURBO_LED_STATE_ON 1
 #endif
 
-bool TurboInput::available() {
+bool TurboInput::isEnabled() {
     // Turbo Button initialized by void Gamepad::setup()
     bool hasTurboAssigned = false;
     GpioMappingInfo* pinMappings = Storage::getInstance().getProfilePinMappings();
@@ -30,7 +31,6 @@ bool TurboInput::available() {
     {
         if ( pinMappings[pin].action == GpioAction::BUTTON_PRESS_TURBO ) {
             hasTurboAssigned = true;
-            turboPinMask = 1 << pin;
             break;
         }
     }
@@ -42,6 +42,8 @@ void TurboInput::setup()
     const TurboOptions& options = Storage::getInstance().getAddonOptions().turboOptions;
     uint32_t now = getMillis();
 
+    // Turbo pin mask
+    reinit();
 
     // Turbo Dial
     uint8_t shotCount = std::clamp<uint8_t>(options.shotCount, TURBO_SHOT_MIN, TURBO_SHOT_MAX);
@@ -64,9 +66,10 @@ void TurboInput::setup()
         gpio_put(options.ledPin, 1);
     }
 
-    Gamepad * gamepad = Storage::getInstance().GetProcessedGamepad();
-	gamepad->auxState.turbo.enabled = true;
-    gamepad->auxState.turbo.active = 1;
+    // Turbo LED state goes to core1 in the aux state core0 publishes after the driver ran
+    GamepadAuxTurbo& turboAux = Storage::getInstance().GetProcessedGamepad()->auxState.turbo;
+    turboAux.enabled = true;
+    turboAux.active = 1;
 
     // SHMUP Mode
     if ( options.shmupModeEnabled ) {
@@ -82,6 +85,9 @@ void TurboInput::setup()
                 shmupBtnPinMask[i] = 1 << shmupBtnPin[i];
             }
         }
+        // charge pins aren't in the pin mappings, have them debounced with the buttons
+        FrameContext::addDebounceGpios(shmupBtnPinMask[0] | shmupBtnPinMask[1] | shmupBtnPinMask[2] | shmupBtnPinMask[3],
+            Storage::getInstance().getGamepadOptions().debounceModeButtons);
         shmupBtnMask[0] = options.shmupBtnMask1; // Charge Buttons Assignment
         shmupBtnMask[1] = options.shmupBtnMask2;
         shmupBtnMask[2] = options.shmupBtnMask3;
@@ -177,7 +183,7 @@ void TurboInput::process()
         }
     }
 
-    uint64_t now = getMicro();
+    uint64_t now = FrameContext::current().micros;
 
     // Use the dial to modify our turbo shot speed (don't save on dial modify)
     if (hasShmupDial && nextAdcRead < now) {
@@ -200,19 +206,21 @@ void TurboInput::process()
     // OFF: No turbo buttons enabled
     // ON: 1 or more turbo buttons enabled
     // BLINK: OFF on turbo shot, ON on turbo flicker
-    Gamepad * processedGamepad = Storage::getInstance().GetProcessedGamepad();
+    uint8_t turboActivity;
     if (turboButtonsMask) {
         if (gamepad->state.buttons & turboButtonsMask)
-            processedGamepad->auxState.turbo.activity = bTurboFlicker ? TURBO_LED_STATE_ON : TURBO_LED_STATE_OFF;
+            turboActivity = bTurboFlicker ? TURBO_LED_STATE_ON : TURBO_LED_STATE_OFF;
         else
-            processedGamepad->auxState.turbo.activity = TURBO_LED_STATE_ON;
+            turboActivity = TURBO_LED_STATE_ON;
     } else {
-        processedGamepad->auxState.turbo.activity = TURBO_LED_STATE_OFF;
+        turboActivity = TURBO_LED_STATE_OFF;
     }
+    // core0 only, core1 reads the published copy (Storage::readProcessedAuxState)
+    Storage::getInstance().GetProcessedGamepad()->auxState.turbo.activity = turboActivity;
 
     // PWM LED Pin
     if ( hasLedPin ) {
-        if ( processedGamepad->auxState.turbo.activity == TURBO_LED_STATE_ON ) {
+        if ( turboActivity == TURBO_LED_STATE_ON ) {
             gpio_put(options.ledPin, TURBO_LED_STATE_ON);
         } else {
             gpio_put(options.ledPin, TURBO_LED_STATE_OFF);
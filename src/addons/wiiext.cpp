@@ -1,37 +1,35 @@
 #include "addons/wiiext.h"
-#include "drivermanager.h"
+#include "framecontext.h"
 #include "storagemanager.h"
 #include "hardware/gpio.h"
 #include "helper.h"
 #include "config.pb.h"
 
+bool WiiExtensionInput::isEnabled() {
+    return Storage::getInstance().getAddonOptions().wiiOptions.enabled;
+}
+
 bool WiiExtensionInput::available() {
-    const WiiOptions& options = Storage::getInstance().getAddonOptions().wiiOptions;
-    if (options.enabled) {
-        // addon is enabled. let's scan available blocks.
-        wii = new WiiExtensionDevice();
-        PeripheralI2CScanResult result = PeripheralManager::getInstance().scanForI2CDevice(wii->getDeviceAddresses());
-        if (result.address > -1) {
-            wii->setAddress(result.address);
-            wii->setI2C(PeripheralManager::getInstance().getI2C(result.block));
-            return true;
-        } else {
-            delete wii;
-        }
+    // addon is enabled. let's scan available blocks.
+    wii = new WiiExtensionDevice();
+    PeripheralI2CScanResult result = PeripheralManager::getInstance().scanForI2CDevice(wii->getDeviceAddresses());
+    if (result.address > -1) {
+        wii->setAddress(result.address);
+        wii->setI2C(PeripheralManager::getInstance().getI2C(result.block));
+        return true;
+    } else {
+        delete wii;
     }
     return false;
 }
 
 void WiiExtensionInput::setup() {
     const WiiOptions& options = Storage::getInstance().getAddonOptions().wiiOptions;
-    nextTimer = getMillis();
 
 #if WII_EXTENSION_DEBUG==true
     stdio_init_all();
 #endif
 
-    uIntervalMS = 0;
-
     currentConfig = NULL;
     
     //wii = new WiiExtensionDevice(
@@ -48,15 +46,13 @@ void WiiExtensionInput::setup() {
     update();
 }
 
-void WiiExtensionInput::process() {
-    if (nextTimer < getMillis()) {
-        wii->poll();
+void WiiExtensionInput::poll() {
+    wii->poll();
 
-        update();
-              
-        nextTimer = getMillis() + uIntervalMS;
-    }
+    update();
+}
 
+void WiiExtensionInput::process() {
     if (currentConfig != NULL) {
         queueAnalogChange(WiiAnalogs::WII_ANALOG_LEFT_X, leftX, lastLeftX);
         queueAnalogChange(WiiAnalogs::WII_ANALOG_LEFT_Y, leftY, lastLeftY);
@@ -109,10 +105,7 @@ uint16_t WiiExtensionInput::bounds(uint16_t x, uint16_t out_min, uint16_t out_ma
 
 void WiiExtensionInput::update() {
     if (wii->extensionType != WII_EXTENSION_NONE) {
-        uint16_t joystickMid = GAMEPAD_JOYSTICK_MID;
-        if ( DriverManager::getInstance().getDriver() != nullptr ) {
-            joystickMid = DriverManager::getInstance().getDriver()->GetJoystickMidValue();
-        }
+        uint16_t joystickMid = FrameContext::current().joystickMid;
         currentConfig = &extensionConfigs[wii->extensionType];
 
         //for (const auto& [extensionButton, value] : currentConfig->buttonMap) {
@@ -394,10 +387,7 @@ void WiiExtensionInput::updateAnalogState() {
     Gamepad * gamepad = Storage::getInstance().GetGamepad();
     gamepad->hasAnalogTriggers = isAnalogTriggers;
 
-    uint16_t joystickMid = GAMEPAD_JOYSTICK_MID;
-    if ( DriverManager::getInstance().getDriver() != nullptr ) {
-        joystickMid = DriverManager::getInstance().getDriver()->GetJoystickMidValue();
-    }
+    uint16_t joystickMid = FrameContext::current().joystickMid;
 
     uint16_t axisType;
     uint16_t analogInput;
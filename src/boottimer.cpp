@@ -0,0 +1,98 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#include "boottimer.h"
+
+#include <string.h>
+
+#include <atomic>
+
+#include "hardware/timer.h"
+#include "pico/platform.h"
+
+#define BOOT_TIMES_MAGIC 0x424f5431 // "BOT1"
+
+struct BootTimesTable {
+    uint32_t magic;
+    uint32_t size;
+    BootTimes times;
+};
+
+// not cleared on boot, a watchdog reboot into web config keeps the times of the previous boot
+static BootTimesTable __uninitialized_ram(lastBoot);
+
+static BootTimes bootTimes;
+static uint32_t lastMark = 0;
+static std::atomic<bool> reportSent{false};
+
+static const char* phaseNames[BOOT_PHASE_COUNT] = {
+    "reset",
+    "storage",
+    "peripherals",
+    "gamepad",
+    "addons",
+    "bootAction",
+    "driver",
+    "core1",
+    "firstReport",
+    "deferredAddons",
+};
+
+static inline void recordPhase(BootPhase phase, uint32_t startUs, uint32_t now) {
+    bootTimes.phaseUs[phase] = now - startUs;
+    bootTimes.doneUs[phase] = now;
+    // a phase that ends after the first report is added to the times kept for web config
+    if (reportSent.load(std::memory_order_acquire)) {
+        lastBoot.times.phaseUs[phase] = bootTimes.phaseUs[phase];
+        lastBoot.times.doneUs[phase] = bootTimes.doneUs[phase];
+    }
+}
+
+void BootTimer::start() {
+    memset(&bootTimes, 0, sizeof(bootTimes));
+    reportSent.store(false, std::memory_order_relaxed);
+    lastMark = time_us_32();
+    recordPhase(BOOT_PHASE_RESET, 0, lastMark);
+}
+
+void BootTimer::mark(BootPhase phase) {
+    uint32_t now = time_us_32();
+    recordPhase(phase, lastMark, now);
+    lastMark = now;
+}
+
+void BootTimer::record(BootPhase phase, uint32_t startUs) {
+    recordPhase(phase, startUs, time_us_32());
+}
+
+void BootTimer::firstReport() {
+    mark(BOOT_PHASE_FIRST_REPORT);
+    lastBoot.magic = BOOT_TIMES_MAGIC;
+    lastBoot.size = sizeof(BootTimesTable);
+    memcpy(&lastBoot.times, &bootTimes, sizeof(BootTimes));
+    reportSent.store(true, std::memory_order_release);
+}
+
+bool BootTimer::firstReportSent() {
+    return reportSent.load(std::memory_order_acquire);
+}
+
+bool BootTimer::deferredSetupDue() {
+    return firstReportSent() || time_us_32() >= BOOT_DEFERRED_SETUP_TIMEOUT_MS * 1000;
+}
+
+const BootTimes& BootTimer::getBootTimes() {
+    return bootTimes;
+}
+
+const BootTimes* BootTimer::getLastBootTimes() {
+    // power-on leaves random contents
+    if (lastBoot.magic != BOOT_TIMES_MAGIC || lastBoot.size != sizeof(BootTimesTable)) return nullptr;
+    return &lastBoot.times;
+}
+
+const char* BootTimer::getPhaseName(BootPhase phase) {
+    return (phase < BOOT_PHASE_COUNT) ? phaseNames[phase] : "";
+}
@@ -124,6 +124,24 @@
 #ifndef DEFAULT_DEBOUNCE_DELAY
     #define DEFAULT_DEBOUNCE_DELAY 5
 #endif
+#ifndef DEFAULT_DEBOUNCE_MODE_BUTTONS
+    #define DEFAULT_DEBOUNCE_MODE_BUTTONS DEBOUNCE_MODE_STANDARD
+#endif
+#ifndef DEFAULT_DEBOUNCE_MODE_DIRECTIONS
+    #define DEFAULT_DEBOUNCE_MODE_DIRECTIONS DEBOUNCE_MODE_STANDARD
+#endif
+#ifndef DEFAULT_INPUT_SAMPLING_MODE
+    #define DEFAULT_INPUT_SAMPLING_MODE INPUT_SAMPLING_FREE_RUN
+#endif
+#ifndef DEFAULT_LATE_LATCH_LEAD_US
+    #define DEFAULT_LATE_LATCH_LEAD_US 250
+#endif
+#ifndef DEFAULT_FAST_BOOT
+    #define DEFAULT_FAST_BOOT false
+#endif
+#ifndef DEFAULT_FLASH_STALL_BUDGET_US
+    #define DEFAULT_FLASH_STALL_BUDGET_US EEPROM_STALL_BUDGET_US
+#endif
 
 #ifndef DEFAULT_PS4_REPORTHACK
     #define DEFAULT_PS4_REPORTHACK false
@@ -293,6 +311,12 @@ void ConfigUtils::initUnsetPropertiesWithDefaults(Config& config)
     INIT_UNSET_PROPERTY(config.gamepadOptions, profileNumber, 1);
     INIT_UNSET_PROPERTY(config.gamepadOptions, ps4ControllerType, DEFAULT_PS4CONTROLLER_TYPE);
     INIT_UNSET_PROPERTY(config.gamepadOptions, debounceDelay, DEFAULT_DEBOUNCE_DELAY);
+    INIT_UNSET_PROPERTY(config.gamepadOptions, debounceModeButtons, DEFAULT_DEBOUNCE_MODE_BUTTONS);
+    INIT_UNSET_PROPERTY(config.gamepadOptions, debounceModeDirections, DEFAULT_DEBOUNCE_MODE_DIRECTIONS);
+    INIT_UNSET_PROPERTY(config.gamepadOptions, inputSamplingMode, DEFAULT_INPUT_SAMPLING_MODE);
+    INIT_UNSET_PROPERTY(config.gamepadOptions, lateLatchLeadUs, DEFAULT_LATE_LATCH_LEAD_US);
+    INIT_UNSET_PROPERTY(config.gamepadOptions, fastBoot, DEFAULT_FAST_BOOT);
+    INIT_UNSET_PROPERTY(config.gamepadOptions, flashStallBudgetUs, DEFAULT_FLASH_STALL_BUDGET_US);
     INIT_UNSET_PROPERTY(config.gamepadOptions, inputModeB1, DEFAULT_INPUT_MODE_B1);
     INIT_UNSET_PROPERTY(config.gamepadOptions, inputModeB2, DEFAULT_INPUT_MODE_B2);
     INIT_UNSET_PROPERTY(config.gamepadOptions, inputModeB3, DEFAULT_INPUT_MODE_B3);
@@ -653,6 +677,7 @@ void ConfigUtils::initUnsetPropertiesWithDefaults(Config& config)
     INIT_UNSET_PROPERTY(config.addonOptions.analogADS1256Options, drdyPin, SPI_ANALOG1256_DRDY_PIN);
     INIT_UNSET_PROPERTY(config.addonOptions.analogADS1256Options, avdd, ADS1256_MAX_3V);
     INIT_UNSET_PROPERTY(config.addonOptions.analogADS1256Options, enableTriggers, false);
+    INIT_UNSET_PROPERTY(config.addonOptions.analogADS1256Options, pollPeriodUs, SPI_ANALOG1256_POLL_US);
 
     INIT_UNSET_PROPERTY(config.addonOptions.dualDirectionalOptions, enabled, !!DUAL_DIRECTIONAL_ENABLED);
     INIT_UNSET_PROPERTY(config.addonOptions.dualDirectionalOptions, deprecatedUpPin, (Pin_t)-1);
@@ -1527,9 +1552,12 @@ void hotkeysMigration(Config& config)
 // Loading / Saving
 // -----------------------------------------------------
 
-// We put a ConfigFooter struct at the end of the flash area reserved for FlashPROM. It contains a magicvalue, the size
-// of the serialized config data and a CRC of that data. This information allows us to both locate and verify the stored
-// data. The serialized data is located directly before the footer:
+// The serialized config is the cache of FlashPROM, which saves it as a log of full and delta records and replays
+// that into the cache on start.
+//
+// Before the log, we put a ConfigFooter struct at the end of the flash area reserved for FlashPROM. It contains a
+// magicvalue, the size of the serialized config data and a CRC of that data. The serialized data is located directly
+// before the footer, a block without log records is still read this way:
 //
 //                       FlashPROM block
 // ┌────────────────────────────┴─────────────────────────────┐
@@ -1542,21 +1570,17 @@ struct ConfigFooter
     uint32_t dataSize;
     uint32_t dataCrc;
     uint32_t magic;
-
-    bool operator==(const ConfigFooter& other) const
-    {
-        return
-            dataSize == other.dataSize &&
-            dataCrc == other.dataCrc &&
-            magic == other.magic;
-    }
 };
 
 static const uint32_t FOOTER_MAGIC = 0xd2f1e365;
 
+// Bump when a migration is added to ConfigUtils::load. A config saved with this version, by a firmware with the same
+// Config message, has been through all of them and had every field set, so it is used as it was decoded.
+static const uint32_t CONFIG_SCHEMA_VERSION = 1;
+
 // Verify that the maximum size of the serialized Config object fits into the allocated flash block
 #if defined(Config_size)
-    static_assert(Config_size + sizeof(ConfigFooter) <= EEPROM_SIZE_BYTES, "Maximum size of Config exceeds the maximum size allocated for FlashPROM");
+    static_assert(Config_size <= EEPROM_MAX_IMAGE_SIZE, "Maximum size of Config exceeds the maximum size allocated for FlashPROM");
 #else
     #error "Maximum size of Config cannot be determined statically, make sure that you do not use any dynamically sized arrays or strings"
 #endif
@@ -1565,6 +1589,12 @@ static bool loadConfigInner(Config& config)
 {
     config = Config Config_init_zero;
 
+    if (EEPROM.size() > 0)
+    {
+        pb_istream_t inputStream = pb_istream_from_buffer(EEPROM.writeCache, EEPROM.size());
+        return pb_decode(&inputStream, Config_fields, &config);
+    }
+
     const uint8_t* flashEnd = reinterpret_cast<const uint8_t*>(EEPROM_ADDRESS_START) + EEPROM_SIZE_BYTES;
     const ConfigFooter& footer = *reinterpret_cast<const ConfigFooter*>(flashEnd - sizeof(ConfigFooter));
 
@@ -1593,10 +1623,25 @@ static bool loadConfigInner(Config& config)
     return pb_decode(&inputStream, Config_fields, &config);
 }
 
+static bool isCurrentSchema(const Config& config)
+{
+    // a different Config_size means fields were added or removed since the config was saved
+    return
+        config.migrations.schemaVersion == CONFIG_SCHEMA_VERSION &&
+        config.migrations.schemaSize == Config_size &&
+        strncmp(config.boardVersion, GP2040VERSION, sizeof(config.boardVersion)) == 0;
+}
+
 void ConfigUtils::load(Config& config)
 {
     // First try to load from Protobuf storage, if that fails fall back to legacy storage.
-    const bool loaded = loadConfigInner(config) | fromLegacyStorage(config);
+    const bool decoded = loadConfigInner(config);
+    if (decoded && isCurrentSchema(config))
+    {
+        return;
+    }
+
+    const bool loaded = decoded || fromLegacyStorage(config);
 
     if (!loaded)
     {
@@ -1637,6 +1682,10 @@ void ConfigUtils::load(Config& config)
     config.boardVersion[sizeof(config.boardVersion) - 1] = '\0';
     config.has_boardVersion = true;
 
+    // Stamp the schema, the next boot skips all of the above
+    config.migrations.schemaVersion = CONFIG_SCHEMA_VERSION;
+    config.migrations.schemaSize = Config_size;
+
     // Save, to make sure we persist any performed migration steps
     save(config);
 }
@@ -1699,6 +1748,19 @@ static void setHasFlags(const pb_msgdesc_t* fields, void* s)
     } while (pb_field_iter_next(&iter));
 }
 
+// Sub-messages are written through streams of their own, which start counting bytes_written from 0. The offset in the
+// cache is kept in the state they share with the outer stream.
+static bool writeToCache(pb_ostream_t* stream, const pb_byte_t* buf, size_t count)
+{
+    uint32_t& offset = *reinterpret_cast<uint32_t*>(stream->state);
+    if (!EEPROM.write(offset, buf, count))
+    {
+        return false;
+    }
+    offset += count;
+    return true;
+}
+
 bool ConfigUtils::save(Config& config)
 {
     // We only allow saves from core0. Saves from core1 have to be marshalled to core0.
@@ -1713,36 +1775,19 @@ bool ConfigUtils::save(Config& config)
     // its default value.
     setHasFlags(Config_fields, &config);
 
-    // Encode the data directly into the cache of FlashPROM
-    pb_ostream_t outputStream = pb_ostream_from_buffer(EEPROM.writeCache, EEPROM_SIZE_BYTES - sizeof(ConfigFooter));
+    // Encode the data directly into the cache of FlashPROM, which keeps track of the bytes that changed
+    uint32_t cacheOffset = 0;
+    pb_ostream_t outputStream = {};
+    outputStream.callback = &writeToCache;
+    outputStream.state = &cacheOffset;
+    outputStream.max_size = EEPROM_MAX_IMAGE_SIZE;
     if (!pb_encode(&outputStream, Config_fields, &config))
     {
         return false;
     }
 
-    // Create the new footer
-    ConfigFooter newFooter;
-    newFooter.dataSize = outputStream.bytes_written;
-    newFooter.dataCrc = CRC32::calculate(EEPROM.writeCache, newFooter.dataSize);
-    newFooter.magic = FOOTER_MAGIC;
-
-    // The data has changed when the footer content has changed. Only then do we acutally need to save.
-    const ConfigFooter& oldFooter = *reinterpret_cast<ConfigFooter*>(EEPROM.writeCache + EEPROM_SIZE_BYTES - sizeof(ConfigFooter));
-    if (newFooter == oldFooter)
-    {
-        // The data has not changed, no saving neccessary.
-        return true;
-    }
-
-    // Write the footer
-    ConfigFooter* cacheFooter = reinterpret_cast<ConfigFooter*>(EEPROM.writeCache + EEPROM_SIZE_BYTES - sizeof(ConfigFooter));
-    memcpy(cacheFooter, &newFooter, sizeof(ConfigFooter));
-
-    // Move the encoded data in memory down to the footer
-    memmove(EEPROM.writeCache + EEPROM_SIZE_BYTES - sizeof(ConfigFooter) - newFooter.dataSize, EEPROM.writeCache, newFooter.dataSize);
-    memset(EEPROM.writeCache, 0, EEPROM_SIZE_BYTES - sizeof(ConfigFooter) - newFooter.dataSize);
-
-    EEPROM.commit();
+    // Only the changes are saved, nothing is when the config is the same as the one in flash
+    EEPROM.commit(outputStream.bytes_written);
 
     return true;
 }
@@ -9,10 +9,15 @@
 #include "peripheralmanager.h"
 #include "AnimationStorage.hpp"
 #include "system.h"
+#include "loopprofiler.h"
+#include "latencytracer.h"
+#include "boottimer.h"
+#include "addonmanager.h"
 #include "config_utils.h"
 #include "types.h"
 #include "version.h"
 
+#include <algorithm>
 #include <cstring>
 #include <string>
 #include <vector>
@@ -680,6 +685,13 @@ std::string setGamepadOptions()
     readDoc(gamepadOptions.fourWayMode, doc, "fourWayMode");
     readDoc(gamepadOptions.profileNumber, doc, "profileNumber");
     readDoc(gamepadOptions.debounceDelay, doc, "debounceDelay");
+    readDoc(gamepadOptions.debounceModeButtons, doc, "debounceModeButtons");
+    readDoc(gamepadOptions.debounceModeDirections, doc, "debounceModeDirections");
+    readDoc(gamepadOptions.inputSamplingMode, doc, "inputSamplingMode");
+    readDoc(gamepadOptions.lateLatchLeadUs, doc, "lateLatchLeadUs");
+    readDoc(gamepadOptions.fastBoot, doc, "fastBoot");
+    readDoc(gamepadOptions.flashStallBudgetUs, doc, "flashStallBudgetUs");
+    gamepadOptions.flashStallBudgetUs = std::clamp(gamepadOptions.flashStallBudgetUs, (uint32_t)EEPROM_PAGE_PROGRAM_MAX_US, (uint32_t)EEPROM_STALL_BUDGET_MAX_US);
     readDoc(gamepadOptions.inputModeB1, doc, "inputModeB1");
     readDoc(gamepadOptions.inputModeB2, doc, "inputModeB2");
     readDoc(gamepadOptions.inputModeB3, doc, "inputModeB3");
@@ -747,6 +759,12 @@ std::string getGamepadOptions()
     writeDoc(doc, "fourWayMode", gamepadOptions.fourWayMode ? 1 : 0);
     writeDoc(doc, "profileNumber", gamepadOptions.profileNumber);
     writeDoc(doc, "debounceDelay", gamepadOptions.debounceDelay);
+    writeDoc(doc, "debounceModeButtons", gamepadOptions.debounceModeButtons);
+    writeDoc(doc, "debounceModeDirections", gamepadOptions.debounceModeDirections);
+    writeDoc(doc, "inputSamplingMode", gamepadOptions.inputSamplingMode);
+    writeDoc(doc, "lateLatchLeadUs", gamepadOptions.lateLatchLeadUs);
+    writeDoc(doc, "fastBoot", gamepadOptions.fastBoot ? 1 : 0);
+    writeDoc(doc, "flashStallBudgetUs", gamepadOptions.flashStallBudgetUs);
     writeDoc(doc, "inputModeB1", gamepadOptions.inputModeB1);
     writeDoc(doc, "inputModeB2", gamepadOptions.inputModeB2);
     writeDoc(doc, "inputModeB3", gamepadOptions.inputModeB3);
@@ -1561,6 +1579,15 @@ std::string setAddonOptions()
     AnalogADS1219Options& analogADS1219Options = Storage::getInstance().getAddonOptions().analogADS1219Options;
     docToValue(analogADS1219Options.enabled, doc, "I2CAnalog1219InputEnabled");
 
+    AnalogADS1256Options& ads1256Options = Storage::getInstance().getAddonOptions().analogADS1256Options;
+    docToValue(ads1256Options.enabled, doc, "Analog1256Enabled");
+    docToValue(ads1256Options.spiBlock, doc, "analog1256Block");
+    docToValue(ads1256Options.csPin, doc, "analog1256CsPin");
+    docToValue(ads1256Options.drdyPin, doc, "analog1256DrdyPin");
+    docToValue(ads1256Options.avdd, doc, "analog1256AnalogMax");
+    docToValue(ads1256Options.enableTriggers, doc, "analog1256EnableTriggers");
+    docToValue(ads1256Options.pollPeriodUs, doc, "analog1256PollPeriodUs");
+
     PlayerNumberOptions& playerNumberOptions = Storage::getInstance().getAddonOptions().playerNumberOptions;
     docToValue(playerNumberOptions.number, doc, "playerNumber");
     docToValue(playerNumberOptions.enabled, doc, "PlayerNumAddonEnabled");
@@ -2059,6 +2086,7 @@ std::string getAddonOptions()
     writeDoc(doc, "analog1256DrdyPin", ads1256Options.drdyPin);
     writeDoc(doc, "analog1256AnalogMax", ads1256Options.avdd);
     writeDoc(doc, "analog1256EnableTriggers", ads1256Options.enableTriggers);
+    writeDoc(doc, "analog1256PollPeriodUs", ads1256Options.pollPeriodUs);
 
     const FocusModeOptions& focusModeOptions = Storage::getInstance().getAddonOptions().focusModeOptions;
     writeDoc(doc, "focusModeButtonLockMask", focusModeOptions.buttonLockMask);
@@ -2197,6 +2225,190 @@ std::string getMemoryReport()
     writeDoc(doc, "staticAllocs", System::getStaticAllocs());
     writeDoc(doc, "totalHeap", System::getTotalHeap());
     writeDoc(doc, "usedHeap", System::getUsedHeap());
+
+    // live event handlers per event type, indexed by GPEventType
+    JsonArray handlers = doc.createNestedArray("eventHandlers");
+    for (uint8_t eventType = 0; eventType < _GPEventType_ARRAYSIZE; eventType++) {
+        handlers.add(EventManager::getInstance().getHandlerCount((GPEventType)eventType));
+    }
+    writeDoc(doc, "maxEventHandlers", EVENTMGR_MAX_HANDLERS);
+    // events one core sent the other while its queue was full
+    writeDoc(doc, "droppedEvents", EventManager::getInstance().getDroppedEvents(0) + EventManager::getInstance().getDroppedEvents(1));
+
+    // time and heap add-on loading took at boot, per core
+    JsonArray addonLoadUs = doc.createNestedArray("addonLoadUs");
+    JsonArray addonLoadHeap = doc.createNestedArray("addonLoadHeap");
+    for (uint8_t core = 0; core < 2; core++) {
+        const AddonManager * manager = AddonManager::GetCoreManager(core);
+        addonLoadUs.add(manager ? manager->GetLoadUs() : 0);
+        addonLoadHeap.add(manager ? manager->GetLoadHeap() : 0);
+    }
+    return serialize_json(doc);
+}
+
+static void writeAddonTiming(JsonObject timingDoc, const AddonTimingStats& stats)
+{
+    timingDoc["count"] = stats.count;
+    // in ns, most hooks take less than the 1us the timer counts in
+    timingDoc["avgNs"] = (stats.count == 0) ? 0 : (uint32_t)(((uint64_t)stats.sum * 1000) / stats.count);
+    timingDoc["max"] = stats.max;
+}
+
+static void writeLoopStage(JsonArray stages, LoopProfileStage stage, const LoopProfileStats& stats)
+{
+    JsonObject stageDoc = stages.createNestedObject();
+    stageDoc["name"] = LoopProfiler::getStageName(stage);
+    stageDoc["count"] = stats.count;
+    stageDoc["min"] = stats.min;
+    stageDoc["avg"] = LoopProfiler::getAverage(stats);
+    stageDoc["max"] = stats.max;
+
+    JsonArray histogram = stageDoc.createNestedArray("histogram");
+    for (uint8_t bucket = 0; bucket < LOOP_PROFILER_HISTOGRAM_BUCKETS; bucket++) {
+        histogram.add(stats.histogram[bucket]);
+    }
+}
+
+std::string getLoopProfile()
+{
+    DynamicJsonDocument doc(LWIP_HTTPD_POST_MAX_PAYLOAD_LEN);
+    writeDoc(doc, "enabled", LOOP_PROFILER_ENABLED ? true : false);
+
+    JsonArray stages = doc.createNestedArray("stages");
+    for (uint8_t stage = 0; stage < LOOP_STAGE_COUNT; stage++) {
+        writeLoopStage(stages, (LoopProfileStage)stage, LoopProfiler::getStats((LoopProfileStage)stage));
+    }
+
+    // these are web config's own passes, the last session with the gamepad running was kept over the reboot
+    const bool recorded = LoopProfiler::getGameplayStats(LOOP_STAGE_TOTAL) != nullptr;
+    writeDoc(doc, "recorded", recorded);
+    JsonArray gameplayStages = doc.createNestedArray("gameplayStages");
+    for (uint8_t stage = 0; recorded && stage < LOOP_STAGE_COUNT; stage++) {
+        writeLoopStage(gameplayStages, (LoopProfileStage)stage, *LoopProfiler::getGameplayStats((LoopProfileStage)stage));
+    }
+
+    // loaded add-ons of both cores, hook timing only with the profiler enabled, poll stats always
+    JsonArray addonsDoc = doc.createNestedArray("addons");
+    for (uint8_t core = 0; core < 2; core++) {
+        const AddonManager * manager = AddonManager::GetCoreManager(core);
+        if (manager == nullptr) continue;
+
+        for (uint8_t index = 0; index < manager->GetAddonCount(); index++) {
+            const AddonBlock * block = &manager->GetAddonBlock(index);
+            JsonObject addonDoc = addonsDoc.createNestedObject();
+            addonDoc["name"] = AddonManager::GetAddonName(block->id);
+            addonDoc["core"] = core;
+            addonDoc["phase"] = (uint8_t)block->process;
+            if (LOOP_PROFILER_ENABLED && (block->hooks & ADDON_HOOK_PREPROCESS))
+                writeAddonTiming(addonDoc.createNestedObject("preprocess"), block->preprocessTiming);
+            if (LOOP_PROFILER_ENABLED && (block->hooks & ADDON_HOOK_PROCESS))
+                writeAddonTiming(addonDoc.createNestedObject("process"), block->processTiming);
+            if (block->schedule.periodUs != 0) {
+                JsonObject pollDoc = addonDoc.createNestedObject("poll");
+                pollDoc["period"] = block->schedule.periodUs;
+                pollDoc["count"] = block->pollStats.polls;
+                pollDoc["deferred"] = block->pollStats.deferred;
+                pollDoc["overruns"] = block->pollStats.overruns;
+                pollDoc["max"] = block->pollStats.maxUs;
+                pollDoc["maxLate"] = block->pollStats.maxLateUs;
+            }
+        }
+    }
+
+    return serialize_json(doc);
+}
+
+static void writeLatencyStats(JsonObject statsDoc, const LatencyStats& stats, uint32_t avg)
+{
+    statsDoc["count"] = stats.count;
+    statsDoc["min"] = stats.min;
+    statsDoc["avg"] = avg;
+    statsDoc["max"] = stats.max;
+
+    JsonArray histogram = statsDoc.createNestedArray("histogram");
+    for (uint8_t bucket = 0; bucket < LATENCY_TRACER_HISTOGRAM_BUCKETS; bucket++) {
+        histogram.add(stats.histogram[bucket]);
+    }
+}
+
+std::string getLatencyTrace()
+{
+    DynamicJsonDocument doc(LWIP_HTTPD_POST_MAX_PAYLOAD_LEN);
+    writeDoc(doc, "enabled", LATENCY_TRACER_ENABLED ? true : false);
+
+    // only input modes that were traced, the full table would not fit the response
+    JsonArray modes = doc.createNestedArray("modes");
+    for (uint8_t mode = 0; mode < LATENCY_TRACER_INPUT_MODES; mode++) {
+        const LatencyStats& queued = LatencyTracer::getStats((InputMode)mode, LATENCY_POINT_QUEUED);
+        if (queued.count == 0) continue;
+
+        const LatencyStats& completed = LatencyTracer::getStats((InputMode)mode, LATENCY_POINT_COMPLETED);
+        JsonObject modeDoc = modes.createNestedObject();
+        modeDoc["inputMode"] = mode;
+        writeLatencyStats(modeDoc.createNestedObject("queued"), queued, LatencyTracer::getAverage((InputMode)mode, LATENCY_POINT_QUEUED));
+        writeLatencyStats(modeDoc.createNestedObject("completed"), completed, LatencyTracer::getAverage((InputMode)mode, LATENCY_POINT_COMPLETED));
+    }
+
+    return serialize_json(doc);
+}
+
+std::string resetLatencyTrace()
+{
+    LatencyTracer::reset();
+    DynamicJsonDocument doc(LWIP_HTTPD_POST_MAX_PAYLOAD_LEN);
+    doc["success"] = true;
+    return serialize_json(doc);
+}
+
+std::string getBootProfile()
+{
+    DynamicJsonDocument doc(LWIP_HTTPD_POST_MAX_PAYLOAD_LEN);
+    writeDoc(doc, "fastBoot", Storage::getInstance().getGamepadOptions().fastBoot ? 1 : 0);
+
+    // web config itself sends no reports, these are the times of the boot before it
+    const BootTimes* times = BootTimer::getLastBootTimes();
+    writeDoc(doc, "recorded", times != nullptr);
+    JsonArray phases = doc.createNestedArray("phases");
+    if (times != nullptr) {
+        for (uint8_t phase = 0; phase < BOOT_PHASE_COUNT; phase++) {
+            JsonObject phaseDoc = phases.createNestedObject();
+            phaseDoc["name"] = BootTimer::getPhaseName((BootPhase)phase);
+            phaseDoc["us"] = times->phaseUs[phase];
+            phaseDoc["doneUs"] = times->doneUs[phase];
+        }
+    }
+
+    return serialize_json(doc);
+}
+
+static void writeFlashStats(JsonObject doc, const FlashPROMStats& stats)
+{
+    doc["fullRecords"] = stats.fullRecords;
+    doc["deltaRecords"] = stats.deltaRecords;
+    doc["sectorsErased"] = stats.sectorsErased;
+    doc["pagesProgrammed"] = stats.pagesProgrammed;
+    doc["steps"] = stats.steps;
+    doc["maxStallUs"] = stats.maxStallUs;
+    doc["deferredSteps"] = stats.deferredSteps;
+    doc["heldSteps"] = stats.heldSteps;
+    doc["erasesAhead"] = stats.erasesAhead;
+    doc["restartedSaves"] = stats.restartedSaves;
+    doc["unsafeWrites"] = stats.unsafeWrites;
+}
+
+std::string getFlashStats()
+{
+    DynamicJsonDocument doc(LWIP_HTTPD_POST_MAX_PAYLOAD_LEN);
+    writeDoc(doc, "stallBudgetUs", Storage::getInstance().getGamepadOptions().flashStallBudgetUs);
+    writeDoc(doc, "pageProgramMaxUs", EEPROM_PAGE_PROGRAM_MAX_US);
+    writeDoc(doc, "sectorEraseMaxUs", EEPROM_SECTOR_ERASE_MAX_US);
+    writeFlashStats(doc.createNestedObject("current"), EEPROM.getStats());
+
+    // the saves hotkeys made while playing were written in the boot before web config
+    const FlashPROMStats* previous = EEPROM.getPreviousStats();
+    writeDoc(doc, "recorded", previous != nullptr);
+    if (previous != nullptr) writeFlashStats(doc.createNestedObject("previous"), *previous);
+
     return serialize_json(doc);
 }
 
@@ -2342,7 +2554,7 @@ std::string reboot()
         default:
             rebootMode = System::BootMode::DEFAULT;
     }
-    EventManager::getInstance().triggerEvent(new GPRestartEvent(rebootMode));
+    EventManager::getInstance().triggerEvent(GPRestartEvent(rebootMode));
     return serialize_json(doc);
 }
 
@@ -2386,6 +2598,11 @@ static const std::pair<const char*, HandlerFuncPtr> handlerFuncs[] =
     { "/api/getSplashImage", getSplashImage },
     { "/api/getFirmwareVersion", getFirmwareVersion },
     { "/api/getMemoryReport", getMemoryReport },
+    { "/api/getLoopProfile", getLoopProfile },
+    { "/api/getLatencyTrace", getLatencyTrace },
+    { "/api/resetLatencyTrace", resetLatencyTrace },
+    { "/api/getBootProfile", getBootProfile },
+    { "/api/getFlashStats", getFlashStats },
     { "/api/getHeldPins", getHeldPins },
     { "/api/abortGetHeldPins", abortGetHeldPins },
     { "/api/getUsedPins", getUsedPins },
@@ -9,8 +9,22 @@ Gamepad* GPGFX_UI::getGamepad() {
     return Storage::getInstance().GetGamepad();
 }
 
+// Core1 copy of the processed state core0 published, refreshed once per display pass so every element draws the same one
+static Gamepad* processedSnapshot = nullptr;
+static uint32_t processedSnapshotVersion = 0;
+
 Gamepad* GPGFX_UI::getProcessedGamepad() { 
-    return Storage::getInstance().GetProcessedGamepad();
+    return processedSnapshot != nullptr ? processedSnapshot : Storage::getInstance().GetProcessedGamepad();
+}
+
+bool GPGFX_UI::refreshProcessedGamepad() {
+    if (processedSnapshot == nullptr) {
+        processedSnapshot = new Gamepad();
+    } else if (Storage::getInstance().getProcessedStateVersion() == processedSnapshotVersion) {
+        return false;
+    }
+    processedSnapshotVersion = Storage::getInstance().readProcessedState(processedSnapshot->state);
+    return true;
 }
 
 DisplayOptions GPGFX_UI::getDisplayOptions() {
@@ -14,9 +14,9 @@ void ButtonLayoutScreen::init() {
     gamepad = Storage::getInstance().GetGamepad();
     inputMode = DriverManager::getInstance().getInputMode();
 
-    EventManager::getInstance().registerEventHandler(GP_EVENT_PROFILE_CHANGE, GPEVENT_CALLBACK(this->handleProfileChange(event)));
-    EventManager::getInstance().registerEventHandler(GP_EVENT_USBHOST_MOUNT, GPEVENT_CALLBACK(this->handleUSB(event)));
-    EventManager::getInstance().registerEventHandler(GP_EVENT_USBHOST_UNMOUNT, GPEVENT_CALLBACK(this->handleUSB(event)));
+    profileChangeHandler = EventManager::getInstance().registerEventHandler(GP_EVENT_PROFILE_CHANGE, GPEVENT_CALLBACK(this->handleProfileChange(event)));
+    usbMountHandler = EventManager::getInstance().registerEventHandler(GP_EVENT_USBHOST_MOUNT, GPEVENT_CALLBACK(this->handleUSB(event)));
+    usbUnmountHandler = EventManager::getInstance().registerEventHandler(GP_EVENT_USBHOST_UNMOUNT, GPEVENT_CALLBACK(this->handleUSB(event)));
     
     footer = "";
     historyString = "";
@@ -81,10 +81,21 @@ void ButtonLayoutScreen::init() {
 
 void ButtonLayoutScreen::shutdown() {
     clearElements();
+
+    profileChangeHandler.release();
+    usbMountHandler.release();
+    usbUnmountHandler.release();
+}
+
+bool ButtonLayoutScreen::needsRedraw(bool stateChanged) {
+    // the buttons only move with the processed state, the status bar with the banner and a few slow changing modes
+    return stateChanged || bannerDisplay || Storage::getInstance().GetConfigMode() ||
+        (getMillis() - lastRedraw) >= BUTTON_LAYOUT_STATUS_REFRESH_MS;
 }
 
 int8_t ButtonLayoutScreen::update() {
     bool configMode = Storage::getInstance().GetConfigMode();
+    lastRedraw = getMillis();
     uint8_t profileNumber = getGamepad()->getOptions().profileNumber;
     
     // Check if we've updated button layouts while in config mode
@@ -343,7 +343,7 @@ void MainMenuScreen::saveOptions() {
         }
 
         if (saveHasChanged) {
-            EventManager::getInstance().triggerEvent(new GPStorageSaveEvent(true, changeRequiresReboot));
+            EventManager::getInstance().triggerEvent(GPStorageSaveEvent(true, changeRequiresReboot));
             screenIsPrompting = false;
         }
         changeRequiresSave = false;
@@ -2,6 +2,22 @@
 
 #include "pico/stdlib.h"
 #include "version.h"
+#include "loopprofiler.h"
+#include "boottimer.h"
+
+#include <cstdio>
+
+// Boot phases and loop profile stages shown per page, below the title
+#define STATS_PROFILE_ROWS 6
+#define STATS_BOOT_PAGES ((BOOT_PHASE_COUNT + STATS_PROFILE_ROWS - 1) / STATS_PROFILE_ROWS)
+#define STATS_LOOP_PAGES ((LOOP_STAGE_COUNT + STATS_PROFILE_ROWS - 1) / STATS_PROFILE_ROWS)
+#define STATS_PAGE_COUNT (1 + STATS_BOOT_PAGES + STATS_LOOP_PAGES)
+
+static const char* phaseLabels[] = {
+    "Reset", "Store", "Perip", "Gpad", "Addon", "BtAct", "Drivr", "Core1", "1stRp", "Defer"
+};
+
+static_assert(sizeof(phaseLabels) / sizeof(phaseLabels[0]) == BOOT_PHASE_COUNT, "every BootPhase needs a label");
 
 void StatsScreen::init() {
     getRenderer()->clearScreen();
@@ -12,6 +28,14 @@ void StatsScreen::shutdown() {
 }
 
 void StatsScreen::drawScreen() {
+    if (page > STATS_BOOT_PAGES) {
+        drawLoopProfile((page - 1 - STATS_BOOT_PAGES) * STATS_PROFILE_ROWS);
+        return;
+    } else if (page > 0) {
+        drawBootTimes((page - 1) * STATS_PROFILE_ROWS);
+        return;
+    }
+
     getRenderer()->drawText(2, 0, "[GP2040-CE Stats]");
     getRenderer()->drawText(0, 1, "Version: " GP2040VERSIONID);
     getRenderer()->drawText(0, 2, "Build: " GP2040BUILD);
@@ -19,7 +43,48 @@ void StatsScreen::drawScreen() {
     getRenderer()->drawText(0, 4, "Type: " GP2040CONFIG);
     getRenderer()->drawText(0, 5, "Arch: " GP2040PLATFORM);
 
-    getRenderer()->drawText(5, 7, "B2 to Return");
+    getRenderer()->drawText(1, 7, "B1 Page  B2 Return");
+}
+
+void StatsScreen::drawBootTimes(uint8_t firstPhase) {
+    getRenderer()->drawText(1, 0, "[Boot took/at us]");
+
+    // the boot into config mode sends no reports, this is the one before it
+    const BootTimes* times = BootTimer::getLastBootTimes();
+    if (times == nullptr) {
+        getRenderer()->drawText(0, 2, "No boot recorded");
+    } else {
+        char line[24];
+        for (uint8_t row = 0; row < STATS_PROFILE_ROWS && (firstPhase + row) < BOOT_PHASE_COUNT; row++) {
+            uint8_t phase = firstPhase + row;
+            snprintf(line, sizeof(line), "%-5s%8lu%8lu", phaseLabels[phase],
+                (unsigned long)times->phaseUs[phase], (unsigned long)times->doneUs[phase]);
+            getRenderer()->drawText(0, row + 1, line);
+        }
+    }
+
+    getRenderer()->drawText(1, 7, "B1 Page  B2 Return");
+}
+
+void StatsScreen::drawLoopProfile(uint8_t firstStage) {
+    getRenderer()->drawText(1, 0, "[Loop min/avg/max]");
+
+    if (!LOOP_PROFILER_ENABLED) {
+        getRenderer()->drawText(0, 2, "Profiler disabled");
+    } else {
+        char line[24];
+        for (uint8_t row = 0; row < STATS_PROFILE_ROWS && (firstStage + row) < LOOP_STAGE_COUNT; row++) {
+            LoopProfileStage stage = (LoopProfileStage)(firstStage + row);
+            // config mode's own passes only if no session with the gamepad running was kept
+            const LoopProfileStats* gameplay = LoopProfiler::getGameplayStats(stage);
+            const LoopProfileStats& stats = gameplay != nullptr ? *gameplay : LoopProfiler::getStats(stage);
+            snprintf(line, sizeof(line), "%-5s%5lu%5lu%5lu", LoopProfiler::getStageLabel(stage),
+                (unsigned long)stats.min, (unsigned long)LoopProfiler::getAverage(stats), (unsigned long)stats.max);
+            getRenderer()->drawText(0, row + 1, line);
+        }
+    }
+
+    getRenderer()->drawText(1, 7, "B1 Page  B2 Return");
 }
 
 int8_t StatsScreen::update() {
@@ -29,6 +94,8 @@ int8_t StatsScreen::update() {
             if (prevButtonState == GAMEPAD_MASK_B2) {
                 prevButtonState = 0;
                 return DisplayMode::CONFIG_INSTRUCTION;
+            } else if (prevButtonState == GAMEPAD_MASK_B1) {
+                page = (page + 1) % STATS_PAGE_COUNT;
             }
         }
         prevButtonState = buttonState;
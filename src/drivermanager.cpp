@@ -17,6 +17,7 @@
 #include "drivers/xinput/XInputDriver.h"
 
 #include "usbhostmanager.h"
+#include "latencytracer.h"
 
 void DriverManager::setup(InputMode mode) {
     switch (mode) {
@@ -75,4 +76,6 @@ void DriverManager::setup(InputMode mode) {
     // Initialize our chosen driver
     driver->initialize();
     inputMode = mode;
+
+    LATENCY_TRACE_INIT(mode);
 }
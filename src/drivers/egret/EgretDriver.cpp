@@ -1,5 +1,6 @@
 #include "drivers/egret/EgretDriver.h"
 #include "drivers/shared/driverhelper.h"
+#include "latencytracer.h"
 
 void EgretDriver::initialize() {
 	egretReport = {
@@ -58,7 +59,10 @@ void EgretDriver::process(Gamepad * gamepad) {
 		// HID ready + report sent, copy previous report
 		if (tud_hid_ready() && tud_hid_report(0, report, report_size) == true ) {
 			memcpy(last_report, report, report_size);
+			LATENCY_TRACE_QUEUED();
 		}
+	} else {
+		LATENCY_TRACE_UNCHANGED();
 	}
 }
 
@@ -6,6 +6,7 @@
 #include "drivers/hid/HIDDriver.h"
 #include "drivers/hid/HIDDescriptors.h"
 #include "drivers/shared/driverhelper.h"
+#include "latencytracer.h"
 #include "storagemanager.h"
 
 static bool hid_control_xfer_cb(uint8_t rhport, uint8_t stage, tusb_control_request_t const * request)
@@ -104,7 +105,10 @@ void HIDDriver::process(Gamepad * gamepad) {
 		// HID ready + report sent, copy previous report
 		if (tud_hid_ready() && tud_hid_report(0, report, report_size) == true ) {
 			memcpy(last_report, report, report_size);
+			LATENCY_TRACE_QUEUED();
 		}
+	} else {
+		LATENCY_TRACE_UNCHANGED();
 	}
 }
 
@@ -1,6 +1,7 @@
 #include "drivers/keyboard/KeyboardDriver.h"
 #include "storagemanager.h"
 #include "drivers/shared/driverhelper.h"
+#include "latencytracer.h"
 #include "drivers/hid/HIDDescriptors.h"
 
 #include "eventmanager.h"
@@ -24,7 +25,7 @@ void KeyboardDriver::initialize() {
 	};
 
     // Handle Volume for Rotary Encoder
-    EventManager::getInstance().registerEventHandler(GP_EVENT_ENCODER_CHANGE, GPEVENT_CALLBACK(this->handleEncoder(event)));
+    encoderHandler = EventManager::getInstance().registerEventHandler(GP_EVENT_ENCODER_CHANGE, GPEVENT_CALLBACK(this->handleEncoder(event)));
     volumeChange = 0; // no change
 }
 
@@ -121,6 +122,7 @@ void KeyboardDriver::process(Gamepad * gamepad) {
 			if ( tud_hid_report(keyboardReport.reportId, keyboard_report_payload, keyboard_report_size) ) {
 				memcpy(last_report, keyboard_report_payload, keyboard_report_size);
 				last_report_size = keyboard_report_size;
+				LATENCY_TRACE_QUEUED();
 
                 // Adjust volume on success
                 if( volumeChange > 0 ) {
@@ -130,6 +132,8 @@ void KeyboardDriver::process(Gamepad * gamepad) {
                 }
 			}
 		}
+	} else {
+		LATENCY_TRACE_UNCHANGED();
 	}
 }
 
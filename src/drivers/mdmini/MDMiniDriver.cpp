@@ -1,5 +1,6 @@
 #include "drivers/mdmini/MDMiniDriver.h"
 #include "drivers/shared/driverhelper.h"
+#include "latencytracer.h"
 
 void MDMiniDriver::initialize() {
 	mdminiReport = {
@@ -56,7 +57,10 @@ void MDMiniDriver::process(Gamepad * gamepad) {
 		// HID ready + report sent, copy previous report
 		if (tud_hid_ready() && tud_hid_report(0, report, report_size) == true ) {
 			memcpy(last_report, report, report_size);
+			LATENCY_TRACE_QUEUED();
 		}
+	} else {
+		LATENCY_TRACE_UNCHANGED();
 	}
 }
 
@@ -1,5 +1,6 @@
 #include "drivers/pcengine/PCEngineDriver.h"
 #include "drivers/shared/driverhelper.h"
+#include "latencytracer.h"
 
 void PCEngineDriver::initialize() {
 	pcengineReport = {
@@ -57,7 +58,10 @@ void PCEngineDriver::process(Gamepad * gamepad) {
 		// HID ready + report sent, copy previous report
 		if (tud_hid_ready() && tud_hid_report(0, report, report_size) == true ) {
 			memcpy(last_report, report, report_size);
+			LATENCY_TRACE_QUEUED();
 		}
+	} else {
+		LATENCY_TRACE_UNCHANGED();
 	}
 }
 
@@ -6,6 +6,7 @@
 #include "drivers/ps3/PS3Driver.h"
 #include "drivers/ps3/PS3Descriptors.h"
 #include "drivers/shared/driverhelper.h"
+#include "latencytracer.h"
 #include "storagemanager.h"
 #include "pico/rand.h"
 
@@ -140,7 +141,10 @@ void PS3Driver::process(Gamepad * gamepad) {
         // HID ready + report sent, copy previous report
         if (tud_hid_ready() && tud_hid_report(0, report, report_size) == true ) {
             memcpy(last_report, report, report_size);
+            LATENCY_TRACE_QUEUED();
         }
+    } else {
+        LATENCY_TRACE_UNCHANGED();
     }
 
     uint16_t featureSize = sizeof(PS3Features);
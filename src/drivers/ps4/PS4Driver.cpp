@@ -1,5 +1,6 @@
 #include "drivers/ps4/PS4Driver.h"
 #include "drivers/shared/driverhelper.h"
+#include "latencytracer.h"
 #include "storagemanager.h"
 #include "CRC32.h"
 #include "mbedtls/error.h"
@@ -280,10 +281,13 @@ void PS4Driver::process(Gamepad * gamepad) {
         // HID ready + report sent, copy previous report
         if (tud_hid_ready() && tud_hid_report(0, report, report_size) == true ) {
             memcpy(last_report, report, report_size);
+            LATENCY_TRACE_QUEUED();
         }
         // keep track of our last successful report, for keepalive purposes
         last_report_timer = now;
     } else {
+        LATENCY_TRACE_UNCHANGED();
+
         // some games apparently can miss reports, or they rely on official behavior of getting frequent
         // updates. we normally only send a report when the value changes; if we increment the counters
         // every time we generate the report (every GP2040::run loop), we apparently overburden
@@ -1,5 +1,6 @@
 #include "drivers/xbone/XBOneDriver.h"
 #include "drivers/shared/driverhelper.h"
+#include "latencytracer.h"
 
 #include "drivers/xbone/XBOneAuth.h"
 #include "peripheralmanager.h"
@@ -310,7 +311,7 @@ bool xbone_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t result,
         TU_ASSERT(usbd_edpt_xfer(rhport, p_xbone->ep_out, p_xbone->epout_buf,
                                  sizeof(p_xbone->epout_buf)));
     } else if (ep_addr == p_xbone->ep_in) {
-        // Nothing needed
+        LATENCY_TRACE_COMPLETED();
     }
     return true;
 }
@@ -518,8 +519,11 @@ void XBOneDriver::process(Gamepad * gamepad) {
                 if (last_report_counter == 0)
                     last_report_counter = 1;
                 memcpy(last_report, &xboneReport, xboneReportSize);
+                LATENCY_TRACE_QUEUED();
             }
         }
+    } else {
+        LATENCY_TRACE_UNCHANGED();
     }
 }
 
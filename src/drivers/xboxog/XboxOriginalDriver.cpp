@@ -1,6 +1,7 @@
 #include "drivers/xboxog/XboxOriginalDriver.h"
 #include "drivers/xboxog/xid/xid.h"
 #include "drivers/shared/driverhelper.h"
+#include "latencytracer.h"
 
 void XboxOriginalDriver::initialize() {
     xboxOriginalReport = {
@@ -66,7 +67,10 @@ void XboxOriginalDriver::process(Gamepad * gamepad) {
 	if (memcmp(last_report, &xboxOriginalReport, sizeof(XboxOriginalReport)) != 0) {
         if ( xid_send_report(xIndex, &xboxOriginalReport, sizeof(XboxOriginalReport)) == true ) {
             memcpy(last_report, &xboxOriginalReport, sizeof(XboxOriginalReport));
+            LATENCY_TRACE_QUEUED();
         }
+    } else {
+        LATENCY_TRACE_UNCHANGED();
     }
 
     if (xid_get_report(xIndex, &xboxOriginalReportOut, sizeof(xboxOriginalReportOut)))
@@ -5,6 +5,7 @@
 
 #include "drivers/xinput/XInputDriver.h"
 #include "drivers/shared/driverhelper.h"
+#include "latencytracer.h"
 #include "storagemanager.h"
 
 #define USB_SETUP_DEVICE_TO_HOST 0x80
@@ -119,6 +120,8 @@ static bool xinput_xfer_callback(uint8_t rhport, uint8_t ep_addr, xfer_result_t
 
     if (ep_addr == endpoint_out)
         usbd_edpt_xfer(0, endpoint_out, xinput_out_buffer, XINPUT_OUT_SIZE);
+    else if (ep_addr == endpoint_in)
+        LATENCY_TRACE_COMPLETED();
 
     return true;
 }
@@ -226,7 +229,10 @@ void XInputDriver::process(Gamepad * gamepad) {
             usbd_edpt_xfer(0, endpoint_in, (uint8_t *)&xinputReport, sizeof(XInputReport)); // Send report buffer
             usbd_edpt_release(0, endpoint_in);								// Release control of IN endpoint
             memcpy(last_report, &xinputReport, sizeof(XInputReport)); // save if we sent it
+            LATENCY_TRACE_QUEUED();
         }
+    } else {
+        LATENCY_TRACE_UNCHANGED();
     }
 
     // clear potential initial uncaught data in endpoint_out from before registration of xfer_cb
@@ -2,36 +2,177 @@
 #include "storagemanager.h"
 #include "enums.pb.h"
 
+#include <new>
+
+#include "pico/platform.h"
+
+EventHandlerToken& EventHandlerToken::operator=(EventHandlerToken&& other) {
+    if (this != &other) {
+        release();
+        core = other.core;
+        eventType = other.eventType;
+        slot = other.slot;
+        generation = other.generation;
+        other.slot = EVENTMGR_MAX_HANDLERS;
+    }
+    return *this;
+}
+
+void EventHandlerToken::release() {
+    if (isRegistered()) {
+        EventManager::getInstance().unregisterEventHandler(core, eventType, slot, generation);
+        slot = EVENTMGR_MAX_HANDLERS;
+    }
+}
+
 void EventManager::init() {
     clearEventHandlers();
 }
 
-void EventManager::registerEventHandler(GPEventType eventType, EventFunction handler) {
-    typename std::vector<EventEntry>::iterator it = std::find_if(eventList.begin(), eventList.end(), [&eventType](const EventEntry& entry) { return entry.first == eventType; });
+EventHandlerToken EventManager::registerEventHandler(GPEventType eventType, EventFunction handler, uint32_t mask) {
+    if (eventType < 0 || eventType >= _GPEventType_ARRAYSIZE || !handler || mask == 0) return EventHandlerToken();
+
+    // each core only ever touches its own table, the other core reads no more than its count
+    uint8_t core = get_core_num();
+    EventHandlers& entry = eventHandlers[core][eventType];
+    for (uint8_t slot = 0; slot < EVENTMGR_MAX_HANDLERS; slot++) {
+        if (!entry.handlers[slot]) {
+            entry.handlers[slot] = handler;
+            entry.masks[slot] = mask;
+            entry.count++;
+            return EventHandlerToken(core, eventType, slot, entry.generations[slot]);
+        }
+    }
 
-    if (it != eventList.end()) {
-        // If the event already exists, add the handler to its vector
-        it->second.push_back(handler);
+    // all slots are taken
+    return EventHandlerToken();
+}
+
+void EventManager::unregisterEventHandler(uint8_t core, GPEventType eventType, uint8_t slot, uint16_t generation) {
+    if (core >= EVENTMGR_CORES || eventType < 0 || eventType >= _GPEventType_ARRAYSIZE || slot >= EVENTMGR_MAX_HANDLERS) return;
+
+    EventHandlers& entry = eventHandlers[core][eventType];
+    // the slot was cleared and maybe reused since this handler was registered
+    if (entry.generations[slot] != generation || !entry.handlers[slot] || (entry.released & (1 << slot))) return;
+
+    if (dispatchDepth[core] > 0) {
+        // the handler may be running right now, keep it until dispatch is over
+        entry.released |= (1 << slot);
+        entry.count--;
+        hasReleased[core] = true;
     } else {
-        // If the event does not exist, create a new entry with the handler
-        eventList.emplace_back(eventType, std::vector<EventFunction>{handler});
+        releaseSlot(core, eventType, slot);
+        entry.count--;
     }
 }
 
-void EventManager::triggerEvent(GPEvent* event) {
-    GPEventType eventType = event->eventType();
-    for (typename std::vector<EventEntry>::const_iterator it = eventList.begin(); it != eventList.end(); ++it) {
-        if (it->first == eventType) {
-            // Call all event handlers for the specified event
-            const std::vector<EventFunction>& handlers = it->second;
-            for (typename std::vector<EventFunction>::const_iterator handler = handlers.begin(); handler != handlers.end(); ++handler) {
-                (*handler)(event);
+void EventManager::releaseSlot(uint8_t core, GPEventType eventType, uint8_t slot) {
+    EventHandlers& entry = eventHandlers[core][eventType];
+    entry.handlers[slot] = nullptr;
+    entry.generations[slot]++;
+}
+
+void EventManager::triggerEvent(GPEvent& event) {
+    GPEventType eventType = event.eventType();
+    if (eventType < 0 || eventType >= _GPEventType_ARRAYSIZE) return;
+
+    uint8_t core = get_core_num();
+    if (eventHandlers[core ^ 1][eventType].count != 0) queueEvent(event, core ^ 1);
+    if (eventHandlers[core][eventType].count != 0) dispatch(event, core);
+}
+
+void EventManager::dispatch(GPEvent& event, uint8_t core) {
+    EventHandlers& entry = eventHandlers[core][event.eventType()];
+
+    // Call all event handlers of this core for the specified event that want it
+    uint32_t eventMask = event.eventMask();
+    dispatchDepth[core]++;
+    for (uint8_t slot = 0; slot < EVENTMGR_MAX_HANDLERS; slot++) {
+        if (entry.handlers[slot] && !(entry.released & (1 << slot)) && (entry.masks[slot] & eventMask)) {
+            entry.handlers[slot](&event);
+        }
+    }
+    dispatchDepth[core]--;
+
+    if (dispatchDepth[core] == 0 && hasReleased[core]) {
+        hasReleased[core] = false;
+        for (uint8_t type = 0; type < _GPEventType_ARRAYSIZE; type++) {
+            EventHandlers& releasedEntry = eventHandlers[core][type];
+            for (uint8_t slot = 0; slot < EVENTMGR_MAX_HANDLERS; slot++) {
+                if (releasedEntry.released & (1 << slot)) releaseSlot(core, (GPEventType)type, slot);
             }
+            releasedEntry.released = 0;
         }
     }
-    delete event;
+}
+
+template <typename T>
+static GPEvent* copyEvent(GPEvent& event, void* storage) {
+    static_assert(sizeof(T) <= EVENTMGR_QUEUED_EVENT_SIZE, "event does not fit EVENTMGR_QUEUED_EVENT_SIZE");
+    return new (storage) T(static_cast<T&>(event));
+}
+
+void EventManager::queueEvent(GPEvent& event, uint8_t core) {
+    QueuedEvent* queued = queues[core].reserve();
+    if (queued == nullptr) {
+        droppedEvents[core]++;
+        return;
+    }
+
+    // Events only hold plain values, a copy is all the other core needs
+    GPEvent* copy = nullptr;
+    switch (event.eventType()) {
+        case GP_EVENT_RESTART: copy = copyEvent<GPRestartEvent>(event, queued->storage); break;
+        case GP_EVENT_USBHOST_MOUNT: copy = copyEvent<GPUSBHostMountEvent>(event, queued->storage); break;
+        case GP_EVENT_USBHOST_UNMOUNT: copy = copyEvent<GPUSBHostUnmountEvent>(event, queued->storage); break;
+        case GP_EVENT_PROFILE_CHANGE: copy = copyEvent<GPProfileChangeEvent>(event, queued->storage); break;
+        case GP_EVENT_ENCODER_CHANGE: copy = copyEvent<GPEncoderChangeEvent>(event, queued->storage); break;
+        case GP_EVENT_STORAGE_SAVE: copy = copyEvent<GPStorageSaveEvent>(event, queued->storage); break;
+        case GP_EVENT_SYSTEM_REBOOT: copy = copyEvent<GPSystemRebootEvent>(event, queued->storage); break;
+        case GP_EVENT_MENU_NAVIGATE: copy = copyEvent<GPMenuNavigateEvent>(event, queued->storage); break;
+        case GP_EVENT_INPUT_FRAME: copy = copyEvent<GPInputFrameEvent>(event, queued->storage); break;
+        default: break;
+    }
+
+    // the dispatch on the other side finds the event at the start of the slot
+    if (copy != nullptr && (void*)copy == (void*)queued->storage) queues[core].publish();
+}
+
+void EventManager::processQueuedEvents() {
+    uint8_t core = get_core_num();
+    const QueuedEvent* queued;
+    while ((queued = queues[core].peek()) != nullptr) {
+        GPEvent* event = std::launder(reinterpret_cast<GPEvent*>(const_cast<uint8_t*>(queued->storage)));
+        if (eventHandlers[core][event->eventType()].count != 0) dispatch(*event, core);
+        queues[core].consume();
+    }
+}
+
+uint8_t EventManager::getHandlerCount(GPEventType eventType) const {
+    if (eventType < 0 || eventType >= _GPEventType_ARRAYSIZE) return 0;
+
+    return eventHandlers[0][eventType].count + eventHandlers[1][eventType].count;
 }
 
 void EventManager::clearEventHandlers() {
+    for (uint8_t core = 0; core < EVENTMGR_CORES; core++) {
+        for (uint8_t type = 0; type < _GPEventType_ARRAYSIZE; type++) {
+            EventHandlers& entry = eventHandlers[core][type];
+            for (uint8_t slot = 0; slot < EVENTMGR_MAX_HANDLERS; slot++) {
+                if (!entry.handlers[slot]) continue;
 
+                // a running handler is freed once dispatch is over, outstanding tokens no longer match either way
+                if (dispatchDepth[core] > 0) {
+                    if (!(entry.released & (1 << slot))) {
+                        entry.released |= (1 << slot);
+                        hasReleased[core] = true;
+                    }
+                    entry.generations[slot]++;
+                } else {
+                    releaseSlot(core, (GPEventType)type, slot);
+                }
+            }
+            entry.count = 0;
+        }
+    }
 }
@@ -0,0 +1,61 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#include "framecontext.h"
+
+#include "drivermanager.h"
+#include "gamepad.h"
+#include "storagemanager.h"
+
+FrameContext FrameContext::context;
+Mask_t FrameContext::addonGpios = 0;
+Mask_t FrameContext::addonEagerGpios = 0;
+
+// Usable before the first pass: boot code and add-on setup may run the pipeline once before GP2040::run
+FrameContext::FrameContext() :
+	frame(0)
+	, micros(0)
+	, millis(0)
+	, joystickMid(GAMEPAD_JOYSTICK_MID)
+	, socdMode(SOCD_MODE_NEUTRAL)
+	, profileNumber(1)
+	, rawGpio(0)
+	, debouncedGpio(0)
+{
+}
+
+void FrameContext::capture()
+{
+	context.frame++;
+	context.micros = getMicro();
+	context.millis = context.micros / 1000;
+
+	GPDriver * driver = DriverManager::getInstance().getDriver();
+	context.joystickMid = (driver != nullptr) ? driver->GetJoystickMidValue() : GAMEPAD_JOYSTICK_MID;
+
+	refreshOptions();
+}
+
+void FrameContext::captureGpio(Mask_t raw, Mask_t debounced)
+{
+	context.rawGpio = raw;
+	context.debouncedGpio = debounced;
+}
+
+void FrameContext::refreshOptions()
+{
+	const GamepadOptions & options = Storage::getInstance().getGamepadOptions();
+	context.socdMode = Gamepad::resolveSOCDMode(options);
+	context.profileNumber = options.profileNumber;
+}
+
+void FrameContext::addDebounceGpios(Mask_t pins, DebounceMode mode)
+{
+	addonGpios |= pins;
+	if (mode == DEBOUNCE_MODE_EAGER_PRESS)
+		addonEagerGpios |= pins;
+	else
+		addonEagerGpios &= ~pins;
+}
@@ -0,0 +1,79 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#include "framescheduler.h"
+
+#include "pico/time.h"
+#include "hardware/timer.h"
+#include "hardware/structs/usb.h"
+
+// How long past the expected SOF to keep looking before giving up on the lock
+#define FRAME_SCHEDULER_SOF_SLACK_US 100
+
+static inline uint16_t readFrameNumber() {
+	return usb_hw->sof_rd & USB_SOF_RD_BITS;
+}
+
+FrameScheduler::FrameScheduler() :
+	lead(FRAME_SCHEDULER_MIN_LEAD_US),
+	lastSof(0),
+	overruns(0),
+	latchFrame(0),
+	locked(false)
+{
+}
+
+void FrameScheduler::setLead(uint32_t leadUs) {
+	if (leadUs < FRAME_SCHEDULER_MIN_LEAD_US) leadUs = FRAME_SCHEDULER_MIN_LEAD_US;
+	if (leadUs > FRAME_SCHEDULER_MAX_LEAD_US) leadUs = FRAME_SCHEDULER_MAX_LEAD_US;
+	lead = leadUs;
+}
+
+void FrameScheduler::sofObserved(uint32_t now) {
+	lastSof = now;
+	locked = true;
+}
+
+void FrameScheduler::waitForLatch() {
+	if (locked) {
+		int32_t remaining = (int32_t)(latchTime() - time_us_32());
+		if (remaining > 0) {
+			sleep_us(remaining);
+		} else if ((int32_t)(lastSof + FRAME_SCHEDULER_FRAME_US - time_us_32()) <= 0) {
+			// the rest of the loop ran past the SOF we were latching for
+			overruns++;
+			unlock();
+		}
+	}
+
+	latchFrame = readFrameNumber();
+}
+
+void FrameScheduler::syncToFrame() {
+	uint32_t deadline = time_us_32() + FRAME_SCHEDULER_FRAME_US + FRAME_SCHEDULER_SOF_SLACK_US;
+
+	if (locked && readFrameNumber() != latchFrame) {
+		// pipeline took longer than the lead, the report missed this frame's poll
+		overruns++;
+		unlock();
+	}
+
+	if (locked) {
+		deadline = lastSof + FRAME_SCHEDULER_FRAME_US + FRAME_SCHEDULER_SOF_SLACK_US;
+	} else {
+		// only an edge seen from here on gives an accurate phase
+		latchFrame = readFrameNumber();
+	}
+
+	while (readFrameNumber() == latchFrame) {
+		if ((int32_t)(time_us_32() - deadline) > 0) {
+			// no SOF (suspended, disconnected), free run until the next sync finds one
+			unlock();
+			return;
+		}
+	}
+
+	sofObserved(time_us_32());
+}
@@ -13,6 +13,7 @@
 #include "CRC32.h"
 
 #include "drivermanager.h"
+#include "framecontext.h"
 #include "storagemanager.h"
 #include "system.h"
 
@@ -28,62 +29,117 @@ uint64_t getMicro() {
 Gamepad::Gamepad() :
 	options(Storage::getInstance().getGamepadOptions())
 	, hotkeyOptions(Storage::getInstance().getHotkeyOptions())
-{}
+	, buttonMappings{
+		GAMEPAD_MASK_UP,
+		GAMEPAD_MASK_DOWN,
+		GAMEPAD_MASK_LEFT,
+		GAMEPAD_MASK_RIGHT,
+		GAMEPAD_MASK_B1,
+		GAMEPAD_MASK_B2,
+		GAMEPAD_MASK_B3,
+		GAMEPAD_MASK_B4,
+		GAMEPAD_MASK_L1,
+		GAMEPAD_MASK_R1,
+		GAMEPAD_MASK_L2,
+		GAMEPAD_MASK_R2,
+		GAMEPAD_MASK_S1,
+		GAMEPAD_MASK_S2,
+		GAMEPAD_MASK_L3,
+		GAMEPAD_MASK_R3,
+		GAMEPAD_MASK_A1,
+		GAMEPAD_MASK_A2,
+		GAMEPAD_MASK_A3,
+		GAMEPAD_MASK_A4,
+		GAMEPAD_MASK_E1,
+		GAMEPAD_MASK_E2,
+		GAMEPAD_MASK_E3,
+		GAMEPAD_MASK_E4,
+		GAMEPAD_MASK_E5,
+		GAMEPAD_MASK_E6,
+		GAMEPAD_MASK_E7,
+		GAMEPAD_MASK_E8,
+		GAMEPAD_MASK_E9,
+		GAMEPAD_MASK_E10,
+		GAMEPAD_MASK_E11,
+		GAMEPAD_MASK_E12,
+		AUX_MASK_FUNCTION,
+		SUSTAIN_DP_MODE_DP,
+		SUSTAIN_DP_MODE_LS,
+		SUSTAIN_DP_MODE_RS,
+		GAMEPAD_MASK_UP,
+		GAMEPAD_MASK_DOWN,
+		GAMEPAD_MASK_LEFT,
+		GAMEPAD_MASK_RIGHT,
+		ANALOG_DIRECTION_LS_X_NEG,
+		ANALOG_DIRECTION_LS_X_POS,
+		ANALOG_DIRECTION_LS_Y_NEG,
+		ANALOG_DIRECTION_LS_Y_POS,
+		ANALOG_DIRECTION_RS_X_NEG,
+		ANALOG_DIRECTION_RS_X_POS,
+		ANALOG_DIRECTION_RS_Y_NEG,
+		ANALOG_DIRECTION_RS_Y_POS,
+		SUSTAIN_4_8_WAY_MODE
+	}
+{
+	GamepadButtonMapping * mapping = buttonMappings;
+	mapDpadUp       = mapping++;
+	mapDpadDown     = mapping++;
+	mapDpadLeft     = mapping++;
+	mapDpadRight    = mapping++;
+	mapButtonB1     = mapping++;
+	mapButtonB2     = mapping++;
+	mapButtonB3     = mapping++;
+	mapButtonB4     = mapping++;
+	mapButtonL1     = mapping++;
+	mapButtonR1     = mapping++;
+	mapButtonL2     = mapping++;
+	mapButtonR2     = mapping++;
+	mapButtonS1     = mapping++;
+	mapButtonS2     = mapping++;
+	mapButtonL3     = mapping++;
+	mapButtonR3     = mapping++;
+	mapButtonA1     = mapping++;
+	mapButtonA2     = mapping++;
+	mapButtonA3     = mapping++;
+	mapButtonA4     = mapping++;
+	mapButtonE1     = mapping++;
+	mapButtonE2     = mapping++;
+	mapButtonE3     = mapping++;
+	mapButtonE4     = mapping++;
+	mapButtonE5     = mapping++;
+	mapButtonE6     = mapping++;
+	mapButtonE7     = mapping++;
+	mapButtonE8     = mapping++;
+	mapButtonE9     = mapping++;
+	mapButtonE10    = mapping++;
+	mapButtonE11    = mapping++;
+	mapButtonE12    = mapping++;
+	mapButtonFn     = mapping++;
+	mapButtonDP     = mapping++;
+	mapButtonLS     = mapping++;
+	mapButtonRS     = mapping++;
+	mapDigitalUp    = mapping++;
+	mapDigitalDown  = mapping++;
+	mapDigitalLeft  = mapping++;
+	mapDigitalRight = mapping++;
+	mapAnalogLSXNeg = mapping++;
+	mapAnalogLSXPos = mapping++;
+	mapAnalogLSYNeg = mapping++;
+	mapAnalogLSYPos = mapping++;
+	mapAnalogRSXNeg = mapping++;
+	mapAnalogRSXPos = mapping++;
+	mapAnalogRSYNeg = mapping++;
+	mapAnalogRSYPos = mapping++;
+	map48WayMode    = mapping++;
+}
 
 void Gamepad::setup()
 {
 	// Configure pin mapping
 	GpioMappingInfo* pinMappings = Storage::getInstance().getProfilePinMappings();
 
-	mapDpadUp       = new GamepadButtonMapping(GAMEPAD_MASK_UP);
-	mapDpadDown     = new GamepadButtonMapping(GAMEPAD_MASK_DOWN);
-	mapDpadLeft     = new GamepadButtonMapping(GAMEPAD_MASK_LEFT);
-	mapDpadRight    = new GamepadButtonMapping(GAMEPAD_MASK_RIGHT);
-	mapButtonB1     = new GamepadButtonMapping(GAMEPAD_MASK_B1);
-	mapButtonB2     = new GamepadButtonMapping(GAMEPAD_MASK_B2);
-	mapButtonB3     = new GamepadButtonMapping(GAMEPAD_MASK_B3);
-	mapButtonB4     = new GamepadButtonMapping(GAMEPAD_MASK_B4);
-	mapButtonL1     = new GamepadButtonMapping(GAMEPAD_MASK_L1);
-	mapButtonR1     = new GamepadButtonMapping(GAMEPAD_MASK_R1);
-	mapButtonL2     = new GamepadButtonMapping(GAMEPAD_MASK_L2);
-	mapButtonR2     = new GamepadButtonMapping(GAMEPAD_MASK_R2);
-	mapButtonS1     = new GamepadButtonMapping(GAMEPAD_MASK_S1);
-	mapButtonS2     = new GamepadButtonMapping(GAMEPAD_MASK_S2);
-	mapButtonL3     = new GamepadButtonMapping(GAMEPAD_MASK_L3);
-	mapButtonR3     = new GamepadButtonMapping(GAMEPAD_MASK_R3);
-	mapButtonA1     = new GamepadButtonMapping(GAMEPAD_MASK_A1);
-	mapButtonA2     = new GamepadButtonMapping(GAMEPAD_MASK_A2);
-	mapButtonA3     = new GamepadButtonMapping(GAMEPAD_MASK_A3);
-	mapButtonA4     = new GamepadButtonMapping(GAMEPAD_MASK_A4);
-	mapButtonE1     = new GamepadButtonMapping(GAMEPAD_MASK_E1);
-	mapButtonE2     = new GamepadButtonMapping(GAMEPAD_MASK_E2);
-	mapButtonE3     = new GamepadButtonMapping(GAMEPAD_MASK_E3);
-	mapButtonE4     = new GamepadButtonMapping(GAMEPAD_MASK_E4);
-	mapButtonE5     = new GamepadButtonMapping(GAMEPAD_MASK_E5);
-	mapButtonE6     = new GamepadButtonMapping(GAMEPAD_MASK_E6);
-	mapButtonE7     = new GamepadButtonMapping(GAMEPAD_MASK_E7);
-	mapButtonE8     = new GamepadButtonMapping(GAMEPAD_MASK_E8);
-	mapButtonE9     = new GamepadButtonMapping(GAMEPAD_MASK_E9);
-	mapButtonE10    = new GamepadButtonMapping(GAMEPAD_MASK_E10);
-	mapButtonE11    = new GamepadButtonMapping(GAMEPAD_MASK_E11);
-	mapButtonE12    = new GamepadButtonMapping(GAMEPAD_MASK_E12);
-	mapButtonFn     = new GamepadButtonMapping(AUX_MASK_FUNCTION);
-	mapButtonDP     = new GamepadButtonMapping(SUSTAIN_DP_MODE_DP);
-	mapButtonLS     = new GamepadButtonMapping(SUSTAIN_DP_MODE_LS);
-	mapButtonRS     = new GamepadButtonMapping(SUSTAIN_DP_MODE_RS);
-	mapDigitalUp    = new GamepadButtonMapping(GAMEPAD_MASK_UP);
-	mapDigitalDown  = new GamepadButtonMapping(GAMEPAD_MASK_DOWN);
-	mapDigitalLeft  = new GamepadButtonMapping(GAMEPAD_MASK_LEFT);
-	mapDigitalRight = new GamepadButtonMapping(GAMEPAD_MASK_RIGHT);
-	mapAnalogLSXNeg = new GamepadButtonMapping(ANALOG_DIRECTION_LS_X_NEG);
-	mapAnalogLSXPos = new GamepadButtonMapping(ANALOG_DIRECTION_LS_X_POS);
-	mapAnalogLSYNeg = new GamepadButtonMapping(ANALOG_DIRECTION_LS_Y_NEG);
-	mapAnalogLSYPos = new GamepadButtonMapping(ANALOG_DIRECTION_LS_Y_POS);
-	mapAnalogRSXNeg = new GamepadButtonMapping(ANALOG_DIRECTION_RS_X_NEG);
-	mapAnalogRSXPos = new GamepadButtonMapping(ANALOG_DIRECTION_RS_X_POS);
-	mapAnalogRSYNeg = new GamepadButtonMapping(ANALOG_DIRECTION_RS_Y_NEG);
-	mapAnalogRSYPos = new GamepadButtonMapping(ANALOG_DIRECTION_RS_Y_POS);
-	map48WayMode    = new GamepadButtonMapping(SUSTAIN_4_8_WAY_MODE);
+	for (GamepadButtonMapping & mapping : buttonMappings)
+		mapping.pinMask = 0;
 
 	const auto assignCustomMappingToMaps = [&](GpioMappingInfo mapInfo, Pin_t pin) -> void {
 		if (mapDpadUp->buttonMask & mapInfo.customDpadMask)	mapDpadUp->pinMask |= 1 << pin;
@@ -167,64 +223,17 @@ void Gamepad::setup()
 		}
 	}
 
+	// compile the mappings into the tables read() looks the debounced pins up in
+	if (mappingPlan == nullptr)
+		mappingPlan = new GamepadMappingPlan();
+	mappingPlan->compile(*this);
 }
 
 /**
- * @brief Undo setup().
+ * @brief Rebuild the pin mappings for the current profile.
  */
 void Gamepad::reinit()
 {
-	delete mapDpadUp;
-	delete mapDpadDown;
-	delete mapDpadLeft;
-	delete mapDpadRight;
-	delete mapButtonB1;
-	delete mapButtonB2;
-	delete mapButtonB3;
-	delete mapButtonB4;
-	delete mapButtonL1;
-	delete mapButtonR1;
-	delete mapButtonL2;
-	delete mapButtonR2;
-	delete mapButtonS1;
-	delete mapButtonS2;
-	delete mapButtonL3;
-	delete mapButtonR3;
-	delete mapButtonA1;
-	delete mapButtonA2;
-	delete mapButtonA3;
-	delete mapButtonA4;
-	delete mapButtonE1;
-	delete mapButtonE2;
-	delete mapButtonE3;
-	delete mapButtonE4;
-	delete mapButtonE5;
-	delete mapButtonE6;
-	delete mapButtonE7;
-	delete mapButtonE8;
-	delete mapButtonE9;
-	delete mapButtonE10;
-	delete mapButtonE11;
-	delete mapButtonE12;
-	delete mapButtonFn;
-	delete mapButtonDP;
-	delete mapButtonLS;
-	delete mapButtonRS;
-	delete mapDigitalUp;
-	delete mapDigitalDown;
-	delete mapDigitalLeft;
-	delete mapDigitalRight;
-	delete mapAnalogLSXNeg;
-	delete mapAnalogLSXPos;
-	delete mapAnalogLSYNeg;
-	delete mapAnalogLSYPos;
-	delete mapAnalogRSXNeg;
-	delete mapAnalogRSXPos;
-	delete mapAnalogRSYNeg;
-	delete mapAnalogRSYPos;
-	delete map48WayMode;
-
-	// reinitialize pin mappings
 	this->setup();
 }
 
@@ -233,10 +242,8 @@ void Gamepad::process()
 	memcpy(&rawState, &state, sizeof(GamepadState));
 
 	// Get the midpoint value for the current mode
-	uint16_t joystickMid = GAMEPAD_JOYSTICK_MID;
-	if ( DriverManager::getInstance().getDriver() != nullptr ) {
-		joystickMid = DriverManager::getInstance().getDriver()->GetJoystickMidValue();
-	}
+	const FrameContext & frame = FrameContext::current();
+	uint16_t joystickMid = frame.joystickMid;
 
 	// NOTE: Inverted X/Y-axis must run before SOCD and Dpad processing
 	if (options.invertXAxis) {
@@ -261,13 +268,13 @@ void Gamepad::process()
 
 	// 4-way before SOCD, might have better history without losing any coherent functionality
 	if (options.fourWayMode ^ map48WayModeToggle) {
-		state.dpad = filterToFourWayMode(state.dpad);
+		state.dpad = dpadResolver.filterToFourWayMode(state.dpad);
 	}
 
 	uint8_t dpadCheck = state.dpad;
 	uint8_t dpadOnlyMask = 0;
 	uint8_t dpadModeMask = 0;
-	state.dpad = runSOCDCleaner(resolveSOCDMode(options), state.dpad);
+	state.dpad = dpadResolver.runSOCDCleaner(frame.socdMode, state.dpad);
 	dpadOnlyMask = ((dpadCheck & 0xF0) >> 4);
 
 	switch (activeDpadMode)
@@ -312,89 +319,48 @@ void Gamepad::read()
 	Mask_t values = Storage::getInstance().GetGamepad()->debouncedGpio;
 
 	// Get the midpoint value for the current mode
-	uint16_t joystickMid = GAMEPAD_JOYSTICK_MID;
-	if ( DriverManager::getInstance().getDriver() != nullptr ) {
-		joystickMid = DriverManager::getInstance().getDriver()->GetJoystickMidValue();
-	}
+	const FrameContext & frame = FrameContext::current();
+	uint16_t joystickMid = frame.joystickMid;
+
+	const GamepadMappingEntry mapped = mappingPlan->lookup(values);
 
-	state.aux = 0
-		| (values & mapButtonFn->pinMask)   ? mapButtonFn->buttonMask : 0;
-
-	state.dpad = 0
-		| ((values & mapDpadUp->pinMask)       ? mapDpadUp->buttonMask                                              : 0)
-		| ((values & mapDpadDown->pinMask)     ? mapDpadDown->buttonMask                                            : 0)
-		| ((values & mapDpadLeft->pinMask)     ? mapDpadLeft->buttonMask                                            : 0)
-		| ((values & mapDpadRight->pinMask)    ? mapDpadRight->buttonMask                                           : 0)
-		| ((values & mapDigitalUp->pinMask)    ? (mapDigitalUp->buttonMask) | (mapDigitalUp->buttonMask << 4)       : 0)
-		| ((values & mapDigitalDown->pinMask)  ? (mapDigitalDown->buttonMask) | (mapDigitalDown->buttonMask << 4)   : 0)
-		| ((values & mapDigitalLeft->pinMask)  ? (mapDigitalLeft->buttonMask) | (mapDigitalLeft->buttonMask << 4)   : 0)
-		| ((values & mapDigitalRight->pinMask) ? (mapDigitalRight->buttonMask) | (mapDigitalRight->buttonMask << 4) : 0)
-	;
-
-	state.buttons = 0
-		| ((values & mapButtonB1->pinMask)  ? mapButtonB1->buttonMask  : 0)
-		| ((values & mapButtonB2->pinMask)  ? mapButtonB2->buttonMask  : 0)
-		| ((values & mapButtonB3->pinMask)  ? mapButtonB3->buttonMask  : 0)
-		| ((values & mapButtonB4->pinMask)  ? mapButtonB4->buttonMask  : 0)
-		| ((values & mapButtonL1->pinMask)  ? mapButtonL1->buttonMask  : 0)
-		| ((values & mapButtonR1->pinMask)  ? mapButtonR1->buttonMask  : 0)
-		| ((values & mapButtonL2->pinMask)  ? mapButtonL2->buttonMask  : 0)
-		| ((values & mapButtonR2->pinMask)  ? mapButtonR2->buttonMask  : 0)
-		| ((values & mapButtonS1->pinMask)  ? mapButtonS1->buttonMask  : 0)
-		| ((values & mapButtonS2->pinMask)  ? mapButtonS2->buttonMask  : 0)
-		| ((values & mapButtonL3->pinMask)  ? mapButtonL3->buttonMask  : 0)
-		| ((values & mapButtonR3->pinMask)  ? mapButtonR3->buttonMask  : 0)
-		| ((values & mapButtonA1->pinMask)  ? mapButtonA1->buttonMask  : 0)
-		| ((values & mapButtonA2->pinMask)  ? mapButtonA2->buttonMask  : 0)
-		| ((values & mapButtonA3->pinMask)  ? mapButtonA3->buttonMask  : 0)
-		| ((values & mapButtonA4->pinMask)  ? mapButtonA4->buttonMask  : 0)
-		| ((values & mapButtonE1->pinMask)  ? mapButtonE1->buttonMask  : 0)
-		| ((values & mapButtonE2->pinMask)  ? mapButtonE2->buttonMask  : 0)
-		| ((values & mapButtonE3->pinMask)  ? mapButtonE3->buttonMask  : 0)
-		| ((values & mapButtonE4->pinMask)  ? mapButtonE4->buttonMask  : 0)
-		| ((values & mapButtonE5->pinMask)  ? mapButtonE5->buttonMask  : 0)
-		| ((values & mapButtonE6->pinMask)  ? mapButtonE6->buttonMask  : 0)
-		| ((values & mapButtonE7->pinMask)  ? mapButtonE7->buttonMask  : 0)
-		| ((values & mapButtonE8->pinMask)  ? mapButtonE8->buttonMask  : 0)
-		| ((values & mapButtonE9->pinMask)  ? mapButtonE9->buttonMask  : 0)
-		| ((values & mapButtonE10->pinMask) ? mapButtonE10->buttonMask : 0)
-		| ((values & mapButtonE11->pinMask) ? mapButtonE11->buttonMask : 0)
-		| ((values & mapButtonE12->pinMask) ? mapButtonE12->buttonMask : 0)
-	;
+	state.aux = (mapped.flags & GAMEPAD_MAPPING_FUNCTION) ? mapButtonFn->buttonMask : 0;
+	state.dpad = mapped.dpad;
+	state.buttons = mapped.buttons;
 
 	// set the effective dpad mode based on settings + overrides
-	if (values & mapButtonDP->pinMask)	activeDpadMode = DpadMode::DPAD_MODE_DIGITAL;
-	else if (values & mapButtonLS->pinMask)	activeDpadMode = DpadMode::DPAD_MODE_LEFT_ANALOG;
-	else if (values & mapButtonRS->pinMask)	activeDpadMode = DpadMode::DPAD_MODE_RIGHT_ANALOG;
-	else					activeDpadMode = options.dpadMode;
+	if (mapped.flags & GAMEPAD_MAPPING_DP_MODE_DP)		activeDpadMode = DpadMode::DPAD_MODE_DIGITAL;
+	else if (mapped.flags & GAMEPAD_MAPPING_DP_MODE_LS)	activeDpadMode = DpadMode::DPAD_MODE_LEFT_ANALOG;
+	else if (mapped.flags & GAMEPAD_MAPPING_DP_MODE_RS)	activeDpadMode = DpadMode::DPAD_MODE_RIGHT_ANALOG;
+	else							activeDpadMode = options.dpadMode;
 
-	map48WayModeToggle = (values & map48WayMode->pinMask);
+	map48WayModeToggle = (mapped.flags & GAMEPAD_MAPPING_4_8_WAY_MODE);
 
-	if (values & mapAnalogLSXNeg->pinMask) {
+	if (mapped.flags & GAMEPAD_MAPPING_LS_X_NEG) {
 		state.lx = GAMEPAD_JOYSTICK_MIN;
-	} else if (values & mapAnalogLSXPos->pinMask) {
+	} else if (mapped.flags & GAMEPAD_MAPPING_LS_X_POS) {
 		state.lx = GAMEPAD_JOYSTICK_MAX;
 	} else {
 		state.lx = joystickMid;
 	}
-	if (values & mapAnalogLSYNeg->pinMask) {
+	if (mapped.flags & GAMEPAD_MAPPING_LS_Y_NEG) {
 		state.ly = GAMEPAD_JOYSTICK_MIN;
-	} else if (values & mapAnalogLSYPos->pinMask) {
+	} else if (mapped.flags & GAMEPAD_MAPPING_LS_Y_POS) {
 		state.ly = GAMEPAD_JOYSTICK_MAX;
 	} else {
 		state.ly = joystickMid;
 	}
 
-	if (values & mapAnalogRSXNeg->pinMask) {
+	if (mapped.flags & GAMEPAD_MAPPING_RS_X_NEG) {
 		state.rx = GAMEPAD_JOYSTICK_MIN;
-	} else if (values & mapAnalogRSXPos->pinMask) {
+	} else if (mapped.flags & GAMEPAD_MAPPING_RS_X_POS) {
 		state.rx = GAMEPAD_JOYSTICK_MAX;
 	} else {
 		state.rx = joystickMid;
 	}
-	if (values & mapAnalogRSYNeg->pinMask) {
+	if (mapped.flags & GAMEPAD_MAPPING_RS_Y_NEG) {
 		state.ry = GAMEPAD_JOYSTICK_MIN;
-	} else if (values & mapAnalogRSYPos->pinMask) {
+	} else if (mapped.flags & GAMEPAD_MAPPING_RS_Y_POS) {
 		state.ry = GAMEPAD_JOYSTICK_MAX;
 	} else {
 		state.ry = joystickMid;
@@ -658,37 +624,37 @@ void Gamepad::processHotkeyAction(GamepadHotkey action) {
 			break;
 		case HOTKEY_MENU_NAV_UP:
 			if (action != lastAction) {
-                EventManager::getInstance().triggerEvent(new GPMenuNavigateEvent(GpioAction::MENU_NAVIGATION_UP));
+                EventManager::getInstance().triggerEvent(GPMenuNavigateEvent(GpioAction::MENU_NAVIGATION_UP));
             }
 			break;
 		case HOTKEY_MENU_NAV_DOWN:
 			if (action != lastAction) {
-                EventManager::getInstance().triggerEvent(new GPMenuNavigateEvent(GpioAction::MENU_NAVIGATION_DOWN));
+                EventManager::getInstance().triggerEvent(GPMenuNavigateEvent(GpioAction::MENU_NAVIGATION_DOWN));
             }
 			break;
 		case HOTKEY_MENU_NAV_LEFT:
 			if (action != lastAction) {
-                EventManager::getInstance().triggerEvent(new GPMenuNavigateEvent(GpioAction::MENU_NAVIGATION_LEFT));
+                EventManager::getInstance().triggerEvent(GPMenuNavigateEvent(GpioAction::MENU_NAVIGATION_LEFT));
             }
 			break;
 		case HOTKEY_MENU_NAV_RIGHT:
 			if (action != lastAction) {
-                EventManager::getInstance().triggerEvent(new GPMenuNavigateEvent(GpioAction::MENU_NAVIGATION_RIGHT));
+                EventManager::getInstance().triggerEvent(GPMenuNavigateEvent(GpioAction::MENU_NAVIGATION_RIGHT));
             }
 			break;
 		case HOTKEY_MENU_NAV_SELECT:
 			if (action != lastAction) {
-                EventManager::getInstance().triggerEvent(new GPMenuNavigateEvent(GpioAction::MENU_NAVIGATION_SELECT));
+                EventManager::getInstance().triggerEvent(GPMenuNavigateEvent(GpioAction::MENU_NAVIGATION_SELECT));
             }
 			break;
 		case HOTKEY_MENU_NAV_BACK:
 			if (action != lastAction) {
-                EventManager::getInstance().triggerEvent(new GPMenuNavigateEvent(GpioAction::MENU_NAVIGATION_BACK));
+                EventManager::getInstance().triggerEvent(GPMenuNavigateEvent(GpioAction::MENU_NAVIGATION_BACK));
             }
 			break;
 		case HOTKEY_MENU_NAV_TOGGLE:
 			if (action != lastAction) {
-				EventManager::getInstance().triggerEvent(new GPMenuNavigateEvent(GpioAction::MENU_NAVIGATION_TOGGLE));
+				EventManager::getInstance().triggerEvent(GPMenuNavigateEvent(GpioAction::MENU_NAVIGATION_TOGGLE));
 			}
 			break;
 		default: // Unknown action
@@ -697,6 +663,8 @@ void Gamepad::processHotkeyAction(GamepadHotkey action) {
 
 	// only save if requested
 	if (reqSave) {
-		EventManager::getInstance().triggerEvent(new GPStorageSaveEvent(true));
+		// the rest of this pass (process) runs with the new options
+		FrameContext::refreshOptions();
+		EventManager::getInstance().triggerEvent(GPStorageSaveEvent(true));
 	}
 }
@@ -0,0 +1,98 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#include "GamepadMapping.h"
+#include "gamepad.h"
+
+#include <string.h>
+
+GamepadMappingPlan::GamepadMappingPlan()
+{
+	clear();
+}
+
+void GamepadMappingPlan::clear()
+{
+	memset(luts, 0, sizeof(luts));
+}
+
+void GamepadMappingPlan::compile(const Gamepad & gamepad)
+{
+	clear();
+
+	for (const GamepadButtonMapping * map : {
+			gamepad.mapDpadUp, gamepad.mapDpadDown, gamepad.mapDpadLeft, gamepad.mapDpadRight })
+		addDpad(map->pinMask, map->buttonMask);
+
+	// digital directions also set the dpad-only bits
+	for (const GamepadButtonMapping * map : {
+			gamepad.mapDigitalUp, gamepad.mapDigitalDown, gamepad.mapDigitalLeft, gamepad.mapDigitalRight })
+		addDpad(map->pinMask, map->buttonMask | (map->buttonMask << 4));
+
+	for (const GamepadButtonMapping * map : {
+			gamepad.mapButtonB1, gamepad.mapButtonB2, gamepad.mapButtonB3, gamepad.mapButtonB4,
+			gamepad.mapButtonL1, gamepad.mapButtonR1, gamepad.mapButtonL2, gamepad.mapButtonR2,
+			gamepad.mapButtonS1, gamepad.mapButtonS2, gamepad.mapButtonL3, gamepad.mapButtonR3,
+			gamepad.mapButtonA1, gamepad.mapButtonA2, gamepad.mapButtonA3, gamepad.mapButtonA4,
+			gamepad.mapButtonE1, gamepad.mapButtonE2, gamepad.mapButtonE3, gamepad.mapButtonE4,
+			gamepad.mapButtonE5, gamepad.mapButtonE6, gamepad.mapButtonE7, gamepad.mapButtonE8,
+			gamepad.mapButtonE9, gamepad.mapButtonE10, gamepad.mapButtonE11, gamepad.mapButtonE12 })
+		addButtons(map->pinMask, map->buttonMask);
+
+	addFlags(gamepad.mapButtonFn->pinMask,     GAMEPAD_MAPPING_FUNCTION);
+	addFlags(gamepad.mapButtonDP->pinMask,     GAMEPAD_MAPPING_DP_MODE_DP);
+	addFlags(gamepad.mapButtonLS->pinMask,     GAMEPAD_MAPPING_DP_MODE_LS);
+	addFlags(gamepad.mapButtonRS->pinMask,     GAMEPAD_MAPPING_DP_MODE_RS);
+	addFlags(gamepad.map48WayMode->pinMask,    GAMEPAD_MAPPING_4_8_WAY_MODE);
+	addFlags(gamepad.mapAnalogLSXNeg->pinMask, GAMEPAD_MAPPING_LS_X_NEG);
+	addFlags(gamepad.mapAnalogLSXPos->pinMask, GAMEPAD_MAPPING_LS_X_POS);
+	addFlags(gamepad.mapAnalogLSYNeg->pinMask, GAMEPAD_MAPPING_LS_Y_NEG);
+	addFlags(gamepad.mapAnalogLSYPos->pinMask, GAMEPAD_MAPPING_LS_Y_POS);
+	addFlags(gamepad.mapAnalogRSXNeg->pinMask, GAMEPAD_MAPPING_RS_X_NEG);
+	addFlags(gamepad.mapAnalogRSXPos->pinMask, GAMEPAD_MAPPING_RS_X_POS);
+	addFlags(gamepad.mapAnalogRSYNeg->pinMask, GAMEPAD_MAPPING_RS_Y_NEG);
+	addFlags(gamepad.mapAnalogRSYPos->pinMask, GAMEPAD_MAPPING_RS_Y_POS);
+}
+
+void GamepadMappingPlan::addButtons(uint32_t pinMask, uint32_t buttonMask)
+{
+	GamepadMappingEntry outputs = { };
+	outputs.buttons = buttonMask;
+	add(pinMask, outputs);
+}
+
+void GamepadMappingPlan::addDpad(uint32_t pinMask, uint8_t dpadMask)
+{
+	GamepadMappingEntry outputs = { };
+	outputs.dpad = dpadMask;
+	add(pinMask, outputs);
+}
+
+void GamepadMappingPlan::addFlags(uint32_t pinMask, uint16_t flags)
+{
+	GamepadMappingEntry outputs = { };
+	outputs.flags = flags;
+	add(pinMask, outputs);
+}
+
+void GamepadMappingPlan::add(uint32_t pinMask, const GamepadMappingEntry& outputs)
+{
+	for (uint8_t lut = 0; lut < GAMEPAD_MAPPING_LUT_COUNT; lut++) {
+		uint8_t bytePins = (pinMask >> (lut * 8)) & 0xFF;
+		if (bytePins == 0)
+			continue;
+
+		// every value of this byte with at least one of the pins pressed gets the outputs
+		for (uint16_t value = 0; value < GAMEPAD_MAPPING_LUT_SIZE; value++) {
+			if ((value & bytePins) == 0)
+				continue;
+
+			GamepadMappingEntry& entry = luts[lut][value];
+			entry.buttons |= outputs.buttons;
+			entry.flags |= outputs.flags;
+			entry.dpad |= outputs.dpad;
+		}
+	}
+}
@@ -1,5 +1,5 @@
 #include "GamepadState.h"
-#include "drivermanager.h"
+#include "framecontext.h"
 
 // Convert the horizontal GamepadState dpad axis value into an analog value
 uint16_t dpadToAnalogX(uint8_t dpad)
@@ -13,10 +13,7 @@ uint16_t dpadToAnalogX(uint8_t dpad)
 			return GAMEPAD_JOYSTICK_MAX;
 
 		default:
-			if ( DriverManager::getInstance().getDriver() != nullptr )
-				return DriverManager::getInstance().getDriver()->GetJoystickMidValue();
-			else
-				return GAMEPAD_JOYSTICK_MID;
+			return FrameContext::current().joystickMid;
 	}
 }
 
@@ -32,10 +29,7 @@ uint16_t dpadToAnalogY(uint8_t dpad)
 			return GAMEPAD_JOYSTICK_MAX;
 
 		default:
-			if ( DriverManager::getInstance().getDriver() != nullptr )
-				return DriverManager::getInstance().getDriver()->GetJoystickMidValue();
-			else
-				return GAMEPAD_JOYSTICK_MID;
+			return FrameContext::current().joystickMid;
 	}
 }
 
@@ -44,125 +38,168 @@ uint8_t getMaskFromDirection(DpadDirection direction)
 	return dpadMasks[direction-1];
 }
 
-uint8_t updateDpad(uint8_t dpad, DpadDirection direction)
+// Every order the four cardinal directions can be held in: nothing, 4 singles, 12 pairs, 24 triples, 24 quads
+#define FOUR_WAY_HISTORY_COUNT 65
+
+struct FourWayHistory
 {
-	static bool inList[] = {false, false, false, false, false}; // correspond to DpadDirection: none, up, down, left, right
-	static list<DpadDirection> dpadList;
+	uint8_t count;
+	uint8_t order[4];	// dpadMasks index of each held direction, oldest first
+};
 
-	if(dpad & getMaskFromDirection(direction))
-	{
-		if(!inList[direction])
-		{
-			dpadList.push_back(direction);
-			inList[direction] = true;
-		}
+struct FourWayTables
+{
+	FourWayHistory histories[FOUR_WAY_HISTORY_COUNT];
+	uint8_t next[FOUR_WAY_HISTORY_COUNT][16];	// history index after the dpad (low nibble) is read
+	uint8_t output[FOUR_WAY_HISTORY_COUNT];	// direction the history resolves to
+};
+
+static constexpr bool sameHistory(const FourWayHistory& a, const FourWayHistory& b)
+{
+	if (a.count != b.count)
+		return false;
+	for (uint8_t i = 0; i < a.count; i++) {
+		if (a.order[i] != b.order[i])
+			return false;
 	}
-	else
-	{
-		if(inList[direction])
-		{
-			dpadList.remove(direction);
-			inList[direction] = false;
+	return true;
+}
+
+static constexpr FourWayTables buildFourWayTables()
+{
+	FourWayTables tables = { };
+
+	// list the histories shortest first, so index 0 is nothing held
+	uint8_t count = 0;
+	for (uint8_t length = 0; length <= 4; length++) {
+		uint16_t combinations = 1 << (2 * length);
+		for (uint16_t combination = 0; combination < combinations; combination++) {
+			FourWayHistory history = { };
+			uint8_t seen = 0;
+			bool distinct = true;
+			for (uint8_t i = 0; i < length; i++) {
+				uint8_t direction = (combination >> (2 * i)) & 0x3;
+				if (seen & (1 << direction))
+					distinct = false;
+				seen |= (1 << direction);
+				history.order[i] = direction;
+			}
+			if (!distinct)
+				continue;
+			history.count = length;
+			tables.histories[count++] = history;
 		}
 	}
 
-	if(dpadList.empty()) {
-		return 0;
-	}
-	else {
-		return getMaskFromDirection(dpadList.back());
+	for (uint8_t index = 0; index < FOUR_WAY_HISTORY_COUNT; index++) {
+		const FourWayHistory& history = tables.histories[index];
+		tables.output[index] = history.count ? dpadMasks[history.order[history.count - 1]] : 0;
+
+		for (uint8_t dpad = 0; dpad < 16; dpad++) {
+			// released directions leave the history, newly pressed ones join it in up, down, left, right order
+			FourWayHistory updated = { };
+			uint8_t held = 0;
+			for (uint8_t i = 0; i < history.count; i++) {
+				if (dpad & dpadMasks[history.order[i]]) {
+					updated.order[updated.count++] = history.order[i];
+					held |= dpadMasks[history.order[i]];
+				}
+			}
+			for (uint8_t direction = 0; direction < 4; direction++) {
+				if ((dpad & dpadMasks[direction]) && !(held & dpadMasks[direction]))
+					updated.order[updated.count++] = direction;
+			}
+
+			for (uint8_t next = 0; next < FOUR_WAY_HISTORY_COUNT; next++) {
+				if (sameHistory(tables.histories[next], updated)) {
+					tables.next[index][dpad] = next;
+					break;
+				}
+			}
+		}
 	}
-}
 
-/**
- * @brief Filter diagonals out of the dpad, making the device work as a 4-way lever.
- *
- * The most recent cardinal direction wins.
- *
- * @param dpad The GameState.dpad value.
- * @return uint8_t The new dpad value.
- */
-uint8_t filterToFourWayMode(uint8_t dpad)
-{
-	updateDpad(dpad, DIRECTION_UP);
-	updateDpad(dpad, DIRECTION_DOWN);
-	updateDpad(dpad, DIRECTION_LEFT);
-	return updateDpad(dpad, DIRECTION_RIGHT);
+	return tables;
 }
 
-/**
- * @brief Run SOCD cleaning against a D-pad value.
- *
- * @param mode The SOCD cleaning mode.
- * @param dpad The GamepadState.dpad value.
- * @return uint8_t The clean D-pad value.
- */
-uint8_t runSOCDCleaner(SOCDMode mode, uint8_t dpad)
-{
-	if (mode == SOCD_MODE_BYPASS) {
-		return dpad;
-	}
+static constexpr FourWayTables fourWayTables = buildFourWayTables();
 
-	static DpadDirection lastUD = DIRECTION_NONE;
-	static DpadDirection lastLR = DIRECTION_NONE;
-	uint8_t newDpad = 0;
+// One SOCD axis: bit 0 is up (or left), bit 1 is down (or right), the history is the DpadDirection of the axis
+// seen last, as DIRECTION_NONE, the first or the second direction of the axis
+#define SOCD_AXIS_NONE   0
+#define SOCD_AXIS_FIRST  1
+#define SOCD_AXIS_SECOND 2
+#define SOCD_AXIS_BOTH   3
 
-	switch (dpad & (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN))
+// The modes the table covers, bypass does not touch the dpad or the history
+#define SOCD_TABLE_MODES 4
+
+struct SOCDAxisTable
+{
+	uint8_t step[SOCD_TABLE_MODES][3][4];	// [mode][last][held], low nibble output, high nibble next last
+};
+
+static constexpr uint8_t socdAxisStep(SOCDMode mode, bool vertical, uint8_t last, uint8_t held)
+{
+	switch (held)
 	{
-		case (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN):
-			if (mode == SOCD_MODE_UP_PRIORITY)
-			{
-				newDpad |= GAMEPAD_MASK_UP;
-				lastUD = DIRECTION_UP;
-			}
-			else if (mode == SOCD_MODE_SECOND_INPUT_PRIORITY && lastUD != DIRECTION_NONE)
-				newDpad |= (lastUD == DIRECTION_UP) ? GAMEPAD_MASK_DOWN : GAMEPAD_MASK_UP;
-			else if (mode == SOCD_MODE_FIRST_INPUT_PRIORITY && lastUD != DIRECTION_NONE)
-				newDpad |= (lastUD == DIRECTION_UP) ? GAMEPAD_MASK_UP : GAMEPAD_MASK_DOWN;
+		case SOCD_AXIS_BOTH:
+			if (vertical && mode == SOCD_MODE_UP_PRIORITY)
+				return SOCD_AXIS_FIRST | (SOCD_AXIS_FIRST << 4);
+			else if (mode == SOCD_MODE_SECOND_INPUT_PRIORITY && last != SOCD_AXIS_NONE)
+				return (last == SOCD_AXIS_FIRST ? SOCD_AXIS_SECOND : SOCD_AXIS_FIRST) | (last << 4);
+			else if (mode == SOCD_MODE_FIRST_INPUT_PRIORITY && last != SOCD_AXIS_NONE)
+				return last | (last << 4);
 			else
-				lastUD = DIRECTION_NONE;
-			break;
+				return SOCD_AXIS_NONE | (SOCD_AXIS_NONE << 4);
 
-		case GAMEPAD_MASK_UP:
-			newDpad |= GAMEPAD_MASK_UP;
-			lastUD = DIRECTION_UP;
-			break;
-
-		case GAMEPAD_MASK_DOWN:
-			newDpad |= GAMEPAD_MASK_DOWN;
-			lastUD = DIRECTION_DOWN;
-			break;
+		case SOCD_AXIS_FIRST:
+		case SOCD_AXIS_SECOND:
+			return held | (held << 4);
 
 		default:
-			lastUD = DIRECTION_NONE;
-			break;
+			return SOCD_AXIS_NONE | (SOCD_AXIS_NONE << 4);
 	}
+}
 
-	switch (dpad & (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT))
-	{
-		case (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT):
-			if (mode == SOCD_MODE_SECOND_INPUT_PRIORITY && lastLR != DIRECTION_NONE)
-				newDpad |= (lastLR == DIRECTION_LEFT) ? GAMEPAD_MASK_RIGHT : GAMEPAD_MASK_LEFT;
-			else if (mode == SOCD_MODE_FIRST_INPUT_PRIORITY && lastLR != DIRECTION_NONE)
-				newDpad |= (lastLR == DIRECTION_LEFT) ? GAMEPAD_MASK_LEFT : GAMEPAD_MASK_RIGHT;
-			else
-				lastLR = DIRECTION_NONE;
-			break;
+static constexpr SOCDAxisTable buildSOCDAxisTable(bool vertical)
+{
+	SOCDAxisTable table = { };
+	for (uint8_t mode = 0; mode < SOCD_TABLE_MODES; mode++) {
+		for (uint8_t last = 0; last < 3; last++) {
+			for (uint8_t held = 0; held < 4; held++)
+				table.step[mode][last][held] = socdAxisStep((SOCDMode)mode, vertical, last, held);
+		}
+	}
+	return table;
+}
 
-		case GAMEPAD_MASK_LEFT:
-			newDpad |= GAMEPAD_MASK_LEFT;
-			lastLR = DIRECTION_LEFT;
-			break;
+static constexpr SOCDAxisTable socdVerticalTable = buildSOCDAxisTable(true);
+static constexpr SOCDAxisTable socdHorizontalTable = buildSOCDAxisTable(false);
 
-		case GAMEPAD_MASK_RIGHT:
-			newDpad |= GAMEPAD_MASK_RIGHT;
-			lastLR = DIRECTION_RIGHT;
-			break;
+void DpadResolver::reset()
+{
+	fourWayHistory = 0;
+	lastUD = SOCD_AXIS_NONE;
+	lastLR = SOCD_AXIS_NONE;
+}
 
-		default:
-			lastLR = DIRECTION_NONE;
-			break;
+uint8_t DpadResolver::filterToFourWayMode(uint8_t dpad)
+{
+	fourWayHistory = fourWayTables.next[fourWayHistory][dpad & GAMEPAD_MASK_DPAD];
+	return fourWayTables.output[fourWayHistory];
+}
+
+uint8_t DpadResolver::runSOCDCleaner(SOCDMode mode, uint8_t dpad)
+{
+	if (mode == SOCD_MODE_BYPASS || mode >= SOCD_TABLE_MODES) {
+		return dpad;
 	}
 
-	return newDpad;
+	uint8_t vertical = socdVerticalTable.step[mode][lastUD][dpad & (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN)];
+	uint8_t horizontal = socdHorizontalTable.step[mode][lastLR][(dpad & (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT)) >> 2];
+	lastUD = vertical >> 4;
+	lastLR = horizontal >> 4;
+
+	return (vertical & 0x3) | ((horizontal & 0x3) << 2);
 }
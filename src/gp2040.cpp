@@ -3,6 +3,7 @@
 #include "helper.h"
 #include "system.h"
 #include "enums.pb.h"
+#include "framecontext.h"
 
 #include "build_info.h"
 #include "configmanager.h" // Global Managers
@@ -11,6 +12,9 @@
 #include "addonmanager.h"
 #include "types.h"
 #include "usbhostmanager.h"
+#include "loopprofiler.h"
+#include "latencytracer.h"
+#include "boottimer.h"
 
 // Inputs for Core0
 #include "addons/analog.h"
@@ -52,6 +56,7 @@ static absolute_time_t rebootDelayTimeout = nil_time;
 
 void GP2040::setup() {
 	Storage::getInstance().init();
+	BootTimer::mark(BOOT_PHASE_STORAGE);
 
 	PeripheralManager::getInstance().initI2C();
 	PeripheralManager::getInstance().initSPI();
@@ -61,11 +66,14 @@ void GP2040::setup() {
 	if ( PeripheralManager::getInstance().isUSBEnabled(0) ) {
 		set_sys_clock_khz(120000, true); // Set Clock to 120MHz to avoid potential USB timing issues
 	}
+	BootTimer::mark(BOOT_PHASE_PERIPHERALS);
 
 	Gamepad * gamepad = new Gamepad();
 	Gamepad * processedGamepad = new Gamepad();
 	Storage::getInstance().SetGamepad(gamepad);
 	Storage::getInstance().SetProcessedGamepad(processedGamepad);
+	Storage::getInstance().publishProcessedState(processedGamepad->state);
+	Storage::getInstance().publishProcessedAuxState(processedGamepad->auxState);
 
 	// Set pin mappings for all GPIO functions
 	Storage::getInstance().setFunctionalPinMappings();
@@ -75,7 +83,7 @@ void GP2040::setup() {
 	
 	// now we can load the latest configured profile, which will map the
 	// new set of GPIOs to use...
-    this->initializeStandardGpio();
+    gpioInput.initializeStandardGpio();
 
     const GamepadOptions& gamepadOptions = Storage::getInstance().getGamepadOptions();
 
@@ -89,40 +97,44 @@ void GP2040::setup() {
     bootActions.insert({GAMEPAD_MASK_L2, gamepadOptions.inputModeL2});
     bootActions.insert({GAMEPAD_MASK_R1, gamepadOptions.inputModeR1});
     bootActions.insert({GAMEPAD_MASK_R2, gamepadOptions.inputModeR2});
+	BootTimer::mark(BOOT_PHASE_GAMEPAD);
 
 	// Initialize our ADC (various add-ons)
 	adc_init();
 
 	// Setup Add-ons
-	addons.LoadUSBAddon(new KeyboardHostAddon(), CORE0_INPUT);
-	addons.LoadUSBAddon(new GamepadUSBHostAddon(), CORE0_INPUT);
-	addons.LoadAddon(new AnalogInput(), CORE0_INPUT);
-	addons.LoadAddon(new BootselButtonAddon(), CORE0_INPUT);
-	addons.LoadAddon(new DualDirectionalInput(), CORE0_INPUT);
-	addons.LoadAddon(new FocusModeAddon(), CORE0_INPUT);
-	addons.LoadAddon(new I2CAnalog1219Input(), CORE0_INPUT);
-	addons.LoadAddon(new SPIAnalog1256Input(), CORE0_INPUT);
-	addons.LoadAddon(new WiiExtensionInput(), CORE0_INPUT);
-	addons.LoadAddon(new SNESpadInput(), CORE0_INPUT);
-	addons.LoadAddon(new PlayerNumAddon(), CORE0_USBREPORT);
-	addons.LoadAddon(new SliderSOCDInput(), CORE0_INPUT);
-	addons.LoadAddon(new TiltInput(), CORE0_INPUT);
-	addons.LoadAddon(new RotaryEncoderInput(), CORE0_INPUT);
-	addons.LoadAddon(new PCF8575Addon(), CORE0_INPUT);
+	addons.LoadUSBAddon<KeyboardHostAddon>(CORE0_INPUT);
+	addons.LoadUSBAddon<GamepadUSBHostAddon>(CORE0_INPUT);
+	addons.LoadAddon<AnalogInput>(CORE0_INPUT);
+	addons.LoadAddon<BootselButtonAddon>(CORE0_INPUT);
+	addons.LoadAddon<DualDirectionalInput>(CORE0_INPUT);
+	addons.LoadAddon<FocusModeAddon>(CORE0_INPUT);
+	addons.LoadAddon<I2CAnalog1219Input>(CORE0_INPUT);
+	addons.LoadAddon<SPIAnalog1256Input>(CORE0_INPUT);
+	addons.LoadAddon<WiiExtensionInput>(CORE0_INPUT);
+	addons.LoadAddon<SNESpadInput>(CORE0_INPUT);
+	addons.LoadAddon<PlayerNumAddon>(CORE0_USBREPORT);
+	addons.LoadAddon<SliderSOCDInput>(CORE0_INPUT);
+	addons.LoadAddon<TiltInput>(CORE0_INPUT);
+	addons.LoadAddon<RotaryEncoderInput>(CORE0_INPUT);
+	addons.LoadAddon<PCF8575Addon>(CORE0_INPUT);
 
 	// Input override addons
-	addons.LoadAddon(new ReverseInput(), CORE0_INPUT);
-	addons.LoadAddon(new TurboInput(), CORE0_INPUT); // Turbo overrides button states and should be close to the end
-	addons.LoadAddon(new InputMacro(), CORE0_INPUT);
+	addons.LoadAddon<ReverseInput>(CORE0_INPUT);
+	addons.LoadAddon<TurboInput>(CORE0_INPUT); // Turbo overrides button states and should be close to the end
+	addons.LoadAddon<InputMacro>(CORE0_INPUT);
+	BootTimer::mark(BOOT_PHASE_ADDONS);
 
 	InputMode inputMode = gamepad->getOptions().inputMode;
 	const BootAction bootAction = getBootAction();
+	BootTimer::mark(BOOT_PHASE_BOOT_ACTION);
 	switch (bootAction) {
 		case BootAction::ENTER_WEBCONFIG_MODE:
 			// Move this to the Net driver initialize
 			Storage::getInstance().SetConfigMode(true);
 			DriverManager::getInstance().setup(INPUT_MODE_CONFIG);
 			ConfigManager::getInstance().setup(CONFIG_TYPE_WEB);
+			BootTimer::mark(BOOT_PHASE_DRIVER);
 			return;
 		case BootAction::ENTER_USB_MODE:
 			reset_usb_boot(0, 0);
@@ -187,81 +199,10 @@ void GP2040::setup() {
 		// before USB host will be used so we can force it to ignore the check
 		Storage::getInstance().save(true);
 	}
+	BootTimer::mark(BOOT_PHASE_DRIVER);
 
 	// register system event handlers
-	EventManager::getInstance().registerEventHandler(GP_EVENT_STORAGE_SAVE, GPEVENT_CALLBACK(this->handleStorageSave(event)));
-}
-
-/**
- * @brief Initialize standard input button GPIOs that are present in the currently loaded profile.
- */
-void GP2040::initializeStandardGpio() {
-	GpioMappingInfo* pinMappings = Storage::getInstance().getProfilePinMappings();
-	buttonGpios = 0;
-	for (Pin_t pin = 0; pin < (Pin_t)NUM_BANK0_GPIOS; pin++)
-	{
-		// (NONE=-10, RESERVED=-5, ASSIGNED_TO_ADDON=0, everything else is ours)
-		if (pinMappings[pin].action > 0)
-		{
-			gpio_init(pin);             // Initialize pin
-			gpio_set_dir(pin, GPIO_IN); // Set as INPUT
-			gpio_pull_up(pin);          // Set as PULLUP
-			buttonGpios |= 1 << pin;    // mark this pin as mattering for GPIO debouncing
-		}
-	}
-}
-
-/**
- * @brief Deinitialize standard input button GPIOs that are present in the currently loaded profile.
- */
-void GP2040::deinitializeStandardGpio() {
-	GpioMappingInfo* pinMappings = Storage::getInstance().getProfilePinMappings();
-	for (Pin_t pin = 0; pin < (Pin_t)NUM_BANK0_GPIOS; pin++)
-	{
-		// (NONE=-10, RESERVED=-5, ASSIGNED_TO_ADDON=0, everything else is ours)
-		if (pinMappings[pin].action > 0)
-		{
-			gpio_deinit(pin);
-		}
-	}
-}
-
-/**
- * @brief Populate a debounced version of gpio_get_all suitable for use for buttons.
- *
- * For GPIO that are assigned to buttons (based on GpioMappings, see GP2040::initializeStandardGpio),
- * we can centralize their debouncing here and provide access to it to button users.
- *
- * For ease of use this provides the mask bitwise NOTed so that callers don't have to. To avoid misuse
- * and to simplify this method, non-button GPIO IS NOT PRESENT in this result. Use gpio_get_all directly
- * instead, if you don't want debounced data.
- */
-void GP2040::debounceGpioGetAll() {
-	Mask_t raw_gpio = ~gpio_get_all();
-	Gamepad* gamepad = Storage::getInstance().GetGamepad();
-	// return if state isn't different than the actual
-	if (gamepad->debouncedGpio == (raw_gpio & buttonGpios)) return;
-
-	uint32_t debounceDelay = Storage::getInstance().getGamepadOptions().debounceDelay;
-	// abort if no delay is configured
-	if (debounceDelay == 0) {
-		gamepad->debouncedGpio = raw_gpio;
-		return;
-	}
-
-	uint32_t now = getMillis();
-	// check each button use case GPIO for state
-	for (Pin_t pin = 0; pin < (Pin_t)NUM_BANK0_GPIOS; pin++) {
-		Mask_t pin_mask = 1 << pin;
-		if (buttonGpios & pin_mask) {
-			// Allow debouncer to change state if button state changed and debounce delay threshold met
-			if ((gamepad->debouncedGpio & pin_mask) != \
-					(raw_gpio & pin_mask) && ((now - gpioDebounceTime[pin]) > debounceDelay)) {
-				gamepad->debouncedGpio ^= pin_mask;
-				gpioDebounceTime[pin] = now;
-			}
-		}
-	}
+	storageSaveHandler = EventManager::getInstance().registerEventHandler(GP_EVENT_STORAGE_SAVE, GPEVENT_CALLBACK(this->handleStorageSave(event)));
 }
 
 void GP2040::run() {
@@ -269,60 +210,124 @@ void GP2040::run() {
 	Gamepad * gamepad = Storage::getInstance().GetGamepad();
 	Gamepad * processedGamepad = Storage::getInstance().GetProcessedGamepad();
 	bool configMode = Storage::getInstance().GetConfigMode();
-    GamepadState prevState;
+	// what Gamepad::read returned last pass, for the raw masks of the input frame event
+	GamepadState prevRawState = gamepad->state;
+
+	// Late-latch needs the SOF of the device port, USB host needs its task serviced more often than once per frame
+	const GamepadOptions& gamepadOptions = gamepad->getOptions();
+	bool lateLatch = !configMode && gamepadOptions.inputSamplingMode == INPUT_SAMPLING_SOF_LATE_LATCH &&
+		!PeripheralManager::getInstance().isUSBEnabled(0);
+	frameScheduler.setLead(gamepadOptions.lateLatchLeadUs);
+	EEPROM.setStallBudget(gamepadOptions.flashStallBudgetUs);
+	LoopProfiler::init(configMode);
+	bool firstReportSent = false;
 
     // Start the TinyUSB Device functionality
     tud_init(TUD_OPT_RHPORT);
 
 	while (1) { // LOOP
+		// Sleep until the inputs have to be sampled for the next frame
+		if (lateLatch) frameScheduler.waitForLatch();
+
+		LOOP_PROFILE_BEGIN();
+
 		this->getReinitGamepad(gamepad);
 
-		memcpy(&prevState, &gamepad->state, sizeof(GamepadState));
+		// Handlers on this core for events core1 sent (save requests from the display menu)
+		EventManager::getInstance().processQueuedEvents();
 
 		// Do any queued saves in StorageManager
 		Storage::getInstance().performEnqueuedSaves();
+		LOOP_PROFILE_MARK(LOOP_STAGE_STORAGE);
+
+		// Time, driver and options the rest of this pass runs with, taken after the saves so flash writes don't age it
+		FrameContext::capture();
 		
 		// Debounce
-		debounceGpioGetAll();
+		LATENCY_TRACE_SAMPLE();
+		gpioInput.debounceGpioGetAll();
+		LOOP_PROFILE_MARK(LOOP_STAGE_DEBOUNCE);
 		// Read Gamepad
 		gamepad->read();
 
-		checkRawState(prevState, gamepad->state);
+		// Changes of this pass, dispatched as one event once the report is out of the way
+		GPInputFrameEvent inputFrame;
+		inputFrame.setRaw(prevRawState, gamepad->state);
+		prevRawState = gamepad->state;
+		LOOP_PROFILE_MARK(LOOP_STAGE_READ);
 
 		// Config Loop (Web-Config does not require gamepad)
 		if (configMode == true) {
 			
 			ConfigManager::getInstance().loop();
 			rebootHotkeys.process(gamepad, configMode);
+			if (inputFrame.changes != 0) EventManager::getInstance().triggerEvent(inputFrame);
+			// no reports to hold up in web config, erases included
+			EEPROM.maintain();
+			LOOP_PROFILE_END();
 			continue;
 		}
 
 		// Process USB Host on Core0
 		USBHostManager::getInstance().process();
+		LOOP_PROFILE_MARK(LOOP_STAGE_USB_HOST);
 
 		// Pre-Process add-ons for MPGS
 		addons.PreprocessAddons(ADDON_PROCESS::CORE0_INPUT);
+		LOOP_PROFILE_MARK(LOOP_STAGE_ADDON_PREPROCESS);
 
 		gamepad->hotkey(); 	// check for MPGS hotkeys
 		rebootHotkeys.process(gamepad, configMode);
+		LOOP_PROFILE_MARK(LOOP_STAGE_HOTKEYS);
 		
 		gamepad->process(); // process through MPGS
+		LOOP_PROFILE_MARK(LOOP_STAGE_PROCESS);
 
 		// (Post) Process for add-ons
 		addons.ProcessAddons(ADDON_PROCESS::CORE0_INPUT);
 
-		checkProcessedState(processedGamepad->state, gamepad->state);
+		inputFrame.setProcessed(processedGamepad->state, gamepad->state);
+		bool processedChanged = memcmp(&processedGamepad->state, &gamepad->state, sizeof(GamepadState)) != 0;
+		LATENCY_TRACE_STATE(processedChanged);
 
-		// Copy Processed Gamepad for Core1 (race condition otherwise)
-		memcpy(&processedGamepad->state, &gamepad->state, sizeof(GamepadState));
+		// Publish the processed state for Core1, a pass that changed nothing leaves its version alone
+		if (processedChanged) {
+			memcpy(&processedGamepad->state, &gamepad->state, sizeof(GamepadState));
+			Storage::getInstance().publishProcessedState(gamepad->state);
+		}
+		LOOP_PROFILE_MARK(LOOP_STAGE_ADDON_PROCESS);
 
 		// Process Input Driver
 		inputDriver->process(gamepad);
+		// Aux state turbo and the driver set this pass (player LEDs, rumble) for the add-ons on Core1
+		Storage::getInstance().publishProcessedAuxState(processedGamepad->auxState);
+		// Boot ends with the first pass the driver ran with the host ready to take its report
+		if (!firstReportSent && tud_ready()) {
+			BootTimer::firstReport();
+			firstReportSent = true;
+		}
+		LOOP_PROFILE_MARK(LOOP_STAGE_DRIVER);
+
+		// Listeners only run once the report is queued
+		if (inputFrame.changes != 0) EventManager::getInstance().triggerEvent(inputFrame);
+		LOOP_PROFILE_MARK(LOOP_STAGE_EVENTS);
 		
 		// Process USB Report Addons
 		addons.ProcessAddons(ADDON_PROCESS::CORE0_USBREPORT);
+		LOOP_PROFILE_MARK(LOOP_STAGE_ADDON_USBREPORT);
 		
 		tud_task(); // TinyUSB Task update
+		LOOP_PROFILE_MARK(LOOP_STAGE_TUD_TASK);
+
+		// Due add-on polls (I2C/SPI reads) within the pass's budget, the report is already out of the way
+		addons.PollAddons(ADDON_PROCESS::CORE0_INPUT);
+		LOOP_PROFILE_MARK(LOOP_STAGE_ADDON_POLL);
+
+		// The next erase or program of a pending save, within the stall budget and none while anything is held or
+		// changed this pass, erases only while the host isn't taking reports
+		if (tud_ready()) EEPROM.step(inputFrame.changes != 0 || prevRawState.buttons != 0 || prevRawState.dpad != 0 || prevRawState.aux != 0);
+		else EEPROM.maintain();
+		LOOP_PROFILE_MARK(LOOP_STAGE_FLASH);
 
         if (rebootRequested) {
             rebootRequested = false;
@@ -341,6 +346,16 @@ void GP2040::run() {
         if (!is_nil_time(rebootDelayTimeout) && time_reached(rebootDelayTimeout)) {
             System::reboot(System::BootMode::DEFAULT);
         }
+
+		LOOP_PROFILE_END();
+
+		// Lock onto the SOF the armed report goes out after, the next latch is timed from it
+		if (lateLatch) {
+			if (tud_ready())
+				frameScheduler.syncToFrame();
+			else
+				frameScheduler.unlock();
+		}
 	}
 }
 
@@ -351,14 +366,14 @@ void GP2040::getReinitGamepad(Gamepad * gamepad) {
 		// we are moving off of them and onto potentially different pin assignments
 		// we currently don't support ASSIGNED_TO_ADDON pins being reinitialized,
 		// but if they were to be, that'd be the addon's duty, not ours
-		this->deinitializeStandardGpio();
+		gpioInput.deinitializeStandardGpio();
 
 		// now we can load the latest configured profile, which will map the
 		// new set of GPIOs to use...
 		Storage::getInstance().setFunctionalPinMappings();
 
 		// ...and initialize the pins again
-		this->initializeStandardGpio();
+		gpioInput.initializeStandardGpio();
 
 		// now we can tell the gamepad that the new mappings are in place
 		// and ready to use, and the pins are ready, so it should reinitialize itself
@@ -383,9 +398,13 @@ GP2040::BootAction GP2040::getBootAction() {
 				Gamepad * gamepad = Storage::getInstance().GetGamepad();
 				Gamepad * processedGamepad = Storage::getInstance().GetProcessedGamepad();
 				
-				debounceGpioGetAll();
+				FrameContext::capture();
+				gpioInput.debounceGpioGetAll();
 				gamepad->read();
 
+				// Every add-on poll is due right after setup, boot buttons on a bus are read before processing
+				addons.PollAddons(ADDON_PROCESS::CORE0_INPUT, UINT32_MAX);
+
 				// Pre-Process add-ons for MPGS
 				addons.PreprocessAddons(ADDON_PROCESS::CORE0_INPUT);
 				
@@ -394,8 +413,9 @@ GP2040::BootAction GP2040::getBootAction() {
 				// (Post) Process for add-ons
 				addons.ProcessAddons(ADDON_PROCESS::CORE0_INPUT);
 
-				// Copy Processed Gamepad for Core1 (race condition otherwise)
+				// Publish the processed state for Core1
 				memcpy(&processedGamepad->state, &gamepad->state, sizeof(GamepadState));
+				Storage::getInstance().publishProcessedState(gamepad->state);
 
                 const ForcedSetupOptions& forcedSetupOptions = Storage::getInstance().getForcedSetupOptions();
                 bool modeSwitchLocked = forcedSetupOptions.mode == FORCED_SETUP_MODE_LOCK_MODE_SWITCH ||
@@ -500,57 +520,6 @@ void GP2040::RebootHotkeys::process(Gamepad* gamepad, bool configMode) {
 	}
 }
 
-void GP2040::checkRawState(GamepadState prevState, GamepadState currState) {
-    // buttons pressed
-    if (
-        ((currState.aux & ~prevState.aux) != 0) ||
-        ((currState.dpad & ~prevState.dpad) != 0) ||
-        ((currState.buttons & ~prevState.buttons) != 0)
-    ) {
-        EventManager::getInstance().triggerEvent(new GPButtonDownEvent((currState.dpad & ~prevState.dpad), (currState.buttons & ~prevState.buttons), (currState.aux & ~prevState.aux)));
-    }
-
-    // buttons released
-    if (
-        ((prevState.aux & ~currState.aux) != 0) ||
-        ((prevState.dpad & ~currState.dpad) != 0) ||
-        ((prevState.buttons & ~currState.buttons) != 0)
-    ) {
-        EventManager::getInstance().triggerEvent(new GPButtonUpEvent((prevState.dpad & ~currState.dpad), (prevState.buttons & ~currState.buttons), (prevState.aux & ~currState.aux)));
-    }
-}
-
-void GP2040::checkProcessedState(GamepadState prevState, GamepadState currState) {
-    // buttons pressed
-    if (
-        ((currState.aux & ~prevState.aux) != 0) ||
-        ((currState.dpad & ~prevState.dpad) != 0) ||
-        ((currState.buttons & ~prevState.buttons) != 0)
-    ) {
-        EventManager::getInstance().triggerEvent(new GPButtonProcessedDownEvent((currState.dpad & ~prevState.dpad), (currState.buttons & ~prevState.buttons), (currState.aux & ~prevState.aux)));
-    }
-
-    // buttons released
-    if (
-        ((prevState.aux & ~currState.aux) != 0) ||
-        ((prevState.dpad & ~currState.dpad) != 0) ||
-        ((prevState.buttons & ~currState.buttons) != 0)
-    ) {
-        EventManager::getInstance().triggerEvent(new GPButtonProcessedUpEvent((prevState.dpad & ~currState.dpad), (prevState.buttons & ~currState.buttons), (prevState.aux & ~currState.aux)));
-    }
-
-    if (
-        (currState.lx != prevState.lx) ||
-        (currState.ly != prevState.ly) ||
-        (currState.rx != prevState.rx) ||
-        (currState.ry != prevState.ry) ||
-        (currState.lt != prevState.lt) ||
-        (currState.rt != prevState.rt)
-    ) {
-        EventManager::getInstance().triggerEvent(new GPAnalogProcessedMoveEvent(currState.lx, currState.ly, currState.rx, currState.ry, currState.lt, currState.rt));
-    }
-}
-
 void GP2040::handleStorageSave(GPEvent* e) {
     saveRequested = true;
     rebootRequested = ((GPStorageSaveEvent*)e)->restartAfterSave;
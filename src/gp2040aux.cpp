@@ -2,7 +2,9 @@
 #include "gp2040aux.h"
 #include "gamepad.h"
 
+#include "boottimer.h"
 #include "drivermanager.h"
+#include "eventmanager.h"
 #include "storagemanager.h"
 #include "usbhostmanager.h"
 
@@ -16,7 +18,9 @@
 
 #include <iterator>
 
-GP2040Aux::GP2040Aux() : isReady(false), inputDriver(nullptr) {
+#include "hardware/timer.h"
+
+GP2040Aux::GP2040Aux() : isReady(false), deferredSetup(false), inputDriver(nullptr) {
 }
 
 GP2040Aux::~GP2040Aux() {
@@ -41,14 +45,10 @@ void GP2040Aux::setup() {
 		}
 	}
 
-	// Setup Add-ons
-	addons.LoadAddon(new DisplayAddon(), CORE1_LOOP);
-	addons.LoadAddon(new NeoPicoLEDAddon(), CORE1_LOOP);
-	addons.LoadAddon(new PlayerLEDAddon(), CORE1_LOOP);
-	addons.LoadAddon(new BoardLedAddon(), CORE1_LOOP);
-	addons.LoadAddon(new BuzzerSpeakerAddon(), CORE1_LOOP);
-	addons.LoadAddon(new DRV8833RumbleAddon(), CORE1_LOOP);
-	addons.LoadAddon(new ReactiveLEDAddon(), CORE1_LOOP);
+	// Setup Add-ons, with fast boot the display, LEDs and buzzer wait until core0 sent its first report
+	deferredSetup = Storage::getInstance().getGamepadOptions().fastBoot && !Storage::getInstance().GetConfigMode();
+	if (!deferredSetup)
+		setupAddons();
 
 	// Initialize our USB manager
 	USBHostManager::getInstance().start();
@@ -57,8 +57,29 @@ void GP2040Aux::setup() {
 	isReady = true;
 }
 
+void GP2040Aux::setupAddons() {
+	addons.LoadAddon<DisplayAddon>(CORE1_LOOP);
+	addons.LoadAddon<NeoPicoLEDAddon>(CORE1_LOOP);
+	addons.LoadAddon<PlayerLEDAddon>(CORE1_LOOP);
+	addons.LoadAddon<BoardLedAddon>(CORE1_LOOP);
+	addons.LoadAddon<BuzzerSpeakerAddon>(CORE1_LOOP);
+	addons.LoadAddon<DRV8833RumbleAddon>(CORE1_LOOP);
+	addons.LoadAddon<ReactiveLEDAddon>(CORE1_LOOP);
+}
+
 void GP2040Aux::run() {
 	while (1) {
+		// core0 is already running by now, the handlers these register go in core1's own table of EventManager
+		if (deferredSetup && BootTimer::deferredSetupDue()) {
+			uint32_t start = time_us_32();
+			setupAddons();
+			BootTimer::record(BOOT_PHASE_DEFERRED_ADDONS, start);
+			deferredSetup = false;
+		}
+
+		// Handlers on this core for events core0 sent (input frames, menu navigation, profile changes)
+		EventManager::getInstance().processQueuedEvents();
+
 		addons.ProcessAddons(CORE1_LOOP);
 
 		// Run auxiliary functions for input driver on Core1
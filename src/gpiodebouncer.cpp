@@ -0,0 +1,116 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#include "gpiodebouncer.h"
+
+#include <string.h>
+
+GpioDebouncer::GpioDebouncer() :
+	settled(0),
+	releasing(0),
+	delay(0),
+	threshold(0),
+	planes(0),
+	lastMillis(0)
+{
+	memset(counter, 0, sizeof(counter));
+}
+
+void GpioDebouncer::setDelay(uint32_t newDelay) {
+	// a changed delay (as opposed to the very first one) ends any running hold-off,
+	// the counters were sized for the old threshold and can't be compared to the new one
+	if (planes != 0) {
+		settled = ~0;
+		releasing = 0;
+		memset(counter, 0, sizeof(counter));
+	}
+
+	delay = newDelay;
+	threshold = (newDelay > GPIO_DEBOUNCE_MAX_DELAY ? GPIO_DEBOUNCE_MAX_DELAY : newDelay) + 1;
+
+	// a counter below the threshold plus at most threshold elapsed ms must fit, so one more bit than the threshold needs
+	planes = (32 - __builtin_clz(threshold)) + 1;
+}
+
+/**
+ * @brief Add the ms elapsed since the last call to the counters of all pins that are still in their hold-off window.
+ */
+void GpioDebouncer::advance(uint32_t now) {
+	uint32_t elapsed = now - lastMillis;
+	lastMillis = now;
+
+	Mask_t counting = ~settled;
+	if (elapsed == 0 || counting == 0) return;
+
+	// saturate, anything past the threshold settles the pin anyway
+	if (elapsed > threshold) elapsed = threshold;
+
+	// bit-sliced ripple carry add of elapsed to every counting pin
+	Mask_t carry = 0;
+	for (uint8_t plane = 0; plane < planes; plane++) {
+		Mask_t addend = ((elapsed >> plane) & 1) ? counting : 0;
+		Mask_t sum = counter[plane] ^ addend;
+		Mask_t nextCarry = (counter[plane] & addend) | (carry & sum);
+		counter[plane] = sum ^ carry;
+		carry = nextCarry;
+	}
+
+	// bit-sliced counter >= threshold, from the most significant plane down
+	Mask_t greater = 0;
+	Mask_t equal = ~0;
+	for (int8_t plane = planes - 1; plane >= 0; plane--) {
+		if ((threshold >> plane) & 1) {
+			equal &= counter[plane];
+		} else {
+			greater |= equal & counter[plane];
+			equal &= ~counter[plane];
+		}
+	}
+
+	settled |= (greater | equal) & counting;
+}
+
+Mask_t GpioDebouncer::debounce(Mask_t debounced, Mask_t raw, Mask_t watched, Mask_t eager, uint32_t now, uint32_t newDelay) {
+	if (planes == 0 || newDelay != delay) setDelay(newDelay);
+
+	advance(now);
+
+	Mask_t restart = 0;
+	eager &= watched;
+	if (eager != 0) {
+		// a pending release that is sampled pressed again was chatter, stop counting it
+		Mask_t chatter = releasing & raw;
+		releasing &= ~chatter;
+		settled |= chatter;
+
+		// release accepted after staying released for longer than the delay
+		Mask_t release = releasing & settled;
+		debounced &= ~release;
+		releasing &= ~release;
+
+		// start counting pins that were just sampled released
+		Mask_t start = debounced & ~raw & eager & ~releasing;
+		releasing |= start;
+		restart |= start;
+
+		// presses pass on the first sampled edge
+		debounced |= raw & eager;
+	}
+
+	// Allow debouncer to change state if button state changed and debounce delay threshold met
+	Mask_t toggle = (debounced ^ raw) & watched & ~eager & settled;
+	debounced ^= toggle;
+	restart |= toggle;
+
+	if (restart != 0) {
+		// restart the hold-off window for the pins that changed
+		settled &= ~restart;
+		for (uint8_t plane = 0; plane < planes; plane++) {
+			counter[plane] &= ~restart;
+		}
+	}
+
+	return debounced;
+}
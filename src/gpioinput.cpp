@@ -0,0 +1,121 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#include "gpioinput.h"
+
+#include "framecontext.h"
+#include "storagemanager.h"
+
+#include "hardware/gpio.h"
+
+GpioInput::GpioInput() :
+	buttonGpios(0),
+	eagerDebounceGpios(0)
+{
+}
+
+/**
+ * @brief Check if a GPIO mapping drives a direction (d-pad, digital or analog direction) rather than a button.
+ */
+static bool isDirectionMapping(const GpioMappingInfo& mapping) {
+	switch (mapping.action) {
+		case GpioAction::BUTTON_PRESS_UP:
+		case GpioAction::BUTTON_PRESS_DOWN:
+		case GpioAction::BUTTON_PRESS_LEFT:
+		case GpioAction::BUTTON_PRESS_RIGHT:
+		case GpioAction::DIGITAL_DIRECTION_UP:
+		case GpioAction::DIGITAL_DIRECTION_DOWN:
+		case GpioAction::DIGITAL_DIRECTION_LEFT:
+		case GpioAction::DIGITAL_DIRECTION_RIGHT:
+		case GpioAction::ANALOG_DIRECTION_LS_X_NEG:
+		case GpioAction::ANALOG_DIRECTION_LS_X_POS:
+		case GpioAction::ANALOG_DIRECTION_LS_Y_NEG:
+		case GpioAction::ANALOG_DIRECTION_LS_Y_POS:
+		case GpioAction::ANALOG_DIRECTION_RS_X_NEG:
+		case GpioAction::ANALOG_DIRECTION_RS_X_POS:
+		case GpioAction::ANALOG_DIRECTION_RS_Y_NEG:
+		case GpioAction::ANALOG_DIRECTION_RS_Y_POS:
+			return true;
+		case GpioAction::CUSTOM_BUTTON_COMBO:
+			return mapping.customDpadMask != 0;
+		default:
+			return false;
+	}
+}
+
+/**
+ * @brief Initialize standard input button GPIOs that are present in the currently loaded profile.
+ */
+void GpioInput::initializeStandardGpio() {
+	GpioMappingInfo* pinMappings = Storage::getInstance().getProfilePinMappings();
+	const GamepadOptions& gamepadOptions = Storage::getInstance().getGamepadOptions();
+	buttonGpios = 0;
+	eagerDebounceGpios = 0;
+	for (Pin_t pin = 0; pin < (Pin_t)NUM_BANK0_GPIOS; pin++)
+	{
+		// (NONE=-10, RESERVED=-5, ASSIGNED_TO_ADDON=0, everything else is ours)
+		if (pinMappings[pin].action > 0)
+		{
+			gpio_init(pin);             // Initialize pin
+			gpio_set_dir(pin, GPIO_IN); // Set as INPUT
+			gpio_pull_up(pin);          // Set as PULLUP
+			buttonGpios |= 1 << pin;    // mark this pin as mattering for GPIO debouncing
+
+			// debounce mode is chosen per pin class
+			DebounceMode debounceMode = isDirectionMapping(pinMappings[pin]) ?
+				gamepadOptions.debounceModeDirections : gamepadOptions.debounceModeButtons;
+			if (debounceMode == DEBOUNCE_MODE_EAGER_PRESS)
+				eagerDebounceGpios |= 1 << pin;
+		}
+	}
+}
+
+/**
+ * @brief Deinitialize standard input button GPIOs that are present in the currently loaded profile.
+ */
+void GpioInput::deinitializeStandardGpio() {
+	GpioMappingInfo* pinMappings = Storage::getInstance().getProfilePinMappings();
+	for (Pin_t pin = 0; pin < (Pin_t)NUM_BANK0_GPIOS; pin++)
+	{
+		// (NONE=-10, RESERVED=-5, ASSIGNED_TO_ADDON=0, everything else is ours)
+		if (pinMappings[pin].action > 0)
+		{
+			gpio_deinit(pin);
+		}
+	}
+}
+
+/**
+ * @brief Populate a debounced version of gpio_get_all suitable for use for buttons.
+ *
+ * For GPIO that are assigned to buttons (based on GpioMappings, see GpioInput::initializeStandardGpio),
+ * we can centralize their debouncing here and provide access to it to button users.
+ *
+ * Add-ons debounce their own pins here too by registering them with FrameContext::addDebounceGpios.
+ *
+ * For ease of use this provides the mask bitwise NOTed so that callers don't have to. To avoid misuse
+ * and to simplify this method, GPIO that is neither a button nor registered IS NOT PRESENT in this result.
+ * Use FrameContext::current().rawGpio instead, if you don't want debounced data; it is sampled with the
+ * same read.
+ */
+void GpioInput::debounceGpioGetAll() {
+	Mask_t raw_gpio = ~gpio_get_all();
+	Gamepad* gamepad = Storage::getInstance().GetGamepad();
+	Mask_t watchedGpios = buttonGpios | FrameContext::getAddonGpios();
+	Mask_t eagerGpios = eagerDebounceGpios | FrameContext::getAddonEagerGpios();
+	// skip if state isn't different than the actual, unless a deferred release still has to be checked for chatter
+	if (gamepad->debouncedGpio != (raw_gpio & watchedGpios) || gpioDebouncer.pendingReleases() != 0) {
+		uint32_t debounceDelay = Storage::getInstance().getGamepadOptions().debounceDelay;
+		if (debounceDelay == 0) {
+			// no delay is configured
+			gamepad->debouncedGpio = raw_gpio;
+		} else {
+			// debounce all button GPIOs at once, see GpioDebouncer
+			gamepad->debouncedGpio = gpioDebouncer.debounce(gamepad->debouncedGpio, raw_gpio, watchedGpios, eagerGpios, FrameContext::current().millis, debounceDelay);
+		}
+	}
+
+	FrameContext::captureGpio(raw_gpio, gamepad->debouncedGpio);
+}
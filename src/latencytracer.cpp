@@ -0,0 +1,118 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#include "latencytracer.h"
+
+#include <string.h>
+
+#include "pico/platform.h"
+
+#define LATENCY_TRACE_MAGIC 0x4c415431 // "LAT1"
+
+static const LatencyStats emptyStats = {};
+
+#if LATENCY_TRACER_ENABLED
+
+struct LatencyTraceTable {
+    uint32_t magic;
+    uint32_t size;
+    LatencyStats stats[LATENCY_TRACER_INPUT_MODES][LATENCY_POINT_COUNT];
+};
+
+// not cleared on boot, a watchdog reboot into web config keeps the stats of the previous input mode
+static LatencyTraceTable __uninitialized_ram(traceTable);
+
+static LatencyStats* modeStats = nullptr;
+static uint32_t sampleTime = 0;
+static uint32_t pendingStamp = 0;
+static uint32_t inflightStamp = 0;
+static bool pending = false;
+static bool inflight = false;
+
+static inline void record(LatencyStats& stats, uint32_t elapsed) {
+    if (stats.count == 0 || elapsed < stats.min) stats.min = elapsed;
+    if (elapsed > stats.max) stats.max = elapsed;
+    stats.sum += elapsed;
+    stats.count++;
+
+    uint8_t bucket = (elapsed == 0) ? 0 : (32 - __builtin_clz(elapsed));
+    if (bucket >= LATENCY_TRACER_HISTOGRAM_BUCKETS) bucket = LATENCY_TRACER_HISTOGRAM_BUCKETS - 1;
+    stats.histogram[bucket]++;
+}
+
+void LatencyTracer::init(InputMode mode) {
+    // power-on leaves random contents
+    if (traceTable.magic != LATENCY_TRACE_MAGIC || traceTable.size != sizeof(LatencyTraceTable)) {
+        reset();
+    }
+
+    modeStats = (mode < LATENCY_TRACER_INPUT_MODES) ? traceTable.stats[mode] : nullptr;
+    pending = false;
+    inflight = false;
+}
+
+void LatencyTracer::sample(uint32_t now) {
+    sampleTime = now;
+}
+
+void LatencyTracer::stateChanged(bool changed) {
+    // keep the oldest unsent change, the next report carries it as well
+    if (changed && !pending) {
+        pendingStamp = sampleTime;
+        pending = true;
+    }
+}
+
+void LatencyTracer::reportQueued(uint32_t now) {
+    if (!pending || modeStats == nullptr) return;
+
+    record(modeStats[LATENCY_POINT_QUEUED], now - pendingStamp);
+    inflightStamp = pendingStamp;
+    inflight = true;
+    pending = false;
+}
+
+void LatencyTracer::reportUnchanged() {
+    pending = false;
+}
+
+void LatencyTracer::reportCompleted(uint32_t now) {
+    if (!inflight || modeStats == nullptr) return;
+
+    record(modeStats[LATENCY_POINT_COMPLETED], now - inflightStamp);
+    inflight = false;
+}
+
+void LatencyTracer::reset() {
+    memset(&traceTable, 0, sizeof(traceTable));
+    traceTable.magic = LATENCY_TRACE_MAGIC;
+    traceTable.size = sizeof(LatencyTraceTable);
+}
+
+const LatencyStats& LatencyTracer::getStats(InputMode mode, LatencyTracePoint point) {
+    if (mode >= LATENCY_TRACER_INPUT_MODES || traceTable.magic != LATENCY_TRACE_MAGIC) return emptyStats;
+    return traceTable.stats[mode][point];
+}
+
+#else
+
+void LatencyTracer::init(InputMode mode) {}
+void LatencyTracer::sample(uint32_t now) {}
+void LatencyTracer::stateChanged(bool changed) {}
+void LatencyTracer::reportQueued(uint32_t now) {}
+void LatencyTracer::reportUnchanged() {}
+void LatencyTracer::reportCompleted(uint32_t now) {}
+void LatencyTracer::reset() {}
+
+const LatencyStats& LatencyTracer::getStats(InputMode mode, LatencyTracePoint point) {
+    return emptyStats;
+}
+
+#endif
+
+uint32_t LatencyTracer::getAverage(InputMode mode, LatencyTracePoint point) {
+    const LatencyStats& stats = getStats(mode, point);
+    return (stats.count == 0) ? 0 : (uint32_t)(stats.sum / stats.count);
+}
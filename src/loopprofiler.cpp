@@ -0,0 +1,122 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#include "loopprofiler.h"
+
+#include <string.h>
+
+#include "hardware/timer.h"
+#include "pico/platform.h"
+
+#define LOOP_PROFILE_MAGIC 0x4c505231 // "LPR1"
+
+struct LoopProfileTable {
+    uint32_t magic;
+    uint32_t size;
+    bool gameplay;                                  // stageStats are of a boot that wasn't web config
+    bool hasGameplay;
+    LoopProfileStats stageStats[LOOP_STAGE_COUNT];
+    LoopProfileStats gameplayStats[LOOP_STAGE_COUNT];   // of the last boot that wasn't web config
+};
+
+// not cleared on boot, a watchdog reboot into web config keeps the stats of the session before it
+static LoopProfileTable __uninitialized_ram(profileTable);
+static LoopProfileStats (&stageStats)[LOOP_STAGE_COUNT] = profileTable.stageStats;
+static uint32_t iterationStart = 0;
+static uint32_t lastMark = 0;
+
+struct StageNames {
+    const char* name;   // for web config
+    const char* label;  // five characters at most, for the display
+};
+
+static const StageNames stageNames[] = {
+    { "storage", "Store" },
+    { "debounce", "Debnc" },
+    { "read", "Read" },
+    { "usbHost", "USBH" },
+    { "addonPreprocess", "PreAd" },
+    { "hotkeys", "Hotky" },
+    { "process", "Proc" },
+    { "addonProcess", "Addon" },
+    { "driver", "Drivr" },
+    { "events", "Event" },
+    { "addonUsbReport", "RptAd" },
+    { "tudTask", "TUD" },
+    { "addonPoll", "Poll" },
+    { "flash", "Flash" },
+    { "total", "Total" },
+};
+
+static_assert(sizeof(stageNames) / sizeof(stageNames[0]) == LOOP_STAGE_COUNT, "every LoopProfileStage needs its names");
+
+static inline void record(LoopProfileStats& stats, uint32_t elapsed) {
+    if (stats.count == 0 || elapsed < stats.min) stats.min = elapsed;
+    if (elapsed > stats.max) stats.max = elapsed;
+    stats.sum += elapsed;
+    stats.count++;
+
+    uint8_t bucket = (elapsed == 0) ? 0 : (32 - __builtin_clz(elapsed));
+    if (bucket >= LOOP_PROFILER_HISTOGRAM_BUCKETS) bucket = LOOP_PROFILER_HISTOGRAM_BUCKETS - 1;
+    stats.histogram[bucket]++;
+}
+
+void LoopProfiler::init(bool configMode) {
+    // power-on leaves random contents
+    if (profileTable.magic != LOOP_PROFILE_MAGIC || profileTable.size != sizeof(LoopProfileTable)) {
+        memset(&profileTable, 0, sizeof(profileTable));
+        profileTable.magic = LOOP_PROFILE_MAGIC;
+        profileTable.size = sizeof(LoopProfileTable);
+    } else if (profileTable.gameplay && profileTable.stageStats[LOOP_STAGE_TOTAL].count != 0) {
+        memcpy(profileTable.gameplayStats, profileTable.stageStats, sizeof(profileTable.gameplayStats));
+        profileTable.hasGameplay = true;
+    }
+
+    profileTable.gameplay = !configMode;
+    reset();
+}
+
+void LoopProfiler::begin() {
+    iterationStart = time_us_32();
+    lastMark = iterationStart;
+}
+
+void LoopProfiler::mark(LoopProfileStage stage) {
+    uint32_t now = time_us_32();
+    record(stageStats[stage], now - lastMark);
+    lastMark = now;
+}
+
+void LoopProfiler::end() {
+    record(stageStats[LOOP_STAGE_TOTAL], time_us_32() - iterationStart);
+}
+
+void LoopProfiler::reset() {
+    memset(stageStats, 0, sizeof(stageStats));
+}
+
+const LoopProfileStats& LoopProfiler::getStats(LoopProfileStage stage) {
+    return stageStats[stage];
+}
+
+const LoopProfileStats* LoopProfiler::getGameplayStats(LoopProfileStage stage) {
+    return profileTable.hasGameplay ? &profileTable.gameplayStats[stage] : nullptr;
+}
+
+uint32_t LoopProfiler::getAverage(LoopProfileStage stage) {
+    return getAverage(stageStats[stage]);
+}
+
+uint32_t LoopProfiler::getAverage(const LoopProfileStats& stats) {
+    return (stats.count == 0) ? 0 : (uint32_t)(stats.sum / stats.count);
+}
+
+const char* LoopProfiler::getStageName(LoopProfileStage stage) {
+    return stageNames[stage].name;
+}
+
+const char* LoopProfiler::getStageLabel(LoopProfileStage stage) {
+    return stageNames[stage].label;
+}
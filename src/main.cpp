@@ -9,6 +9,7 @@
 // GP2040 includes
 #include "gp2040.h"
 #include "gp2040aux.h"
+#include "boottimer.h"
 
 #include <cstdlib>
 
@@ -33,6 +34,8 @@ void core1() {
 }
 
 int main() {
+	BootTimer::start();
+
 	// Create GP2040 Main Core (core0), Core1 is dependent on Core0
 	gp2040Core0 = new GP2040();
 	gp2040Core1 = new GP2040Aux();
@@ -47,6 +50,7 @@ int main() {
 	while(gp2040Core1->ready() == false ) {
 		__asm volatile ("nop\n");
 	}
+	BootTimer::mark(BOOT_PHASE_CORE1);
 	gp2040Core0->run();
 
 	return 0;
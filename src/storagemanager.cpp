@@ -19,7 +19,6 @@
 
 void Storage::init() {
 	EEPROM.start();
-	critical_section_init(&animationOptionsCs);
 	ConfigUtils::load(config);
 }
 
@@ -95,32 +94,30 @@ static void updateAnimationOptionsProto(const AnimationOptions& options)
 
 void Storage::performEnqueuedSaves()
 {
-	if (animationOptionsSavePending.load())
+	if (animationOptionsToSave.version() != animationOptionsSavedVersion)
 	{
-		critical_section_enter_blocking(&animationOptionsCs);
-		updateAnimationOptionsProto(animationOptionsToSave);
+		AnimationOptions animationOptions;
+		animationOptionsSavedVersion = animationOptionsToSave.read(animationOptions);
+		updateAnimationOptionsProto(animationOptions);
 		save();
-		animationOptionsSavePending.store(false);
-		critical_section_exit(&animationOptionsCs);
 	}
 }
 
 void Storage::enqueueAnimationOptionsSave(const AnimationOptions& animationOptions)
 {
+	// only core1 gets here, the CRC of the last enqueued options is its own
 	const uint32_t crc = CRC32::calculate(&animationOptions);
-	critical_section_enter_blocking(&animationOptionsCs);
 	if (crc != animationOptionsCrc)
 	{
-		animationOptionsToSave = animationOptions;
+		animationOptionsToSave.write(animationOptions);
 		animationOptionsCrc = crc;
-		animationOptionsSavePending.store(true);
 	}
-	critical_section_exit(&animationOptionsCs);
 }
 
 void Storage::ResetSettings()
 {
 	EEPROM.reset();
+	EEPROM.flush();
 	watchdog_reboot(0, SRAM_END, 2000);
 }
 
@@ -131,7 +128,7 @@ bool Storage::setProfile(const uint32_t profileNum)
 		// is this profile enabled?
 		// profile 1 (core) is always enabled, others we must check
 		if (profileNum == 1 || config.profileOptions.gpioMappingsSets[profileNum-2].enabled) {
-			EventManager::getInstance().triggerEvent(new GPProfileChangeEvent(this->config.gamepadOptions.profileNumber, profileNum));
+			EventManager::getInstance().triggerEvent(GPProfileChangeEvent(this->config.gamepadOptions.profileNumber, profileNum));
 			this->config.gamepadOptions.profileNumber = profileNum;
 			return true;
 		}
@@ -228,6 +225,51 @@ Gamepad * Storage::GetProcessedGamepad()
 	return processedGamepad;
 }
 
+void Storage::publishProcessedState(const GamepadState& state)
+{
+	processedState.write(state);
+}
+
+uint32_t Storage::readProcessedState(GamepadState& state) const
+{
+	return processedState.read(state);
+}
+
+void Storage::requestProcessedAux(uint32_t parts)
+{
+	for (uint32_t part = 0; part < PROCESSED_AUX_PART_COUNT; part++) {
+		if (parts & (1U << part)) processedAuxRequested[part].store(1, std::memory_order_relaxed);
+	}
+}
+
+void Storage::publishProcessedAuxState(GamepadAuxState& auxState)
+{
+	if (processedAuxEnabled != (1U << PROCESSED_AUX_PART_COUNT) - 1) {
+		for (uint32_t part = 0; part < PROCESSED_AUX_PART_COUNT; part++) {
+			if ((processedAuxEnabled & (1U << part)) || processedAuxRequested[part].load(std::memory_order_relaxed) == 0)
+				continue;
+			processedAuxEnabled |= 1U << part;
+			switch (1U << part) {
+				case PROCESSED_AUX_PLAYER_ID: auxState.playerID.enabled = true; break;
+				case PROCESSED_AUX_STATUS_LIGHT: auxState.sensors.statusLight.enabled = true; break;
+				case PROCESSED_AUX_LEFT_ACTUATOR: auxState.haptics.leftActuator.enabled = true; break;
+				case PROCESSED_AUX_RIGHT_ACTUATOR: auxState.haptics.rightActuator.enabled = true; break;
+			}
+		}
+	}
+
+	// most passes change nothing, those leave the version alone
+	if (processedAuxState.version() != 0 && memcmp(&auxState, &publishedAuxState, sizeof(GamepadAuxState)) == 0)
+		return;
+	memcpy(&publishedAuxState, &auxState, sizeof(GamepadAuxState));
+	processedAuxState.write(auxState);
+}
+
+uint32_t Storage::readProcessedAuxState(GamepadAuxState& auxState) const
+{
+	return processedAuxState.read(auxState);
+}
+
 /* Animation stuffs */
 AnimationOptions AnimationStorage::getAnimationOptions()
 {
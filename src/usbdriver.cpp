@@ -8,6 +8,7 @@
 
 #include "tusb.h"
 #include "drivermanager.h"
+#include "latencytracer.h"
 
 static bool usb_mounted;
 static bool usb_suspended;
@@ -35,6 +36,11 @@ void tud_hid_set_report_cb(uint8_t itf, uint8_t report_id, hid_report_type_t rep
 	DriverManager::getInstance().getDriver()->set_report(report_id, report_type, buffer, bufsize);
 }
 
+// Invoked when an IN report was sent to the host
+void tud_hid_report_complete_cb(uint8_t instance, uint8_t const *report, uint16_t len) {
+	LATENCY_TRACE_COMPLETED();
+}
+
 // Invoked when device is mounted
 void tud_mount_cb(void)
 {
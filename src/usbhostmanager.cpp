@@ -119,7 +119,7 @@ void tuh_mount_cb(uint8_t dev_addr) {
         vid = 0xFFFF;
         pid = 0xFFFF;
     }
-    EventManager::getInstance().triggerEvent(new GPUSBHostMountEvent(dev_addr, vid, pid));
+    EventManager::getInstance().triggerEvent(GPUSBHostMountEvent(dev_addr, vid, pid));
 }
 
 void tuh_umount_cb(uint8_t dev_addr) {
@@ -128,7 +128,7 @@ void tuh_umount_cb(uint8_t dev_addr) {
         vid = 0xFFFF;
         pid = 0xFFFF;
     }
-    EventManager::getInstance().triggerEvent(new GPUSBHostUnmountEvent(dev_addr, vid, pid));
+    EventManager::getInstance().triggerEvent(GPUSBHostUnmountEvent(dev_addr, vid, pid));
 }
 
 /// Invoked when device is unmounted (bus reset/unplugged)
@@ -115,6 +115,12 @@ app.get('/api/getGamepadOptions', (req, res) => {
 		fnButtonPin: -1,
 		profileNumber: 1,
 		debounceDelay: 5,
+		debounceModeButtons: 0,
+		debounceModeDirections: 0,
+		inputSamplingMode: 0,
+		lateLatchLeadUs: 250,
+		fastBoot: 0,
+		flashStallBudgetUs: 3000,
 		inputModeB1: 1,
 		inputModeB2: 0,
 		inputModeB3: 2,
@@ -528,6 +534,7 @@ app.get('/api/getAddonsOptions', (req, res) => {
 		analog1256DrdyPin: -1,
 		analog1256AnalogMax: 3.3,
 		analog1256EnableTriggers: false,
+		analog1256PollPeriodUs: 1000,
 		encoderOneEnabled: 0,
 		encoderOnePinA: -1,
 		encoderOnePinB: -1,
@@ -800,6 +807,151 @@ app.get('/api/getMemoryReport', (req, res) => {
 		staticAllocs: 200,
 		totalHeap: 2048 * 1024,
 		usedHeap: 1048 * 1024,
+		eventHandlers: [0, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 0, 1, 0],
+		maxEventHandlers: 8,
+		droppedEvents: 0,
+		addonLoadUs: [5200, 1800],
+		addonLoadHeap: [2400, 1100],
+	});
+});
+
+app.get('/api/getLoopProfile', (req, res) => {
+	const stages = [
+		'storage',
+		'debounce',
+		'read',
+		'usbHost',
+		'addonPreprocess',
+		'hotkeys',
+		'process',
+		'addonProcess',
+		'driver',
+		'events',
+		'addonUsbReport',
+		'tudTask',
+		'addonPoll',
+		'flash',
+		'total',
+	];
+	return res.send({
+		enabled: true,
+		stages: stages.map((name) => ({
+			name,
+			count: 1000,
+			min: 1,
+			avg: 2,
+			max: 8,
+			histogram: [0, 100, 800, 90, 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0],
+		})),
+		recorded: true,
+		gameplayStages: stages.map((name) => ({
+			name,
+			count: 600000,
+			min: 1,
+			avg: 3,
+			max: 45,
+			histogram: [0, 90000, 400000, 100000, 9000, 900, 90, 10, 0, 0, 0, 0, 0, 0, 0, 0],
+		})),
+		addons: [
+			{
+				name: 'Analog',
+				core: 0,
+				phase: 0,
+				process: { count: 1000, avgNs: 1500, max: 4 },
+			},
+			{
+				name: 'WiiExtension',
+				core: 0,
+				phase: 0,
+				process: { count: 1000, avgNs: 400, max: 1 },
+				poll: {
+					period: 1000,
+					count: 120,
+					deferred: 2,
+					overruns: 0,
+					max: 310,
+					maxLate: 180,
+				},
+			},
+			{
+				name: 'Display',
+				core: 1,
+				phase: 3,
+				process: { count: 1000, avgNs: 9000, max: 2100 },
+			},
+		],
+	});
+});
+
+app.get('/api/getLatencyTrace', (req, res) => {
+	const stats = (min, avg, max) => ({
+		count: 500,
+		min,
+		avg,
+		max,
+		histogram: [0, 0, 0, 0, 0, 0, 0, 0, 20, 400, 80, 0, 0, 0, 0, 0],
+	});
+	return res.send({
+		enabled: true,
+		modes: [
+			{
+				inputMode: 0,
+				queued: stats(130, 420, 980),
+				completed: stats(260, 690, 1210),
+			},
+		],
+	});
+});
+
+app.get('/api/resetLatencyTrace', (req, res) => {
+	return res.send({ success: true });
+});
+
+app.get('/api/getBootProfile', (req, res) => {
+	const phases = [
+		['reset', 1800],
+		['storage', 21000],
+		['peripherals', 900],
+		['gamepad', 350],
+		['addons', 5200],
+		['bootAction', 60],
+		['driver', 400],
+		['core1', 48000],
+		['firstReport', 180000],
+		['deferredAddons', 0],
+	];
+	let doneUs = 0;
+	return res.send({
+		fastBoot: 0,
+		recorded: true,
+		phases: phases.map(([name, us]) => {
+			doneUs += us;
+			return { name, us, doneUs: us ? doneUs : 0 };
+		}),
+	});
+});
+
+app.get('/api/getFlashStats', (req, res) => {
+	const stats = {
+		fullRecords: 1,
+		deltaRecords: 12,
+		sectorsErased: 2,
+		pagesProgrammed: 36,
+		steps: 38,
+		maxStallUs: 45210,
+		deferredSteps: 5400,
+		heldSteps: 2,
+		erasesAhead: 1,
+		restartedSaves: 1,
+		unsafeWrites: 0,
+	};
+	return res.send({
+		stallBudgetUs: 3000,
+		pageProgramMaxUs: 3000,
+		sectorEraseMaxUs: 400000,
+		current: { ...stats, deltaRecords: 0, pagesProgrammed: 0, steps: 0, maxStallUs: 0 },
+		recorded: true,
+		previous: stats,
 	});
 });
 
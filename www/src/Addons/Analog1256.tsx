@@ -23,6 +23,11 @@ export const analog1256Scheme = {
 		.number()
 		.label('Analog1256 DRDY Pin')
 		.validatePinWhenValue('Analog1256Enabled'),
+	analog1256AnalogMax: yup.number().label('Analog1256 Analog Max'),
+	analog1256PollPeriodUs: yup
+		.number()
+		.label('Analog1256 Read Period')
+		.validateRangeWhenValue('Analog1256Enabled', 250, 100000),
 };
 
 export const analog1256State = {
@@ -32,6 +37,7 @@ export const analog1256State = {
 	analog1256DrdyPin: -1,
 	analog1256AnalogMax: 3.3,
 	analog1256EnableTriggers: false,
+	analog1256PollPeriodUs: 1000,
 };
 
 const Analog1256 = ({ values, errors, handleChange, handleCheckbox }) => {
@@ -150,6 +156,24 @@ const Analog1256 = ({ values, errors, handleChange, handleCheckbox }) => {
 						<option value="5.0">{'5v'}</option>
 					</FormSelect>
 				</Row>
+				<Row className="mb-3">
+					<FormControl
+						type="number"
+						label={t('AddonsConfig:analog1256-poll-period')}
+						name="analog1256PollPeriodUs"
+						className="form-control-sm"
+						groupClassName="col-sm-3 mb-3"
+						value={values.analog1256PollPeriodUs}
+						error={errors.analog1256PollPeriodUs}
+						isInvalid={errors.analog1256PollPeriodUs}
+						onChange={handleChange}
+						min={250}
+						max={100000}
+					/>
+					<div className="col-sm-9 mb-3 form-text">
+						{t('AddonsConfig:analog1256-poll-period-help')}
+					</div>
+				</Row>
 				<Row>
 					<FormCheck
 						label={t('AddonsConfig:analog1256-enable-triggers')}
@@ -148,6 +148,9 @@ export default {
 	'analog1256-drdy-pin': 'Data Ready (DRDY) Pin',
 	'analog1256-analog-max': 'Analog Max',
 	'analog1256-enable-triggers': 'Enable Triggers',
+	'analog1256-poll-period': 'Read Period (us)',
+	'analog1256-poll-period-help':
+		'The channels are read after each report instead of in front of it, a stick movement can take up to one period longer to reach the host. Shorter periods leave less time for the rest of the loop.',
 	'joystick-selection-slider-mode-0': 'Digital',
 	'joystick-selection-slider-mode-1': 'Left Analog',
 	'joystick-selection-slider-mode-2': 'Right Analog',
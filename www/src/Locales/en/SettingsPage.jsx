@@ -57,6 +57,28 @@ export default {
 	},
 	'profile-label': 'Profile',
 	'debounce-delay-label': 'Debounce Delay in milliseconds',
+	'debounce-mode-buttons-label': 'Button Debounce Mode',
+	'debounce-mode-directions-label': 'Direction Debounce Mode',
+	'debounce-mode-note':
+		'Eager Press sends a press as soon as it is seen and only applies the debounce delay to releases, a release is sent once the input stayed released for the whole delay.',
+	'debounce-mode-options': {
+		standard: 'Standard',
+		'eager-press': 'Eager Press',
+	},
+	'input-sampling-mode-label': 'Input Sampling Mode',
+	'input-sampling-mode-options': {
+		'free-run': 'Free Run',
+		'sof-late-latch': 'USB Frame Late-Latch',
+	},
+	'late-latch-lead-label': 'Late-Latch Lead in microseconds',
+	'input-sampling-mode-note':
+		'USB Frame Late-Latch samples the inputs once per USB frame, the lead time before the host polls, and idles in between. Raise the lead if add-ons make the loop slower than the lead. Not used with USB host add-ons.',
+	'fast-boot-label': 'Fast Boot',
+	'fast-boot-note':
+		'Sets up the display, LEDs and buzzer once the first report went out, so the controller answers the host sooner after plugging in. Without a host they come up after a second.',
+	'flash-stall-budget-label': 'Flash Stall Budget in microseconds',
+	'flash-stall-budget-note':
+		'Saves go to flash one page at a time between input frames, never while a button is held, and no step that could take longer than the budget runs while playing. Sector erases happen in web config, before the host takes reports, or right before a reboot; a save that needs one while playing waits for then and is lost if the controller is unplugged first. From 3000 to 10000.',
 	'ps4-mode-explanation-text':
 		'PS4 mode allows GP2040-CE to run as an authenticated PS4 controller.',
 	'ps4-mode-warning-text':
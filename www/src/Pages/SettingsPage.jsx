@@ -225,6 +225,16 @@ const SOCD_MODES = [
 	{ labelKey: 'socd-cleaning-mode-options.off', value: 4 },
 ];
 
+const DEBOUNCE_MODES = [
+	{ labelKey: 'debounce-mode-options.standard', value: 0 },
+	{ labelKey: 'debounce-mode-options.eager-press', value: 1 },
+];
+
+const INPUT_SAMPLING_MODES = [
+	{ labelKey: 'input-sampling-mode-options.free-run', value: 0 },
+	{ labelKey: 'input-sampling-mode-options.sof-late-latch', value: 1 },
+];
+
 const PS4_MODES = [
 	{ labelKey: 'ps4-mode-options.controller', value: 0 },
 	{ labelKey: 'ps4-mode-options.arcadestick', value: 7 },
@@ -407,6 +417,34 @@ const schema = yup.object().shape({
 		.oneOf(AUTHENTICATION_TYPES.map((o) => o.value))
 		.label('X-Input Authentication Type'),
 	debounceDelay: yup.number().required().label('Debounce Delay'),
+	debounceModeButtons: yup
+		.number()
+		.required()
+		.oneOf(DEBOUNCE_MODES.map((o) => o.value))
+		.label('Button Debounce Mode'),
+	debounceModeDirections: yup
+		.number()
+		.required()
+		.oneOf(DEBOUNCE_MODES.map((o) => o.value))
+		.label('Direction Debounce Mode'),
+	inputSamplingMode: yup
+		.number()
+		.required()
+		.oneOf(INPUT_SAMPLING_MODES.map((o) => o.value))
+		.label('Input Sampling Mode'),
+	lateLatchLeadUs: yup
+		.number()
+		.required()
+		.min(50)
+		.max(900)
+		.label('Late-Latch Lead'),
+	fastBoot: yup.number().required().label('Fast Boot'),
+	flashStallBudgetUs: yup
+		.number()
+		.required()
+		.min(3000)
+		.max(10000)
+		.label('Flash Stall Budget'),
 	inputModeB1: yup
 		.number()
 		.required()
@@ -475,6 +513,13 @@ const FormContext = ({ setButtonLabels, setKeyMappings }) => {
 		if (!!values.dpadMode) values.dpadMode = parseInt(values.dpadMode);
 		if (!!values.inputMode) values.inputMode = parseInt(values.inputMode);
 		if (!!values.socdMode) values.socdMode = parseInt(values.socdMode);
+		if (!!values.debounceModeButtons)
+			values.debounceModeButtons = parseInt(values.debounceModeButtons);
+		if (!!values.debounceModeDirections)
+			values.debounceModeDirections = parseInt(values.debounceModeDirections);
+		if (!!values.inputSamplingMode)
+			values.inputSamplingMode = parseInt(values.inputSamplingMode);
+		if (!!values.fastBoot) values.fastBoot = parseInt(values.fastBoot);
 		if (!!values.switchTpShareForDs4)
 			values.switchTpShareForDs4 = parseInt(values.switchTpShareForDs4);
 		if (!!values.forcedSetupMode)
@@ -1358,6 +1403,8 @@ export default function SettingsPage() {
 	const translatedInputModeGroups = translateArray(INPUT_MODE_GROUPS);
 	const translatedDpadModes = translateArray(DPAD_MODES);
 	const translatedSocdModes = translateArray(SOCD_MODES);
+	const translatedDebounceModes = translateArray(DEBOUNCE_MODES);
+	const translatedInputSamplingModes = translateArray(INPUT_SAMPLING_MODES);
 	const translatedHotkeyActions = translateArray(HOTKEY_ACTIONS);
 	const translatedForcedSetupModes = translateArray(FORCED_SETUP_MODES);
 	// Not currently used but we might add the option at a later date (wheel type, etc.)
@@ -1603,6 +1650,143 @@ export default function SettingsPage() {
 															/>
 														</Col>
 													</Form.Group>
+													<Form.Group className="row mb-3">
+														<Form.Label>
+															{t('SettingsPage:debounce-mode-buttons-label')}
+														</Form.Label>
+														<Col sm={3}>
+															<Form.Select
+																name="debounceModeButtons"
+																className="form-select-sm"
+																value={values.debounceModeButtons}
+																onChange={handleChange}
+																isInvalid={errors.debounceModeButtons}
+															>
+																{translatedDebounceModes.map((o, i) => (
+																	<option
+																		key={`button-debounceModeButtons-option-${i}`}
+																		value={o.value}
+																	>
+																		{o.label}
+																	</option>
+																))}
+															</Form.Select>
+															<Form.Control.Feedback type="invalid">
+																{errors.debounceModeButtons}
+															</Form.Control.Feedback>
+														</Col>
+													</Form.Group>
+													<Form.Group className="row mb-3">
+														<Form.Label>
+															{t('SettingsPage:debounce-mode-directions-label')}
+														</Form.Label>
+														<Col sm={3}>
+															<Form.Select
+																name="debounceModeDirections"
+																className="form-select-sm"
+																value={values.debounceModeDirections}
+																onChange={handleChange}
+																isInvalid={errors.debounceModeDirections}
+															>
+																{translatedDebounceModes.map((o, i) => (
+																	<option
+																		key={`button-debounceModeDirections-option-${i}`}
+																		value={o.value}
+																	>
+																		{o.label}
+																	</option>
+																))}
+															</Form.Select>
+															<Form.Control.Feedback type="invalid">
+																{errors.debounceModeDirections}
+															</Form.Control.Feedback>
+														</Col>
+													</Form.Group>
+													<p>{t('SettingsPage:debounce-mode-note')}</p>
+													<Form.Group className="row mb-3">
+														<Form.Label>
+															{t('SettingsPage:input-sampling-mode-label')}
+														</Form.Label>
+														<Col sm={3}>
+															<Form.Select
+																name="inputSamplingMode"
+																className="form-select-sm"
+																value={values.inputSamplingMode}
+																onChange={handleChange}
+																isInvalid={errors.inputSamplingMode}
+															>
+																{translatedInputSamplingModes.map((o, i) => (
+																	<option
+																		key={`button-inputSamplingMode-option-${i}`}
+																		value={o.value}
+																	>
+																		{o.label}
+																	</option>
+																))}
+															</Form.Select>
+															<Form.Control.Feedback type="invalid">
+																{errors.inputSamplingMode}
+															</Form.Control.Feedback>
+														</Col>
+													</Form.Group>
+													{parseInt(values.inputSamplingMode) === 1 && (
+														<Form.Group className="row mb-3">
+															<Form.Label>
+																{t('SettingsPage:late-latch-lead-label')}
+															</Form.Label>
+															<Col sm={3}>
+																<Form.Control
+																	type="number"
+																	name="lateLatchLeadUs"
+																	className="form-control-sm"
+																	value={values.lateLatchLeadUs}
+																	error={errors.lateLatchLeadUs}
+																	isInvalid={errors.lateLatchLeadUs}
+																	onChange={handleChange}
+																	min={50}
+																	max={900}
+																/>
+															</Col>
+														</Form.Group>
+													)}
+													<p>{t('SettingsPage:input-sampling-mode-note')}</p>
+													<Form.Group className="row mb-3">
+														<Col sm={3}>
+															<Form.Check
+																label={t('SettingsPage:fast-boot-label')}
+																type="switch"
+																id="fastBoot"
+																isInvalid={false}
+																checked={Boolean(values.fastBoot)}
+																onChange={(e) => {
+																	setFieldValue(
+																		'fastBoot',
+																		e.target.checked ? 1 : 0,
+																	);
+																}}
+															/>
+														</Col>
+													</Form.Group>
+													<p>{t('SettingsPage:fast-boot-note')}</p>
+													<Form.Group className="row mb-3">
+														<Form.Label>
+															{t('SettingsPage:flash-stall-budget-label')}
+														</Form.Label>
+														<Col sm={3}>
+															<Form.Control
+																type="number"
+																name="flashStallBudgetUs"
+																className="form-control-sm"
+																value={values.flashStallBudgetUs}
+																error={errors.flashStallBudgetUs}
+																isInvalid={errors.flashStallBudgetUs}
+																onChange={handleChange}
+																min={3000}
+																max={10000}
+															/>
+														</Col>
+													</Form.Group>
+													<p>{t('SettingsPage:flash-stall-budget-note')}</p>
 													<Button type="submit">
 														{t('Common:button-save-label')}
 													</Button>